@@ -83,7 +83,9 @@ constexpr auto CONNECT_FLOOD_COUNT_MCN = 100;
 constexpr auto CONNECT_FLOOD_PERIOD = 30;
 
 ConnectionManager::ConnectionManager() : floodCounter(CONNECT_FLOOD_PERIOD), downloads(cqis[CONNECTION_TYPE_DOWNLOAD]) {
-	TimerManager::getInstance()->addListener(this);
+	auto tm = TimerManager::getInstance();
+	tickTask = tm->addTask("Connection tick", 1000, [this](uint64_t aTick) { onTimerTick(aTick); }, tm->getBackgroundExecutor());
+	maintenanceTask = tm->addTask("Connection maintenance", 60 * 1000, [this](uint64_t aTick) { onTimerMaintenance(aTick); }, tm->getBackgroundExecutor());
 	ClientManager::getInstance()->addListener(this);
 
 	features = {
@@ -352,7 +354,7 @@ void ConnectionManager::onUserUpdated(const UserPtr& aUser) noexcept {
 	}
 }
 
-void ConnectionManager::on(TimerManagerListener::Second, uint64_t aTick) noexcept {
+void ConnectionManager::onTimerTick(uint64_t aTick) noexcept {
 	StringList removedTokens;
 
 	attemptDownloads(aTick, removedTokens);
@@ -513,7 +515,7 @@ void ConnectionManager::createNewMCN(const HintedUser& aUser) noexcept {
 }
 
 constexpr auto MAX_UC_INACTIVITY_SECONDS = 180;
-void ConnectionManager::on(TimerManagerListener::Minute, uint64_t aTick) noexcept {
+void ConnectionManager::onTimerMaintenance(uint64_t aTick) noexcept {
 	WLock l(cs);
 	for (auto i = removedDownloadTokens.begin(); i != removedDownloadTokens.end();) {
 		if((i->second + (90 * 1000)) < aTick) {
@@ -1347,7 +1349,8 @@ void ConnectionManager::disconnect(const string& aToken) const noexcept {
 }
 
 void ConnectionManager::shutdown(const ProgressFunction& progressF) noexcept {
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(tickTask);
+	TimerManager::getInstance()->removeTask(maintenanceTask);
 	ClientManager::getInstance()->removeListener(this);
 	shuttingDown = true;
 	disconnect();
@@ -21,7 +21,6 @@
 
 #include <airdcpp/hub/ClientManagerListener.h>
 #include <airdcpp/connection/ConnectionManagerListener.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 #include <airdcpp/protocol/AdcSupports.h>
 #include <airdcpp/connection/ConnectionType.h>
@@ -128,8 +127,7 @@ inline bool operator==(ConnectionQueueItem::Ptr ptr, const UserPtr& aUser) noexc
 inline bool operator==(ConnectionQueueItem::Ptr ptr, const string& aToken) noexcept { return compare(ptr->getToken(), aToken) == 0; }
 
 class ConnectionManager : public Speaker<ConnectionManagerListener>, public ClientManagerListener,
-	public UserConnectionListener, public TimerManagerListener, 
-	public Singleton<ConnectionManager>
+	public UserConnectionListener, public Singleton<ConnectionManager>
 {
 public:
 	AdcSupports userConnectionSupports;
@@ -278,9 +276,12 @@ private:
 	void on(AdcCommand::INF, UserConnection*, const AdcCommand&) noexcept override;
 	void on(AdcCommand::STA, UserConnection*, const AdcCommand&) noexcept override;
 
-	// TimerManagerListener
-	void on(TimerManagerListener::Second, uint64_t aTick) noexcept override;
-	void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
+	// Timer tasks (run in the background thread of the timer)
+	TimerTaskId tickTask = 0;
+	TimerTaskId maintenanceTask = 0;
+
+	void onTimerTick(uint64_t aTick) noexcept;
+	void onTimerMaintenance(uint64_t aTick) noexcept;
 
 	// ClientManagerListener
 	void on(ClientManagerListener::UserConnected, const OnlineUser& aUser, bool) noexcept override { onUserUpdated(aUser.getUser()); }
@@ -33,13 +33,13 @@ constexpr auto CONDWAIT_TIMEOUT = 250;
 	// constructor
 	ThrottleManager::ThrottleManager(void)
 	{
-		TimerManager::getInstance()->addListener(this);
+		refillTask = TimerManager::getInstance()->addTask("Throttle refill", 1000, [this](uint64_t aTick) { onTimerRefill(aTick); });
 	}
 
 	// destructor
 	ThrottleManager::~ThrottleManager()
 	{
-		TimerManager::getInstance()->removeListener(this);
+		TimerManager::getInstance()->removeTask(refillTask);
 
 		// release conditional variables on exit
 		downCond.notify_all();
@@ -49,7 +49,7 @@ constexpr auto CONDWAIT_TIMEOUT = 250;
 	/*
 	 * Limits a traffic and reads a packet from the network
 	 */
-	int ThrottleManager::read(Socket* sock, void* buffer, size_t len)
+	int ThrottleManager::read(Socket* sock, void* buffer, size_t len, bool aWait)
 	{
 		size_t downs = DownloadManager::getInstance()->getTotalDownloadConnectionCount();
 		if (getDownLimit() == 0 || downs == 0)
@@ -77,6 +77,10 @@ constexpr auto CONDWAIT_TIMEOUT = 250;
 			return readSize;
 		}
 
+		if (!aWait) {
+			return THROTTLED;
+		}
+
 		// no tokens, wait for them
 		downCond.wait_for(lock, std::chrono::milliseconds(CONDWAIT_TIMEOUT));
 		return -1;	// from BufferedSocket: -1 = retry, 0 = connection close
@@ -86,7 +90,7 @@ constexpr auto CONDWAIT_TIMEOUT = 250;
 	 * Limits a traffic and writes a packet to the network
 	 * We must handle this a little bit differently than downloads, because of that stupidity in OpenSSL
 	 */		
-	int ThrottleManager::write(Socket* sock, void* buffer, size_t& len)
+	int ThrottleManager::write(Socket* sock, void* buffer, size_t& len, bool aWait)
 	{
 		size_t ups = UploadManager::getInstance()->getUploadCount();
 		if(getUpLimit() == 0 || ups == 0)
@@ -111,11 +115,47 @@ constexpr auto CONDWAIT_TIMEOUT = 250;
 			return sent;
 		}
 		
+		if (!aWait) {
+			return THROTTLED;
+		}
+
 		// no tokens, wait for them
 		upCond.wait_for(lock, std::chrono::milliseconds(CONDWAIT_TIMEOUT));
 		return 0;	// from BufferedSocket: -1 = failed, 0 = retry
 	}
 
+#ifdef __linux__
+	int ThrottleManager::sendFile(Socket* sock, int aFd, int64_t aPos, size_t& len, bool aWait)
+	{
+		size_t ups = UploadManager::getInstance()->getUploadCount();
+		if(getUpLimit() == 0 || ups == 0)
+			return sock->sendFile(aFd, aPos, len);
+
+		unique_lock<mutex> lock(upMutex);
+
+		if(upTokens > 0)
+		{
+			size_t slice = (getUpLimit() * 1024) / ups;
+			len = min(slice, min(len, upTokens));
+			upTokens -= len;
+
+			lock.unlock();
+
+			int sent = sock->sendFile(aFd, aPos, len);
+
+			// give a chance to other transfers to get a token
+			Thread::yield();
+			return sent;
+		}
+
+		if (aWait) {
+			upCond.wait_for(lock, std::chrono::milliseconds(CONDWAIT_TIMEOUT));
+		}
+
+		return THROTTLED;
+	}
+#endif
+
 	void ThrottleManager::setSetting(SettingsManager::IntSetting setting, int value) noexcept {
 		if (value < 0 || value > MAX_LIMIT)
 			value = 0;
@@ -159,8 +199,8 @@ constexpr auto CONDWAIT_TIMEOUT = 250;
 		}
 	}
 
-	// TimerManagerListener
-	void ThrottleManager::on(TimerManagerListener::Second, uint64_t /*aTick*/) noexcept {
+	// Timer tasks
+	void ThrottleManager::onTimerRefill(uint64_t /*aTick*/) noexcept {
 		auto downLimit = getDownLimit() * 1024;
 		auto upLimit = getUpLimit() * 1024;
 		
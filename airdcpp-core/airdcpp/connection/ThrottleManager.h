@@ -21,7 +21,6 @@
 
 #include <airdcpp/core/Singleton.h>
 #include <airdcpp/settings/SettingsManager.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 #include <condition_variable>
 #include <mutex>
@@ -35,20 +34,31 @@ namespace dcpp
 	 * Inspired by Token Bucket algorithm: http://en.wikipedia.org/wiki/Token_bucket
 	 */
 	class ThrottleManager :
-		public Singleton<ThrottleManager>, private TimerManagerListener
+		public Singleton<ThrottleManager>
 	{
 	public:
 
+		// Returned when there are no tokens available and the caller didn't want to wait for them
+		static const int THROTTLED = -2;
+
 		/*
 		 * Limits a traffic and reads a packet from the network
 		 */
-		int read(Socket* sock, void* buffer, size_t len);
+		int read(Socket* sock, void* buffer, size_t len, bool aWait = true);
 		
 		/*
 		 * Limits a traffic and writes a packet to the network
 		 * We must handle this a little bit differently than downloads, because of that stupidity in OpenSSL
 		 */		
-		int write(Socket* sock, void* buffer, size_t& len);
+		int write(Socket* sock, void* buffer, size_t& len, bool aWait = true);
+
+#ifdef __linux__
+		/*
+		 * Limits a traffic and sends data from a file descriptor to the network without copying it
+		 * Returns THROTTLED if there were no tokens available (after waiting for them if aWait is set)
+		 */
+		int sendFile(Socket* sock, int aFd, int64_t aPos, size_t& len, bool aWait = true);
+#endif
 
 		/*
 		 * Returns current download limit.
@@ -84,8 +94,9 @@ namespace dcpp
 		// destructor
 		~ThrottleManager() override;
 		
-		// TimerManagerListener
-		void on(TimerManagerListener::Second, uint64_t aTick) noexcept override;
+		// Timer tasks (run in the timer thread)
+		TimerTaskId refillTask = 0;
+		void onTimerRefill(uint64_t aTick) noexcept;
 				
 	};
 
@@ -43,6 +43,9 @@ void UDPServer::listen() {
 		socket->setLocalIp6(CONNSETTING(BIND_ADDRESS6));
 		socket->setV4only(false);
 		port = socket->listen(Util::toString(CONNSETTING(UDP_PORT)));
+
+		// Keep the counter of the previous socket
+		closedSocketDrops = receiveQueueDrops;
 		start();
 	} catch(...) {
 		socket.reset();
@@ -64,6 +67,23 @@ void UDPServer::disconnect() {
 	}
 }
 
+// Maximum size of a single packet
+constexpr auto BUFSIZE = 8192;
+
+// Number of packets read with a single call
+constexpr auto BATCH_SIZE = 32;
+
+// Packets will be dropped if the earlier ones can't be processed fast enough
+// (up to 8 MiB of buffers may be allocated with the default values)
+constexpr auto MAX_BATCHES = 32;
+
+UDPServer::PacketBatch::PacketBatch() : buffer(BUFSIZE * BATCH_SIZE), datagrams(BATCH_SIZE) {
+	for (size_t i = 0; i < datagrams.size(); ++i) {
+		datagrams[i].buf = &buffer[i * BUFSIZE];
+		datagrams[i].bufLen = BUFSIZE;
+	}
+}
+
 UDPServer::UDPServer() : stop(false), pp(true) { }
 UDPServer::~UDPServer() { }
 
@@ -72,26 +92,95 @@ void UDPServer::addTask(Callback&& aTask) noexcept {
 	pp.addTask(std::move(aTask));
 }
 
-constexpr auto BUFSIZE = 8192;
-int UDPServer::run() {
-	int len;
-	string remoteAddr;
+UDPServer::Stats UDPServer::getStats() const noexcept {
+	Stats ret;
+	ret.packetsReceived = packetsReceived;
+	ret.packetsPerSecond = packetsPerSecond;
+	ret.packetsDropped = packetsDropped;
+	ret.receiveQueueDrops = receiveQueueDrops;
+	return ret;
+}
+
+UDPServer::PacketBatch* UDPServer::getFreeBatch() noexcept {
+	Lock l(batchCS);
+	if (!freeBatches.empty()) {
+		auto batch = freeBatches.back();
+		freeBatches.pop_back();
+		return batch;
+	}
+
+	if (batches.size() < MAX_BATCHES) {
+		batches.push_back(make_unique<PacketBatch>());
+		return batches.back().get();
+	}
+
+	return nullptr;
+}
+
+void UDPServer::releaseBatch(PacketBatch* aBatch) noexcept {
+	Lock l(batchCS);
+	freeBatches.push_back(aBatch);
+}
+
+void UDPServer::updateStats(uint64_t aTick) noexcept {
+	receiveQueueDrops = closedSocketDrops + socket->getReceiveQueueDrops();
+
+	if (aTick < lastStatsTick + 1000) {
+		return;
+	}
+
+	uint64_t packets = packetsReceived;
+	if (lastStatsTick > 0) {
+		packetsPerSecond = (packets - lastStatsPackets) * 1000 / (aTick - lastStatsTick);
+	}
+
+	lastStatsTick = aTick;
+	lastStatsPackets = packets;
+}
 
+int UDPServer::run() {
 	while(!stop) {
 		try {
+			auto tick = GET_TICK();
+			updateStats(tick);
+
 			if(!socket->wait(400, true, false).first) {
 				continue;
 			}
 
-			auto buffer = vector<uint8_t>(BUFSIZE);
-			if((len = socket->read(buffer.data(), BUFSIZE, remoteAddr)) > 0) {
-				pp.addTask([buf = std::move(buffer), len, remoteAddr, this] { handlePacket(buf, len, remoteAddr); });
+			auto batch = getFreeBatch();
+			auto readBatch = batch ? batch : &discardBatch;
+
+			auto count = socket->readDatagrams(readBatch->datagrams.data(), readBatch->datagrams.size());
+			if (count > 0) {
+				packetsReceived += count;
+				if (!batch) {
+					packetsDropped += count;
+					continue;
+				}
+
+				batch->count = count;
+				pp.addTask([batch, this] {
+					handleBatch(*batch);
+					releaseBatch(batch);
+				});
+				continue;
+			}
+
+			if (batch) {
+				releaseBatch(batch);
+			}
+
+			if (count < 0) {
+				// Would block
 				continue;
 			}
 		} catch(const SocketException& e) {
 			dcdebug("SearchManager::run Error: %s\n", e.getError().c_str());
 		}
 
+		closedSocketDrops += socket->getReceiveQueueDrops();
+
 		bool failed = false;
 		while(!stop) {
 			try {
@@ -121,8 +210,20 @@ int UDPServer::run() {
 	return 0;
 }
 
-void UDPServer::handlePacket(const ByteVector& aBuf, size_t aLen, const string& aRemoteIp) {
-	string x(aBuf.begin(), aBuf.begin() + aLen);
+void UDPServer::handleBatch(const PacketBatch& aBatch) noexcept {
+	// Let the searches handle the results from the same batch at once
+	SearchManager::getInstance()->batchResults([&aBatch, this] {
+		for (size_t i = 0; i < aBatch.count; ++i) {
+			const auto& datagram = aBatch.datagrams[i];
+			if (datagram.len > 0) {
+				handlePacket(datagram.buf, datagram.len, datagram.ip);
+			}
+		}
+	});
+}
+
+void UDPServer::handlePacket(const uint8_t* aBuf, size_t aLen, const string& aRemoteIp) {
+	string x(reinterpret_cast<const char*>(aBuf), aLen);
 
 	//check if this packet has been encrypted
 	if (SETTING(ENABLE_SUDP) && aLen >= 32 && ((aLen & 15) == 0)) {
@@ -20,7 +20,9 @@
 #define DCPLUSPLUS_DCPP_UDP_SERVER_H
 
 #include <airdcpp/protocol/AdcCommand.h>
+#include <airdcpp/connection/socket/Socket.h>
 #include <airdcpp/core/queue/DispatcherQueue.h>
+#include <airdcpp/core/thread/CriticalSection.h>
 
 namespace dcpp {
 
@@ -35,6 +37,19 @@ public:
 
 
 	void addTask(Callback&& aTask) noexcept;
+
+	struct Stats {
+		uint64_t packetsReceived = 0;
+		uint64_t packetsPerSecond = 0;
+
+		// Packets discarded because the earlier ones haven't been processed yet
+		uint64_t packetsDropped = 0;
+
+		// Packets discarded by the system because the socket receive buffer was full
+		uint64_t receiveQueueDrops = 0;
+	};
+
+	Stats getStats() const noexcept;
 private:
 	friend class CommandHandler<UDPServer>;
 
@@ -44,8 +59,41 @@ private:
 	string port;
 	bool stop;
 
+	// Packets are read in batches into reusable buffers that are returned to the pool once the packets have been handled
+	struct PacketBatch {
+		PacketBatch();
+
+		ByteVector buffer;
+		vector<Socket::Datagram> datagrams;
+		size_t count = 0;
+	};
+
+	PacketBatch* getFreeBatch() noexcept;
+	void releaseBatch(PacketBatch* aBatch) noexcept;
+
+	vector<unique_ptr<PacketBatch>> batches;
+	vector<PacketBatch*> freeBatches;
+	CriticalSection batchCS;
+
+	// Used for reading packets that are dropped
+	PacketBatch discardBatch;
+
+	void updateStats(uint64_t aTick) noexcept;
+
+	atomic<uint64_t> packetsReceived { 0 };
+	atomic<uint64_t> packetsDropped { 0 };
+	atomic<uint64_t> receiveQueueDrops { 0 };
+	atomic<uint64_t> packetsPerSecond { 0 };
+
+	// Counters of the previous sockets (the system counter is reset when the socket is recreated)
+	uint64_t closedSocketDrops = 0;
+
+	uint64_t lastStatsTick = 0;
+	uint64_t lastStatsPackets = 0;
+
 	DispatcherQueue pp;
-	void handlePacket(const ByteVector& aBuf, size_t aLen, const string& aRemoteIp);
+	void handleBatch(const PacketBatch& aBatch) noexcept;
+	void handlePacket(const uint8_t* aBuf, size_t aLen, const string& aRemoteIp);
 
 	// Search results
 	void handle(AdcCommand::RES, AdcCommand& c, const string& aRemoteIp) noexcept;
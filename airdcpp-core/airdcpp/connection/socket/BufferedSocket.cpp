@@ -221,6 +221,10 @@ void BufferedSocket::threadRead() {
 		throw SocketException(STRING(CONNECTION_CLOSED));
 	}
 
+	parseData(left);
+}
+
+void BufferedSocket::parseData(int left) {
 	string::size_type pos = 0;
 	// always uncompressed data
 	string l;
@@ -324,6 +328,13 @@ void BufferedSocket::threadSendFile(InputStream* file) {
 	auto sockSize = (size_t)sock->getSocketOptInt(SO_SNDBUF);
 	size_t bufSize = max(sockSize, (size_t)64*1024);
 
+#ifdef __linux__
+	if (canSendFileDirect(file)) {
+		threadSendFileDirect(file, bufSize);
+		return;
+	}
+#endif
+
 	ByteVector readBuf(bufSize);
 	ByteVector writeBufTmp(bufSize);
 
@@ -376,7 +387,7 @@ void BufferedSocket::threadSendFile(InputStream* file) {
 				writeSize = min(sockSize / 2, writeBufTmp.size() - writePos);
 				written = useLimiter ? 
 					ThrottleManager::getInstance()->write(sock.get(), &writeBufTmp[writePos], writeSize) : 
-					sock->read(&inbuf[0], inbuf.size());
+					sock->write(&writeBufTmp[writePos], writeSize);
 			}
 			
 			if(written > 0) {
@@ -415,6 +426,68 @@ void BufferedSocket::threadSendFile(InputStream* file) {
 	}
 }
 
+#ifdef __linux__
+bool BufferedSocket::canSendFileDirect(InputStream* aStream) const noexcept {
+	if (!SETTING(ZERO_COPY_UPLOADS) || !sock->supportsSendFile()) {
+		return false;
+	}
+
+	int fd;
+	int64_t pos, maxBytes;
+	return aStream->getDirectSource(fd, pos, maxBytes);
+}
+
+int BufferedSocket::sendFileDirect(InputStream* aStream, size_t aChunkSize, bool aWait) {
+	int fd;
+	int64_t pos, maxBytes;
+	if (!aStream->getDirectSource(fd, pos, maxBytes)) {
+		dcassert(0);
+		return 0;
+	}
+
+	auto len = maxBytes == -1 ? aChunkSize : static_cast<size_t>(min(maxBytes, static_cast<int64_t>(aChunkSize)));
+	if (len == 0) {
+		return 0;
+	}
+
+	auto sent = useLimiter ?
+		ThrottleManager::getInstance()->sendFile(sock.get(), fd, pos, len, aWait) :
+		sock->sendFile(fd, pos, len);
+
+	if (sent > 0) {
+		aStream->onDirectRead(sent);
+		fire(BufferedSocketListener::BytesSent(), sent, sent);
+	}
+
+	return sent;
+}
+
+void BufferedSocket::threadSendFileDirect(InputStream* aStream, size_t aChunkSize) {
+	while (!disconnecting) {
+		// Process possible async calls 
+		checkEvents();
+
+		auto sent = sendFileDirect(aStream, aChunkSize, true);
+		if (sent == 0) {
+			fire(BufferedSocketListener::TransmitDone());
+			return;
+		}
+
+		if (sent == -1) {
+			while (!disconnecting) {
+				auto [read, write] = sock->wait(POLL_TIMEOUT, true, true);
+				if (read) {
+					threadRead();
+				}
+				if (write) {
+					break;
+				}
+			}
+		}
+	}
+}
+#endif
+
 void BufferedSocket::write(const char* aBuf, size_t aLen) noexcept {
 	if(!sock.get())
 		return;
@@ -522,6 +595,12 @@ int BufferedSocket::run() {
 				break;
 			}
 			if(state == RUNNING) {
+#ifdef __linux__
+				if(attachReactor()) {
+					// The reactor thread will take care of the socket from now on
+					return 0;
+				}
+#endif
 				checkSocket();
 			}
 		} catch(const Exception& e) {
@@ -540,6 +619,11 @@ void BufferedSocket::fail(const string& aError) {
 	}
 	//fire listener before deleting socket to be able to retrieve information from it.. does it cause any problems?? 
 	if (sock.get()) {
+#ifdef __linux__
+		if (reactor) {
+			reactor->removeSocket(this);
+		}
+#endif
 		sock->disconnect();
 	}
 }
@@ -552,7 +636,285 @@ void BufferedSocket::shutdown(const Callback& f) {
 
 void BufferedSocket::addTask(Tasks task, unique_ptr<TaskData>&& data) {
 	dcassert(task == DISCONNECT || task == SHUTDOWN || task == ASYNC_CALL || sock.get());
-	tasks.emplace_back(task, std::move(data)); taskSem.signal();
+	tasks.emplace_back(task, std::move(data));
+
+#ifdef __linux__
+	if (reactor) {
+		reactor->scheduleTasks(this);
+		return;
+	}
+#endif
+
+	taskSem.signal();
+}
+
+#ifdef __linux__
+
+// Limit the amount of data written per event so that other sockets of the reactor won't get starved
+constexpr size_t MAX_REACTOR_WRITE = 1024 * 1024;
+
+bool BufferedSocket::attachReactor() noexcept {
+	auto threads = SETTING(SOCKET_REACTOR_THREADS);
+	if (threads <= 0 || disconnecting) {
+		return false;
+	}
+
+	auto r = SocketReactor::getReactor(threads);
+	if (!r) {
+		return false;
+	}
+
+	// Tasks added after this will be scheduled for the reactor
+	Lock l(cs);
+	reactor = r;
+	reactor->addSocket(this);
+	return true;
+}
+
+SocketReactor::Status BufferedSocket::onReactorTasks() noexcept {
+	for (;;) {
+		TaskPair p;
+		{
+			Lock l(cs);
+			if (tasks.empty()) {
+				break;
+			}
+
+			p = std::move(tasks.front());
+			tasks.pop_front();
+		}
+
+		if (p.first == SHUTDOWN) {
+			if (p.second)
+				static_cast<CallData*>(p.second.get())->f();
+			return SocketReactor::Status::SHUTDOWN;
+		}
+
+		if (state != RUNNING) {
+			continue;
+		}
+
+		try {
+			if (p.first == SEND_DATA) {
+				// Picked up by reactorWrite
+			} else if (p.first == SEND_FILE) {
+				reactorStartSendFile(static_cast<SendFileInfo*>(p.second.get())->stream);
+			} else if (p.first == DISCONNECT) {
+				if (disconnecting) {
+					// Graceless, drop the pending output
+					fail(STRING(DISCONNECTED));
+				} else {
+					// Queued data must reach the wire first (failed in reactorCheckDisconnect)
+					reactorDisconnecting = true;
+				}
+			} else if (p.first == ASYNC_CALL) {
+				static_cast<CallData*>(p.second.get())->f();
+			} else {
+				dcdebug("%d unexpected in RUNNING state\n", p.first);
+			}
+		} catch (const Exception& e) {
+			fail(e.getError());
+		}
+	}
+
+	// Send new data right away
+	return onReactorEvents(false, true);
+}
+
+SocketReactor::Status BufferedSocket::onReactorEvents(bool aReadable, bool aWritable) noexcept {
+	auto status = SocketReactor::Status::WAIT;
+
+	try {
+		if (aReadable && state == RUNNING) {
+			status = reactorRead();
+		}
+
+		if (aWritable && state == RUNNING) {
+			auto writeStatus = reactorWrite();
+			if (writeStatus == SocketReactor::Status::THROTTLED || status == SocketReactor::Status::WAIT) {
+				status = writeStatus;
+			}
+		}
+	} catch (const Exception& e) {
+		fail(e.getError());
+	}
+
+	reactorCheckDisconnect();
+	return status;
+}
+
+void BufferedSocket::reactorCheckDisconnect() noexcept {
+	if (!reactorDisconnecting || state != RUNNING || hasPendingOutput()) {
+		return;
+	}
+
+	{
+		Lock l(cs);
+		if (!writeBuf.empty()) {
+			return;
+		}
+	}
+
+	fail(STRING(DISCONNECTED));
 }
 
+SocketReactor::Status BufferedSocket::reactorRead() {
+	int left = (mode == MODE_DATA && useLimiter) ? ThrottleManager::getInstance()->read(sock.get(), &inbuf[0], inbuf.size(), false) : sock->read(&inbuf[0], inbuf.size());
+	if (left == ThrottleManager::THROTTLED) {
+		return SocketReactor::Status::THROTTLED;
+	} else if (left == -1) {
+		// EWOULDBLOCK, no data received...
+		return SocketReactor::Status::WAIT;
+	} else if (left == 0) {
+		// This socket has been closed...
+		throw SocketException(STRING(CONNECTION_CLOSED));
+	}
+
+	parseData(left);
+
+	if (state == RUNNING && sock->hasBufferedData()) {
+		// The socket won't be reported as readable for this data
+		return SocketReactor::Status::PENDING;
+	}
+
+	return SocketReactor::Status::WAIT;
+}
+
+void BufferedSocket::reactorStartSendFile(InputStream* aStream) {
+	dcassert(aStream && !sendStream);
+	if (disconnecting) {
+		return;
+	}
+
+	auto sockSize = (size_t)sock->getSocketOptInt(SO_SNDBUF);
+	fileBufSize = max(sockSize, (size_t)64*1024);
+	fileWriteSize = max(sockSize / 2, (size_t)1);
+
+	sendStream = aStream;
+	sendDirect = canSendFileDirect(aStream);
+	fileBuf.clear();
+	fileBufPos = 0;
+	fileReadDone = false;
+}
+
+bool BufferedSocket::reactorReadFile() {
+	if (fileBufPos < fileBuf.size()) {
+		return true;
+	}
+
+	if (!fileReadDone) {
+		fileBuf.resize(fileBufSize);
+		size_t bytesRead = fileBuf.size();
+		size_t actual = sendStream->read(&fileBuf[0], bytesRead);
+
+		if (bytesRead > 0) {
+			fire(BufferedSocketListener::BytesSent(), bytesRead, 0);
+		}
+
+		fileBufPos = 0;
+		if (actual > 0) {
+			fileBuf.resize(actual);
+			return true;
+		}
+
+		fileReadDone = true;
+	}
+
+	reactorEndSendFile();
+	return false;
+}
+
+void BufferedSocket::reactorEndSendFile() noexcept {
+	sendStream = nullptr;
+	sendDirect = false;
+	fileBuf.clear();
+	fileBufPos = 0;
+
+	fire(BufferedSocketListener::TransmitDone());
+}
+
+bool BufferedSocket::hasPendingOutput() const noexcept {
+	return retryWriteSize > 0 || sendPos < sendBuf.size() || sendStream;
+}
+
+SocketReactor::Status BufferedSocket::reactorWrite() {
+	size_t total = 0;
+	while (total < MAX_REACTOR_WRITE && state == RUNNING && !disconnecting) {
+		bool isFile;
+		if (retryWriteSize > 0) {
+			isFile = retryFileWrite;
+		} else {
+			if (sendPos == sendBuf.size()) {
+				// Protocol data from other threads
+				sendBuf.clear();
+				sendPos = 0;
+
+				Lock l(cs);
+				writeBuf.swap(sendBuf);
+			}
+
+			if (sendPos < sendBuf.size()) {
+				isFile = false;
+			} else if (sendDirect) {
+				auto sent = sendFileDirect(sendStream, fileBufSize, false);
+				if (sent == ThrottleManager::THROTTLED) {
+					return SocketReactor::Status::THROTTLED;
+				} else if (sent == -1) {
+					// Wait until the socket is writable
+					break;
+				} else if (sent == 0) {
+					reactorEndSendFile();
+					break;
+				}
+
+				total += sent;
+				continue;
+			} else if (sendStream && reactorReadFile()) {
+				isFile = true;
+			} else {
+				// Nothing to send
+				break;
+			}
+		}
+
+		int written;
+		size_t writeSize;
+		if (isFile) {
+			writeSize = retryWriteSize > 0 ? retryWriteSize : min(fileWriteSize, fileBuf.size() - fileBufPos);
+			if (useLimiter) {
+				written = ThrottleManager::getInstance()->write(sock.get(), &fileBuf[fileBufPos], writeSize, false);
+				if (written == ThrottleManager::THROTTLED) {
+					return SocketReactor::Status::THROTTLED;
+				}
+			} else {
+				written = sock->write(&fileBuf[fileBufPos], writeSize);
+			}
+		} else {
+			writeSize = retryWriteSize > 0 ? retryWriteSize : sendBuf.size() - sendPos;
+			written = sock->write(&sendBuf[sendPos], writeSize);
+		}
+
+		if (written <= 0) {
+			// Wait until the socket is writable
+			retryWriteSize = writeSize;
+			retryFileWrite = isFile;
+			break;
+		}
+
+		retryWriteSize = 0;
+		total += written;
+
+		if (isFile) {
+			fileBufPos += written;
+			fire(BufferedSocketListener::BytesSent(), 0, written);
+		} else {
+			sendPos += written;
+		}
+	}
+
+	return SocketReactor::Status::WAIT;
+}
+
+#endif
+
 } // namespace dcpp
@@ -30,6 +30,7 @@
 #include <airdcpp/core/thread/Semaphore.h>
 #include <airdcpp/core/thread/Thread.h>
 #include <airdcpp/connection/socket/Socket.h>
+#include <airdcpp/connection/socket/SocketReactor.h>
 #include <airdcpp/core/Speaker.h>
 
 namespace dcpp {
@@ -66,6 +67,10 @@ public:
 	static void waitShutdown() noexcept {
 		while(sockets > 0)
 			Thread::sleep(100);
+
+#ifdef __linux__
+		SocketReactor::shutdownAll();
+#endif
 	}
 
 	using SocketAcceptFloodF = std::function<bool (const string &)>;
@@ -180,6 +185,8 @@ private:
 	void threadSendFile(InputStream* is);
 	void threadSendData();
 
+	void parseData(int left);
+
 	void fail(const string& aError);
 	static atomic<long> sockets;
 
@@ -190,6 +197,66 @@ private:
 	void setOptions();
 	void shutdown(const Callback& f);
 	void addTask(Tasks task, unique_ptr<TaskData>&& data);
+
+#ifdef __linux__
+	// Zero-copy uploads (the file data is sent by the kernel without passing it via our buffers)
+	bool canSendFileDirect(InputStream* aStream) const noexcept;
+	void threadSendFileDirect(InputStream* aStream, size_t aChunkSize);
+
+	// Returns the number of bytes sent, 0 if the whole file has been sent, -1 if the call would block
+	// or ThrottleManager::THROTTLED if there are no bandwidth tokens available
+	int sendFileDirect(InputStream* aStream, size_t aChunkSize, bool aWait);
+
+	// Event loop mode (see SocketReactor)
+	friend class SocketReactor;
+
+	// Hand the connected socket over to a reactor thread if enabled
+	bool attachReactor() noexcept;
+
+	// Reactor thread handlers
+	SocketReactor::Status onReactorEvents(bool aReadable, bool aWritable) noexcept;
+	SocketReactor::Status onReactorTasks() noexcept;
+	SocketReactor::Status reactorRead();
+	SocketReactor::Status reactorWrite();
+
+	void reactorStartSendFile(InputStream* aStream);
+
+	// Returns false if the whole file has been sent
+	bool reactorReadFile();
+	void reactorEndSendFile() noexcept;
+	bool hasPendingOutput() const noexcept;
+
+	// Fails the socket after a graceful disconnect once all pending output has been written
+	void reactorCheckDisconnect() noexcept;
+
+	// Graceful disconnect was requested while there was still data to send
+	bool reactorDisconnecting = false;
+
+	SocketReactor* reactor = nullptr;
+
+	// Owned by the reactor
+	uint32_t reactorEvents = 0;
+	bool reactorRegistered = false;
+	bool reactorScheduled = false;
+	bool reactorThrottled = false;
+	bool reactorPending = false;
+	bool reactorClosed = false;
+
+	size_t sendPos = 0;
+
+	// File upload in progress
+	InputStream* sendStream = nullptr;
+	ByteVector fileBuf;
+	size_t fileBufPos = 0;
+	size_t fileBufSize = 0;
+	size_t fileWriteSize = 0;
+	bool fileReadDone = false;
+	bool sendDirect = false;
+
+	// OpenSSL requires failed writes to be retried with the same arguments
+	size_t retryWriteSize = 0;
+	bool retryFileWrite = false;
+#endif
 };
 
 } // namespace dcpp
@@ -158,6 +158,35 @@ int SSLSocket::write(const void* aBuffer, size_t aLen) {
 	return ret;
 }
 
+#ifdef __linux__
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L && !defined(OPENSSL_NO_KTLS)
+bool SSLSocket::supportsSendFile() const noexcept {
+	return ssl && BIO_get_ktls_send(SSL_get_wbio(ssl));
+}
+
+int SSLSocket::sendFile(int aFd, int64_t aPos, size_t aLen) {
+	if (!ssl) {
+		return -1;
+	}
+
+	auto ret = checkSSL(static_cast<int>(SSL_sendfile(ssl, aFd, static_cast<off_t>(aPos), aLen, 0)));
+	if (ret > 0) {
+		stats.totalUp += ret;
+	}
+	return ret;
+}
+#else
+bool SSLSocket::supportsSendFile() const noexcept {
+	return false;
+}
+
+int SSLSocket::sendFile(int, int64_t, size_t) {
+	dcassert(0);
+	return -1;
+}
+#endif
+#endif
+
 int SSLSocket::checkSSL(int ret) {
 	if(!ssl) {
 		return -1;
@@ -228,6 +257,10 @@ std::pair<bool, bool> SSLSocket::wait(uint64_t millis, bool checkRead, bool chec
 	return Socket::wait(millis, checkRead, checkWrite);
 }
 
+bool SSLSocket::hasBufferedData() const noexcept {
+	return ssl && SSL_pending(ssl) > 0;
+}
+
 bool SSLSocket::isTrusted() const noexcept {
 	if(!ssl) {
 		return false;
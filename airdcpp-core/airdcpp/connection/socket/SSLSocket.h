@@ -52,6 +52,13 @@ public:
 	int read(void* aBuffer, size_t aBufLen) override;
 	int write(const void* aBuffer, size_t aLen) override;
 	std::pair<bool, bool> wait(uint64_t millis, bool checkRead, bool checkWrite) override;
+	bool hasBufferedData() const noexcept override;
+
+#ifdef __linux__
+	// Files can be sent directly only when the record layer has been offloaded to the kernel (kTLS)
+	bool supportsSendFile() const noexcept override;
+	int sendFile(int aFd, int64_t aPos, size_t aLen) override;
+#endif
 	void shutdown() noexcept override;
 	void close() noexcept override;
 
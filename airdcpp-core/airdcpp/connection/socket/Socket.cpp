@@ -26,6 +26,10 @@
 #include <airdcpp/core/localization/ResourceManager.h>
 #include <airdcpp/util/SystemUtil.h>
 
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
 /// @todo remove when MinGW has this
 #ifdef __MINGW32__
 #ifndef EADDRNOTAVAIL
@@ -221,6 +225,13 @@ socket_t Socket::setSock(socket_t s, int af) {
 	setSocketOpt2(s, SOL_SOCKET, SO_REUSEPORT, 1);
 #endif
 
+#ifdef SO_RXQ_OVFL
+	if (type == TYPE_UDP) {
+		// Report the number of datagrams dropped due to a full receive buffer
+		setSocketOpt2(s, SOL_SOCKET, SO_RXQ_OVFL, 1);
+	}
+#endif
+
 	if(af == AF_INET) {
 		dcassert(sock4 == INVALID_SOCKET);
 		sock4 = s;
@@ -635,6 +646,70 @@ int Socket::read(void* aBuffer, size_t aBufLen, string &aIP) {
 	return len;
 }
 
+#ifdef __linux__
+#define MAX_DATAGRAM_BATCH 64
+
+int Socket::readDatagrams(Datagram* datagrams_, size_t aCount) {
+	dcassert(type == TYPE_UDP);
+
+	auto count = min(aCount, static_cast<size_t>(MAX_DATAGRAM_BATCH));
+
+	mmsghdr msgs[MAX_DATAGRAM_BATCH];
+	iovec iovs[MAX_DATAGRAM_BATCH];
+	addr remoteAddrs[MAX_DATAGRAM_BATCH];
+	char controls[MAX_DATAGRAM_BATCH][CMSG_SPACE(sizeof(uint32_t))];
+
+	memset(msgs, 0, sizeof(mmsghdr) * count);
+	for (size_t i = 0; i < count; ++i) {
+		iovs[i].iov_base = datagrams_[i].buf;
+		iovs[i].iov_len = datagrams_[i].bufLen;
+
+		auto& hdr = msgs[i].msg_hdr;
+		hdr.msg_iov = &iovs[i];
+		hdr.msg_iovlen = 1;
+		hdr.msg_name = &remoteAddrs[i].sa;
+		hdr.msg_namelen = sizeof(addr);
+		hdr.msg_control = controls[i];
+		hdr.msg_controllen = sizeof(controls[i]);
+	}
+
+	auto sock = readable(sock4, sock6);
+	auto n = check([&] {
+		return ::recvmmsg(sock, msgs, static_cast<unsigned int>(count), 0, nullptr);
+	}, true);
+
+	for (int i = 0; i < n; ++i) {
+		auto& hdr = msgs[i].msg_hdr;
+		datagrams_[i].len = msgs[i].msg_len;
+		datagrams_[i].ip = resolveName(&remoteAddrs[i].sa, hdr.msg_namelen);
+		stats.totalDown += msgs[i].msg_len;
+
+#ifdef SO_RXQ_OVFL
+		for (auto cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+			if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+				memcpy(sock == sock4 ? &receiveQueueDrops4 : &receiveQueueDrops6, CMSG_DATA(cmsg), sizeof(uint32_t));
+			}
+		}
+#endif
+	}
+
+	return n;
+}
+#else
+int Socket::readDatagrams(Datagram* datagrams_, size_t aCount) {
+	dcassert(aCount > 0);
+
+	auto& d = datagrams_[0];
+	auto len = read(d.buf, d.bufLen, d.ip);
+	if (len < 0) {
+		return -1;
+	}
+
+	d.len = len;
+	return 1;
+}
+#endif
+
 int Socket::socksRead(ByteVector& aBuffer, size_t aBufLen, const SocksCompleteF& aIsComplete, uint64_t aTimeout) {
 	int i = 0;
 	while (i <= 0 || !aIsComplete(aBuffer, i)) {
@@ -687,6 +762,17 @@ int Socket::write(const void* aBuffer, size_t aLen) {
 	return sent;
 }
 
+#ifdef __linux__
+int Socket::sendFile(int aFd, int64_t aPos, size_t aLen) {
+	auto offset = static_cast<off_t>(aPos);
+	auto sent = check([&] { return ::sendfile(getSock(), aFd, &offset, aLen); }, true);
+	if (sent > 0) {
+		stats.totalUp += sent;
+	}
+	return static_cast<int>(sent);
+}
+#endif
+
 /**
  * Sends data, will block until all data has been sent or an exception occurs
  * @param aBuffer Buffer with data
@@ -1067,6 +1153,9 @@ void Socket::shutdown() noexcept {
 void Socket::close() noexcept {
 	sock4.reset();
 	sock6.reset();
+
+	receiveQueueDrops4 = 0;
+	receiveQueueDrops6 = 0;
 }
 
 void Socket::disconnect() noexcept {
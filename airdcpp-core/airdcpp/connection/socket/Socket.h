@@ -140,8 +140,41 @@ public:
 	 */
 	virtual int read(void* aBuffer, size_t aBufLen, string &aIP);
 
+	struct Datagram {
+		uint8_t* buf = nullptr;
+		size_t bufLen = 0;
+
+		// Set when the datagram has been read
+		size_t len = 0;
+		string ip;
+	};
+
+	/**
+	 * Reads multiple datagrams with a single call when supported by the system (UDP only)
+	 * @param datagrams_ Receive buffers, the length and remote IP are set for each datagram that was read
+	 * @return Number of datagrams read and -1 if the call would block.
+	 */
+	int readDatagrams(Datagram* datagrams_, size_t aCount);
+
+	/** Number of datagrams discarded by the system because the receive buffer was full (if reported by the system) */
+	uint64_t getReceiveQueueDrops() const noexcept { return receiveQueueDrops4 + receiveQueueDrops6; }
+
 	virtual std::pair<bool, bool> wait(uint64_t millis, bool checkRead, bool checkWrite);
 
+	/** Whether there is received data that can be read without the socket becoming readable again (e.g. decrypted TLS records) */
+	virtual bool hasBufferedData() const noexcept { return false; }
+
+#ifdef __linux__
+	/** Whether file content can be sent with sendFile (without copying it via user space) */
+	virtual bool supportsSendFile() const noexcept { return true; }
+
+	/**
+	 * Sends data directly from a file descriptor, the file position of the descriptor isn't modified
+	 * @return Number of bytes sent, 0 at the end of the file and -1 if the call would block.
+	 */
+	virtual int sendFile(int aFd, int64_t aPos, size_t aLen);
+#endif
+
 	static string resolve(const string& aDns, int af = AF_UNSPEC) noexcept;
 	addrinfo_p resolveAddr(const string& name, const string& port, int family = AF_UNSPEC, int flags = 0) const;
 
@@ -183,6 +216,9 @@ public:
 
 	const string& getIp() const noexcept;
 	bool isV6Valid() const noexcept;
+
+	/** Descriptor of the connected socket (for event loops) */
+	socket_t getNativeSock() const { return getSock(); }
 	static string resolveName(const sockaddr* sa, socklen_t sa_len, int flags = NI_NUMERICHOST);
 protected:
 	using addr = union {
@@ -198,6 +234,10 @@ protected:
 	mutable SocketHandle sock4;
 	mutable SocketHandle sock6;
 
+	// Counters reported separately for each socket
+	uint32_t receiveQueueDrops4 = 0;
+	uint32_t receiveQueueDrops6 = 0;
+
 	SocketType type;
 
 	class Stats {
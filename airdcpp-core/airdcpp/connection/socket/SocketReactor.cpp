@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+
+#ifdef __linux__
+
+#include <airdcpp/connection/socket/SocketReactor.h>
+
+#include <airdcpp/connection/socket/BufferedSocket.h>
+#include <airdcpp/core/timer/TimerManager.h>
+#include <airdcpp/util/SystemUtil.h>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+namespace dcpp {
+
+// Maximum number of events to handle per iteration
+constexpr auto MAX_EVENTS = 256;
+
+// How long to wait before retrying throttled sockets (bandwidth tokens are added every second)
+constexpr auto THROTTLE_RETRY_DELAY = 100;
+
+CriticalSection SocketReactor::poolCS;
+vector<unique_ptr<SocketReactor>> SocketReactor::pool;
+
+SocketReactor* SocketReactor::getReactor(int aMaxThreads) noexcept {
+	Lock l(poolCS);
+
+	SocketReactor* ret = nullptr;
+	for (const auto& r : pool) {
+		if (!ret || r->getSocketCount() < ret->getSocketCount()) {
+			ret = r.get();
+		}
+	}
+
+	if ((!ret || ret->getSocketCount() > 0) && static_cast<int>(pool.size()) < aMaxThreads) {
+		unique_ptr<SocketReactor> reactor(new SocketReactor());
+		if (reactor->epollFd == -1 || reactor->eventFd == -1) {
+			dcdebug("SocketReactor: failed to create the event descriptors (%s)\n", strerror(errno));
+			return ret;
+		}
+
+		try {
+			reactor->start();
+		} catch (const ThreadException& e) {
+			dcdebug("SocketReactor: %s\n", e.what());
+			return ret;
+		}
+
+		ret = reactor.get();
+		pool.push_back(std::move(reactor));
+	}
+
+	return ret;
+}
+
+void SocketReactor::shutdownAll() noexcept {
+	Lock l(poolCS);
+	for (auto& r : pool) {
+		{
+			Lock rl(r->cs);
+			r->stopping = true;
+		}
+
+		r->wakeUp();
+		r->join();
+	}
+
+	pool.clear();
+}
+
+SocketReactor::SocketReactor() {
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (epollFd != -1 && eventFd != -1) {
+		epoll_event ev = { };
+		ev.events = EPOLLIN;
+		ev.data.ptr = nullptr;
+		if (epoll_ctl(epollFd, EPOLL_CTL_ADD, eventFd, &ev) != 0) {
+			::close(eventFd);
+			eventFd = -1;
+		}
+	}
+}
+
+SocketReactor::~SocketReactor() {
+	dcassert(socketCount == 0);
+	if (eventFd != -1) {
+		::close(eventFd);
+	}
+
+	if (epollFd != -1) {
+		::close(epollFd);
+	}
+}
+
+void SocketReactor::wakeUp() noexcept {
+	uint64_t value = 1;
+	[[maybe_unused]] auto written = ::write(eventFd, &value, sizeof(value));
+}
+
+void SocketReactor::addSocket(BufferedSocket* aSocket) noexcept {
+	socketCount++;
+
+	{
+		Lock l(cs);
+		addedSockets.push_back(aSocket);
+	}
+
+	wakeUp();
+}
+
+void SocketReactor::scheduleTasks(BufferedSocket* aSocket) noexcept {
+	{
+		Lock l(cs);
+		if (aSocket->reactorScheduled) {
+			return;
+		}
+
+		aSocket->reactorScheduled = true;
+		scheduledSockets.push_back(aSocket);
+	}
+
+	wakeUp();
+}
+
+void SocketReactor::removeSocket(BufferedSocket* aSocket) noexcept {
+	if (!aSocket->reactorRegistered) {
+		return;
+	}
+
+	if (aSocket->reactorEvents != 0) {
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, aSocket->sock->getNativeSock(), nullptr);
+	}
+
+	aSocket->reactorRegistered = false;
+	aSocket->reactorEvents = 0;
+}
+
+void SocketReactor::updateInterest(BufferedSocket* aSocket, uint32_t aEvents) noexcept {
+	if (!aSocket->reactorRegistered || aSocket->reactorEvents == aEvents) {
+		return;
+	}
+
+	// Hangups and errors are reported even with an empty event mask, sockets without any interest
+	// (throttled ones) are removed from the set so that they won't wake up the thread repeatedly
+	int op = aEvents == 0 ? EPOLL_CTL_DEL : aSocket->reactorEvents == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+
+	epoll_event ev = { };
+	ev.events = aEvents;
+	ev.data.ptr = aSocket;
+	if (epoll_ctl(epollFd, op, aSocket->sock->getNativeSock(), &ev) == 0) {
+		aSocket->reactorEvents = aEvents;
+	} else {
+		dcdebug("SocketReactor: failed to modify the socket events (%s)\n", strerror(errno));
+	}
+}
+
+void SocketReactor::closeSocket(BufferedSocket* aSocket) noexcept {
+	if (aSocket->reactorClosed) {
+		return;
+	}
+
+	removeSocket(aSocket);
+	aSocket->reactorClosed = true;
+
+	// There may still be events for the socket in the current batch
+	closedSockets.push_back(aSocket);
+}
+
+void SocketReactor::handleStatus(BufferedSocket* aSocket, Status aStatus) noexcept {
+	if (aStatus == Status::SHUTDOWN) {
+		closeSocket(aSocket);
+		return;
+	}
+
+	if (aStatus == Status::THROTTLED) {
+		// Ignore the socket until there are new tokens available
+		updateInterest(aSocket, 0);
+		if (!aSocket->reactorThrottled) {
+			aSocket->reactorThrottled = true;
+			throttledSockets.emplace_back(aSocket, GET_TICK() + THROTTLE_RETRY_DELAY);
+		}
+
+		return;
+	}
+
+	if (aSocket->reactorThrottled) {
+		// Wait for the retry
+		return;
+	}
+
+	if (aStatus == Status::PENDING && !aSocket->reactorPending) {
+		aSocket->reactorPending = true;
+		pendingSockets.push_back(aSocket);
+	}
+
+	updateInterest(aSocket, static_cast<uint32_t>(EPOLLIN) | (aSocket->hasPendingOutput() ? static_cast<uint32_t>(EPOLLOUT) : static_cast<uint32_t>(0)));
+}
+
+void SocketReactor::handleEvents(BufferedSocket* aSocket, bool aReadable, bool aWritable) noexcept {
+	if (aSocket->reactorClosed) {
+		return;
+	}
+
+	handleStatus(aSocket, aSocket->onReactorEvents(aReadable, aWritable));
+}
+
+void SocketReactor::handleTasks(BufferedSocket* aSocket) noexcept {
+	if (aSocket->reactorClosed) {
+		return;
+	}
+
+	handleStatus(aSocket, aSocket->onReactorTasks());
+}
+
+int SocketReactor::run() {
+	epoll_event events[MAX_EVENTS];
+	vector<BufferedSocket*> added, scheduled, pending;
+	for (;;) {
+		auto timeout = !pendingSockets.empty() ? 0 : !throttledSockets.empty() ? THROTTLE_RETRY_DELAY : -1;
+		auto n = epoll_wait(epollFd, events, MAX_EVENTS, timeout);
+		if (n < 0) {
+			if (errno != EINTR) {
+				dcdebug("SocketReactor: epoll_wait failed (%s)\n", strerror(errno));
+				Thread::sleep(timeout > 0 ? timeout : 10);
+			}
+
+			n = 0;
+		}
+
+		// Socket events
+		for (int i = 0; i < n; ++i) {
+			auto socket = static_cast<BufferedSocket*>(events[i].data.ptr);
+			if (!socket) {
+				uint64_t value;
+				[[maybe_unused]] auto ret = ::read(eventFd, &value, sizeof(value));
+				continue;
+			}
+
+			// Errors and hangups are reported by read
+			auto readable = (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0;
+			auto writable = (events[i].events & EPOLLOUT) != 0;
+			handleEvents(socket, readable, writable);
+		}
+
+		// Incoming data that was left in the socket's buffers
+		pending.swap(pendingSockets);
+		for (auto socket : pending) {
+			socket->reactorPending = false;
+			if (!socket->reactorThrottled) {
+				handleEvents(socket, true, false);
+			}
+		}
+
+		pending.clear();
+
+		// Throttled sockets
+		if (!throttledSockets.empty()) {
+			auto tick = GET_TICK();
+			std::erase_if(throttledSockets, [&](const auto& p) {
+				if (p.second > tick) {
+					return false;
+				}
+
+				p.first->reactorThrottled = false;
+				pending.push_back(p.first);
+				return true;
+			});
+
+			for (auto socket : pending) {
+				handleEvents(socket, true, socket->hasPendingOutput());
+			}
+
+			pending.clear();
+		}
+
+		// Tasks from other threads
+		{
+			Lock l(cs);
+			added.swap(addedSockets);
+			scheduled.swap(scheduledSockets);
+			for (auto socket : scheduled) {
+				socket->reactorScheduled = false;
+			}
+
+			if (stopping && socketCount == 0 && added.empty()) {
+				break;
+			}
+		}
+
+		for (auto socket : added) {
+			epoll_event ev = { };
+			ev.events = EPOLLIN;
+			ev.data.ptr = socket;
+			if (epoll_ctl(epollFd, EPOLL_CTL_ADD, socket->sock->getNativeSock(), &ev) == 0) {
+				socket->reactorRegistered = true;
+				socket->reactorEvents = EPOLLIN;
+			} else {
+				socket->fail(SystemUtil::translateError(errno));
+			}
+
+			// Listeners may have added tasks before the socket was handed over
+			handleTasks(socket);
+		}
+
+		for (auto socket : scheduled) {
+			handleTasks(socket);
+		}
+
+		added.clear();
+		scheduled.clear();
+
+		// Delete sockets that have been shut down
+		for (auto socket : closedSockets) {
+			dcassert(!socket->reactorScheduled);
+			if (socket->reactorThrottled) {
+				std::erase_if(throttledSockets, [socket](const auto& p) { return p.first == socket; });
+			}
+
+			if (socket->reactorPending) {
+				std::erase(pendingSockets, socket);
+			}
+
+			delete socket;
+			socketCount--;
+		}
+
+		closedSockets.clear();
+	}
+
+	return 0;
+}
+
+} // namespace dcpp
+
+#endif // __linux__
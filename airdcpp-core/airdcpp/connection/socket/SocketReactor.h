@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_SOCKET_REACTOR_H
+#define DCPLUSPLUS_DCPP_SOCKET_REACTOR_H
+
+#ifdef __linux__
+
+#include <airdcpp/core/header/typedefs.h>
+
+#include <airdcpp/core/thread/CriticalSection.h>
+#include <airdcpp/core/thread/Thread.h>
+
+namespace dcpp {
+
+class BufferedSocket;
+
+// epoll event loop that serves connected buffered sockets
+//
+// Each socket is owned by a single reactor thread once the connection has been established so that
+// the listener events of a socket are still fired from one thread at a time
+class SocketReactor : public Thread {
+public:
+	// Socket state after an event has been handled
+	enum class Status : uint8_t {
+		WAIT, // Wait for new events
+		PENDING, // There is buffered data to be processed
+		THROTTLED, // Out of bandwidth tokens, retry later
+		SHUTDOWN // The socket should be deleted
+	};
+
+	// Returns the least loaded reactor (new threads are started until the thread limit has been reached)
+	static SocketReactor* getReactor(int aMaxThreads) noexcept;
+
+	// Stops all reactor threads (all sockets must have been shut down before calling this)
+	static void shutdownAll() noexcept;
+
+	// Start serving a connected socket
+	// The socket is registered from the reactor thread, pending tasks will be processed after that
+	void addSocket(BufferedSocket* aSocket) noexcept;
+
+	// Process the pending tasks of a socket in the reactor thread
+	void scheduleTasks(BufferedSocket* aSocket) noexcept;
+
+	// Stop receiving events for a socket (must be called from the reactor thread before the socket is closed)
+	void removeSocket(BufferedSocket* aSocket) noexcept;
+
+	size_t getSocketCount() const noexcept {
+		return socketCount;
+	}
+
+	~SocketReactor() override;
+
+	SocketReactor(SocketReactor&) = delete;
+	SocketReactor& operator=(SocketReactor&) = delete;
+private:
+	SocketReactor();
+
+	int run() override;
+
+	void wakeUp() noexcept;
+
+	// Handlers for the reactor thread
+	void handleEvents(BufferedSocket* aSocket, bool aReadable, bool aWritable) noexcept;
+	void handleTasks(BufferedSocket* aSocket) noexcept;
+	void handleStatus(BufferedSocket* aSocket, Status aStatus) noexcept;
+	void updateInterest(BufferedSocket* aSocket, uint32_t aEvents) noexcept;
+	void closeSocket(BufferedSocket* aSocket) noexcept;
+
+	int epollFd = -1;
+	int eventFd = -1;
+
+	atomic<size_t> socketCount { 0 };
+
+	// Accessed from other threads
+	CriticalSection cs;
+	vector<BufferedSocket*> addedSockets;
+	vector<BufferedSocket*> scheduledSockets;
+	bool stopping = false;
+
+	// Reactor thread only
+
+	// Sockets that ran out of bandwidth tokens (no events are received until they are retried)
+	vector<pair<BufferedSocket*, uint64_t>> throttledSockets;
+
+	// Sockets with buffered incoming data
+	vector<BufferedSocket*> pendingSockets;
+
+	// Sockets that will be deleted after the current iteration
+	vector<BufferedSocket*> closedSockets;
+
+	static CriticalSection poolCS;
+	static vector<unique_ptr<SocketReactor>> pool;
+};
+
+} // namespace dcpp
+
+#endif // __linux__
+
+#endif // !defined(DCPLUSPLUS_DCPP_SOCKET_REACTOR_H)
@@ -87,7 +87,8 @@ void MappingManager::close() {
 
 	if(renewal) {
 		renewal = 0;
-		TimerManager::getInstance()->removeListener(this);
+		TimerManager::getInstance()->removeTask(renewalTask);
+		renewalTask = 0;
 	}
 
 	if(working.get()) {
@@ -236,20 +237,21 @@ string MappingManager::deviceString(Mapper& mapper) const {
 void MappingManager::renewLater(Mapper& mapper) {
 	auto minutes = mapper.renewal();
 	if(minutes) {
-		bool addTimer = !renewal;
-		renewal = GET_TICK() + std::max(minutes, 10u) * 60 * 1000;
-		if(addTimer) {
-			TimerManager::getInstance()->addListener(this);
-		}
+		auto delay = std::max(minutes, 10u) * 60 * 1000;
+		renewal = GET_TICK() + delay;
 
+		TimerManager::getInstance()->removeTask(renewalTask);
+		renewalTask = TimerManager::getInstance()->addDeadline("Port mapping renewal", delay, [this](uint64_t) { onRenewal(); });
 	} else if(renewal) {
 		renewal = 0;
-		TimerManager::getInstance()->removeListener(this);
+		TimerManager::getInstance()->removeTask(renewalTask);
+		renewalTask = 0;
 	}
 }
 
-void MappingManager::on(TimerManagerListener::Minute, uint64_t tick) noexcept {
-	if(tick >= renewal && !busy.test_and_set()) {
+void MappingManager::onRenewal() noexcept {
+	// A running mapping operation will schedule the next renewal
+	if(!busy.test_and_set()) {
 		try { start(); } catch(const ThreadException&) { busy.clear(); }
 	}
 }
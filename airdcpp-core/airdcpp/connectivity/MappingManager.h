@@ -29,7 +29,6 @@
 #include <airdcpp/connectivity/Mapper.h>
 #include <airdcpp/message/Message.h>
 #include <airdcpp/core/thread/Thread.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 namespace dcpp {
 
@@ -38,8 +37,7 @@ using std::unique_ptr;
 using std::vector;
 
 class MappingManager :
-	private Thread,
-	private TimerManagerListener
+	private Thread
 {
 public:
 	/** add an implementation derived from the base Mapper class, passed as template parameter.
@@ -67,6 +65,7 @@ private:
 	atomic_flag busy;
 	unique_ptr<Mapper> working; /// currently working implementation.
 	uint64_t renewal = 0; /// when the next renewal should happen, if requested by the mapper.
+	TimerTaskId renewalTask = 0;
 
 	int run() override;
 
@@ -76,7 +75,7 @@ private:
 	void renewLater(Mapper& mapper);
 
 	bool v6;
-	void on(TimerManagerListener::Minute, uint64_t tick) noexcept override;
+	void onRenewal() noexcept;
 };
 
 } // namespace dcpp
@@ -19,6 +19,7 @@
 #ifndef DCPLUSPLUS_DCPP_SPEAKER_H
 #define DCPLUSPLUS_DCPP_SPEAKER_H
 
+#include <atomic>
 #include <utility>
 #include <vector>
 
@@ -29,6 +30,33 @@ namespace dcpp {
 
 using std::vector;
 
+// Identifies the event that is being fired by the current thread
+// Listeners of the same event may use the ID to share work (e.g. serialization of identical data)
+class SpeakerEvent {
+public:
+	// Returns 0 when not called from a listener
+	static uint64_t getCurrentId() noexcept {
+		return currentId;
+	}
+
+	SpeakerEvent() noexcept : prevId(currentId) {
+		currentId = ++lastId;
+	}
+
+	~SpeakerEvent() noexcept {
+		// Restore the outer event in case of nested events
+		currentId = prevId;
+	}
+
+	SpeakerEvent(const SpeakerEvent&) = delete;
+	SpeakerEvent& operator=(const SpeakerEvent&) = delete;
+private:
+	const uint64_t prevId;
+
+	static inline thread_local uint64_t currentId = 0;
+	static inline std::atomic<uint64_t> lastId = 0;
+};
+
 template<typename Listener>
 class Speaker {
 	typedef vector<Listener*> ListenerList;
@@ -42,6 +70,7 @@ public:
 	template<typename... ArgT>
 	void fire(ArgT&&... args) noexcept {
 		Lock l(listenerCS);
+		SpeakerEvent event;
 		tmpListeners = listeners;
 		for(auto listener: tmpListeners) {
 			listener->on(std::forward<ArgT>(args)...);
@@ -53,6 +82,7 @@ public:
 	template<typename... ArgT>
 	void fireReversed(ArgT&&... args) noexcept {
 		Lock l(listenerCS);
+		SpeakerEvent event;
 		tmpListeners = listeners;
 		for (auto listener : tmpListeners | views::reverse) {
 			listener->on(std::forward<ArgT>(args)...);
@@ -47,6 +47,8 @@ public:
 		table.resize(s);
 	}
 
+	size_t getTableSize() const noexcept { return table.size(); }
+
 	void merge(const BloomFilter<N>& aBloom) {
 		for (size_t i = 0; i < table.size(); ++i) {
 			if (aBloom.table[i] == true) {
@@ -271,6 +271,17 @@ void CryptoManager::loadCertificates() noexcept{
 	if (!clientContext || !serverContext)
 		return;
 
+#ifdef SSL_OP_ENABLE_KTLS
+	// Let the kernel handle the record layer so that uploads can be sent directly from the files
+	if (SETTING(ZERO_COPY_UPLOADS)) {
+		SSL_CTX_set_options(clientContext, SSL_OP_ENABLE_KTLS);
+		SSL_CTX_set_options(serverContext, SSL_OP_ENABLE_KTLS);
+	} else {
+		SSL_CTX_clear_options(clientContext, SSL_OP_ENABLE_KTLS);
+		SSL_CTX_clear_options(serverContext, SSL_OP_ENABLE_KTLS);
+	}
+#endif
+
 	keyprint.clear();
 	certsLoaded = false;
 
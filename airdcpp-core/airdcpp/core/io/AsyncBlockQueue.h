@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_ASYNC_BLOCK_QUEUE_H
+#define DCPLUSPLUS_DCPP_ASYNC_BLOCK_QUEUE_H
+
+#include <cstdint>
+#include <vector>
+
+namespace dcpp {
+
+// Bookkeeping for reading a file with asynchronous reads to a fixed set of buffers
+//
+// Reads are queued to the buffers in a round-robin order and they may complete in any order,
+// while the data is delivered in the file order. A buffer can be reused only after its block
+// has been delivered (completed blocks may still be waiting for the earlier ones).
+class AsyncBlockQueue {
+public:
+	explicit AsyncBlockQueue(unsigned aDepth) : blocks(aDepth) {}
+
+	// Whether there is a free buffer for a new read
+	bool canQueue() const noexcept {
+		return pending < blocks.size();
+	}
+
+	// Reserve the next buffer for a read, returns the buffer index
+	unsigned queue(uint64_t aOffset) noexcept {
+		auto index = nextBlock;
+		blocks[index] = { aOffset, 0, false };
+
+		nextBlock = (nextBlock + 1) % blocks.size();
+		pending++;
+		inFlight++;
+		return index;
+	}
+
+	void complete(unsigned aIndex, int aResult) noexcept {
+		blocks[aIndex].result = aResult;
+		blocks[aIndex].completed = true;
+		inFlight--;
+	}
+
+	// Whether the next block in the file order can be delivered
+	bool hasNext() const noexcept {
+		return pending > 0 && blocks[deliverBlock].completed;
+	}
+
+	// Release the next block in the file order, returns the buffer index
+	// The buffer content stays valid until a new read is queued
+	unsigned popNext() noexcept {
+		auto index = deliverBlock;
+		blocks[index].completed = false;
+
+		deliverBlock = (deliverBlock + 1) % blocks.size();
+		pending--;
+		return index;
+	}
+
+	int getResult(unsigned aIndex) const noexcept {
+		return blocks[aIndex].result;
+	}
+
+	uint64_t getOffset(unsigned aIndex) const noexcept {
+		return blocks[aIndex].offset;
+	}
+
+	// Blocks that have been queued but not delivered
+	unsigned getPending() const noexcept {
+		return pending;
+	}
+
+	// Reads that haven't completed (the buffers may still be written to)
+	unsigned getInFlight() const noexcept {
+		return inFlight;
+	}
+private:
+	struct Block {
+		uint64_t offset;
+		int result;
+		bool completed;
+	};
+
+	std::vector<Block> blocks;
+
+	unsigned nextBlock = 0;
+	unsigned deliverBlock = 0;
+
+	unsigned pending = 0;
+	unsigned inFlight = 0;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_ASYNC_BLOCK_QUEUE_H)
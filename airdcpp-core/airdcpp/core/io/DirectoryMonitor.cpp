@@ -0,0 +1,649 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+#include <airdcpp/core/io/DirectoryMonitor.h>
+
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/io/DirectoryReader.h>
+#include <airdcpp/core/localization/ResourceManager.h>
+#include <airdcpp/util/PathUtil.h>
+#include <airdcpp/util/SystemUtil.h>
+#include <airdcpp/util/Util.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/fanotify.h>
+#include <sys/inotify.h>
+#include <sys/statfs.h>
+#include <unistd.h>
+#endif
+
+namespace dcpp {
+
+#ifdef __linux__
+
+// Files are reported only after they have been closed (or moved in) so that files being written won't be hashed
+#define INOTIFY_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_MOVE_SELF | IN_ONLYDIR)
+#define FANOTIFY_MASK (FAN_CREATE | FAN_DELETE | FAN_MOVED_FROM | FAN_MOVED_TO | FAN_CLOSE_WRITE | FAN_ONDIR)
+
+#define EVENT_BUFFER_SIZE (64 * 1024)
+
+DirectoryMonitor::DirectoryMonitor() {
+	wakeupFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+}
+
+DirectoryMonitor::~DirectoryMonitor() {
+	stop();
+
+	if (wakeupFd != -1) {
+		close(wakeupFd);
+	}
+}
+
+bool DirectoryMonitor::isSupported() noexcept {
+	return true;
+}
+
+DirectoryMonitor::Backend DirectoryMonitor::addDirectory(const string& aPath) {
+	dcassert(!aPath.empty() && aPath.back() == PATH_SEPARATOR);
+
+	Lock l(cs);
+	if (stopping) {
+		throw MonitorException(STRING(UNKNOWN_ERROR));
+	}
+
+	Backend backend = Backend::INOTIFY;
+	if (inotifyRoots.contains(aPath)) {
+		return backend;
+	}
+
+	if (addFanotifyUnsafe(aPath)) {
+		backend = Backend::FANOTIFY;
+	} else {
+		addInotifyUnsafe(aPath);
+	}
+
+	if (!started) {
+		started = true;
+		start();
+	} else {
+		wakeup();
+	}
+
+	return backend;
+}
+
+bool DirectoryMonitor::removeDirectory(const string& aPath) noexcept {
+	Lock l(cs);
+	if (auto i = inotifyRoots.find(aPath); i != inotifyRoots.end()) {
+		// The monitor thread may be polling the descriptor
+		closedFds.push_back(i->second->fd);
+		inotifyRoots.erase(i);
+		wakeup();
+		return true;
+	}
+
+	return removeFanotifyUnsafe(aPath);
+}
+
+StringList DirectoryMonitor::getDirectories() const noexcept {
+	StringList ret;
+
+	Lock l(cs);
+	for (const auto& path: inotifyRoots | views::keys) {
+		ret.push_back(path);
+	}
+
+	for (const auto& fs: fanotifyFilesystems) {
+		for (const auto& path: fs->roots | views::values) {
+			ret.push_back(path);
+		}
+	}
+
+	return ret;
+}
+
+size_t DirectoryMonitor::getWatchCount() const noexcept {
+	size_t ret = 0;
+
+	Lock l(cs);
+	for (const auto& root: inotifyRoots | views::values) {
+		ret += root->watches.size();
+	}
+
+	return ret;
+}
+
+void DirectoryMonitor::stop() noexcept {
+	{
+		Lock l(cs);
+		if (stopping) {
+			return;
+		}
+
+		stopping = true;
+		wakeup();
+	}
+
+	if (started) {
+		join();
+	}
+
+	Lock l(cs);
+	for (const auto& root: inotifyRoots | views::values) {
+		close(root->fd);
+	}
+
+	for (const auto& fs: fanotifyFilesystems) {
+		close(fs->mountFd);
+	}
+
+	for (auto fd: closedFds) {
+		close(fd);
+	}
+
+	if (fanotifyFd != -1) {
+		close(fanotifyFd);
+		fanotifyFd = -1;
+	}
+
+	inotifyRoots.clear();
+	fanotifyFilesystems.clear();
+	closedFds.clear();
+}
+
+void DirectoryMonitor::wakeup() noexcept {
+	uint64_t value = 1;
+	[[maybe_unused]] auto written = ::write(wakeupFd, &value, sizeof(value));
+}
+
+
+// FANOTIFY
+static bool canResolveHandles(int aMountFd, const string& aPath) noexcept {
+	alignas(file_handle) char buf[sizeof(file_handle) + MAX_HANDLE_SZ];
+	auto handle = reinterpret_cast<file_handle*>(buf);
+	handle->handle_bytes = MAX_HANDLE_SZ;
+
+	int mountId;
+	if (name_to_handle_at(AT_FDCWD, aPath.c_str(), handle, &mountId, 0) == -1) {
+		return false;
+	}
+
+	// Requires CAP_DAC_READ_SEARCH
+	auto fd = open_by_handle_at(aMountFd, handle, O_PATH | O_CLOEXEC);
+	if (fd == -1) {
+		return false;
+	}
+
+	close(fd);
+	return true;
+}
+
+bool DirectoryMonitor::addFanotifyUnsafe(const string& aPath) {
+	if (fanotifyUnavailable) {
+		return false;
+	}
+
+	if (fanotifyFd == -1) {
+		// Watching file systems requires CAP_SYS_ADMIN (and Linux 5.9 or newer for the name reporting)
+		fanotifyFd = fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_NONBLOCK | FAN_REPORT_DFID_NAME, O_RDONLY | O_LARGEFILE);
+		if (fanotifyFd == -1) {
+			dcdebug("DirectoryMonitor: fanotify isn't available (%s)\n", SystemUtil::translateError(errno).c_str());
+			fanotifyUnavailable = true;
+			return false;
+		}
+	}
+
+	// Events report the real path
+	auto resolved = realpath(aPath.c_str(), nullptr);
+	if (!resolved) {
+		throw MonitorException(SystemUtil::translateError(errno));
+	}
+
+	auto realPath = PathUtil::ensureTrailingSlash(resolved);
+	free(resolved);
+
+	struct statfs st;
+	if (statfs(realPath.c_str(), &st) == -1) {
+		throw MonitorException(SystemUtil::translateError(errno));
+	}
+
+	int32_t fsid[2];
+	memcpy(fsid, &st.f_fsid, sizeof(fsid));
+
+	auto fs = ranges::find_if(fanotifyFilesystems, [&fsid](const unique_ptr<FanotifyFilesystem>& aFs) {
+		return memcmp(aFs->fsid, fsid, sizeof(fsid)) == 0;
+	});
+
+	if (fs == fanotifyFilesystems.end()) {
+		auto mountFd = open(realPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (mountFd == -1) {
+			throw MonitorException(SystemUtil::translateError(errno));
+		}
+
+		// File systems without file handle support can't be watched
+		if (!canResolveHandles(mountFd, realPath) || fanotify_mark(fanotifyFd, FAN_MARK_ADD | FAN_MARK_FILESYSTEM, FANOTIFY_MASK, AT_FDCWD, realPath.c_str()) == -1) {
+			dcdebug("DirectoryMonitor: can't use fanotify for %s (%s)\n", aPath.c_str(), SystemUtil::translateError(errno).c_str());
+			close(mountFd);
+			return false;
+		}
+
+		auto newFs = make_unique<FanotifyFilesystem>();
+		memcpy(newFs->fsid, fsid, sizeof(fsid));
+		newFs->mountFd = mountFd;
+		fs = fanotifyFilesystems.insert(fanotifyFilesystems.end(), std::move(newFs));
+	}
+
+	(*fs)->roots[realPath] = aPath;
+	return true;
+}
+
+bool DirectoryMonitor::removeFanotifyUnsafe(const string& aPath) noexcept {
+	for (auto fs = fanotifyFilesystems.begin(); fs != fanotifyFilesystems.end(); ++fs) {
+		auto& roots = (*fs)->roots;
+		auto root = ranges::find_if(roots, [&aPath](const auto& aRoot) { return aRoot.second == aPath; });
+		if (root == roots.end()) {
+			continue;
+		}
+
+		auto realPath = root->first;
+		roots.erase(root);
+
+		if (roots.empty()) {
+			fanotify_mark(fanotifyFd, FAN_MARK_REMOVE | FAN_MARK_FILESYSTEM, FANOTIFY_MASK, AT_FDCWD, realPath.c_str());
+			close((*fs)->mountFd);
+			fanotifyFilesystems.erase(fs);
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+string DirectoryMonitor::resolveFanotifyPathUnsafe(const FanotifyFilesystem& aFilesystem, const void* aHandle) const noexcept {
+	auto fd = open_by_handle_at(aFilesystem.mountFd, static_cast<file_handle*>(const_cast<void*>(aHandle)), O_PATH | O_CLOEXEC);
+	if (fd == -1) {
+		// Deleted already
+		return Util::emptyString;
+	}
+
+	char buf[PATH_MAX];
+	auto len = readlink(("/proc/self/fd/" + Util::toString(fd)).c_str(), buf, sizeof(buf));
+	close(fd);
+
+	if (len <= 0) {
+		return Util::emptyString;
+	}
+
+	auto realPath = PathUtil::ensureTrailingSlash(string(buf, len));
+	for (const auto& [rootRealPath, rootPath]: aFilesystem.roots) {
+		if (realPath.compare(0, rootRealPath.size(), rootRealPath) == 0) {
+			return rootPath + realPath.substr(rootRealPath.size());
+		}
+	}
+
+	// Outside the monitored roots
+	return Util::emptyString;
+}
+
+void DirectoryMonitor::readFanotify(EventList& events_) noexcept {
+	Lock l(cs);
+	if (fanotifyFd == -1) {
+		return;
+	}
+
+	alignas(fanotify_event_metadata) char buf[EVENT_BUFFER_SIZE];
+	for (;;) {
+		auto len = ::read(fanotifyFd, buf, sizeof(buf));
+		if (len <= 0) {
+			if (len == -1 && errno == EINTR) {
+				continue;
+			}
+
+			break;
+		}
+
+		auto meta = reinterpret_cast<const fanotify_event_metadata*>(buf);
+		for (; FAN_EVENT_OK(meta, len); meta = FAN_EVENT_NEXT(meta, len)) {
+			if (meta->vers != FANOTIFY_METADATA_VERSION) {
+				continue;
+			}
+
+			if (meta->mask & FAN_Q_OVERFLOW) {
+				// The queue is shared by all file systems
+				for (const auto& fs: fanotifyFilesystems) {
+					for (const auto& rootPath: fs->roots | views::values) {
+						events_.push_back({ EventType::OVERFLOW, rootPath, Util::emptyString });
+					}
+				}
+
+				continue;
+			}
+
+			auto info = reinterpret_cast<const fanotify_event_info_fid*>(reinterpret_cast<const char*>(meta) + meta->metadata_len);
+			if (meta->event_len < meta->metadata_len + sizeof(fanotify_event_info_fid) || info->hdr.info_type != FAN_EVENT_INFO_TYPE_DFID_NAME) {
+				continue;
+			}
+
+			auto fs = ranges::find_if(fanotifyFilesystems, [info](const unique_ptr<FanotifyFilesystem>& aFs) {
+				return memcmp(aFs->fsid, &info->fsid, sizeof(aFs->fsid)) == 0;
+			});
+
+			if (fs == fanotifyFilesystems.end()) {
+				continue;
+			}
+
+			auto handle = reinterpret_cast<const file_handle*>(info->handle);
+			auto name = reinterpret_cast<const char*>(handle->f_handle + handle->handle_bytes);
+			if (strcmp(name, ".") == 0) {
+				// Event for the directory itself
+				continue;
+			}
+
+			auto directoryPath = resolveFanotifyPathUnsafe(**fs, handle);
+			if (directoryPath.empty()) {
+				continue;
+			}
+
+			// Events for the same item may have been merged, the receiver will check the current state
+			auto path = directoryPath + name;
+			if (meta->mask & FAN_ONDIR) {
+				path += PATH_SEPARATOR;
+				if (meta->mask & (FAN_DELETE | FAN_MOVED_FROM)) {
+					events_.push_back({ EventType::DIRECTORY_REMOVED, path, Util::emptyString });
+				}
+
+				if (meta->mask & (FAN_CREATE | FAN_MOVED_TO)) {
+					events_.push_back({ EventType::DIRECTORY_CREATED, path, Util::emptyString });
+				}
+			} else {
+				if (meta->mask & (FAN_DELETE | FAN_MOVED_FROM)) {
+					events_.push_back({ EventType::FILE_REMOVED, path, Util::emptyString });
+				}
+
+				if (meta->mask & (FAN_CLOSE_WRITE | FAN_MOVED_TO)) {
+					events_.push_back({ EventType::FILE_MODIFIED, path, Util::emptyString });
+				}
+			}
+		}
+	}
+}
+
+
+// INOTIFY
+void DirectoryMonitor::addInotifyUnsafe(const string& aPath) {
+	auto root = make_unique<InotifyRoot>();
+	root->path = aPath;
+	root->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (root->fd == -1) {
+		throw MonitorException(SystemUtil::translateError(errno));
+	}
+
+	try {
+		addWatchesUnsafe(*root, aPath);
+	} catch (const MonitorException&) {
+		close(root->fd);
+		throw;
+	}
+
+	inotifyRoots.emplace(aPath, std::move(root));
+}
+
+void DirectoryMonitor::addWatchesUnsafe(InotifyRoot& aRoot, const string& aPath) {
+	StringList pendingPaths = { aPath };
+	while (!pendingPaths.empty()) {
+		auto path = std::move(pendingPaths.back());
+		pendingPaths.pop_back();
+
+		auto wd = inotify_add_watch(aRoot.fd, path.c_str(), INOTIFY_MASK);
+		if (wd == -1) {
+			if (errno == ENOSPC) {
+				throw MonitorException(STRING(MONITORING_WATCH_LIMIT_REACHED));
+			}
+
+			if (path == aPath && aPath == aRoot.path) {
+				throw MonitorException(SystemUtil::translateError(errno));
+			}
+
+			// Removed or inaccessible subdirectory (it won't be shared either)
+			continue;
+		}
+
+		// The same directory may be reached through links
+		if (!aRoot.watches.emplace(wd, path).second) {
+			continue;
+		}
+
+		DirectoryReader::List entries;
+		DirectoryReader::read(path, entries);
+		for (const auto& entry: entries) {
+			if (entry.isDirectory()) {
+				pendingPaths.push_back(path + entry.name + PATH_SEPARATOR);
+			}
+		}
+	}
+}
+
+void DirectoryMonitor::removeWatchesUnsafe(InotifyRoot& aRoot, const string& aPath) noexcept {
+	for (auto i = aRoot.watches.begin(); i != aRoot.watches.end();) {
+		if (i->second.compare(0, aPath.size(), aPath) == 0) {
+			inotify_rm_watch(aRoot.fd, i->first);
+			i = aRoot.watches.erase(i);
+		} else {
+			++i;
+		}
+	}
+}
+
+void DirectoryMonitor::readInotify(int aFd, EventList& events_) noexcept {
+	Lock l(cs);
+	auto rootIter = ranges::find_if(inotifyRoots | views::values, [aFd](const unique_ptr<InotifyRoot>& aRoot) { return aRoot->fd == aFd; });
+	if (rootIter.base() == inotifyRoots.end()) {
+		// Removed
+		return;
+	}
+
+	auto& root = **rootIter;
+	optional<string> error;
+
+	alignas(inotify_event) char buf[EVENT_BUFFER_SIZE];
+	for (;;) {
+		auto len = ::read(aFd, buf, sizeof(buf));
+		if (len <= 0) {
+			if (len == -1 && errno == EINTR) {
+				continue;
+			}
+
+			break;
+		}
+
+		for (auto p = buf; p < buf + len;) {
+			const auto& ev = *reinterpret_cast<const inotify_event*>(p);
+			p += sizeof(inotify_event) + ev.len;
+
+			if (ev.mask & IN_Q_OVERFLOW) {
+				events_.push_back({ EventType::OVERFLOW, root.path, Util::emptyString });
+				continue;
+			}
+
+			auto w = root.watches.find(ev.wd);
+			if (w == root.watches.end()) {
+				continue;
+			}
+
+			const auto directoryPath = w->second;
+			if (ev.mask & (IN_IGNORED | IN_MOVE_SELF)) {
+				if (directoryPath == root.path) {
+					error = STRING(MONITORING_ROOT_REMOVED);
+				} else if (ev.mask & IN_IGNORED) {
+					root.watches.erase(w);
+				}
+
+				continue;
+			}
+
+			if (ev.len == 0) {
+				continue;
+			}
+
+			auto path = directoryPath + ev.name;
+			if (ev.mask & IN_ISDIR) {
+				path += PATH_SEPARATOR;
+				if (ev.mask & (IN_CREATE | IN_MOVED_TO)) {
+					// Changes made before the watches were added will be picked up by the receiver
+					try {
+						addWatchesUnsafe(root, path);
+					} catch (const MonitorException& e) {
+						error = e.getError();
+					}
+
+					events_.push_back({ EventType::DIRECTORY_CREATED, path, Util::emptyString });
+				} else if (ev.mask & (IN_DELETE | IN_MOVED_FROM)) {
+					// Moved directories are watched again with the new path
+					removeWatchesUnsafe(root, path);
+					events_.push_back({ EventType::DIRECTORY_REMOVED, path, Util::emptyString });
+				}
+			} else if (ev.mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+				events_.push_back({ EventType::FILE_MODIFIED, path, Util::emptyString });
+			} else if (ev.mask & (IN_DELETE | IN_MOVED_FROM)) {
+				events_.push_back({ EventType::FILE_REMOVED, path, Util::emptyString });
+			}
+		}
+	}
+
+	if (error) {
+		// Not polled at the moment
+		events_.push_back({ EventType::FAILED, root.path, *error });
+		close(root.fd);
+		inotifyRoots.erase(rootIter.base());
+	}
+}
+
+
+// THREAD
+int DirectoryMonitor::run() {
+	while (!stopping) {
+		vector<pollfd> fds;
+
+		{
+			Lock l(cs);
+			for (auto fd: closedFds) {
+				close(fd);
+			}
+
+			closedFds.clear();
+
+			fds.push_back({ wakeupFd, POLLIN, 0 });
+			if (!fanotifyFilesystems.empty()) {
+				fds.push_back({ fanotifyFd, POLLIN, 0 });
+			}
+
+			for (const auto& root: inotifyRoots | views::values) {
+				fds.push_back({ root->fd, POLLIN, 0 });
+			}
+		}
+
+		if (poll(fds.data(), fds.size(), -1) == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			dcdebug("DirectoryMonitor: poll failed (%s)\n", SystemUtil::translateError(errno).c_str());
+			break;
+		}
+
+		EventList events;
+		for (const auto& p: fds) {
+			if (!(p.revents & POLLIN)) {
+				continue;
+			}
+
+			if (p.fd == wakeupFd) {
+				uint64_t value;
+				[[maybe_unused]] auto bytes = ::read(wakeupFd, &value, sizeof(value));
+			} else if (p.fd == fanotifyFd) {
+				readFanotify(events);
+			} else {
+				readInotify(p.fd, events);
+			}
+		}
+
+		fireEvents(events);
+	}
+
+	return 0;
+}
+
+#else
+
+DirectoryMonitor::DirectoryMonitor() {
+
+}
+
+DirectoryMonitor::~DirectoryMonitor() {
+
+}
+
+bool DirectoryMonitor::isSupported() noexcept {
+	return false;
+}
+
+DirectoryMonitor::Backend DirectoryMonitor::addDirectory(const string&) {
+	throw MonitorException(STRING(MONITORING_NOT_SUPPORTED));
+}
+
+bool DirectoryMonitor::removeDirectory(const string&) noexcept {
+	return false;
+}
+
+StringList DirectoryMonitor::getDirectories() const noexcept {
+	return StringList();
+}
+
+size_t DirectoryMonitor::getWatchCount() const noexcept {
+	return 0;
+}
+
+void DirectoryMonitor::stop() noexcept {
+
+}
+
+int DirectoryMonitor::run() {
+	return 0;
+}
+
+#endif
+
+void DirectoryMonitor::fireEvents(const EventList& aEvents) noexcept {
+	for (const auto& e: aEvents) {
+		switch (e.type) {
+			case EventType::FILE_MODIFIED: fire(DirectoryMonitorListener::FileModified(), e.path); break;
+			case EventType::FILE_REMOVED: fire(DirectoryMonitorListener::FileRemoved(), e.path); break;
+			case EventType::DIRECTORY_CREATED: fire(DirectoryMonitorListener::DirectoryCreated(), e.path); break;
+			case EventType::DIRECTORY_REMOVED: fire(DirectoryMonitorListener::DirectoryRemoved(), e.path); break;
+			case EventType::OVERFLOW: fire(DirectoryMonitorListener::Overflow(), e.path); break;
+			case EventType::FAILED: fire(DirectoryMonitorListener::Failed(), e.path, e.error); break;
+		}
+	}
+}
+
+} // namespace dcpp
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_DIRECTORY_MONITOR_H
+#define DCPLUSPLUS_DCPP_DIRECTORY_MONITOR_H
+
+#include <airdcpp/core/io/DirectoryMonitorListener.h>
+#include <airdcpp/core/Speaker.h>
+#include <airdcpp/core/thread/CriticalSection.h>
+#include <airdcpp/core/thread/Thread.h>
+
+namespace dcpp {
+
+// Reports changes inside the monitored directory trees
+//
+// Linux only. Entire file systems are watched with fanotify (FAN_REPORT_DFID_NAME) when the process has
+// the required privileges. Otherwise inotify is used with a watch for each directory and a separate
+// instance for each root, so that a queue overflow only affects the root where it happened.
+//
+// The events tell which paths have changed. They may be merged or reordered, so the receiver
+// should check the current state of the path from the file system.
+class DirectoryMonitor : public Speaker<DirectoryMonitorListener>, private Thread {
+public:
+	enum class Backend {
+		NONE,
+		FANOTIFY,
+		INOTIFY
+	};
+
+	DirectoryMonitor();
+	~DirectoryMonitor() override;
+
+	static bool isSupported() noexcept;
+
+	// Start monitoring the directory and all its subdirectories (the path must end with a separator)
+	// Throws MonitorException
+	Backend addDirectory(const string& aPath);
+	bool removeDirectory(const string& aPath) noexcept;
+
+	StringList getDirectories() const noexcept;
+
+	// Number of watched directories (inotify only)
+	size_t getWatchCount() const noexcept;
+
+	void stop() noexcept;
+
+	DirectoryMonitor(const DirectoryMonitor&) = delete;
+	DirectoryMonitor& operator=(const DirectoryMonitor&) = delete;
+private:
+	enum class EventType {
+		FILE_MODIFIED,
+		FILE_REMOVED,
+		DIRECTORY_CREATED,
+		DIRECTORY_REMOVED,
+		OVERFLOW,
+		FAILED
+	};
+
+	struct Event {
+		EventType type;
+		string path;
+		string error;
+	};
+
+	using EventList = vector<Event>;
+
+	int run() override;
+	void fireEvents(const EventList& aEvents) noexcept;
+
+	mutable CriticalSection cs;
+	atomic<bool> stopping = false;
+	bool started = false;
+
+#ifdef __linux__
+	struct InotifyRoot {
+		string path;
+		int fd = -1;
+
+		// Watch descriptor -> directory path
+		unordered_map<int, string> watches;
+	};
+
+	struct FanotifyFilesystem {
+		int32_t fsid[2];
+
+		// Directory on the file system for resolving the file handles
+		int mountFd = -1;
+
+		// Monitored roots on the file system (resolved path -> root path)
+		StringMap roots;
+	};
+
+	// Throws MonitorException
+	bool addFanotifyUnsafe(const string& aPath);
+	void addInotifyUnsafe(const string& aPath);
+
+	bool removeFanotifyUnsafe(const string& aPath) noexcept;
+
+	// Adds watches for the directory and its subdirectories
+	// Throws MonitorException
+	void addWatchesUnsafe(InotifyRoot& aRoot, const string& aPath);
+	void removeWatchesUnsafe(InotifyRoot& aRoot, const string& aPath) noexcept;
+
+	void readInotify(int aFd, EventList& events_) noexcept;
+	void readFanotify(EventList& events_) noexcept;
+
+	// Returns the monitored path for a directory that was resolved from a fanotify event
+	string resolveFanotifyPathUnsafe(const FanotifyFilesystem& aFilesystem, const void* aHandle) const noexcept;
+
+	void wakeup() noexcept;
+
+	// Root path -> instance
+	unordered_map<string, unique_ptr<InotifyRoot>> inotifyRoots;
+
+	// Closed after the monitor thread has stopped polling them
+	vector<int> closedFds;
+
+	vector<unique_ptr<FanotifyFilesystem>> fanotifyFilesystems;
+	int fanotifyFd = -1;
+	bool fanotifyUnavailable = false;
+
+	int wakeupFd = -1;
+#endif
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_DIRECTORY_MONITOR_H)
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_DIRECTORY_MONITOR_LISTENER_H
+#define DCPLUSPLUS_DCPP_DIRECTORY_MONITOR_LISTENER_H
+
+#include <airdcpp/core/header/typedefs.h>
+
+namespace dcpp {
+
+	// Events are fired from the monitor thread
+	// Directory paths end with a path separator
+	class DirectoryMonitorListener {
+	public:
+		virtual ~DirectoryMonitorListener() {}
+		template<int I>	struct X { enum { TYPE = I }; };
+
+		// File was closed after writing or moved inside a monitored directory
+		typedef X<0> FileModified;
+
+		// File was deleted or moved away
+		typedef X<1> FileRemoved;
+
+		// Directory was created or moved inside a monitored directory
+		typedef X<2> DirectoryCreated;
+
+		// Directory was deleted or moved away
+		typedef X<3> DirectoryRemoved;
+
+		// Events were lost for the monitored root, the content needs to be rescanned
+		typedef X<4> Overflow;
+
+		// Monitoring has stopped for the root because of an error
+		typedef X<5> Failed;
+
+		virtual void on(FileModified, const string& /*aPath*/) noexcept {}
+		virtual void on(FileRemoved, const string& /*aPath*/) noexcept {}
+		virtual void on(DirectoryCreated, const string& /*aPath*/) noexcept {}
+		virtual void on(DirectoryRemoved, const string& /*aPath*/) noexcept {}
+		virtual void on(Overflow, const string& /*aRootPath*/) noexcept {}
+		virtual void on(Failed, const string& /*aRootPath*/, const string& /*aError*/) noexcept {}
+	};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_DIRECTORY_MONITOR_LISTENER_H)
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+#include <airdcpp/core/io/DirectoryReader.h>
+
+#include <airdcpp/core/classes/ScopedFunctor.h>
+#include <airdcpp/util/PathUtil.h>
+#include <airdcpp/util/SystemUtil.h>
+#include <airdcpp/util/text/Text.h>
+
+#if defined(__linux__)
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#endif
+
+namespace dcpp {
+
+#if defined(__linux__) && defined(STATX_TYPE)
+
+// Not exposed by the libc headers
+struct linux_dirent64 {
+	ino64_t d_ino;
+	off64_t d_off;
+	unsigned short d_reclen;
+	unsigned char d_type;
+	char d_name[];
+};
+
+// Fits the entries of most directories in a single call
+#define GETDENTS_BUFFER_SIZE (32 * 1024)
+
+struct ItemAttributes {
+	mode_t mode = 0;
+	int64_t size = -1;
+	time_t lastWriteTime = 0;
+	time_t changeTime = 0;
+	uint64_t fileId = 0;
+};
+
+static bool getAttributes(int aDirFd, const char* aName, bool aFollowLinks, ItemAttributes& attributes_) noexcept {
+	// statx isn't available with kernels older than 4.11
+	static atomic<bool> statxUnsupported = false;
+	if (!statxUnsupported) {
+		struct statx st;
+		auto flags = AT_STATX_SYNC_AS_STAT | (aFollowLinks ? 0 : AT_SYMLINK_NOFOLLOW);
+		if (statx(aDirFd, aName, flags, STATX_TYPE | STATX_SIZE | STATX_MTIME | STATX_CTIME | STATX_INO, &st) == 0) {
+			attributes_.mode = st.stx_mode;
+			attributes_.size = static_cast<int64_t>(st.stx_size);
+			attributes_.lastWriteTime = static_cast<time_t>(st.stx_mtime.tv_sec);
+			attributes_.changeTime = static_cast<time_t>(st.stx_ctime.tv_sec);
+			attributes_.fileId = st.stx_ino;
+			return true;
+		}
+
+		if (errno != ENOSYS) {
+			return false;
+		}
+
+		statxUnsupported = true;
+	}
+
+	struct stat st;
+	if (fstatat(aDirFd, aName, &st, aFollowLinks ? 0 : AT_SYMLINK_NOFOLLOW) == -1) {
+		return false;
+	}
+
+	attributes_.mode = st.st_mode;
+	attributes_.size = st.st_size;
+	attributes_.lastWriteTime = st.st_mtime;
+	attributes_.changeTime = st.st_ctime;
+	attributes_.fileId = st.st_ino;
+	return true;
+}
+
+static void setAttributes(const ItemAttributes& aAttributes, DirectoryReader::Entry& entry_) noexcept {
+	entry_.directory = S_ISDIR(aAttributes.mode);
+	entry_.size = aAttributes.size;
+	entry_.lastWriteTime = aAttributes.lastWriteTime;
+	entry_.changeTime = aAttributes.changeTime;
+	entry_.fileId = aAttributes.fileId;
+}
+
+static void readAttributes(int aDirFd, unsigned char aType, DirectoryReader::Entry& entry_) noexcept {
+	ItemAttributes attributes;
+
+	// The type is known without an extra call for most file systems, links need to be resolved separately
+	if (aType == DT_LNK || aType == DT_UNKNOWN) {
+		if (!getAttributes(aDirFd, entry_.name.c_str(), false, attributes)) {
+			return;
+		}
+
+		entry_.link = S_ISLNK(attributes.mode);
+		if (entry_.link && !getAttributes(aDirFd, entry_.name.c_str(), true, attributes)) {
+			// Broken link
+			return;
+		}
+	} else if (!getAttributes(aDirFd, entry_.name.c_str(), true, attributes)) {
+		return;
+	}
+
+	setAttributes(attributes, entry_);
+}
+
+bool DirectoryReader::read(const string& aPath, List& entries_) noexcept {
+	auto fd = open(aPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd == -1) {
+		return false;
+	}
+
+	ScopedFunctor([fd] { close(fd); });
+
+	alignas(linux_dirent64) char buf[GETDENTS_BUFFER_SIZE];
+	for (;;) {
+		auto bytes = syscall(SYS_getdents64, fd, buf, sizeof(buf));
+		if (bytes == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			dcdebug("DirectoryReader: failed to read directory %s (%s)\n", aPath.c_str(), SystemUtil::translateError(errno).c_str());
+			break;
+		}
+
+		if (bytes == 0) {
+			break;
+		}
+
+		for (long pos = 0; pos < bytes;) {
+			auto d = reinterpret_cast<const linux_dirent64*>(buf + pos);
+			pos += d->d_reclen;
+
+			if (strcmp(d->d_name, ".") == 0 || strcmp(d->d_name, "..") == 0) {
+				continue;
+			}
+
+			if (!Text::validateUtf8(d->d_name)) {
+				dcdebug("DirectoryReader: UTF-8 validation failed for the item name (%s)\n", Text::sanitizeUtf8(d->d_name).c_str());
+				continue;
+			}
+
+			Entry e;
+			e.name = d->d_name;
+			e.hidden = d->d_name[0] == '.';
+			readAttributes(fd, d->d_type, e);
+
+			entries_.push_back(std::move(e));
+		}
+	}
+
+	return true;
+}
+
+bool DirectoryReader::readItem(const string& aPath, Entry& entry_) noexcept {
+	ItemAttributes attributes;
+	if (!getAttributes(AT_FDCWD, aPath.c_str(), true, attributes)) {
+		return false;
+	}
+
+	setAttributes(attributes, entry_);
+	return true;
+}
+
+#else
+
+bool DirectoryReader::read(const string& aPath, List& entries_) noexcept {
+	FileFindIter end;
+	FileFindIter i(aPath, "*");
+	if (!(i != end)) {
+		// Empty or it couldn't be opened
+		return File::isDirectory(aPath);
+	}
+
+	for (; i != end; ++i) {
+		Entry e;
+		e.name = i->getFileName();
+		if (e.name.empty()) {
+			break;
+		}
+
+		e.directory = i->isDirectory();
+		e.hidden = i->isHidden();
+		e.link = i->isLink();
+		e.size = i->getSize();
+		e.lastWriteTime = i->getLastWriteTime();
+
+		entries_.push_back(std::move(e));
+	}
+
+	return true;
+}
+
+bool DirectoryReader::readItem(const string& aPath, Entry& entry_) noexcept {
+	try {
+		FileItem item(PathUtil::isDirectoryPath(aPath) ? aPath.substr(0, aPath.size() - 1) : aPath);
+		entry_.directory = item.isDirectory();
+		entry_.hidden = item.isHidden();
+		entry_.link = item.isLink();
+		entry_.size = item.getSize();
+		entry_.lastWriteTime = item.getLastWriteTime();
+	} catch (const FileException&) {
+		return false;
+	}
+
+	return true;
+}
+
+#endif
+
+} // namespace dcpp
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_DIRECTORY_READER_H
+#define DCPLUSPLUS_DCPP_DIRECTORY_READER_H
+
+#include <airdcpp/core/io/File.h>
+
+namespace dcpp {
+
+// Lists the content of a directory with the attributes of all items resolved upfront
+//
+// The result is equal to iterating the directory with FileFindIter and calling all attribute getters
+// for each item. On Linux the directory is read with getdents64 and each item is examined with a single
+// statx call relative to the directory descriptor (instead of a separate stat call with the full path
+// for each attribute).
+class DirectoryReader {
+public:
+	struct Entry : FileItemInfoBase {
+		string name;
+
+		bool directory = false;
+		bool hidden = false;
+		bool link = false;
+		int64_t size = -1;
+		time_t lastWriteTime = 0;
+
+		// Used for detecting changed directories (zero if not available on the platform)
+		time_t changeTime = 0;
+		uint64_t fileId = 0;
+
+		bool isDirectory() const noexcept override { return directory; }
+		bool isHidden() const noexcept override { return hidden; }
+		bool isLink() const noexcept override { return link; }
+		int64_t getSize() const noexcept override { return size; }
+		time_t getLastWriteTime() const noexcept override { return lastWriteTime; }
+	};
+
+	using List = vector<Entry>;
+
+	// Appends the items of the directory (path must end with a separator)
+	// Returns false if the directory couldn't be opened
+	static bool read(const string& aPath, List& entries_) noexcept;
+
+	// Reads the attributes of a single item (links are followed, the name isn't set)
+	// Returns false if the item doesn't exist
+	static bool readItem(const string& aPath, Entry& entry_) noexcept;
+};
+
+} // namespace dcpp
+
+#endif // DCPLUSPLUS_DCPP_DIRECTORY_READER_H
@@ -203,6 +203,36 @@ size_t File::write(const void* buf, size_t len) {
 	dcassert(x == len);
 	return x;
 }
+
+size_t File::readAt(void* buf, size_t len, int64_t aPos) {
+	OVERLAPPED o = { 0 };
+	o.Offset = (DWORD)(aPos & 0xffffffff);
+	o.OffsetHigh = (DWORD)(aPos >> 32);
+
+	DWORD x;
+	if(!::ReadFile(h, buf, (DWORD)len, &x, &o)) {
+		auto error = GetLastError();
+		if (error == ERROR_HANDLE_EOF) {
+			return 0;
+		}
+
+		throw FileException(SystemUtil::translateError(error));
+	}
+	return x;
+}
+
+size_t File::writeAt(const void* buf, size_t len, int64_t aPos) {
+	OVERLAPPED o = { 0 };
+	o.Offset = (DWORD)(aPos & 0xffffffff);
+	o.OffsetHigh = (DWORD)(aPos >> 32);
+
+	DWORD x;
+	if(!::WriteFile(h, buf, (DWORD)len, &x, &o)) {
+		throw FileException(SystemUtil::translateError(GetLastError()));
+	}
+	dcassert(x == len);
+	return x;
+}
 void File::setEOF() {
 	dcassert(isOpen());
 	if(!SetEndOfFile(h)) {
@@ -483,6 +513,21 @@ void File::movePos(int64_t pos) noexcept {
 	lseek(h, (off_t)pos, SEEK_CUR);
 }
 
+bool File::getDirectSource(int& fd_, int64_t& pos_, int64_t& maxBytes_) noexcept {
+	if (!isOpen()) {
+		return false;
+	}
+
+	fd_ = h;
+	pos_ = getPos();
+	maxBytes_ = -1;
+	return pos_ >= 0;
+}
+
+void File::onDirectRead(int64_t aBytes) noexcept {
+	movePos(aBytes);
+}
+
 size_t File::read(void* buf, size_t& len) {
 	ssize_t result = ::read(h, buf, len);
 	if (result == -1) {
@@ -511,6 +556,38 @@ size_t File::write(const void* buf, size_t len) {
 	return len;
 }
 
+size_t File::readAt(void* buf, size_t len, int64_t aPos) {
+	ssize_t result;
+	do {
+		result = ::pread(h, buf, len, (off_t)aPos);
+	} while (result == -1 && errno == EINTR);
+
+	if (result == -1) {
+		throw FileException(SystemUtil::translateError(errno));
+	}
+	return (size_t)result;
+}
+
+size_t File::writeAt(const void* buf, size_t len, int64_t aPos) {
+	ssize_t result;
+	auto pointer = (const char*)buf;
+	size_t left = len;
+
+	while (left > 0) {
+		result = ::pwrite(h, pointer, left, (off_t)aPos);
+		if (result == -1) {
+			if (errno != EINTR) {
+				throw FileException(SystemUtil::translateError(errno));
+			}
+		} else {
+			pointer += result;
+			left -= result;
+			aPos += result;
+		}
+	}
+	return len;
+}
+
 // some ftruncate implementations can't extend files like SetEndOfFile,
 // not sure if the client code needs this...
 int File::extendFile(int64_t len) noexcept {
@@ -125,6 +125,16 @@ public:
 	size_t read(void* buf, size_t& len) override;
 	size_t write(const void* buf, size_t len) override;
 
+	// Positional I/O, the current file position isn't used
+	// These may be called from multiple threads simultaneously
+	size_t readAt(void* buf, size_t len, int64_t aPos);
+	size_t writeAt(const void* buf, size_t len, int64_t aPos);
+
+#ifndef _WIN32
+	bool getDirectSource(int& fd_, int64_t& pos_, int64_t& maxBytes_) noexcept override;
+	void onDirectRead(int64_t aBytes) noexcept override;
+#endif
+
 	// This has no effect if aForce is false
 	// Generally the operating system should decide when the buffered data is written on disk
 	size_t flushBuffers(bool aForce = true) override;
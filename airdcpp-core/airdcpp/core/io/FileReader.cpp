@@ -23,11 +23,21 @@
 #include <airdcpp/core/header/debug.h>
 #include <airdcpp/core/io/File.h>
 #include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/classes/ScopedFunctor.h>
 #include <airdcpp/util/PathUtil.h>
 #include <airdcpp/util/text/Text.h>
 #include <airdcpp/util/Util.h>
 #include <airdcpp/util/SystemUtil.h>
 
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <airdcpp/core/io/AsyncBlockQueue.h>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
 namespace dcpp {
 
 using std::make_pair;
@@ -45,9 +55,11 @@ size_t FileReader::read(const string& aPath, const DataCallback& callback) {
 
 	if (preferredStrategy == ASYNC) {
 		ret = readAsync(aPath, callback);
+		lastStrategy = ASYNC;
 	}
 
 	if (ret == READ_FAILED) {
+		lastStrategy = SYNC;
 		ret = readSync(aPath, callback);
 	}
 
@@ -207,6 +219,290 @@ size_t FileReader::readAsync(const string& aPath, const DataCallback& callback)
 	return *((size_t*)&over.Offset);
 }
 
+#elif defined(__linux__) && __has_include(<linux/io_uring.h>)
+
+// Number of reads that are kept in flight
+static const unsigned ASYNC_QUEUE_DEPTH = 4;
+
+// Buffer, offset and length alignment for O_DIRECT (covers the logical block size of all common devices)
+static const size_t DIRECT_IO_ALIGNMENT = 4096;
+
+// Minimal io_uring wrapper (the kernel interface is used directly so that liburing isn't needed)
+class IoUring : boost::noncopyable {
+public:
+	// Throws FileException
+	explicit IoUring(unsigned aEntries) {
+		io_uring_params params;
+		memset(&params, 0, sizeof(params));
+
+		fd = static_cast<int>(syscall(__NR_io_uring_setup, aEntries, &params));
+		if (fd < 0) {
+			throw FileException(SystemUtil::translateError(errno));
+		}
+
+		sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+		auto singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (singleMmap) {
+			sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+		}
+
+		sqRing = mapRing(sqRingSize, IORING_OFF_SQ_RING);
+		cqRing = singleMmap ? sqRing : mapRing(cqRingSize, IORING_OFF_CQ_RING);
+		sqes = static_cast<io_uring_sqe*>(mapRing(sqesSize, IORING_OFF_SQES));
+		if (!sqRing || !cqRing || !sqes) {
+			auto error = errno;
+			unmap();
+			throw FileException(SystemUtil::translateError(error));
+		}
+
+		auto sq = static_cast<uint8_t*>(sqRing);
+		sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+		sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+		sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+		auto cq = static_cast<uint8_t*>(cqRing);
+		cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+		cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+		cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+		cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+	}
+
+	~IoUring() {
+		unmap();
+	}
+
+	bool registerBuffers(const iovec* aBuffers, unsigned aCount) noexcept {
+		return syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, aBuffers, aCount) == 0;
+	}
+
+	// Adds a read in the submission queue, the entry is submitted by the next call of waitCompletion
+	// Registered buffers are used if a buffer index is given
+	void queueRead(int aFd, void* aBuf, uint32_t aLen, uint64_t aOffset, int aBufferIndex, uint64_t aUserData) noexcept {
+		auto tail = *sqTail;
+		auto index = tail & sqMask;
+
+		auto& sqe = sqes[index];
+		memset(&sqe, 0, sizeof(sqe));
+		sqe.opcode = aBufferIndex >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+		sqe.fd = aFd;
+		sqe.addr = reinterpret_cast<uint64_t>(aBuf);
+		sqe.len = aLen;
+		sqe.off = aOffset;
+		sqe.buf_index = static_cast<uint16_t>(aBufferIndex >= 0 ? aBufferIndex : 0);
+		sqe.user_data = aUserData;
+
+		sqArray[index] = index;
+		std::atomic_ref<unsigned>(*sqTail).store(tail + 1, std::memory_order_release);
+		queued++;
+	}
+
+	// Submits the queued entries and waits for the next completion
+	// Returns the user data and result (negative error code on failure) of the completed operation
+	// Throws FileException
+	pair<uint64_t, int> waitCompletion() {
+		for (;;) {
+			auto head = *cqHead;
+			if (queued == 0 && head != std::atomic_ref<unsigned>(*cqTail).load(std::memory_order_acquire)) {
+				const auto& cqe = cqes[head & cqMask];
+				auto ret = make_pair(static_cast<uint64_t>(cqe.user_data), cqe.res);
+				std::atomic_ref<unsigned>(*cqHead).store(head + 1, std::memory_order_release);
+				return ret;
+			}
+
+			auto ret = syscall(__NR_io_uring_enter, fd, queued, queued == 0 ? 1 : 0, queued == 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+			if (ret < 0) {
+				if (errno == EINTR || errno == EAGAIN) {
+					continue;
+				}
+
+				throw FileException(SystemUtil::translateError(errno));
+			}
+
+			queued -= static_cast<unsigned>(ret);
+		}
+	}
+private:
+	void* mapRing(size_t aSize, off_t aOffset) noexcept {
+		auto ret = mmap(nullptr, aSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, aOffset);
+		return ret == MAP_FAILED ? nullptr : ret;
+	}
+
+	void unmap() noexcept {
+		if (sqes) {
+			munmap(sqes, sqesSize);
+		}
+
+		if (cqRing && cqRing != sqRing) {
+			munmap(cqRing, cqRingSize);
+		}
+
+		if (sqRing) {
+			munmap(sqRing, sqRingSize);
+		}
+
+		close(fd);
+	}
+
+	int fd = -1;
+
+	// Entries that haven't been submitted yet
+	unsigned queued = 0;
+
+	void* sqRing = nullptr;
+	void* cqRing = nullptr;
+	io_uring_sqe* sqes = nullptr;
+
+	size_t sqRingSize = 0;
+	size_t cqRingSize = 0;
+	size_t sqesSize = 0;
+
+	unsigned* sqTail = nullptr;
+	unsigned sqMask = 0;
+	unsigned* sqArray = nullptr;
+
+	unsigned* cqHead = nullptr;
+	unsigned* cqTail = nullptr;
+	unsigned cqMask = 0;
+	io_uring_cqe* cqes = nullptr;
+};
+
+// The ring and the registered buffers are reused for all reads of the thread
+// (setting them up for each file would cost more than reading a small file)
+struct AsyncReadContext : boost::noncopyable {
+	// Throws FileException
+	explicit AsyncReadContext(size_t aBlockSize) : ring(ASYNC_QUEUE_DEPTH), blockSize(aBlockSize) {
+		buffer.resize(blockSize * ASYNC_QUEUE_DEPTH + DIRECT_IO_ALIGNMENT);
+
+		auto aligned = ((reinterpret_cast<size_t>(buffer.data()) + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT) * DIRECT_IO_ALIGNMENT;
+
+		iovec vecs[ASYNC_QUEUE_DEPTH];
+		for (unsigned i = 0; i < ASYNC_QUEUE_DEPTH; ++i) {
+			blocks[i] = reinterpret_cast<uint8_t*>(aligned) + i * blockSize;
+			vecs[i] = { blocks[i], blockSize };
+		}
+
+		// May fail because of the locked memory limit, regular reads are used in that case
+		registeredBuffers = ring.registerBuffers(vecs, ASYNC_QUEUE_DEPTH);
+		if (!registeredBuffers) {
+			dcdebug("FileReader: failed to register buffers (%s)\n", SystemUtil::translateError(errno).c_str());
+		}
+	}
+
+	IoUring ring;
+	const size_t blockSize;
+
+	vector<uint8_t> buffer;
+	uint8_t* blocks[ASYNC_QUEUE_DEPTH];
+	bool registeredBuffers = false;
+};
+
+static thread_local unique_ptr<AsyncReadContext> asyncReadContext;
+static thread_local bool asyncReadUnsupported = false;
+
+size_t FileReader::readAsync(const string& aPath, const DataCallback& callback) {
+	if (asyncReadUnsupported) {
+		return READ_FAILED;
+	}
+
+	auto block = getBlockSize(DIRECT_IO_ALIGNMENT);
+	if (!asyncReadContext || asyncReadContext->blockSize != block) {
+		try {
+			asyncReadContext = make_unique<AsyncReadContext>(block);
+		} catch (const FileException& e) {
+			// Not supported by the kernel or disabled
+			dcdebug("FileReader: failed to create io_uring instance (%s)\n", e.getError().c_str());
+			asyncReadUnsupported = true;
+			return READ_FAILED;
+		}
+	}
+
+	unique_ptr<File> f;
+	try {
+		f = make_unique<File>(aPath, File::READ, File::OPEN | File::SHARED_WRITE, File::BUFFER_NONE);
+	} catch (const FileException& e) {
+		// O_DIRECT isn't supported by all file systems (the synchronous read will throw if the file can't be opened at all)
+		dcdebug("FileReader: failed to open unbuffered file %s (%s)\n", aPath.c_str(), e.getError().c_str());
+		return READ_FAILED;
+	}
+
+	auto& ctx = *asyncReadContext;
+	auto fd = f->getNativeHandle();
+	auto fileSize = static_cast<uint64_t>(f->getSize());
+
+	AsyncBlockQueue blocks(ASYNC_QUEUE_DEPTH);
+	uint64_t nextOffset = 0;
+	bool eof = false, go = true;
+	size_t total = 0;
+
+	// The kernel writes to the buffers until the reads have completed
+	ScopedFunctor([&] {
+		while (blocks.getInFlight() > 0) {
+			try {
+				auto completion = ctx.ring.waitCompletion();
+				blocks.complete(static_cast<unsigned>(completion.first), completion.second);
+			} catch (const FileException&) {
+				// The buffers can't be reused safely
+				asyncReadContext.release();
+				asyncReadUnsupported = true;
+				break;
+			}
+		}
+	});
+
+	for (;;) {
+		// Keep the queue full; continue past the initial size for files that are still being written
+		while (go && !eof && blocks.canQueue() && (nextOffset < fileSize || blocks.getPending() == 0)) {
+			auto index = blocks.queue(nextOffset);
+			ctx.ring.queueRead(fd, ctx.blocks[index], static_cast<uint32_t>(block), nextOffset, ctx.registeredBuffers ? static_cast<int>(index) : -1, index);
+			nextOffset += block;
+		}
+
+		if (blocks.getPending() == 0) {
+			break;
+		}
+
+		// Completions may arrive in any order, deliver the data sequentially
+		while (!blocks.hasNext()) {
+			auto [index, res] = ctx.ring.waitCompletion();
+			blocks.complete(static_cast<unsigned>(index), res);
+		}
+
+		auto index = blocks.popNext();
+		auto res = blocks.getResult(index);
+		if (res < 0) {
+			if (total == 0 && (res == -EINVAL || res == -EOPNOTSUPP)) {
+				// Unbuffered reads or the operation aren't supported for this file
+				dcdebug("FileReader: unbuffered read failed for %s (%s)\n", aPath.c_str(), SystemUtil::translateError(-res).c_str());
+				go = false;
+				total = READ_FAILED;
+				break;
+			}
+
+			throw FileException(SystemUtil::translateError(-res));
+		}
+
+		dcassert(blocks.getOffset(index) == total);
+		if (res > 0 && go) {
+			go = callback(ctx.blocks[index], static_cast<size_t>(res));
+			total += static_cast<size_t>(res);
+		}
+
+		// A short read means the end of the file (O_DIRECT reads are never split before it)
+		if (static_cast<size_t>(res) < block) {
+			eof = true;
+		}
+
+		if (!go) {
+			break;
+		}
+	}
+
+	return total;
+}
+
 #else
 
 size_t FileReader::readAsync(const string& file, const DataCallback& callback) {
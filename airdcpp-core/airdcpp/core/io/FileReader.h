@@ -60,11 +60,15 @@ public:
 	 */
 	size_t read(const string& file, const DataCallback& callback);
 
+	/** Strategy used by the previous read (asynchronous reads fall back to synchronous ones if they aren't supported) */
+	Strategy getLastStrategy() const noexcept { return lastStrategy; }
+
 private:
 	static const size_t DEFAULT_BLOCK_SIZE;
 
 	string file;
 	Strategy preferredStrategy;
+	Strategy lastStrategy = SYNC;
 	size_t blockSize;
 
 	vector<uint8_t> buffer;
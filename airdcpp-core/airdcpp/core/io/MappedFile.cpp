@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+
+#include <airdcpp/core/io/MappedFile.h>
+
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/io/File.h>
+#include <airdcpp/util/SystemUtil.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+namespace dcpp {
+
+// The mapping stays valid after the file has been closed
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const string& aPath) {
+	File f(aPath, File::READ, File::OPEN | File::SHARED_WRITE, File::BUFFER_AUTO);
+	len = static_cast<size_t>(f.getSize());
+	if (len == 0) {
+		throw FileException("Empty file");
+	}
+
+	auto mapping = ::CreateFileMapping(f.getNativeHandle(), NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapping) {
+		throw FileException(SystemUtil::translateError(::GetLastError()));
+	}
+
+	buf = static_cast<const uint8_t*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	auto err = ::GetLastError();
+	::CloseHandle(mapping);
+
+	if (!buf) {
+		throw FileException(SystemUtil::translateError(err));
+	}
+}
+
+MappedFile::~MappedFile() {
+	::UnmapViewOfFile(buf);
+}
+
+#else
+
+MappedFile::MappedFile(const string& aPath) {
+	File f(aPath, File::READ, File::OPEN | File::SHARED_WRITE, File::BUFFER_AUTO);
+	len = static_cast<size_t>(f.getSize());
+	if (len == 0) {
+		throw FileException("Empty file");
+	}
+
+	auto p = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, f.getNativeHandle(), 0);
+	if (p == MAP_FAILED) {
+		throw FileException(SystemUtil::translateError(errno));
+	}
+
+#ifdef MADV_WILLNEED
+	::madvise(p, len, MADV_WILLNEED);
+#endif
+
+	buf = static_cast<const uint8_t*>(p);
+}
+
+MappedFile::~MappedFile() {
+	::munmap(const_cast<uint8_t*>(buf), len);
+}
+
+#endif
+
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_MAPPED_FILE_H
+#define DCPLUSPLUS_DCPP_MAPPED_FILE_H
+
+#include <airdcpp/core/header/typedefs.h>
+
+namespace dcpp {
+
+/** Read-only memory mapping of an entire file */
+class MappedFile : boost::noncopyable {
+public:
+	/** @throw FileException if the file can't be opened or mapped */
+	explicit MappedFile(const string& aPath);
+	~MappedFile();
+
+	const uint8_t* data() const noexcept { return buf; }
+	size_t size() const noexcept { return len; }
+private:
+	const uint8_t* buf = nullptr;
+	size_t len = 0;
+};
+
+}
+
+#endif // !defined(DCPLUSPLUS_DCPP_MAPPED_FILE_H)
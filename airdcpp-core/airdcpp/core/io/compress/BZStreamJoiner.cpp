@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+#include <airdcpp/core/io/compress/BZStreamJoiner.h>
+
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/io/stream/StreamBase.h>
+#include <airdcpp/core/localization/ResourceManager.h>
+
+#include <bit>
+
+namespace dcpp {
+
+// BZFilter always uses the maximum block size
+static const char BZ_HEADER[] = "BZh9";
+static const uint64_t BZ_HEADER_BITS = 4 * 8;
+
+static const uint64_t BZ_BLOCK_MAGIC = 0x314159265359ULL;
+static const uint64_t BZ_EOS_MAGIC = 0x177245385090ULL;
+static const uint64_t BZ_MAGIC_BITS = 48;
+
+static const size_t BUF_SIZE = 256 * 1024;
+
+// Reads max 32 bits starting from the given bit position
+static uint32_t readBits(const string& aData, uint64_t aPos, int aCount) noexcept {
+	dcassert(aCount > 0 && aCount <= 32 && aPos + aCount <= aData.size() * 8);
+
+	auto byte = aPos / 8;
+	uint64_t value = 0;
+	for (size_t i = 0; i < 5; ++i) {
+		value <<= 8;
+		if (byte + i < aData.size()) {
+			value |= static_cast<uint8_t>(aData[byte + i]);
+		}
+	}
+
+	return static_cast<uint32_t>((value >> (40 - aPos % 8 - aCount)) & ((1ULL << aCount) - 1));
+}
+
+static uint64_t readMagic(const string& aData, uint64_t aPos) noexcept {
+	return (static_cast<uint64_t>(readBits(aData, aPos, 24)) << 24) | readBits(aData, aPos + 24, 24);
+}
+
+BZStreamJoiner::Stream::Stream(string&& aData) : data(std::move(aData)) {
+	const auto totalBits = static_cast<uint64_t>(data.size()) * 8;
+	if (totalBits < BZ_HEADER_BITS + BZ_MAGIC_BITS + 32 || data.compare(0, 4, BZ_HEADER) != 0) {
+		throw Exception(STRING(DECOMPRESSION_ERROR));
+	}
+
+	// The end of stream marker is followed by the combined CRC and padding to a full byte
+	optional<uint64_t> eosPos;
+	for (int padding = 0; padding < 8; ++padding) {
+		auto pos = totalBits - padding - BZ_MAGIC_BITS - 32;
+		if (pos < BZ_HEADER_BITS) {
+			break;
+		}
+
+		if (readMagic(data, pos) == BZ_EOS_MAGIC && (padding == 0 || readBits(data, totalBits - padding, padding) == 0)) {
+			eosPos = pos;
+			break;
+		}
+	}
+
+	if (!eosPos) {
+		throw Exception(STRING(DECOMPRESSION_ERROR));
+	}
+
+	blocksStart = BZ_HEADER_BITS;
+	blocksEnd = *eosPos;
+	combinedCRC = readBits(data, blocksEnd + BZ_MAGIC_BITS, 32);
+
+	// Block lengths aren't stored so the block headers need to be searched for
+	// A false match would cause a CRC mismatch
+	uint32_t crc = 0;
+	uint64_t window = 0;
+	for (auto pos = blocksStart; pos < blocksEnd; ++pos) {
+		window = ((window << 1) | ((static_cast<uint8_t>(data[pos / 8]) >> (7 - pos % 8)) & 1)) & ((1ULL << BZ_MAGIC_BITS) - 1);
+		if (window != BZ_BLOCK_MAGIC || pos + 1 < blocksStart + BZ_MAGIC_BITS || pos + 1 + 32 > blocksEnd) {
+			continue;
+		}
+
+		crc = std::rotl(crc, 1) ^ readBits(data, pos + 1, 32);
+		blockCount++;
+	}
+
+	if (crc != combinedCRC || (blocksEnd > blocksStart && readMagic(data, blocksStart) != BZ_BLOCK_MAGIC)) {
+		throw Exception(STRING(DECOMPRESSION_ERROR));
+	}
+}
+
+BZStreamJoiner::BZStreamJoiner(OutputStream& aStream) : os(aStream) {
+	buf.reserve(BUF_SIZE + 8);
+	buf.insert(buf.end(), BZ_HEADER, BZ_HEADER + 4);
+}
+
+void BZStreamJoiner::append(const Stream& aStream) {
+	auto pos = aStream.blocksStart;
+	for (; pos + 32 <= aStream.blocksEnd; pos += 32) {
+		writeBits(readBits(aStream.data, pos, 32), 32);
+	}
+
+	if (pos < aStream.blocksEnd) {
+		auto remaining = static_cast<int>(aStream.blocksEnd - pos);
+		writeBits(readBits(aStream.data, pos, remaining), remaining);
+	}
+
+	// The combined CRC is rotated by one bit for each block
+	combinedCRC = std::rotl(combinedCRC, static_cast<int>(aStream.blockCount % 32)) ^ aStream.combinedCRC;
+	blockCount += aStream.blockCount;
+}
+
+int64_t BZStreamJoiner::finish() {
+	writeBits(static_cast<uint32_t>(BZ_EOS_MAGIC >> 24), 24);
+	writeBits(static_cast<uint32_t>(BZ_EOS_MAGIC & 0xFFFFFF), 24);
+	writeBits(combinedCRC, 32);
+
+	if (bitCount > 0) {
+		writeBits(0, 8 - bitCount);
+	}
+
+	flush();
+	return written;
+}
+
+void BZStreamJoiner::writeBits(uint32_t aValue, int aCount) {
+	// Max 7 pending bits + 32 new bits
+	bitBuf = (bitBuf << aCount) | aValue;
+	bitCount += aCount;
+	while (bitCount >= 8) {
+		bitCount -= 8;
+		buf.push_back(static_cast<uint8_t>(bitBuf >> bitCount));
+	}
+
+	if (buf.size() >= BUF_SIZE) {
+		flush();
+	}
+}
+
+void BZStreamJoiner::flush() {
+	if (buf.empty()) {
+		return;
+	}
+
+	written += os.write(buf.data(), buf.size());
+	buf.clear();
+}
+
+} // namespace dcpp
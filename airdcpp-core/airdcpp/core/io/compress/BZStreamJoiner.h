@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_BZSTREAMJOINER_H
+#define DCPLUSPLUS_DCPP_BZSTREAMJOINER_H
+
+#include <airdcpp/core/header/typedefs.h>
+
+namespace dcpp {
+
+class OutputStream;
+
+// Joins complete bzip2 streams into a single stream without recompressing the data
+//
+// The compressed blocks of each stream are copied as such (block boundaries aren't byte-aligned)
+// and a new end of stream marker with a combined CRC is written after them. Unlike with
+// concatenated streams, decompressors that stop at the first end of stream marker will
+// get all data.
+class BZStreamJoiner {
+public:
+	// Block structure of a complete stream that was compressed with BZFilter
+	class Stream {
+	public:
+		// Throws Exception if the data isn't a complete bzip2 stream
+		explicit Stream(string&& aData);
+
+		size_t getSize() const noexcept { return data.size(); }
+	private:
+		friend class BZStreamJoiner;
+
+		string data;
+
+		// Bit range of the compressed blocks
+		uint64_t blocksStart = 0;
+		uint64_t blocksEnd = 0;
+
+		uint32_t blockCount = 0;
+		uint32_t combinedCRC = 0;
+	};
+
+	explicit BZStreamJoiner(OutputStream& aStream);
+
+	void append(const Stream& aStream);
+
+	// Writes the end of stream marker
+	// Returns the total number of bytes written
+	int64_t finish();
+
+	BZStreamJoiner(BZStreamJoiner&) = delete;
+	BZStreamJoiner& operator=(BZStreamJoiner&) = delete;
+private:
+	void writeBits(uint32_t aValue, int aCount);
+	void flush();
+
+	OutputStream& os;
+
+	ByteVector buf;
+	uint64_t bitBuf = 0;
+	int bitCount = 0;
+
+	uint32_t blockCount = 0;
+	uint32_t combinedCRC = 0;
+	int64_t written = 0;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_BZSTREAMJOINER_H)
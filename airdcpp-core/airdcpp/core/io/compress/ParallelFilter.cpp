@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+#include <airdcpp/core/io/compress/ParallelFilter.h>
+
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/classes/ScopedFunctor.h>
+#include <airdcpp/core/localization/ResourceManager.h>
+#include <airdcpp/settings/SettingsManager.h>
+
+#include <bzlib.h>
+#include <zlib.h>
+
+#include <condition_variable>
+#include <thread>
+
+namespace dcpp {
+
+// The maximum distance of deflate back-references
+#define DEFLATE_WINDOW_SIZE 32768
+
+class ParallelFilterWorkers {
+public:
+	explicit ParallelFilterWorkers(size_t aCount) {
+		for (size_t i = 0; i < aCount; ++i) {
+			threads.emplace_back([this] { runWorker(); });
+		}
+	}
+
+	~ParallelFilterWorkers() {
+		{
+			std::lock_guard<std::mutex> l(mutex);
+			stopping = true;
+		}
+
+		jobAdded.notify_all();
+		for (auto& t : threads) {
+			t.join();
+		}
+	}
+
+	void add(ParallelFilterPool::Job&& aJob) noexcept {
+		{
+			std::lock_guard<std::mutex> l(mutex);
+			jobs.push_back(std::move(aJob));
+		}
+
+		jobAdded.notify_one();
+	}
+
+	size_t getCount() const noexcept {
+		return threads.size();
+	}
+
+	ParallelFilterWorkers(ParallelFilterWorkers&) = delete;
+	ParallelFilterWorkers& operator=(ParallelFilterWorkers&) = delete;
+private:
+	void runWorker() noexcept {
+		for (;;) {
+			ParallelFilterPool::Job job;
+
+			{
+				std::unique_lock<std::mutex> l(mutex);
+				jobAdded.wait(l, [this] { return stopping || !jobs.empty(); });
+				if (jobs.empty()) {
+					return;
+				}
+
+				job = std::move(jobs.front());
+				jobs.pop_front();
+			}
+
+			// Exceptions are passed to the filter through the future
+			job();
+		}
+	}
+
+	vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable jobAdded;
+	std::deque<ParallelFilterPool::Job> jobs;
+	bool stopping = false;
+};
+
+// Threads are started when the first stream is compressed
+static ParallelFilterWorkers& getWorkers() noexcept {
+	static ParallelFilterWorkers workers(max(std::thread::hardware_concurrency(), 1U));
+	return workers;
+}
+
+void ParallelFilterPool::run(Job&& aJob) noexcept {
+	getWorkers().add(std::move(aJob));
+}
+
+size_t ParallelFilterPool::getWorkerCount() noexcept {
+	return getWorkers().getCount();
+}
+
+ParallelBZCodec::ParallelBZCodec(string& output_) : os(output_), joiner(os) {
+
+}
+
+void ParallelBZCodec::compress(Block& block_) {
+	// The output may be slightly larger than the input for incompressible data
+	auto len = static_cast<unsigned int>(block_.input.size() + block_.input.size() / 100 + 600);
+	string bz(len, '\0');
+
+	auto err = BZ2_bzBuffToBuffCompress(&bz[0], &len, reinterpret_cast<char*>(block_.input.data()), static_cast<unsigned int>(block_.input.size()), 9, 0, 30);
+	if (err != BZ_OK) {
+		throw Exception(STRING(COMPRESSION_ERROR));
+	}
+
+	bz.resize(len);
+	block_.stream = make_unique<BZStreamJoiner::Stream>(std::move(bz));
+	ByteVector().swap(block_.input);
+}
+
+void ParallelBZCodec::append(const Block& aBlock) {
+	joiner.append(*aBlock.stream);
+}
+
+void ParallelBZCodec::finish() {
+	joiner.finish();
+}
+
+
+ParallelZCodec::ParallelZCodec(string& output_) : output(output_), level(SETTING(MAX_COMPRESSION)), adler(adler32(0, nullptr, 0)) {
+
+}
+
+void ParallelZCodec::prepare(Block& block_, Block& next_, bool aLast) const noexcept {
+	block_.last = aLast;
+	block_.level = compressing ? level : 0;
+
+	if (!aLast) {
+		auto dictionaryLen = min(block_.input.size(), static_cast<size_t>(DEFLATE_WINDOW_SIZE));
+		next_.dictionary.assign(block_.input.end() - dictionaryLen, block_.input.end());
+	}
+}
+
+void ParallelZCodec::compress(Block& block_) {
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+
+	// Raw deflate, the zlib header and trailer are written when combining the blocks
+	if (deflateInit2(&zs, block_.level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		throw Exception(STRING(COMPRESSION_ERROR));
+	}
+
+	ScopedFunctor([&zs] { deflateEnd(&zs); });
+
+	if (!block_.dictionary.empty() && deflateSetDictionary(&zs, block_.dictionary.data(), static_cast<uInt>(block_.dictionary.size())) != Z_OK) {
+		throw Exception(STRING(COMPRESSION_ERROR));
+	}
+
+	// Ending at a byte boundary allows concatenating the blocks
+	block_.output.resize(deflateBound(&zs, static_cast<uLong>(block_.input.size())) + 16);
+
+	zs.next_in = block_.input.data();
+	zs.avail_in = static_cast<uInt>(block_.input.size());
+	zs.next_out = reinterpret_cast<Bytef*>(&block_.output[0]);
+	zs.avail_out = static_cast<uInt>(block_.output.size());
+
+	auto err = deflate(&zs, block_.last ? Z_FINISH : Z_SYNC_FLUSH);
+	if (err != (block_.last ? Z_STREAM_END : Z_OK) || zs.avail_in != 0) {
+		throw Exception(STRING(COMPRESSION_ERROR));
+	}
+
+	block_.output.resize(block_.output.size() - zs.avail_out);
+	block_.adler = adler32(adler32(0, nullptr, 0), block_.input.data(), static_cast<uInt>(block_.input.size()));
+}
+
+void ParallelZCodec::append(const Block& aBlock) {
+	if (!headerWritten) {
+		// zlib header with the compression level hint
+		uint8_t flags = (level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3) << 6;
+		flags += (31 - (0x78 * 256 + flags) % 31) % 31;
+
+		output += static_cast<char>(0x78);
+		output += static_cast<char>(flags);
+		headerWritten = true;
+	}
+
+	output += aBlock.output;
+	adler = adler32_combine(adler, aBlock.adler, static_cast<z_off_t>(aBlock.input.size()));
+
+	totalIn += aBlock.input.size();
+	totalOut += aBlock.output.size();
+
+	// Check if there's any use compressing; if not, save some cpu...
+	if (compressing && totalIn > 64 * 1024 && (static_cast<double>(totalOut) / totalIn) > 0.95) {
+		compressing = false;
+		dcdebug("Dynamically disabled compression\n");
+	}
+}
+
+void ParallelZCodec::finish() {
+	for (int i = 3; i >= 0; --i) {
+		output += static_cast<char>((adler >> (i * 8)) & 0xFF);
+	}
+}
+
+} // namespace dcpp
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_PARALLEL_FILTER_H
+#define DCPLUSPLUS_DCPP_PARALLEL_FILTER_H
+
+#include <airdcpp/core/header/typedefs.h>
+
+#include <airdcpp/core/io/compress/BZStreamJoiner.h>
+#include <airdcpp/core/io/stream/Streams.h>
+
+#include <deque>
+#include <future>
+
+namespace dcpp {
+
+// Worker threads that are shared by all parallel filters
+// Concurrent streams (e.g. multiple filelist uploads) queue their blocks in the same pool so that
+// the number of compression threads stays bounded
+class ParallelFilterPool {
+public:
+	using Job = std::function<void()>;
+
+	static void run(Job&& aJob) noexcept;
+	static size_t getWorkerCount() noexcept;
+};
+
+// Compression filter that splits the input in blocks that are compressed concurrently
+// The result is a single compressed stream that is decompressed just like the output of the corresponding single-threaded filter
+//
+// The codec compresses the blocks in the shared worker pool and combines the results in the calling thread (in input order)
+template<class Codec>
+class ParallelFilter {
+public:
+	using Block = typename Codec::Block;
+
+	ParallelFilter() : codec(output), maxPendingBlocks(ParallelFilterPool::getWorkerCount() * 2) {
+		current.input.reserve(Codec::BLOCK_SIZE);
+	}
+
+	~ParallelFilter() {
+		// Wait for the queued blocks
+		for (auto& b : pendingBlocks) {
+			b.wait();
+		}
+	}
+
+	/**
+	* Compress data.
+	* @param in Input data
+	* @param insize Input size (Set to 0 to indicate that no more data will follow)
+	* @param out Output buffer
+	* @param outsize Output size, set to compressed size on return.
+	* @return True if there's more processing to be done.
+	*/
+	bool operator()(const void* in, size_t& insize, void* out, size_t& outsize) {
+		if (outsize == 0)
+			return true;
+
+		if (insize > 0) {
+			dcassert(!finishing);
+
+			auto data = static_cast<const uint8_t*>(in);
+			for (size_t pos = 0; pos < insize;) {
+				auto n = min(insize - pos, Codec::BLOCK_SIZE - current.input.size());
+				current.input.insert(current.input.end(), data + pos, data + pos + n);
+				pos += n;
+
+				if (current.input.size() == Codec::BLOCK_SIZE) {
+					submit(false);
+				}
+			}
+		} else if (!finishing) {
+			finishing = true;
+			submit(true);
+		}
+
+		// Combine the completed blocks
+		while (!pendingBlocks.empty() && (pendingBlocks.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready || (finishing && outputPos == output.size()))) {
+			auto block = pendingBlocks.front().get();
+			pendingBlocks.pop_front();
+
+			codec.append(block);
+		}
+
+		if (finishing && pendingBlocks.empty() && !finished) {
+			codec.finish();
+			finished = true;
+		}
+
+		auto n = min(outsize, output.size() - outputPos);
+		memcpy(out, output.data() + outputPos, n);
+		outputPos += n;
+		if (outputPos == output.size()) {
+			output.clear();
+			outputPos = 0;
+		}
+
+		outsize = n;
+		return !finished || outputPos < output.size();
+	}
+
+	ParallelFilter(ParallelFilter&) = delete;
+	ParallelFilter& operator=(ParallelFilter&) = delete;
+private:
+	void submit(bool aLast) {
+		auto block = std::move(current);
+		current = Block();
+		current.input.reserve(Codec::BLOCK_SIZE);
+
+		codec.prepare(block, current, aLast);
+
+		if (aLast && pendingBlocks.empty()) {
+			// Inputs that fit in a single block are compressed in the calling thread
+			std::promise<Block> p;
+			Codec::compress(block);
+			p.set_value(std::move(block));
+			pendingBlocks.push_back(p.get_future());
+			return;
+		}
+
+		// Limit the memory usage
+		while (pendingBlocks.size() >= maxPendingBlocks) {
+			auto completed = pendingBlocks.front().get();
+			pendingBlocks.pop_front();
+			codec.append(completed);
+		}
+
+		auto task = make_shared<std::packaged_task<Block()>>([b = std::move(block)]() mutable {
+			Codec::compress(b);
+			return std::move(b);
+		});
+
+		pendingBlocks.push_back(task->get_future());
+		ParallelFilterPool::run([task] { (*task)(); });
+	}
+
+	// Compressed data that hasn't been returned yet
+	string output;
+	size_t outputPos = 0;
+
+	Codec codec;
+
+	Block current;
+	std::deque<std::future<Block>> pendingBlocks;
+	const size_t maxPendingBlocks;
+
+	bool finishing = false;
+	bool finished = false;
+};
+
+// Independent bzip2 streams of 900k blocks (like pbzip2) that are joined into a single stream
+class ParallelBZCodec {
+public:
+	static const size_t BLOCK_SIZE = 900 * 1000;
+
+	struct Block {
+		ByteVector input;
+		unique_ptr<BZStreamJoiner::Stream> stream;
+	};
+
+	explicit ParallelBZCodec(string& output_);
+
+	void prepare(Block&, Block&, bool) const noexcept { }
+
+	// Called from worker threads
+	static void compress(Block& block_);
+
+	void append(const Block& aBlock);
+	void finish();
+private:
+	StringOutputStream os;
+	BZStreamJoiner joiner;
+};
+
+// Raw deflate blocks ending at byte boundaries (like pigz)
+// Each block is primed with the last 32 KiB of the previous input so that the compression ratio stays close to the single-threaded one
+class ParallelZCodec {
+public:
+	static const size_t BLOCK_SIZE = 128 * 1024;
+
+	struct Block {
+		ByteVector input;
+		ByteVector dictionary;
+		bool last = false;
+		int level = 0;
+
+		string output;
+		uint32_t adler = 0;
+	};
+
+	explicit ParallelZCodec(string& output_);
+
+	void prepare(Block& block_, Block& next_, bool aLast) const noexcept;
+
+	// Called from worker threads
+	static void compress(Block& block_);
+
+	void append(const Block& aBlock);
+	void finish();
+private:
+	string& output;
+
+	const int level;
+	bool headerWritten = false;
+
+	// Compression is disabled if it doesn't seem to be worth it (see ZFilter)
+	bool compressing = true;
+	int64_t totalIn = 0;
+	int64_t totalOut = 0;
+
+	uint32_t adler;
+};
+
+using ParallelBZFilter = ParallelFilter<ParallelBZCodec>;
+using ParallelZFilter = ParallelFilter<ParallelZCodec>;
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_PARALLEL_FILTER_H)
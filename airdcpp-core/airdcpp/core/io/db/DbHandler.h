@@ -34,6 +34,34 @@ class DbSnapshot {
 
 };
 
+// Set of writes that are committed to the database with a single operation
+class DbWriteBatch {
+public:
+	struct Entry {
+		string key;
+
+		// Removal if not set
+		std::optional<string> value;
+	};
+
+	void put(string&& aKey, string&& aValue) noexcept { entries.push_back({ std::move(aKey), std::move(aValue) }); }
+	void remove(string&& aKey) noexcept { entries.push_back({ std::move(aKey), std::nullopt }); }
+
+	const std::vector<Entry>& getEntries() const noexcept { return entries; }
+	bool empty() const noexcept { return entries.empty(); }
+	size_t size() const noexcept { return entries.size(); }
+private:
+	std::vector<Entry> entries;
+};
+
+// Error codes of DbException
+enum DbErrorCode {
+	DB_ERROR_NONE = 0,
+
+	// The entry can't be stored by the backend (e.g. the key is too long), writing it again won't succeed either
+	DB_ERROR_INVALID_DATA = 1,
+};
+
 // Most methods throw DbException in case of errors
 class DbHandler : boost::noncopyable {
 public:
@@ -48,10 +76,28 @@ public:
 
 	virtual bool hasKey(void* key, size_t keyLen, DbSnapshot* aSnapshot = nullptr) = 0;
 
+	// Applies the entries in order
+	// Backends that support atomic batches should override this (the default implementation writes the entries one by one)
+	virtual void write(const DbWriteBatch& aBatch) {
+		for (const auto& e: aBatch.getEntries()) {
+			if (e.value) {
+				put((void*)e.key.data(), e.key.size(), (void*)e.value->data(), e.value->size());
+			} else {
+				remove((void*)e.key.data(), e.key.size());
+			}
+		}
+	}
+
 	virtual size_t size(bool thorough, DbSnapshot* aSnapshot = nullptr) = 0;
 	virtual int64_t getSizeOnDisk() = 0;
 
 	virtual void remove_if(std::function<bool(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot = nullptr) = 0;
+
+	// Calls the handler for each key starting with the prefix (in key order)
+	virtual void forEachPrefix(void* aPrefix, size_t aPrefixLen, std::function<void(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot = nullptr) = 0;
+
+	// Calls the handler for each key starting from the given key (in key order) until the handler returns false
+	virtual void forEachFrom(void* aKey, size_t aKeyLen, std::function<bool(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot = nullptr) = 0;
 	virtual void compact() {}
 
 	virtual string getStats() { return "Not supported"; }
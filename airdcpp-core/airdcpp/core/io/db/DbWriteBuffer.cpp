@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+#include <airdcpp/core/io/db/DbWriteBuffer.h>
+
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/timer/TimerManager.h>
+
+namespace dcpp {
+
+DbWriteBuffer::DbWriteBuffer(DbHandler& aDb, size_t aMaxPendingBytes, uint64_t aMaxDelayMs, DbWriteBuffer* aDependency) noexcept : db(aDb), dependency(aDependency), maxPendingBytes(aMaxPendingBytes), maxDelay(aMaxDelayMs) {
+
+}
+
+void DbWriteBuffer::put(string&& aKey, string&& aValue) {
+	add(std::move(aKey), std::move(aValue));
+}
+
+void DbWriteBuffer::remove(string&& aKey) {
+	add(std::move(aKey), std::nullopt);
+}
+
+bool DbWriteBuffer::putDeferred(string&& aKey, string&& aValue) noexcept {
+	return addPending(std::move(aKey), std::move(aValue));
+}
+
+void DbWriteBuffer::add(string&& aKey, std::optional<string>&& aValue) {
+	if (addPending(std::move(aKey), std::move(aValue))) {
+		flush();
+	}
+}
+
+bool DbWriteBuffer::addPending(string&& aKey, std::optional<string>&& aValue) noexcept {
+	auto tick = GET_TICK();
+
+	Lock l(cs);
+	if (pending.empty()) {
+		firstPendingTick = tick;
+	}
+
+	pendingBytes += aKey.size() + (aValue ? aValue->size() : 0);
+	pending.insert_or_assign(std::move(aKey), std::move(aValue));
+
+	return pendingBytes >= maxPendingBytes || tick - firstPendingTick >= maxDelay;
+}
+
+const std::optional<string>* DbWriteBuffer::findPendingUnsafe(const string& aKey) const noexcept {
+	if (auto i = pending.find(aKey); i != pending.end()) {
+		return &i->second;
+	}
+
+	if (auto i = flushing.find(aKey); i != flushing.end()) {
+		return &i->second;
+	}
+
+	return nullptr;
+}
+
+bool DbWriteBuffer::get(const string& aKey, size_t aInitialValueLen, const LoadF& aLoadF) {
+	std::optional<string> value;
+	{
+		Lock l(cs);
+		if (auto p = findPendingUnsafe(aKey); p) {
+			if (!*p) {
+				// Removed
+				return false;
+			}
+
+			// Copy the value so that the handler won't be called while holding the lock
+			value = **p;
+		}
+	}
+
+	if (value) {
+		return aLoadF((void*)value->data(), value->size());
+	}
+
+	return db.get((void*)aKey.data(), aKey.size(), aInitialValueLen, aLoadF);
+}
+
+bool DbWriteBuffer::hasKey(const string& aKey) {
+	{
+		Lock l(cs);
+		if (auto p = findPendingUnsafe(aKey); p) {
+			return p->has_value();
+		}
+	}
+
+	return db.hasKey((void*)aKey.data(), aKey.size());
+}
+
+void DbWriteBuffer::flush() {
+	if (dependency) {
+		dependency->flush();
+	}
+
+	Lock fl(flushCS);
+
+	DbWriteBatch batch;
+	size_t bytes = 0;
+
+	{
+		Lock l(cs);
+		if (pending.empty()) {
+			return;
+		}
+
+		// Keep the entries visible for lookups until they have been committed
+		dcassert(flushing.empty());
+		flushing.swap(pending);
+		bytes = pendingBytes;
+		pendingBytes = 0;
+
+		for (const auto& [key, value]: flushing) {
+			if (value) {
+				batch.put(string(key), string(*value));
+			} else {
+				batch.remove(string(key));
+			}
+		}
+	}
+
+	try {
+		try {
+			db.write(batch);
+		} catch (const DbException& e) {
+			if (e.getErrorCode() != DB_ERROR_INVALID_DATA) {
+				throw;
+			}
+
+			// Retrying the batch would fail forever, drop the entries that can't be stored
+			writeValidEntries(batch);
+		}
+	} catch (const DbException&) {
+		restoreFlushing(bytes);
+		throw;
+	}
+
+	Lock l(cs);
+	flushing.clear();
+}
+
+void DbWriteBuffer::writeValidEntries(const DbWriteBatch& aBatch) {
+	for (const auto& e: aBatch.getEntries()) {
+		DbWriteBatch entryBatch;
+		if (e.value) {
+			entryBatch.put(string(e.key), string(*e.value));
+		} else {
+			entryBatch.remove(string(e.key));
+		}
+
+		try {
+			db.write(entryBatch);
+		} catch (const DbException& ex) {
+			if (ex.getErrorCode() != DB_ERROR_INVALID_DATA) {
+				throw;
+			}
+
+			dcdebug("DbWriteBuffer: discarding an invalid entry (key length " SIZET_FMT "): %s\n", e.key.size(), ex.getError().c_str());
+		}
+	}
+}
+
+void DbWriteBuffer::restoreFlushing(size_t aBytes) noexcept {
+	// Put the entries back so that nothing is lost (possible newer writes will be preserved)
+	Lock l(cs);
+	if (pending.empty()) {
+		firstPendingTick = GET_TICK();
+	}
+
+	for (auto& [key, value]: flushing) {
+		pending.try_emplace(key, std::move(value));
+	}
+
+	pendingBytes += aBytes;
+	flushing.clear();
+}
+
+void DbWriteBuffer::flushExpired(uint64_t aTick) {
+	{
+		Lock l(cs);
+		if (pending.empty() || aTick - firstPendingTick < maxDelay) {
+			return;
+		}
+	}
+
+	flush();
+}
+
+size_t DbWriteBuffer::getPendingCount() const noexcept {
+	Lock l(cs);
+	return pending.size() + flushing.size();
+}
+
+} //dcpp
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+
+#ifndef DCPLUSPLUS_DCPP_DB_WRITE_BUFFER_H_
+#define DCPLUSPLUS_DCPP_DB_WRITE_BUFFER_H_
+
+#include <airdcpp/core/io/db/DbHandler.h>
+#include <airdcpp/core/thread/CriticalSection.h>
+
+namespace dcpp {
+
+// Combines writes to a database into batches (group commit)
+//
+// The pending batch is committed when its size exceeds the limit or when the oldest pending write
+// is older than the maximum delay. Writes that haven't been committed yet are visible to the lookups
+// made through the buffer.
+//
+// Methods that write to the database throw DbException
+class DbWriteBuffer : boost::noncopyable {
+public:
+	using LoadF = std::function<bool(void* aValue, size_t aValueLen)>;
+
+	// Pending writes of the dependency buffer are always committed first (e.g. data referenced by the entries of this buffer)
+	DbWriteBuffer(DbHandler& aDb, size_t aMaxPendingBytes, uint64_t aMaxDelayMs, DbWriteBuffer* aDependency = nullptr) noexcept;
+
+	void put(string&& aKey, string&& aValue);
+	void remove(string&& aKey);
+
+	// Queues the write without committing (use when the caller holds locks of its own)
+	// Returns true if the buffer should be flushed by the caller
+	bool putDeferred(string&& aKey, string&& aValue) noexcept;
+
+	bool get(const string& aKey, size_t aInitialValueLen, const LoadF& aLoadF);
+	bool hasKey(const string& aKey);
+
+	// Commits all pending writes
+	void flush();
+
+	// Commits the pending writes if the oldest one has waited for longer than the maximum delay
+	void flushExpired(uint64_t aTick);
+
+	size_t getPendingCount() const noexcept;
+
+	DbHandler& getDb() noexcept { return db; }
+private:
+	// Removals are stored as unset values
+	using PendingMap = unordered_map<string, std::optional<string>>;
+
+	void add(string&& aKey, std::optional<string>&& aValue);
+
+	// Returns true if the pending writes should be committed
+	bool addPending(string&& aKey, std::optional<string>&& aValue) noexcept;
+
+	// Writes the entries one by one, entries rejected as invalid by the database are discarded
+	void writeValidEntries(const DbWriteBatch& aBatch);
+
+	// Moves the entries of a failed commit back to the pending batch
+	void restoreFlushing(size_t aBytes) noexcept;
+
+	// Returns nullptr if there are no uncommitted writes for the key
+	const std::optional<string>* findPendingUnsafe(const string& aKey) const noexcept;
+
+	// Writes that haven't been committed yet
+	PendingMap pending;
+
+	// The batch that is currently being committed
+	PendingMap flushing;
+
+	size_t pendingBytes = 0;
+	uint64_t firstPendingTick = 0;
+
+	DbHandler& db;
+	DbWriteBuffer* const dependency;
+	const size_t maxPendingBytes;
+	const uint64_t maxDelay;
+
+	mutable CriticalSection cs;
+
+	// Only one batch is committed at a time
+	CriticalSection flushCS;
+};
+
+} //dcpp
+
+#endif
@@ -0,0 +1,472 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+#include <airdcpp/core/io/db/LMDB.h>
+
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/io/File.h>
+#include <airdcpp/hash/value/TigerHash.h>
+#include <airdcpp/util/PathUtil.h>
+#include <airdcpp/core/localization/ResourceManager.h>
+#include <airdcpp/util/Util.h>
+#include <airdcpp/core/version.h>
+
+// Address space reserved for the map initially
+// The file is sparse on other platforms so the reservation is made large enough to avoid resizing in practice
+// (resizing isn't possible while snapshots are open), Windows grows the file to the full map size
+#ifdef _WIN32
+#define MIN_MAP_SIZE (sizeof(void*) == 4 ? 256 * 1024 * 1024ULL : 1024 * 1024 * 1024ULL)
+#else
+#define MIN_MAP_SIZE (sizeof(void*) == 4 ? 256 * 1024 * 1024ULL : 64 * 1024 * 1024 * 1024ULL)
+#endif
+
+namespace dcpp {
+
+LMDB::LmdbSnapshot::LmdbSnapshot(LMDB& aDb) : db(aDb) {
+	RLock l(db.mapCS);
+	db.checkDbError(mdb_txn_begin(db.env, nullptr, MDB_RDONLY, &txn));
+	db.openSnapshots++;
+}
+
+LMDB::LmdbSnapshot::~LmdbSnapshot() {
+	mdb_txn_abort(txn);
+	db.openSnapshots--;
+}
+
+LMDB::LMDB(const string& aPath, const string& aFriendlyName, uint64_t cacheSize) :
+	DbHandler(aPath, aFriendlyName, cacheSize) {
+
+}
+
+LMDB::~LMDB() {
+	if (env)
+		mdb_env_close(env);
+}
+
+string LMDB::getRepairFlag() const { return dbPath + "REPAIR"; }
+
+void LMDB::open(StepFunction stepF, MessageFunction messageF) {
+	if (PathUtil::fileExists(getRepairFlag())) {
+		repair(stepF, messageF);
+		File::deleteFile(getRepairFlag());
+	}
+
+	// Leave room for growth, the map is grown further when needed
+	mapSize = max(static_cast<size_t>(MIN_MAP_SIZE), static_cast<size_t>(max(getSizeOnDisk(), static_cast<int64_t>(0))) * 2);
+
+	auto ret = mdb_env_create(&env);
+	if (ret == MDB_SUCCESS) {
+		ret = mdb_env_set_mapsize(env, mapSize);
+	}
+
+	if (ret == MDB_SUCCESS) {
+		// Snapshots are used from different threads
+		ret = mdb_env_open(env, Text::fromUtf8(dbPath).c_str(), MDB_NOTLS, 0644);
+	}
+
+	if (ret == MDB_SUCCESS) {
+		MDB_txn* txn = nullptr;
+		ret = mdb_txn_begin(env, nullptr, 0, &txn);
+		if (ret == MDB_SUCCESS) {
+			ret = mdb_dbi_open(txn, nullptr, 0, &dbi);
+			if (ret == MDB_SUCCESS) {
+				ret = mdb_txn_commit(txn);
+			} else {
+				mdb_txn_abort(txn);
+			}
+		}
+	}
+
+	if (ret == MDB_SUCCESS) {
+		maxKeySize = static_cast<size_t>(mdb_env_get_maxkeysize(env));
+		dcassert(maxKeySize > TigerHash::BYTES);
+	}
+
+	if (ret != MDB_SUCCESS) {
+		messageF(STRING_F(DB_OPEN_FAILED, getNameLower() % mdb_strerror(ret) % APPNAME), false, true);
+		throw DbException();
+	}
+}
+
+void LMDB::repair(StepFunction stepF, MessageFunction /*messageF*/) {
+	// Copy-on-write B-tree, the database is always consistent after a crash
+	stepF(STRING_F(REPAIRING_X, getNameLower()));
+}
+
+void LMDB::performWrite(const std::function<int(MDB_txn*)>& f) {
+	for (;;) {
+		int ret;
+		{
+			RLock l(mapCS);
+
+			MDB_txn* txn = nullptr;
+			checkDbError(mdb_txn_begin(env, nullptr, 0, &txn));
+
+			ret = f(txn);
+			if (ret == MDB_SUCCESS) {
+				ret = mdb_txn_commit(txn);
+			} else {
+				mdb_txn_abort(txn);
+			}
+		}
+
+		if (ret == MDB_MAP_FULL) {
+			growMap();
+			continue;
+		}
+
+		checkDbError(ret);
+		return;
+	}
+}
+
+void LMDB::performRead(const std::function<void(MDB_txn*)>& f, DbSnapshot* aSnapshot) {
+	totalReads++;
+	if (aSnapshot) {
+		f(static_cast<LmdbSnapshot*>(aSnapshot)->txn);
+		return;
+	}
+
+	RLock l(mapCS);
+
+	MDB_txn* txn = nullptr;
+	checkDbError(mdb_txn_begin(env, nullptr, MDB_RDONLY, &txn));
+
+	try {
+		f(txn);
+	} catch (...) {
+		mdb_txn_abort(txn);
+		throw;
+	}
+
+	mdb_txn_abort(txn);
+}
+
+void LMDB::growMap() {
+	WLock l(mapCS);
+	if (openSnapshots > 0) {
+		// Fail the write, buffered writes are retried after the snapshot has been released
+		throw DbException(getFriendlyName() + ": " + mdb_strerror(MDB_MAP_FULL));
+	}
+
+	auto newSize = mapSize * 2;
+	checkDbError(mdb_env_set_mapsize(env, newSize));
+
+	mapSize = newSize;
+	mapResizes++;
+}
+
+string LMDB::getLongKey(const void* aKey, size_t aKeyLen) const noexcept {
+	dcassert(isLongKey(aKeyLen));
+
+	// Keep the beginning so that prefix iteration continues to work
+	string ret(static_cast<const char*>(aKey), maxKeySize - TigerHash::BYTES);
+
+	TigerHash tiger;
+	tiger.update(aKey, aKeyLen);
+	ret.append(reinterpret_cast<const char*>(tiger.finalize()), TigerHash::BYTES);
+	return ret;
+}
+
+string LMDB::encodeLongValue(const void* aKey, size_t aKeyLen, const void* aValue, size_t aValueLen) noexcept {
+	auto keyLen = static_cast<uint32_t>(aKeyLen);
+
+	string ret;
+	ret.reserve(sizeof(uint32_t) + aKeyLen + aValueLen);
+	ret.append(reinterpret_cast<const char*>(&keyLen), sizeof(uint32_t));
+	ret.append(static_cast<const char*>(aKey), aKeyLen);
+	ret.append(static_cast<const char*>(aValue), aValueLen);
+	return ret;
+}
+
+bool LMDB::decodeEntry(const MDB_val& aKey, const MDB_val& aValue, MDB_val& key_, MDB_val& value_) const noexcept {
+	if (!isLongKey(aKey.mv_size)) {
+		key_ = aKey;
+		value_ = aValue;
+		return true;
+	}
+
+	if (aValue.mv_size < sizeof(uint32_t)) {
+		return false;
+	}
+
+	uint32_t keyLen;
+	memcpy(&keyLen, aValue.mv_data, sizeof(uint32_t));
+	if (aValue.mv_size - sizeof(uint32_t) < keyLen) {
+		return false;
+	}
+
+	auto data = static_cast<char*>(aValue.mv_data) + sizeof(uint32_t);
+	key_ = MDB_val{ keyLen, data };
+	value_ = MDB_val{ aValue.mv_size - sizeof(uint32_t) - keyLen, data + keyLen };
+	return true;
+}
+
+int LMDB::putEntry(MDB_txn* aTxn, const void* aKey, size_t aKeyLen, const void* aValue, size_t aValueLen) {
+	if (!isLongKey(aKeyLen)) {
+		MDB_val key{ aKeyLen, const_cast<void*>(aKey) };
+		MDB_val value{ aValueLen, const_cast<void*>(aValue) };
+		return mdb_put(aTxn, dbi, &key, &value, 0);
+	}
+
+	auto longKey = getLongKey(aKey, aKeyLen);
+	auto longValue = encodeLongValue(aKey, aKeyLen, aValue, aValueLen);
+
+	MDB_val key{ longKey.size(), longKey.data() };
+	MDB_val value{ longValue.size(), longValue.data() };
+	return mdb_put(aTxn, dbi, &key, &value, 0);
+}
+
+int LMDB::removeEntry(MDB_txn* aTxn, const void* aKey, size_t aKeyLen) {
+	int ret;
+	if (!isLongKey(aKeyLen)) {
+		MDB_val key{ aKeyLen, const_cast<void*>(aKey) };
+		ret = mdb_del(aTxn, dbi, &key, nullptr);
+	} else {
+		auto longKey = getLongKey(aKey, aKeyLen);
+		MDB_val key{ longKey.size(), longKey.data() };
+		ret = mdb_del(aTxn, dbi, &key, nullptr);
+	}
+
+	return ret == MDB_NOTFOUND ? MDB_SUCCESS : ret;
+}
+
+int LMDB::getEntry(MDB_txn* aTxn, const void* aKey, size_t aKeyLen, MDB_val& value_) {
+	if (!isLongKey(aKeyLen)) {
+		MDB_val key{ aKeyLen, const_cast<void*>(aKey) };
+		return mdb_get(aTxn, dbi, &key, &value_);
+	}
+
+	auto longKey = getLongKey(aKey, aKeyLen);
+	MDB_val key{ longKey.size(), longKey.data() };
+
+	MDB_val storedValue;
+	auto ret = mdb_get(aTxn, dbi, &key, &storedValue);
+	if (ret != MDB_SUCCESS) {
+		return ret;
+	}
+
+	// Compare the full key in case of a hash collision
+	MDB_val fullKey;
+	if (!decodeEntry(key, storedValue, fullKey, value_) || fullKey.mv_size != aKeyLen || memcmp(fullKey.mv_data, aKey, aKeyLen) != 0) {
+		return MDB_NOTFOUND;
+	}
+
+	return MDB_SUCCESS;
+}
+
+void LMDB::put(void* aKey, size_t keyLen, void* aValue, size_t valueLen, DbSnapshot* /*aSnapshot*/ /*nullptr*/) {
+	totalWrites++;
+	performWrite([&](MDB_txn* aTxn) {
+		return putEntry(aTxn, aKey, keyLen, aValue, valueLen);
+	});
+}
+
+void LMDB::write(const DbWriteBatch& aBatch) {
+	totalWrites += aBatch.size();
+	performWrite([&](MDB_txn* aTxn) {
+		for (const auto& e: aBatch.getEntries()) {
+			auto ret = e.value ?
+				putEntry(aTxn, e.key.data(), e.key.size(), e.value->data(), e.value->size()) :
+				removeEntry(aTxn, e.key.data(), e.key.size());
+
+			if (ret != MDB_SUCCESS) {
+				return ret;
+			}
+		}
+
+		return MDB_SUCCESS;
+	});
+}
+
+bool LMDB::get(void* aKey, size_t keyLen, size_t /*initialValueLen*/, std::function<bool(void* aValue, size_t aValueLen)> loadF, DbSnapshot* aSnapshot /*nullptr*/) {
+	bool ret = false;
+	performRead([&](MDB_txn* aTxn) {
+		MDB_val value;
+		auto res = getEntry(aTxn, aKey, keyLen, value);
+		if (res == MDB_NOTFOUND) {
+			return;
+		}
+
+		checkDbError(res);
+
+		// The value points to the map and is valid until the transaction ends
+		ret = loadF(value.mv_data, value.mv_size);
+	}, aSnapshot);
+
+	return ret;
+}
+
+bool LMDB::hasKey(void* aKey, size_t keyLen, DbSnapshot* aSnapshot /*nullptr*/) {
+	bool ret = false;
+	performRead([&](MDB_txn* aTxn) {
+		MDB_val value;
+		auto res = getEntry(aTxn, aKey, keyLen, value);
+		if (res != MDB_NOTFOUND) {
+			checkDbError(res);
+			ret = true;
+		}
+	}, aSnapshot);
+
+	return ret;
+}
+
+void LMDB::remove(void* aKey, size_t keyLen, DbSnapshot* /*aSnapshot*/ /*nullptr*/) {
+	performWrite([&](MDB_txn* aTxn) {
+		return removeEntry(aTxn, aKey, keyLen);
+	});
+}
+
+string LMDB::getStats() {
+	MDB_stat stat;
+	MDB_envinfo info;
+	{
+		RLock l(mapCS);
+		checkDbError(mdb_env_stat(env, &stat));
+		checkDbError(mdb_env_info(env, &info));
+	}
+
+	string ret = "\r\n-=[ Stats for " + getFriendlyName() + " ]=-\n\n";
+	ret += "\r\n\r\nTotal entries: " + Util::toString(stat.ms_entries);
+	ret += "\r\nTree depth: " + Util::toString(stat.ms_depth);
+	ret += "\r\nPages (branch/leaf/overflow): " + Util::toString(stat.ms_branch_pages) + "/" + Util::toString(stat.ms_leaf_pages) + "/" + Util::toString(stat.ms_overflow_pages);
+	ret += "\r\nTotal reads: " + Util::toString(totalReads);
+	ret += "\r\nTotal Writes: " + Util::toString(totalWrites);
+	ret += "\r\nPage size: " + Util::formatBytes(static_cast<int64_t>(stat.ms_psize));
+	ret += "\r\nMap size: " + Util::formatBytes(static_cast<int64_t>(info.me_mapsize)) + " (resized " + Util::toString(mapResizes) + " times)";
+	ret += "\r\nCurrent size on disk: " + Util::formatBytes(getSizeOnDisk());
+	ret += "\r\n";
+	return ret;
+}
+
+int64_t LMDB::getSizeOnDisk() {
+	return File::getDirSize(getPath(), false);
+}
+
+size_t LMDB::size(bool /*thorough*/, DbSnapshot* aSnapshot /*nullptr*/) {
+	// Exact count is maintained by the B-tree
+	size_t ret = 0;
+	performRead([&](MDB_txn* aTxn) {
+		MDB_stat stat;
+		checkDbError(mdb_stat(aTxn, dbi, &stat));
+		ret = stat.ms_entries;
+	}, aSnapshot);
+
+	return ret;
+}
+
+DbSnapshot* LMDB::getSnapshot() {
+	return new LmdbSnapshot(*this);
+}
+
+void LMDB::forEachPrefix(void* aPrefix, size_t aPrefixLen, std::function<void(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot /*nullptr*/) {
+	performRead([&](MDB_txn* aTxn) {
+		MDB_cursor* cursor = nullptr;
+		checkDbError(mdb_cursor_open(aTxn, dbi, &cursor));
+
+		// Long keys contain only the beginning of the original key
+		auto searchLen = min(aPrefixLen, maxKeySize - TigerHash::BYTES);
+		MDB_val key{ searchLen, aPrefix };
+		MDB_val value;
+
+		try {
+			// Empty keys can't be used for positioning
+			auto ret = mdb_cursor_get(cursor, &key, &value, searchLen > 0 ? MDB_SET_RANGE : MDB_FIRST);
+			for (; ret != MDB_NOTFOUND; ret = mdb_cursor_get(cursor, &key, &value, MDB_NEXT)) {
+				checkDbError(ret);
+				if (key.mv_size < searchLen || memcmp(key.mv_data, aPrefix, searchLen) != 0) {
+					break;
+				}
+
+				MDB_val entryKey, entryValue;
+				if (!decodeEntry(key, value, entryKey, entryValue) || entryKey.mv_size < aPrefixLen || memcmp(entryKey.mv_data, aPrefix, aPrefixLen) != 0) {
+					continue;
+				}
+
+				f(entryKey.mv_data, entryKey.mv_size, entryValue.mv_data, entryValue.mv_size);
+			}
+		} catch (...) {
+			mdb_cursor_close(cursor);
+			throw;
+		}
+
+		mdb_cursor_close(cursor);
+	}, aSnapshot);
+}
+
+void LMDB::forEachFrom(void* aKey, size_t aKeyLen, std::function<bool(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot /*nullptr*/) {
+	performRead([&](MDB_txn* aTxn) {
+		MDB_cursor* cursor = nullptr;
+		checkDbError(mdb_cursor_open(aTxn, dbi, &cursor));
+
+		// Long keys contain only the beginning of the original key, skip the ones preceding the start key
+		auto searchLen = min(aKeyLen, maxKeySize - TigerHash::BYTES);
+		MDB_val key{ searchLen, aKey };
+		MDB_val value;
+
+		try {
+			auto ret = mdb_cursor_get(cursor, &key, &value, searchLen > 0 ? MDB_SET_RANGE : MDB_FIRST);
+			for (; ret != MDB_NOTFOUND; ret = mdb_cursor_get(cursor, &key, &value, MDB_NEXT)) {
+				checkDbError(ret);
+
+				MDB_val entryKey, entryValue;
+				if (!decodeEntry(key, value, entryKey, entryValue) || string_view(static_cast<const char*>(entryKey.mv_data), entryKey.mv_size) < string_view(static_cast<const char*>(aKey), aKeyLen)) {
+					continue;
+				}
+
+				if (!f(entryKey.mv_data, entryKey.mv_size, entryValue.mv_data, entryValue.mv_size)) {
+					break;
+				}
+			}
+		} catch (...) {
+			mdb_cursor_close(cursor);
+			throw;
+		}
+
+		mdb_cursor_close(cursor);
+	}, aSnapshot);
+}
+
+void LMDB::remove_if(std::function<bool(void* aKey, size_t key_len, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot /*nullptr*/) {
+	// Collect the keys first so that the write transaction won't block other writers while the callback is being run
+	DbWriteBatch batch;
+	forEachPrefix(nullptr, 0, [&](void* aKey, size_t aKeyLen, void* aValue, size_t aValueLen) {
+		if (f(aKey, aKeyLen, aValue, aValueLen)) {
+			batch.remove(string(static_cast<const char*>(aKey), aKeyLen));
+		}
+	}, aSnapshot);
+
+	if (!batch.empty()) {
+		write(batch);
+	}
+}
+
+void LMDB::checkDbError(int aRet) {
+	if (aRet == MDB_SUCCESS || aRet == MDB_NOTFOUND)
+		return;
+
+	if (aRet == MDB_BAD_VALSIZE) {
+		// Retrying won't help
+		throw DbException(mdb_strerror(aRet), DB_ERROR_INVALID_DATA);
+	}
+
+	throw DbException(mdb_strerror(aRet));
+}
+
+} //dcpp
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+
+#ifndef DCPLUSPLUS_DCPP_LMDB_H_
+#define DCPLUSPLUS_DCPP_LMDB_H_
+
+#include <airdcpp/core/io/db/DbHandler.h>
+#include <airdcpp/core/thread/CriticalSection.h>
+
+#include <lmdb.h>
+
+namespace dcpp {
+
+// Memory mapped B-tree database
+// Reads are served directly from the OS page cache, the cache size isn't used
+class LMDB : public DbHandler {
+public:
+	DbSnapshot* getSnapshot();
+
+	LMDB(const string& aPath, const string& aFriendlyName, uint64_t cacheSize);
+	~LMDB();
+
+	void put(void* aKey, size_t keyLen, void* aValue, size_t valueLen, DbSnapshot* aSnapshot /*nullptr*/);
+	bool get(void* aKey, size_t keyLen, size_t /*initialValueLen*/, std::function<bool(void* aValue, size_t aValueLen)> loadF, DbSnapshot* aSnapshot /*nullptr*/);
+	void remove(void* aKey, size_t keyLen, DbSnapshot* aSnapshot /*nullptr*/);
+	bool hasKey(void* aKey, size_t keyLen, DbSnapshot* aSnapshot /*nullptr*/);
+	void write(const DbWriteBatch& aBatch);
+
+	string getStats();
+
+	size_t size(bool /*thorough*/, DbSnapshot* aSnapshot /*nullptr*/);
+	int64_t getSizeOnDisk();
+
+	void remove_if(std::function<bool(void* aKey, size_t key_len, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot /*nullptr*/);
+	void forEachPrefix(void* aPrefix, size_t aPrefixLen, std::function<void(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot /*nullptr*/);
+	void forEachFrom(void* aKey, size_t aKeyLen, std::function<bool(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot /*nullptr*/);
+	void repair(StepFunction stepF, MessageFunction messageF);
+	void open(StepFunction stepF, MessageFunction messageF);
+private:
+	// Read transaction that is kept open
+	class LmdbSnapshot : public DbSnapshot {
+	public:
+		LmdbSnapshot(LMDB& aDb);
+		~LmdbSnapshot();
+
+		MDB_txn* txn = nullptr;
+	private:
+		// The map can't be resized while the transaction is open
+		LMDB& db;
+	};
+
+	string getRepairFlag() const;
+
+	// Runs the function in a write transaction
+	// The map is grown and the transaction is retried if the database runs out of space
+	void performWrite(const std::function<int(MDB_txn*)>& f);
+
+	// Runs the function in a read transaction (or inside the snapshot)
+	void performRead(const std::function<void(MDB_txn*)>& f, DbSnapshot* aSnapshot);
+
+	void growMap();
+	void checkDbError(int aRet);
+
+	// Keys that exceed the maximum key size of LMDB (511 bytes by default) are stored as the beginning of the key followed
+	// by a hash of the whole key, and the whole key is stored in front of the value
+	// Stored keys having the maximum length are always in this format
+	bool isLongKey(size_t aKeyLen) const noexcept { return aKeyLen >= maxKeySize; }
+	string getLongKey(const void* aKey, size_t aKeyLen) const noexcept;
+	static string encodeLongValue(const void* aKey, size_t aKeyLen, const void* aValue, size_t aValueLen) noexcept;
+
+	// Returns the original key and value of a stored entry
+	// Returns false for long keys with invalid values
+	bool decodeEntry(const MDB_val& aKey, const MDB_val& aValue, MDB_val& key_, MDB_val& value_) const noexcept;
+
+	// Entry operations inside a transaction (the keys are converted when needed)
+	int putEntry(MDB_txn* aTxn, const void* aKey, size_t aKeyLen, const void* aValue, size_t aValueLen);
+	int removeEntry(MDB_txn* aTxn, const void* aKey, size_t aKeyLen);
+	int getEntry(MDB_txn* aTxn, const void* aKey, size_t aKeyLen, MDB_val& value_);
+
+	MDB_env* env = nullptr;
+	MDB_dbi dbi = 0;
+	size_t mapSize = 0;
+	size_t maxKeySize = 0;
+
+	// Transactions hold a read lock while they are running, resizing the map requires exclusive access
+	// Snapshots don't hold the lock, the map isn't resized while they are open
+	SharedMutex mapCS;
+	atomic<int> openSnapshots = 0;
+
+	uint64_t totalReads = 0;
+	uint64_t totalWrites = 0;
+	uint64_t mapResizes = 0;
+};
+
+} //dcpp
+
+#endif
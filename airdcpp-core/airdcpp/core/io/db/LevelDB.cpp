@@ -177,6 +177,22 @@ void LevelDB::remove(void* aKey, size_t keyLen, DbSnapshot* /*aSnapshot*/ /*null
 	DBACTION(db->Delete(writeoptions, key));
 }
 
+void LevelDB::write(const DbWriteBatch& aBatch) {
+	leveldb::WriteBatch wb;
+	for (const auto& e: aBatch.getEntries()) {
+		if (e.value) {
+			wb.Put(e.key, *e.value);
+		} else {
+			wb.Delete(e.key);
+		}
+	}
+
+	totalWrites += aBatch.size();
+
+	// A single synced write for the whole batch
+	DBACTION(db->Write(writeoptions, &wb));
+}
+
 int64_t LevelDB::getSizeOnDisk() {
 	return File::getDirSize(getPath(), false);
 }
@@ -228,6 +244,36 @@ void LevelDB::remove_if(std::function<bool(void* aKey, size_t key_len, void* aVa
 	DBACTION(db->Write(writeoptions, &wb));
 }
 
+void LevelDB::forEachPrefix(void* aPrefix, size_t aPrefixLen, std::function<void(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot /*nullptr*/) {
+	leveldb::ReadOptions options;
+	options.fill_cache = false;
+	if (aSnapshot)
+		options.snapshot = static_cast<LevelSnapshot*>(aSnapshot)->snapshot;
+
+	leveldb::Slice prefix((const char*)aPrefix, aPrefixLen);
+
+	auto it = unique_ptr<leveldb::Iterator>(db->NewIterator(options));
+	for (it->Seek(prefix); it->Valid() && it->key().starts_with(prefix); it->Next()) {
+		checkDbError(it->status());
+		f((void*)it->key().data(), it->key().size(), (void*)it->value().data(), it->value().size());
+	}
+}
+
+void LevelDB::forEachFrom(void* aKey, size_t aKeyLen, std::function<bool(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot /*nullptr*/) {
+	leveldb::ReadOptions options;
+	options.fill_cache = false;
+	if (aSnapshot)
+		options.snapshot = static_cast<LevelSnapshot*>(aSnapshot)->snapshot;
+
+	auto it = unique_ptr<leveldb::Iterator>(db->NewIterator(options));
+	for (it->Seek(leveldb::Slice((const char*)aKey, aKeyLen)); it->Valid(); it->Next()) {
+		checkDbError(it->status());
+		if (!f((void*)it->key().data(), it->key().size(), (void*)it->value().data(), it->value().size())) {
+			break;
+		}
+	}
+}
+
 // free up some space, https://code.google.com/p/leveldb/issues/detail?id=158
 // LevelDB will perform some kind of compaction on every startup but it's not as comprehensive as manual one
 // The issue has been "fixed" in version 1.13 but it still won't match the manual one (possibly because only ranges that are iterated
@@ -40,6 +40,7 @@ public:
 	bool get(void* aKey, size_t keyLen, size_t /*initialValueLen*/, std::function<bool(void* aValue, size_t aValueLen)> loadF, DbSnapshot* aSnapshot /*nullptr*/);
 	void remove(void* aKey, size_t keyLen, DbSnapshot* aSnapshot /*nullptr*/);
 	bool hasKey(void* aKey, size_t keyLen, DbSnapshot* aSnapshot /*nullptr*/);
+	void write(const DbWriteBatch& aBatch);
 
 	string getStats();
 
@@ -47,6 +48,8 @@ public:
 	int64_t getSizeOnDisk();
 
 	void remove_if(std::function<bool(void* aKey, size_t key_len, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot /*nullptr*/);
+	void forEachPrefix(void* aPrefix, size_t aPrefixLen, std::function<void(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot /*nullptr*/);
+	void forEachFrom(void* aKey, size_t aKeyLen, std::function<bool(void* aKey, size_t keyLen, void* aValue, size_t valueLen)> f, DbSnapshot* aSnapshot /*nullptr*/);
 	void compact();
 	void repair(StepFunction stepF, MessageFunction messageF);
 	void open(StepFunction stepF, MessageFunction messageF);
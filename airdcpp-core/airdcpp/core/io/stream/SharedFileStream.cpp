@@ -27,17 +27,34 @@
 
 namespace dcpp {
 
-CriticalSection SharedFileStream::cs;
-SharedFileStream::SharedFileHandleMap SharedFileStream::readpool;
-SharedFileStream::SharedFileHandleMap SharedFileStream::writepool;
+SharedFileStream::PoolShard SharedFileStream::shards[SharedFileStream::POOL_SHARDS];
+SharedFileStream::Stats SharedFileStream::stats;
 
 SharedFileHandle::SharedFileHandle(const string& aPath, int aAccess, int aMode) : 
-	File(aPath, aAccess, aMode), ref_cnt(1), path(aPath), mode(aMode)
+	File(aPath, aAccess, aMode), ref_cnt(1), path(aPath), access(aAccess)
 { }
 
+SharedFileStream::PoolShard& SharedFileStream::getShard(const string& aPath) noexcept {
+	return shards[noCaseStringHash()(aPath) % POOL_SHARDS];
+}
+
+std::unique_lock<std::mutex> SharedFileStream::lockShard(PoolShard& aShard) noexcept {
+	stats.poolLocks++;
+
+	std::unique_lock<std::mutex> l(aShard.cs, std::try_to_lock);
+	if (!l.owns_lock()) {
+		stats.poolContentions++;
+		l.lock();
+	}
+
+	return l;
+}
+
 SharedFileStream::SharedFileStream(const string& aFileName, int aAccess, int aMode) {
-	Lock l(cs);
-	auto& pool = aAccess == File::READ ? readpool : writepool;
+	auto& shard = getShard(aFileName);
+	auto l = lockShard(shard);
+
+	auto& pool = aAccess == File::READ ? shard.readpool : shard.writepool;
 	auto p = pool.find(aFileName);
 	if (p != pool.end()) {
 		sfh = p->second.get();
@@ -45,41 +62,43 @@ SharedFileStream::SharedFileStream(const string& aFileName, int aAccess, int aMo
 	} else {
 	    sfh = new SharedFileHandle(aFileName, aAccess, aMode);
 		pool[aFileName] = unique_ptr<SharedFileHandle>(sfh);
+		stats.openHandles++;
 	}
 }
 
 SharedFileStream::~SharedFileStream() {
-	Lock l(cs);
+	auto& shard = getShard(sfh->path);
+	auto l = lockShard(shard);
 
 	sfh->ref_cnt--;
 	if(sfh->ref_cnt == 0) {
-		auto& pool = sfh->mode == File::READ ? readpool : writepool;
+		auto& pool = sfh->access == File::READ ? shard.readpool : shard.writepool;
 		pool.erase(sfh->path);
+		stats.openHandles--;
     }
 }
 
 size_t SharedFileStream::write(const void* buf, size_t len) {
-	Lock l(sfh->cs);
+	sfh->writeAt(buf, len, pos);
 
-	sfh->setPos(pos);
-	sfh->write(buf, len);
+	stats.writes++;
+	stats.bytesWritten += len;
 
     pos += len;
 	return len;
 }
 
 size_t SharedFileStream::read(void* buf, size_t& len) {
-	Lock l(sfh->cs);
+	len = sfh->readAt(buf, len, pos);
 
-	sfh->setPos(pos);
-	len = sfh->read(buf, len);
+	stats.reads++;
+	stats.bytesRead += len;
 
     pos += len;
 	return len;
 }
 
 int64_t SharedFileStream::getSize() const noexcept {
-	Lock l(sfh->cs);
 	return sfh->getSize();
 }
 
@@ -89,7 +108,6 @@ void SharedFileStream::setSize(int64_t newSize) {
 }
 
 size_t SharedFileStream::flushBuffers(bool aForce) {
-	Lock l(sfh->cs);
 	return sfh->flushBuffers(aForce);
 }
 
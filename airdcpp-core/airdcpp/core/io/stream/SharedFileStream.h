@@ -30,10 +30,11 @@ struct SharedFileHandle : File {
 	SharedFileHandle(const string& aPath, int access, int mode);
 	~SharedFileHandle() noexcept = default;
 
+	// Only needed for resizing, reads and writes are positional
 	CriticalSection cs;
 	int	ref_cnt;
 	string path;
-	int mode;
+	int access;
 };
 
 class SharedFileStream : public IOStream
@@ -42,6 +43,19 @@ class SharedFileStream : public IOStream
 public:
 	using SharedFileHandleMap = unordered_map<string, unique_ptr<SharedFileHandle>, noCaseStringHash, noCaseStringEq>;
 
+	struct Stats {
+		atomic<uint64_t> reads { 0 };
+		atomic<uint64_t> writes { 0 };
+		atomic<uint64_t> bytesRead { 0 };
+		atomic<uint64_t> bytesWritten { 0 };
+
+		// Handle pool lookups and the ones that had to wait for another thread
+		atomic<uint64_t> poolLocks { 0 };
+		atomic<uint64_t> poolContentions { 0 };
+
+		atomic<uint64_t> openHandles { 0 };
+	};
+
     SharedFileStream(const string& aFileName, int access, int mode);
     ~SharedFileStream() override;
 
@@ -53,16 +67,31 @@ public:
 
 	size_t flushBuffers(bool aForce) override;
 
-    static CriticalSection cs;
-	static SharedFileHandleMap readpool;
-	static SharedFileHandleMap writepool;
-
 	void setPos(int64_t aPos) noexcept override;
+
+	static const Stats& getStats() noexcept {
+		return stats;
+	}
 private:
+	// The handle pools are split by the path hash so that opening different files won't serialize on a single lock
+	static const size_t POOL_SHARDS = 16;
+
+	struct PoolShard {
+		std::mutex cs;
+		SharedFileHandleMap readpool;
+		SharedFileHandleMap writepool;
+	};
+
+	static PoolShard& getShard(const string& aPath) noexcept;
+	static std::unique_lock<std::mutex> lockShard(PoolShard& aShard) noexcept;
+
+	static PoolShard shards[POOL_SHARDS];
+	static Stats stats;
+
 	SharedFileHandle* sfh;
-	int64_t pos;
+	int64_t pos = 0;
 };
 
 }
 
-#endif	// _SHAREDFILESTREAM_H
\ No newline at end of file
+#endif	// _SHAREDFILESTREAM_H
@@ -79,6 +79,18 @@ public:
 	virtual void setPos(int64_t /*pos*/) noexcept { }
 	virtual InputStream* releaseRootStream() { return this; }
 	virtual int64_t getSize() const noexcept = 0;
+
+#ifndef _WIN32
+	/**
+		* Used for transferring the data directly from the underlying file descriptor (e.g. with sendfile).
+		* @param maxBytes_ Number of bytes that may be read from the descriptor, -1 if there is no limit
+		* @return False if the stream doesn't read the data as such from a file
+		*/
+	virtual bool getDirectSource(int& /*fd_*/, int64_t& /*pos_*/, int64_t& /*maxBytes_*/) noexcept { return false; }
+
+	/* Advances the stream after aBytes have been consumed directly from the source */
+	virtual void onDirectRead(int64_t /*aBytes*/) noexcept { }
+#endif
 };
 
 class IOStream : public InputStream, public OutputStream {
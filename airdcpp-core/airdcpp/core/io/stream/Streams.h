@@ -119,6 +119,22 @@ public:
 	int64_t getSize() const noexcept override {
 		return s->getSize();
 	}
+
+#ifndef _WIN32
+	bool getDirectSource(int& fd_, int64_t& pos_, int64_t& maxBytes_) noexcept override {
+		if (!s->getDirectSource(fd_, pos_, maxBytes_)) {
+			return false;
+		}
+
+		maxBytes_ = maxBytes_ == -1 ? maxBytes : min(maxBytes, maxBytes_);
+		return true;
+	}
+
+	void onDirectRead(int64_t aBytes) noexcept override {
+		maxBytes -= aBytes;
+		s->onDirectRead(aBytes);
+	}
+#endif
 private:
 	unique_ptr<InputStream> s;
 	int64_t maxBytes;
@@ -672,6 +672,7 @@ enum Strings { // @DontAdd
 	LEAVE_OTHER_PROFILES, // "Remove only from the current profile"
 	LEFT, // "left"
 	LEFT_COLOR, // "Left color"
+	LEVELDB, // "LevelDB"
 	LEVEL_UP, // "Up one level"
 	LIB_CRASH, // "Application ""%s"" caused an unhandled exception in AirDC++. Please uninstall it, upgrade it or use an alternate product."
 	LIMIT, // "Upload limit"
@@ -688,6 +689,7 @@ enum Strings { // @DontAdd
 	LIST_SIZE_DIFF_NOTE, // "The share size in hub %1% (%2%) is different than in the current hub %3% (%4%). Do you want to reload the list?"
 	LIST_TEXTSTYLE, // "Font used in list views (User list, Search, Queue, Transfers...)"
 	LIST_VIEW_COLORS, // "List view colors"
+	LMDB, // "LMDB"
 	LOADING, // "Loading AirDC++, please wait..."
 	LOADING_FILE_LIST, // "Loading file list, this may take a while if the list is large."
 	LOADING_GUI, // "Loading the user interface"
@@ -758,6 +760,7 @@ enum Strings { // @DontAdd
 	MAX_CHAT_RESIZE_LINES, // "Max lines to resize the message box on multiline messages"
 	MAX_DL_SPEED_REACHED, // "Wanted total download speed reached"
 	MAX_DOWNLOAD_RATE, // "Maximum download rate (0 = infinite)"
+	MAX_FILE_HASHING_THREADS, // "Number of hashing threads per file (large files only)"
 	MAX_HASHING_THREADS, // "Maximum number of hashing threads"
 	MAX_HUBS, // "Max hubs"
 	MAX_LOG_LINES, // "Max view history lines"
@@ -832,6 +835,7 @@ enum Strings { // @DontAdd
 	MESSAGES_SENT_THROUGH_REMOTE, // "Messages are now sent through the hub %1% (changed by the remote users)"
 	MESSAGE_SEEN, // "Message seen"
 	MIDNIGHT, // "Midnight"
+	MILLISECONDS_LOWER, // "milliseconds"
 	MINIMUM_LEN, // "Minimum length"
 	MINIMUM_SEARCH_INTERVAL, // "Minimum search interval"
 	MINIMUM_UPDATE_INTERVAL_MIN, // "Minimum update interval (in minutes)"
@@ -846,6 +850,11 @@ enum Strings { // @DontAdd
 	MODE_V4, // "Mode (IPv4)"
 	MODE_V6, // "Mode (IPv6)"
 	MONDAY, // "Monday"
+	MONITORING_ALL_DIRECTORIES, // "All shared directories"
+	MONITORING_INCOMING_ONLY, // "Incoming directories only"
+	MONITORING_NOT_SUPPORTED, // "Monitoring of file system changes isn't supported on this platform"
+	MONITORING_ROOT_REMOVED, // "The directory was removed or moved"
+	MONITORING_WATCH_LIMIT_REACHED, // "Limit of watched directories was reached (see fs.inotify.max_user_watches)"
 	MONTH, // "Month"
 	MONTHS, // "Months"
 	MORE_INFORMATION, // "More information..."
@@ -1109,6 +1118,8 @@ enum Strings { // @DontAdd
 	REFRESHING_SHARE, // "Refreshing share"
 	REFRESH_FILE_LIST, // "Refresh file list"
 	REFRESH_IN_SHARE, // "Refresh in share"
+	REFRESH_MODIFICATION_DATE, // "Modification date"
+	REFRESH_MODIFICATION_DATE_STRICT, // "Modification date, change date and file ID"
 	REFRESH_OPTIONS, // "Refreshing options"
 	REFRESH_QUEUED, // "File list refresh has been queued"
 	REGEXP, // "Regexp"
@@ -1315,6 +1326,7 @@ enum Strings { // @DontAdd
 	SETTINGS_COUNTRY_FORMAT_HELP, // "This box allows customization of the way user country information is displayed throughout the interface. Default: %1% \r\n\r\n  Available variables: \r\n  %%[2code] gets replaced by a 2-letters country code (eg DE, FR). \r\n  %%[3code] gets replaced by a 3-letters country code (eg DEU, FRA). \r\n  %%[continent] gets replaced by a continent code (AF, AS, EU, NA, OC, SA for Africa, Asia, Europe, North America, Oceania and South America). \r\n  %%[engname] gets replaced by the English country friendly name (eg Germany, France). \r\n  %%[name] gets replaced by the localized country friendly name (eg Germany, France on an English operating system). \r\n  %%[officialname] gets replaced by the localized country official name (eg Federal Republic of Germany, French Republic on an English operating system)."
 	SETTINGS_COUNTRY_FORMAT_HELP_DESC, // "Country format help"
 	SETTINGS_CZDC_EXTRA_DOWNLOADS, // "Highest priority extra download slots"
+	SETTINGS_DB_BACKEND, // "Hash database backend (the existing data is imported on next startup)"
 	SETTINGS_DB_REPAIR, // "Verify and repair the hash database on next startup\n(use in case of fatal errors only)"
 	SETTINGS_DEFAULT_AWAY_MSG, // "Default away message"
 	SETTINGS_DELAY_HOURS, // "Hours to search for PROPER when using incrementation"
@@ -1386,6 +1398,8 @@ enum Strings { // @DontAdd
 	SETTINGS_MINIMIZE_ON_STARTUP, // "Minimize at program startup"
 	SETTINGS_MINIMIZE_TRAY, // "Minimize to tray"
 	SETTINGS_MISC, // "Miscellaneous"
+	SETTINGS_MONITORING_DELAY, // "Delay for applying file system changes to share"
+	SETTINGS_MONITORING_MODE, // "Monitor shared directories for changes"
 	SETTINGS_MOUSE_OVER, // "Mouse over"
 	SETTINGS_NETWORK, // "Connection settings"
 	SETTINGS_NMDC_MAGNET_WARNING, // "Warn me about sending files in private chat via NMDC hubs"
@@ -1423,6 +1437,7 @@ enum Strings { // @DontAdd
 	SETTINGS_PUBLIC_HUB_LIST_URL, // "Public hubs list URL"
 	SETTINGS_QUEUE, // "Queue"
 	SETTINGS_RECENT_HOURS, // "Maximum age for a bundle to consider it as recent"
+	SETTINGS_REFRESH_SKIP_UNCHANGED, // "Skip content scan for unchanged directories (not used for manual refreshes)"
 	SETTINGS_REPORT_ADDED_SOURCES, // "Show added bundle sources"
 	SETTINGS_REQUIRES_RESTART, // "Note; most of these options require that you restart AirDC++"
 	SETTINGS_RESET, // "Reset"
@@ -1451,6 +1466,7 @@ enum Strings { // @DontAdd
 	SETTINGS_SKIPPING_OPTIONS, // "Skipping options"
 	SETTINGS_SOCKET_IN_BUFFER, // "Socket read buffer (0 = system default)"
 	SETTINGS_SOCKET_OUT_BUFFER, // "Socket write buffer (0 = system default)"
+	SETTINGS_SOCKET_REACTOR_THREADS, // "Shared connection threads (0 = use a separate thread for each connection)"
 	SETTINGS_SOCKS5, // "SOCKS5"
 	SETTINGS_SOCKS5_IP, // "Socks IP"
 	SETTINGS_SOCKS5_RESOLVE, // "Use SOCKS5 server to resolve host names"
@@ -1494,6 +1510,7 @@ enum Strings { // @DontAdd
 	SETTINGS_WRITE_BUFFER, // "Write buffer size"
 	SETTINGS_WTOOLBAR_SIZE, // "Media toolbar icon size"
 	SETTINGS_ZDC_PROGRESS_OVERRIDE, // "Override system colors"
+	SETTINGS_ZERO_COPY_UPLOADS, // "Send uploaded files directly from the disk cache (no encryption or kernel TLS required)"
 	SETTING_FILE_RECOVERED, // "Settings were recovered from the file %1% that was saved on %2%. The corrupted file has been renamed to %3% (it can safely be removed). Some recent changes may have been lost."
 	SETTING_DONT_DL_ALREADY_QUEUED, // "Don't download files already in queue"
 	SETTING_NAME_X, // "Setting name: %1%"
@@ -1519,6 +1536,7 @@ enum Strings { // @DontAdd
 	SHARE_FILES_BLOCKED, // "Some of the files from directory %1% won't be shared: %2%"
 	SHARE_DIRECTORY_BLOCKED, // "Directory %1% won't be shared: %2%"
 	SHARE_HIDDEN, // "Share hidden"
+	SHARE_MONITORING_FAILED, // "Failed to monitor the directory %1% for changes: %2%"
 	SHARE_PROFILE, // "Share profile"
 	SHARE_PROFILES, // "Share profiles"
 	SHELL_MENU, // "Shell menu"
@@ -1874,6 +1892,7 @@ enum Strings { // @DontAdd
 	WEB_CFG_IDLE_TIMEOUT, // "Default session inactivity timeout"
 	WEB_CFG_PING_INTERVAL, // "Socket ping interval"
 	WEB_CFG_PING_TIMEOUT, // "Socket ping timeout"
+	WEB_CFG_EVENT_BATCH_WINDOW, // "Socket event batching window"
 	WEB_CFG_EXTENSIONS_DEBUG_MODE, // "Run extensions in debug mode"
 	WEB_CFG_EXTENSIONS_INIT_TIMEOUT, // "Initialization timeout for extensions"
 	WEB_CFG_EXTENSIONS_AUTO_UPDATE, // "Update extensions automatically"
@@ -1882,6 +1901,7 @@ enum Strings { // @DontAdd
 	WEB_CFG_SHARE_DIRECTORY_VALIDATION_HOOK_TIMEOUT, // "Share directory validation"
 	WEB_CFG_NEW_SHARE_FILE_VALIDATION_HOOK_TIMEOUT, // "New share file validation"
 	WEB_CFG_NEW_SHARE_DIRECTORY_VALIDATION_HOOK_TIMEOUT, // "New share directory validation"
+	WEB_CFG_SHARE_FILE_BATCH_VALIDATION_HOOK_TIMEOUT, // "Share file batch validation"
 
 	WEB_CFG_OUTGOING_CHAT_MESSAGE_HOOK_TIMEOUT, // "Outgoing chat message"
 	WEB_CFG_INCOMING_CHAT_MESSAGE_HOOK_TIMEOUT, // "Incoming chat message"
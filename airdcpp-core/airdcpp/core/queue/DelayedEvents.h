@@ -32,18 +32,28 @@ struct DelayTask {
 	DelayedF f;
 };
 
+// Each pending event has a timer deadline, which is moved forward when the event is postponed
+// The events are run in the background thread of the timer
 template<class T>
-class DelayedEvents : private TimerManagerListener {
+class DelayedEvents {
 public:
 	using List = unordered_map<T, unique_ptr<DelayTask>>;
 
-	DelayedEvents() { 
-		TimerManager::getInstance()->addListener(this);
-	}
+	DelayedEvents() = default;
+
+	~DelayedEvents() {
+		set<TimerTaskId> pendingDeadlines;
 
-	~DelayedEvents() override {
-		TimerManager::getInstance()->removeListener(this);
-		clear();
+		{
+			Lock l(cs);
+			eventList.clear();
+			pendingDeadlines.swap(deadlines);
+		}
+
+		// Wait for the running callbacks
+		for (const auto& id: pendingDeadlines) {
+			TimerManager::getInstance()->removeTask(id);
+		}
 	}
 
 	bool runTask(const T& aKey) {
@@ -64,32 +74,17 @@ public:
 		return true;
 	}
 
-	void on(TimerManagerListener::Second, uint64_t aTick) noexcept override {
-		vector<T> taskKeys;
-
-		{
-			Lock l(cs);
-			for (const auto& i: eventList) {
-				if (aTick > i.second->runTick) {
-					taskKeys.push_back(i.first);
-				}
-			}
-		}
-
-		for (const auto& k: taskKeys) {
-			runTask(k);
-		}
-	}
-
 	void addEvent(const T& aKey, DelayedF f, uint64_t aDelayTicks) {
 		Lock l(cs);
 
 		if (auto i = eventList.find(aKey); i != eventList.end()) {
+			// The deadline will be moved when it expires
 			i->second.get()->runTick = GET_TICK() + aDelayTicks;
 			return;
 		}
 
-		eventList.emplace(aKey, make_unique<DelayTask>(f, GET_TICK() + aDelayTicks));
+		auto task = eventList.emplace(aKey, make_unique<DelayTask>(f, GET_TICK() + aDelayTicks)).first->second.get();
+		addDeadlineUnsafe(aKey, task, aDelayTicks);
 	}
 
 	void clear() {
@@ -107,9 +102,50 @@ public:
 		return false;
 	}
 private:
+	void addDeadlineUnsafe(const T& aKey, const DelayTask* aTask, uint64_t aDelayTicks) noexcept {
+		auto tm = TimerManager::getInstance();
+
+		// The callback reads the ID while holding the lock
+		auto id = make_shared<TimerTaskId>(0);
+		*id = tm->addDeadline("Delayed event", aDelayTicks, [this, aKey, aTask, id](uint64_t aTick) {
+			onDeadline(aKey, aTask, id, aTick);
+		}, tm->getBackgroundExecutor());
+
+		deadlines.insert(*id);
+	}
+
+	void onDeadline(const T& aKey, const DelayTask* aTask, const shared_ptr<TimerTaskId>& aId, uint64_t aTick) noexcept {
+		auto run = false;
+
+		{
+			Lock l(cs);
+
+			// Skip events that have been removed (and possibly added again with a new deadline)
+			auto i = eventList.find(aKey);
+			if (i != eventList.end() && i->second.get() == aTask) {
+				if (aTick < aTask->runTick) {
+					// Postponed
+					addDeadlineUnsafe(aKey, aTask, aTask->runTick - aTick);
+				} else {
+					run = true;
+				}
+			}
+		}
+
+		if (run) {
+			runTask(aKey);
+		}
+
+		// Removed only after the event has been run so that the destructor will wait for it
+		Lock l(cs);
+		deadlines.erase(*aId);
+	}
 
 	CriticalSection cs;
 	List eventList;
+
+	// Deadlines that haven't been run yet
+	set<TimerTaskId> deadlines;
 };
 
 } // namespace dcpp
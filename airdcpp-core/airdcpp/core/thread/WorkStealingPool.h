@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_WORK_STEALING_POOL_H
+#define DCPLUSPLUS_DCPP_WORK_STEALING_POOL_H
+
+#include <airdcpp/core/header/typedefs.h>
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace dcpp {
+
+// Runs recursively spawned tasks with a fixed number of workers
+//
+// Each worker has its own task queue. New tasks are added in the queue of the worker that spawned them and
+// the worker takes the most recently added task first (depth-first order). Idle workers steal the oldest
+// tasks from the other queues, which are usually the ones representing the largest amount of work.
+//
+// The pool is meant for a single run, the calling thread is used as the first worker.
+template<class T>
+class WorkStealingPool {
+public:
+	// Handler receives the index of the worker running the task (it can be used for accessing per-worker data)
+	using TaskF = std::function<void(T& aTask, size_t aWorker)>;
+
+	explicit WorkStealingPool(size_t aWorkerCount) : queues(std::max<size_t>(aWorkerCount, 1)) { }
+
+	size_t getWorkerCount() const noexcept {
+		return queues.size();
+	}
+
+	// Adds a task in the queue of the worker
+	// Safe to call only before the pool is started or from the task handler of the same worker
+	void push(size_t aWorker, T&& aTask) noexcept {
+		pending++;
+
+		{
+			auto& queue = queues[aWorker];
+			std::lock_guard<std::mutex> l(queue.mutex);
+			queue.tasks.push_back(std::move(aTask));
+		}
+
+		{
+			// Idle workers check the counter while holding the lock
+			std::lock_guard<std::mutex> l(idleMutex);
+			pushCount++;
+		}
+
+		taskAdded.notify_one();
+	}
+
+	// Runs until all tasks (including the ones spawned by the tasks) have been completed
+	// Exceptions thrown by the handler are rethrown after all workers have stopped (no new tasks are run after that)
+	void run(const TaskF& aTaskF) {
+		vector<std::thread> threads;
+		for (size_t i = 1; i < queues.size(); ++i) {
+			threads.emplace_back([this, i, &aTaskF] {
+				runWorker(i, aTaskF);
+			});
+		}
+
+		runWorker(0, aTaskF);
+
+		for (auto& t: threads) {
+			t.join();
+		}
+
+		if (exception) {
+			std::rethrow_exception(exception);
+		}
+	}
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+private:
+	struct Queue {
+		std::mutex mutex;
+		deque<T> tasks;
+	};
+
+	bool pop(size_t aWorker, T& task_) noexcept {
+		{
+			auto& own = queues[aWorker];
+			std::lock_guard<std::mutex> l(own.mutex);
+			if (!own.tasks.empty()) {
+				task_ = std::move(own.tasks.back());
+				own.tasks.pop_back();
+				return true;
+			}
+		}
+
+		for (size_t i = 1; i < queues.size(); ++i) {
+			auto& victim = queues[(aWorker + i) % queues.size()];
+			std::lock_guard<std::mutex> l(victim.mutex);
+			if (!victim.tasks.empty()) {
+				task_ = std::move(victim.tasks.front());
+				victim.tasks.pop_front();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void runWorker(size_t aWorker, const TaskF& aTaskF) noexcept {
+		T task;
+		for (;;) {
+			uint64_t seenPushes;
+			{
+				std::lock_guard<std::mutex> l(idleMutex);
+				seenPushes = pushCount;
+			}
+
+			if (pop(aWorker, task)) {
+				if (!failed) {
+					try {
+						aTaskF(task, aWorker);
+					} catch (...) {
+						std::lock_guard<std::mutex> l(idleMutex);
+						if (!exception) {
+							exception = std::current_exception();
+						}
+
+						failed = true;
+					}
+				}
+
+				// Spawned tasks have been counted already
+				if (--pending == 0) {
+					{
+						std::lock_guard<std::mutex> l(idleMutex);
+					}
+
+					taskAdded.notify_all();
+				}
+
+				continue;
+			}
+
+			// Nothing to steal, wait until new tasks are added or everything has been completed
+			std::unique_lock<std::mutex> l(idleMutex);
+			taskAdded.wait(l, [&] {
+				return pending == 0 || pushCount != seenPushes;
+			});
+
+			if (pending == 0) {
+				return;
+			}
+		}
+	}
+
+	vector<Queue> queues;
+
+	// Tasks that have been added but not completed
+	atomic<size_t> pending = 0;
+	atomic<bool> failed = false;
+
+	std::mutex idleMutex;
+	std::condition_variable taskAdded;
+	uint64_t pushCount = 0;
+	std::exception_ptr exception;
+};
+
+} // namespace dcpp
+
+#endif // DCPLUSPLUS_DCPP_WORK_STEALING_POOL_H
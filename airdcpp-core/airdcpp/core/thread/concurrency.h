@@ -35,6 +35,8 @@ using tbb::concurrent_queue;
 using tbb::parallel_for_each;
 using tbb::task_group;
 
+constexpr bool PARALLEL_FOR_EACH_CONCURRENT = true;
+
 class TaskScheduler {
 public:
 	TaskScheduler() { }
@@ -58,6 +60,8 @@ using concurrency::concurrent_queue;
 using concurrency::task_group;
 using concurrency::parallel_for_each;
 
+constexpr bool PARALLEL_FOR_EACH_CONCURRENT = true;
+
 class TaskScheduler {
 public:
 	TaskScheduler() {
@@ -86,6 +90,9 @@ public:
 
 #define parallel_for_each for_each
 
+// The items are handled one by one
+constexpr bool PARALLEL_FOR_EACH_CONCURRENT = false;
+
 	template <typename T>
 	class concurrent_queue {
 	public:
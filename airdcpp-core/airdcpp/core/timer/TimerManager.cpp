@@ -30,45 +30,189 @@ namespace dcpp {
 
 using namespace boost::posix_time;
 
-TimerManager::TimerManager() {
+// Wheel tick length (milliseconds)
+#define TIMER_RESOLUTION 100
+
+// Tasks running in the timer thread for longer than this will delay other tasks (milliseconds)
+#define SLOW_TASK_DURATION 500
+
+TimerManager::TimerManager() : wheel(getTick() / TIMER_RESOLUTION), backgroundTasks(true), diskTasks(true),
+	backgroundExecutor([this](Callback&& aTask) { backgroundTasks.addTask(std::move(aTask)); }),
+	diskExecutor([this](Callback&& aTask) { diskTasks.addTask(std::move(aTask)); }) {
 	// This mutex will be unlocked only upon shutdown
 	mtx.lock();
 }
 
 TimerManager::~TimerManager() {
-	dcassert(listeners.size() == 0);
+
 }
 
 void TimerManager::shutdown() {
 	mtx.unlock();
 	join();
+
+	backgroundTasks.stop();
+	diskTasks.stop();
+
+	backgroundTasks.join();
+	diskTasks.join();
+}
+
+TimerTaskId TimerManager::addTask(const string& aName, uint64_t aIntervalMs, TimerTaskF&& aTask, const TimerExecutor& aExecutor) noexcept {
+	dcassert(aIntervalMs > 0);
+	return addTask(aName, aIntervalMs, aIntervalMs, std::move(aTask), aExecutor);
+}
+
+TimerTaskId TimerManager::addDeadline(const string& aName, uint64_t aDelayMs, TimerTaskF&& aTask, const TimerExecutor& aExecutor) noexcept {
+	return addTask(aName, 0, aDelayMs, std::move(aTask), aExecutor);
+}
+
+TimerTaskId TimerManager::addTask(const string& aName, uint64_t aInterval, uint64_t aDelay, TimerTaskF&& aTask, const TimerExecutor& aExecutor) noexcept {
+	auto deadline = getTick() + aDelay;
+
+	Lock l(cs);
+	auto task = make_shared<Task>(++lastTaskId, aName, aInterval, std::move(aTask), aExecutor);
+	tasks.emplace(task->id, task);
+	scheduleUnsafe(std::move(task), deadline);
+	return lastTaskId;
+}
+
+void TimerManager::removeTask(TimerTaskId aId) noexcept {
+	TaskPtr task;
+
+	{
+		Lock l(cs);
+		auto i = tasks.find(aId);
+		if (i == tasks.end()) {
+			return;
+		}
+
+		task = i->second;
+		tasks.erase(i);
+	}
+
+	// The wheel entry will be dropped when it expires
+	task->removed = true;
+
+	// Wait for the running execution
+	Lock l(task->runCS);
+}
+
+vector<TimerTaskStats> TimerManager::getTaskStats() const noexcept {
+	vector<TimerTaskStats> ret;
+
+	Lock l(cs);
+	for (const auto& t: tasks | views::values) {
+		ret.push_back({ t->name, t->interval, t->runs, t->overruns, t->totalJitter, t->maxJitter, t->totalDuration, t->maxDuration });
+	}
+
+	return ret;
+}
+
+void TimerManager::scheduleUnsafe(TaskPtr aTask, uint64_t aDeadline) noexcept {
+	aTask->deadline = aDeadline;
+
+	// Round up so that the task won't be run early
+	wheel.add(std::move(aTask), (aDeadline + TIMER_RESOLUTION - 1) / TIMER_RESOLUTION);
+}
+
+void TimerManager::dispatch(const TaskPtr& aTask, uint64_t aTick) noexcept {
+	if (aTask->removed) {
+		return;
+	}
+
+	uint64_t deadline = 0;
+
+	{
+		Lock l(cs);
+		deadline = aTask->deadline;
+		if (aTask->interval > 0) {
+			// Keep the fixed rate unless the timer has fallen behind
+			auto next = deadline + aTask->interval;
+			scheduleUnsafe(aTask, next > aTick ? next : aTick + aTask->interval);
+		}
+	}
+
+	if (aTask->running.exchange(true)) {
+		aTask->overruns++;
+		dcdebug("TimerManager: task %s is still running, skipping the execution\n", aTask->name.c_str());
+		return;
+	}
+
+	if (aTask->executor) {
+		aTask->executor([aTask, deadline, this] {
+			execute(aTask, deadline);
+		});
+	} else {
+		execute(aTask, deadline);
+	}
+}
+
+template<typename T>
+static void updateMax(atomic<T>& aMax, T aValue) noexcept {
+	auto cur = aMax.load();
+	while (cur < aValue && !aMax.compare_exchange_weak(cur, aValue)) { }
+}
+
+void TimerManager::execute(const TaskPtr& aTask, uint64_t aDeadline) noexcept {
+	{
+		Lock l(aTask->runCS);
+		if (!aTask->removed) {
+			auto start = getTick();
+			aTask->callback(start);
+			auto duration = getTick() - start;
+
+			auto jitter = start > aDeadline ? start - aDeadline : 0;
+			aTask->runs++;
+			aTask->totalJitter += jitter;
+			updateMax(aTask->maxJitter, jitter);
+			aTask->totalDuration += duration;
+			updateMax(aTask->maxDuration, duration);
+
+			if (!aTask->executor && duration > SLOW_TASK_DURATION) {
+				dcdebug("TimerManager: task %s took " U64_FMT " ms to complete in the timer thread\n", aTask->name.c_str(), duration);
+			}
+		}
+	}
+
+	aTask->running = false;
+
+	if (aTask->interval == 0) {
+		// Deadline tasks are kept in the list until they have completed so that they can be removed safely
+		Lock l(cs);
+		tasks.erase(aTask->id);
+	}
 }
 
 int TimerManager::run() {
 
 	//https://bugs.launchpad.net/dcplusplus/+bug/713742
 	
-	auto now = microsec_clock::universal_time();
-	auto nextSecond = now + seconds(1);
-	auto nextMin = now + minutes(1);
+	auto nextTick = microsec_clock::universal_time() + milliseconds(TIMER_RESOLUTION);
+
+	TimerWheel<TaskPtr>::List expired;
+	while(!mtx.timed_lock(nextTick)) {
+		nextTick += milliseconds(TIMER_RESOLUTION);
+		auto now = microsec_clock::universal_time();
+		if (nextTick <= now) {
+			nextTick = now + milliseconds(TIMER_RESOLUTION);
+		}
 
+		const auto tick = getTick();
 
-	while(!mtx.timed_lock(nextSecond)) {
-		nextSecond += seconds(1);
-		now = microsec_clock::universal_time();
-		if (nextSecond <= now)
 		{
-			nextSecond = now + seconds(1);
+			// Catch up if the thread has fallen behind
+			Lock l(cs);
+			while (wheel.getCurrent() < tick / TIMER_RESOLUTION) {
+				wheel.advance(expired);
+			}
 		}
 
-		const auto t = getTick();
-		fire(TimerManagerListener::Second(), t);
-
-		if (nextMin <= now)
-		{
-			nextMin += minutes(1);
-			fire(TimerManagerListener::Minute(), t);
+		for (const auto& t: expired) {
+			dispatch(t, tick);
 		}
+
+		expired.clear();
 	}
 
 	mtx.unlock();
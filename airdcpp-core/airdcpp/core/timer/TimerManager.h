@@ -19,20 +19,70 @@
 #ifndef DCPLUSPLUS_DCPP_TIMER_MANAGER_H
 #define DCPLUSPLUS_DCPP_TIMER_MANAGER_H
 
+#include <airdcpp/forward.h>
+
 #include <airdcpp/core/Singleton.h>
-#include <airdcpp/core/Speaker.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
+#include <airdcpp/core/queue/DispatcherQueue.h>
+#include <airdcpp/core/thread/CriticalSection.h>
+#include <airdcpp/core/timer/TimerWheel.h>
 #include <airdcpp/core/thread/Thread.h>
 
 #include <boost/thread/mutex.hpp>
 
 namespace dcpp {
 
-class TimerManager : public Speaker<TimerManagerListener>, public Singleton<TimerManager>, public Thread
+using TimerTaskF = std::function<void (uint64_t aTick)>;
+
+// Runs the task callback in the wanted thread
+// Tasks without an executor are run in the timer thread and they must not block
+using TimerExecutor = std::function<void (Callback&& aTask)>;
+
+struct TimerTaskStats {
+	string name;
+
+	// 0 for deadline tasks
+	uint64_t interval;
+
+	uint64_t runs;
+
+	// Executions skipped because the previous one was still running
+	uint64_t overruns;
+
+	// Delay between the scheduled time and the start of the execution
+	uint64_t totalJitter;
+	uint64_t maxJitter;
+
+	uint64_t totalDuration;
+	uint64_t maxDuration;
+};
+
+class TimerManager : public Singleton<TimerManager>, public Thread
 {
 public:
 	void shutdown();
 
+	// Runs the task repeatedly with the given interval (milliseconds)
+	// A new execution won't be started before the previous one has finished
+	TimerTaskId addTask(const string& aName, uint64_t aIntervalMs, TimerTaskF&& aTask, const TimerExecutor& aExecutor = nullptr) noexcept;
+
+	// Runs the task once after the given delay (milliseconds)
+	TimerTaskId addDeadline(const string& aName, uint64_t aDelayMs, TimerTaskF&& aTask, const TimerExecutor& aExecutor = nullptr) noexcept;
+
+	// Waits for a possible running execution of the task to finish (unless called from the task itself)
+	void removeTask(TimerTaskId aId) noexcept;
+
+	vector<TimerTaskStats> getTaskStats() const noexcept;
+
+	// Shared background thread for housekeeping tasks that shouldn't be run in the timer thread
+	const TimerExecutor& getBackgroundExecutor() const noexcept {
+		return backgroundExecutor;
+	}
+
+	// Separate thread for tasks that write to disk so that slow writes won't delay the housekeeping tasks
+	const TimerExecutor& getDiskExecutor() const noexcept {
+		return diskExecutor;
+	}
+
 	static time_t getTime();
 	static uint64_t getTick();
 
@@ -42,6 +92,53 @@ private:
 	friend class Singleton<TimerManager>;
 	boost::timed_mutex mtx;
 
+	struct Task {
+		Task(TimerTaskId aId, const string& aName, uint64_t aInterval, TimerTaskF&& aCallback, const TimerExecutor& aExecutor) noexcept :
+			id(aId), name(aName), interval(aInterval), callback(std::move(aCallback)), executor(aExecutor) { }
+
+		const TimerTaskId id;
+		const string name;
+		const uint64_t interval;
+		const TimerTaskF callback;
+		const TimerExecutor executor;
+
+		// Next scheduled execution (milliseconds)
+		uint64_t deadline = 0;
+
+		// Queued in the executor or being run
+		atomic<bool> running = false;
+		atomic<bool> removed = false;
+
+		// Held while the callback is being run
+		CriticalSection runCS;
+
+		atomic<uint64_t> runs = 0;
+		atomic<uint64_t> overruns = 0;
+		atomic<uint64_t> totalJitter = 0;
+		atomic<uint64_t> maxJitter = 0;
+		atomic<uint64_t> totalDuration = 0;
+		atomic<uint64_t> maxDuration = 0;
+	};
+
+	using TaskPtr = shared_ptr<Task>;
+
+	TimerTaskId addTask(const string& aName, uint64_t aInterval, uint64_t aDelay, TimerTaskF&& aTask, const TimerExecutor& aExecutor) noexcept;
+
+	void scheduleUnsafe(TaskPtr aTask, uint64_t aDeadline) noexcept;
+	void dispatch(const TaskPtr& aTask, uint64_t aTick) noexcept;
+	void execute(const TaskPtr& aTask, uint64_t aDeadline) noexcept;
+
+	TimerWheel<TaskPtr> wheel;
+	unordered_map<TimerTaskId, TaskPtr> tasks;
+	TimerTaskId lastTaskId = 0;
+	mutable CriticalSection cs;
+
+	DispatcherQueue backgroundTasks;
+	DispatcherQueue diskTasks;
+
+	const TimerExecutor backgroundExecutor;
+	const TimerExecutor diskExecutor;
+
 	TimerManager();
 	~TimerManager();
 	
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_TIMER_WHEEL_H
+#define DCPLUSPLUS_DCPP_TIMER_WHEEL_H
+
+#include <airdcpp/forward.h>
+
+namespace dcpp {
+
+// Hierarchical timing wheel
+//
+// Entries are placed in the slots of the lowest level that covers their expiration tick. Slots of the
+// upper levels are cascaded to the lower levels when the lower level wraps around, which keeps
+// both adding and advancing constant time regardless of the number of entries.
+//
+// Entries expiring beyond the range of the top level are parked in the top level and re-added
+// until they are in range.
+//
+// The class isn't thread safe
+template<class T, int LevelBits = 6, int Levels = 4>
+class TimerWheel {
+public:
+	using List = vector<T>;
+
+	explicit TimerWheel(uint64_t aCurrentTick) noexcept : current(aCurrentTick) { }
+
+	// Expiration ticks that have passed already will expire on the next advance
+	void add(T&& aEntry, uint64_t aExpires) noexcept {
+		count++;
+		insert(Entry(std::max(aExpires, current + 1), std::move(aEntry)));
+	}
+
+	// Advances the wheel by one tick and appends the entries that expired
+	void advance(List& expired_) noexcept {
+		current++;
+
+		// Move the entries of the upper levels downwards (top level first) when the lower levels wrap around
+		for (int level = Levels - 1; level > 0; --level) {
+			if ((current & ((1ULL << (LevelBits * level)) - 1)) == 0) {
+				cascade(level, expired_);
+			}
+		}
+
+		auto& slot = levels[0][current & SLOT_MASK];
+		if (slot.empty()) {
+			return;
+		}
+
+		auto entries = std::move(slot);
+		slot.clear();
+		for (auto& e: entries) {
+			if (e.first <= current) {
+				count--;
+				expired_.push_back(std::move(e.second));
+			} else {
+				// Parked in the top level
+				insert(std::move(e));
+			}
+		}
+	}
+
+	uint64_t getCurrent() const noexcept {
+		return current;
+	}
+
+	size_t size() const noexcept {
+		return count;
+	}
+private:
+	static constexpr uint64_t SLOT_COUNT = 1ULL << LevelBits;
+	static constexpr uint64_t SLOT_MASK = SLOT_COUNT - 1;
+
+	// Ticks covered by all levels
+	static constexpr uint64_t MAX_RANGE = 1ULL << (LevelBits * Levels);
+
+	using Entry = pair<uint64_t, T>;
+	using Slot = vector<Entry>;
+
+	void insert(Entry&& aEntry) noexcept {
+		auto delta = aEntry.first - current;
+
+		// Park the entry in the last slot of the range if it's out of reach
+		auto expires = delta >= MAX_RANGE ? current + MAX_RANGE - 1 : aEntry.first;
+		delta = expires - current;
+
+		int level = 0;
+		while (level + 1 < Levels && delta >= (1ULL << (LevelBits * (level + 1)))) {
+			level++;
+		}
+
+		levels[level][(expires >> (LevelBits * level)) & SLOT_MASK].push_back(std::move(aEntry));
+	}
+
+	void cascade(int aLevel, List& expired_) noexcept {
+		auto& slot = levels[aLevel][(current >> (LevelBits * aLevel)) & SLOT_MASK];
+		if (slot.empty()) {
+			return;
+		}
+
+		auto entries = std::move(slot);
+		slot.clear();
+		for (auto& e: entries) {
+			if (e.first <= current) {
+				count--;
+				expired_.push_back(std::move(e.second));
+			} else {
+				insert(std::move(e));
+			}
+		}
+	}
+
+	Slot levels[Levels][SLOT_COUNT];
+
+	uint64_t current;
+	size_t count = 0;
+};
+
+} // namespace dcpp
+
+#endif // DCPLUSPLUS_DCPP_TIMER_WHEEL_H
@@ -48,7 +48,7 @@ const char* UpdateManager::versionUrl[VERSION_LAST] = {
 };
 
 UpdateManager::UpdateManager() : lastIPUpdate(GET_TICK()) {
-	TimerManager::getInstance()->addListener(this);
+	maintenanceTask = TimerManager::getInstance()->addTask("Update maintenance", 60 * 1000, [this](uint64_t aTick) { onTimerMaintenance(aTick); });
 
 	links.geoip = "http://geoip.airdcpp.net";
 	links.ipcheck4 = "http://checkip.dyndns.org/";
@@ -75,14 +75,14 @@ UpdateManager::UpdateManager() : lastIPUpdate(GET_TICK()) {
 }
 
 UpdateManager::~UpdateManager() { 
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(maintenanceTask);
 }
 
 void UpdateManager::log(const string& aMsg, LogMessage::Severity aSeverity) noexcept {
 	LogManager::getInstance()->message(aMsg, aSeverity, STRING(UPDATER));
 }
 
-void UpdateManager::on(TimerManagerListener::Minute, uint64_t aTick) noexcept {
+void UpdateManager::onTimerMaintenance(uint64_t aTick) noexcept {
 	if (SETTING(UPDATE_IP_HOURLY) && lastIPUpdate + 60*60*1000 < aTick) {
 		checkIP(false, false);
 		lastIPUpdate = aTick;
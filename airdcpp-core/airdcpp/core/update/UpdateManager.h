@@ -22,7 +22,6 @@
 #include <airdcpp/message/Message.h>
 #include <airdcpp/core/Singleton.h>
 #include <airdcpp/core/Speaker.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 #include <airdcpp/core/update/UpdateManagerListener.h>
 
 #include <airdcpp/core/version.h>
@@ -32,7 +31,7 @@ namespace dcpp {
 struct HttpDownload;
 class UpdateDownloader;
 
-class UpdateManager : public Singleton<UpdateManager>, public Speaker<UpdateManagerListener>, private TimerManagerListener
+class UpdateManager : public Singleton<UpdateManager>, public Speaker<UpdateManagerListener>
 {
 
 public:
@@ -99,7 +98,9 @@ private:
 	void completeLanguageDownload();
 	void completeIPCheck(bool aManualCheck, bool v6);
 
-	void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
+	// Timer tasks (run in the timer thread)
+	TimerTaskId maintenanceTask = 0;
+	void onTimerMaintenance(uint64_t aTick) noexcept;
 
 	static string parseIP(const string& aText, bool v6);
 };
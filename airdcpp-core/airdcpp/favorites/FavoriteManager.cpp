@@ -46,7 +46,7 @@ FavoriteManager::~FavoriteManager() {
 }
 
 void FavoriteManager::shutdown() noexcept {
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(saveTask);
 	save();
 }
 
@@ -357,7 +357,9 @@ void FavoriteManager::load() noexcept {
 	});
 
 	lastXmlSave = GET_TICK();
-	TimerManager::getInstance()->addListener(this);
+
+	auto tm = TimerManager::getInstance();
+	saveTask = tm->addTask("Favorites save", 1000, [this](uint64_t aTick) { onTimerSave(aTick); }, tm->getDiskExecutor());
 }
 
 void FavoriteManager::loadFavoriteHubs(SimpleXML& aXml) {
@@ -535,7 +537,7 @@ FavoriteHubEntryList::const_iterator FavoriteManager::getFavoriteHubUnsafe(Favor
 	return ranges::find_if(favoriteHubs, [aToken](const FavoriteHubEntryPtr& f) { return f->getToken() == aToken; });
 }
 
-void FavoriteManager::on(TimerManagerListener::Second, uint64_t aTick) noexcept {
+void FavoriteManager::onTimerSave(uint64_t aTick) noexcept {
 	if (xmlDirty && aTick > (lastXmlSave + 15 * 1000)) {
 		save();
 	}
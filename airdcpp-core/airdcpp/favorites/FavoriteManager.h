@@ -23,7 +23,6 @@
 #include <airdcpp/favorites/FavoriteManagerListener.h>
 #include <airdcpp/settings/SettingsManagerListener.h>
 #include <airdcpp/share/profiles/ShareProfileManagerListener.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 #include <airdcpp/favorites/FavHubGroup.h>
 #include <airdcpp/favorites/HubEntry.h>
@@ -33,7 +32,7 @@
 namespace dcpp {
 
 class FavoriteManager : public Speaker<FavoriteManagerListener>, public Singleton<FavoriteManager>,
-	private SettingsManagerListener, private ClientManagerListener, private ShareProfileManagerListener, private TimerManagerListener
+	private SettingsManagerListener, private ClientManagerListener, private ShareProfileManagerListener
 {
 public:
 // Favorite Hubs
@@ -99,8 +98,9 @@ private:
 
 	int resetProfile(ProfileToken oldProfile, ProfileToken newProfile, bool nmdcOnly) noexcept;
 
-	// TimerManagerListener
-	void on(TimerManagerListener::Second, uint64_t tick) noexcept override;
+	// Timer tasks (run in the disk thread of the timer)
+	TimerTaskId saveTask = 0;
+	void onTimerSave(uint64_t aTick) noexcept;
 
 	// ShareManagerListener
 	void on(ShareProfileManagerListener::DefaultProfileChanged, ProfileToken aOldDefault, ProfileToken aNewDefault) noexcept override;
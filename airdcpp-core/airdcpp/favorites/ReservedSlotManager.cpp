@@ -33,11 +33,11 @@ namespace dcpp {
 using ranges::find_if;
 
 ReservedSlotManager::ReservedSlotManager(SlotsUpdatedF&& aSlotsUpdatedF) noexcept : onSlotsUpdated(std::move(aSlotsUpdatedF)) {
-	TimerManager::getInstance()->addListener(this);
+	expirationTask = TimerManager::getInstance()->addTask("Reserved slot expiration", 60 * 1000, [this](uint64_t aTick) { onTimerExpiration(aTick); });
 }
 
 ReservedSlotManager::~ReservedSlotManager() {
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(expirationTask);
 }
 
 optional<UserConnectResult> ReservedSlotManager::reserveSlot(const HintedUser& aUser, uint64_t aTime) noexcept {
@@ -72,7 +72,7 @@ void ReservedSlotManager::unreserveSlot(const UserPtr& aUser) noexcept {
 	}
 }
 
-void ReservedSlotManager::on(TimerManagerListener::Minute, uint64_t aTick) noexcept {
+void ReservedSlotManager::onTimerExpiration(uint64_t aTick) noexcept {
 	UserList reservedRemoved;
 	{
 		WLock l(cs);
@@ -22,13 +22,12 @@
 #include <airdcpp/forward.h>
 
 #include <airdcpp/core/thread/CriticalSection.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 #include <airdcpp/hub/UserConnectResult.h>
 #include <airdcpp/user/User.h>
 
 namespace dcpp {
 
-class ReservedSlotManager : private TimerManagerListener
+class ReservedSlotManager
 {
 public:
 	
@@ -39,15 +38,16 @@ public:
 
 	using SlotsUpdatedF = std::function<void (const UserPtr &)>;
 	explicit ReservedSlotManager(SlotsUpdatedF&& aSlotsUpdatedF) noexcept;
-	~ReservedSlotManager() override;
+	~ReservedSlotManager();
 private:
 	mutable SharedMutex cs;
 
 	using SlotMap = unordered_map<UserPtr, uint64_t, User::Hash>;
 	SlotMap reservedSlots;
 	
-	// TimerManagerListener
-	void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
+	// Timer tasks (run in the timer thread)
+	TimerTaskId expirationTask = 0;
+	void onTimerExpiration(uint64_t aTick) noexcept;
 
 	SlotsUpdatedF onSlotsUpdated;
 };
@@ -49,10 +49,6 @@ bool DirectoryListing::File::Sort::operator()(const Ptr& a, const Ptr& b) const
 DirectoryListing::File::File(Directory* aDir, const string& aName, int64_t aSize, const TTHValue& aTTH, time_t aRemoteDate) noexcept :
 	name(aName), size(aSize), parent(aDir), tthRoot(aTTH), remoteDate(aRemoteDate), token(itemIdCounter++) {
 
-	if (size > 0) {
-		dupe = DupeUtil::checkFileDupe(tthRoot);
-	}
-
 	//dcdebug("DirectoryListing::File (copy) %s was created\n", aName.c_str());
 }
 
@@ -310,21 +306,51 @@ bool DirectoryListing::File::isInQueue() const noexcept {
 	return DupeUtil::isQueueDupe(dupe) || DupeUtil::isFinishedDupe(dupe);
 }
 
+void DirectoryListing::File::checkDupes(const vector<File*>& aFiles) noexcept {
+	vector<TTHValue> tths;
+	tths.reserve(aFiles.size());
+	for (const auto& f: aFiles) {
+		tths.push_back(f->getTTH());
+	}
+
+	auto dupes = DupeUtil::checkFileDupes(tths);
+	for (size_t i = 0; i < aFiles.size(); ++i) {
+		aFiles[i]->setDupe(dupes[i]);
+	}
+}
+
+void DirectoryListing::Directory::getFilesRecursive(vector<File*>& files_) const noexcept {
+	for (const auto& d : directories | views::values) {
+		d->getFilesRecursive(files_);
+	}
+
+	for (const auto& f : files) {
+		files_.push_back(f.get());
+	}
+}
+
 DupeType DirectoryListing::Directory::checkDupesRecursive() noexcept {
+	// Check all files at once instead of locking the share and queue for each file
+	vector<File*> allFiles;
+	getFilesRecursive(allFiles);
+	File::checkDupes(allFiles);
+
+	return updateDupesRecursive();
+}
+
+DupeType DirectoryListing::Directory::updateDupesRecursive() noexcept {
 	// Go through the files even if the directory is incomplete 
 	// (some of the children may still be available)
 	DupeUtil::DupeSet dupeSet;
 
 	// Children
 	for (const auto& d : directories | views::values) {
-		dupeSet.emplace(d->checkDupesRecursive());
+		dupeSet.emplace(d->updateDupesRecursive());
 	}
 
 	// Files
 	for (const auto& f : files) {
-		auto fileDupe = DupeUtil::checkFileDupe(f->getTTH());
-		f->setDupe(fileDupe);
-		dupeSet.emplace(fileDupe);
+		dupeSet.emplace(f->getDupe());
 	}
 
 	setDupe(DupeUtil::parseDirectoryContentDupe(dupeSet));
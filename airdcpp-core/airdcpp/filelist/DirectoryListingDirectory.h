@@ -60,6 +60,9 @@ public:
 
 	bool isInQueue() const noexcept;
 
+	// Updates the dupe status of the files with a single lookup
+	static void checkDupes(const vector<File*>& aFiles) noexcept;
+
 	Owner getOwner() const noexcept {
 		return owner;
 	}
@@ -165,6 +168,11 @@ protected:
 
 	void getContentInfo(size_t& directories_, size_t& files_, bool aCountVirtual) const noexcept;
 
+	void getFilesRecursive(vector<File*>& files_) const noexcept;
+
+	// Calculates the directory dupe status from the (already checked) file dupes
+	DupeType updateDupesRecursive() noexcept;
+
 	DirectoryContentInfo contentInfo = DirectoryContentInfo::uninitialized();
 	const string name;
 	const DirectoryListingItemToken token;
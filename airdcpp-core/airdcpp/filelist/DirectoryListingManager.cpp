@@ -43,12 +43,12 @@ bool DirectoryDownload::HasOwner::operator()(const DirectoryDownloadPtr& ddi) co
 
 DirectoryListingManager::DirectoryListingManager() noexcept {
 	QueueManager::getInstance()->addListener(this);
-	TimerManager::getInstance()->addListener(this);
+	maintenanceTask = TimerManager::getInstance()->addTask("Directory download maintenance", 60 * 1000, [this](uint64_t aTick) { onTimerMaintenance(aTick); });
 }
 
 DirectoryListingManager::~DirectoryListingManager() noexcept {
 	QueueManager::getInstance()->removeListener(this);
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(maintenanceTask);
 }
 
 
@@ -96,7 +96,7 @@ void DirectoryListingManager::removeDirectoryDownload(const DirectoryDownloadPtr
 	fire(DirectoryListingManagerListener::DirectoryDownloadRemoved(), aDownloadInfo);
 }
 
-void DirectoryListingManager::on(TimerManagerListener::Minute, uint64_t aTick) noexcept {
+void DirectoryListingManager::onTimerMaintenance(uint64_t aTick) noexcept {
 	DirectoryDownloadList toRemove;
 
 	{
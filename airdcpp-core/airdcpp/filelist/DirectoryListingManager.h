@@ -30,10 +30,9 @@
 #include <airdcpp/message/Message.h>
 #include <airdcpp/queue/QueueAddInfo.h>
 #include <airdcpp/core/Singleton.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 namespace dcpp {
-	class DirectoryListingManager : public Singleton<DirectoryListingManager>, public Speaker<DirectoryListingManagerListener>, public QueueManagerListener, public TimerManagerListener {
+	class DirectoryListingManager : public Singleton<DirectoryListingManager>, public Speaker<DirectoryListingManagerListener>, public QueueManagerListener {
 	public:
 		typedef unordered_map<UserPtr, DirectoryListingPtr, User::Hash> DirectoryListingMap;
 
@@ -107,7 +106,9 @@ namespace dcpp {
 
 		void on(QueueManagerListener::PartialListFinished, const HintedUser& aUser, const string& aXml, const string& aBase) noexcept override;
 
-		void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
+		// Timer tasks (run in the timer thread)
+		TimerTaskId maintenanceTask = 0;
+		void onTimerMaintenance(uint64_t aTick) noexcept;
 	};
 
 }
@@ -83,6 +83,10 @@ void ListLoader::loadFile(StringPairList& attribs, bool) {
 
 	auto f = make_shared<DirectoryListing::File>(cur, n, size, tth, Util::parseRemoteFileItemDate(getAttrib(attribs, sDate, 3)));
 	cur->files.push_back(f);
+
+	if (size > 0) {
+		dupeCheckFiles.push_back(f.get());
+	}
 }
 
 DirectoryListing::Directory::DirType ListLoader::parseDirectoryType(bool aIncomplete, const DirectoryContentInfo& aContentInfo) noexcept {
@@ -195,6 +199,10 @@ void ListLoader::endTag(const string& aName) {
 
 			cur->setComplete();
 
+			// Check the dupes at once after all files have been loaded (the hooks may use them)
+			DirectoryListing::File::checkDupes(dupeCheckFiles);
+			dupeCheckFiles.clear();
+
 			if (list->loadHooks && list->loadHooks->hasSubscribers()) {
 				list->updateStatus(STRING(RUNNING_HOOKS));
 				runHooksRecursive(list->getRoot());
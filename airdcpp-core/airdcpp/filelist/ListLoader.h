@@ -50,6 +50,9 @@ private:
 	DirectoryListing* list;
 	DirectoryListing::Directory* cur;
 
+	// Loaded files with an unknown dupe status
+	vector<DirectoryListing::File*> dupeCheckFiles;
+
 	bool inListing = false;
 	int dirsLoaded = 0;
 
@@ -209,6 +209,8 @@ class StringSearch;
 
 class TigerHash;
 
+using TimerTaskId = uint32_t;
+
 class Transfer;
 using TransferToken = uint32_t;
 
@@ -71,6 +71,13 @@ void HashManager::onDirectoryHashed(const string& aPath, const HasherStats& aSta
 }
 
 void HashManager::onHasherFinished(int aDirectoriesHashed, const HasherStats& aStats, int aHasherId) noexcept {
+	// Nothing more to combine with the pending writes
+	try {
+		store->flush();
+	} catch (const HashException& e) {
+		logHasher(e.getError(), aHasherId, LogMessage::SEV_ERROR, false);
+	}
+
 	fire(HashManagerListener::HasherFinished(), aDirectoriesHashed, aStats, aHasherId);
 }
 
@@ -79,6 +86,10 @@ void HashManager::removeHasher(int aHasherId) noexcept {
 	std::erase_if(hashers, [aHasherId](const Hasher* aHasher) { return aHasher->hasherID == aHasherId; });
 }
 
+int HashManager::getPipelineWorkerCount() const noexcept {
+	return SETTING(HASHER_PIPELINE_THREADS);
+}
+
 void HashManager::logHasher(const string& aMessage, int aHasherID, LogMessage::Severity aSeverity, bool aLock) const noexcept {
 	ConditionalRLock l(Hasher::hcs, aLock);
 	log((hashers.size() > 1 ? "[" + STRING_F(HASHER_X, aHasherID) + "] " + ": " : Util::emptyString) + aMessage, aSeverity);
@@ -370,10 +381,19 @@ int HashManager::Optimizer::run() {
 void HashManager::startup(StartupLoader& aLoader) {
 	hashers.push_back(new Hasher(false, 0, this));
 	store->load(aLoader); 
+
+	auto tm = TimerManager::getInstance();
+	flushTask = tm->addTask("Hash database flush", 1000, [this](uint64_t aTick) { onTimerFlush(aTick); }, tm->getDiskExecutor());
+}
+
+void HashManager::onTimerFlush(uint64_t aTick) noexcept {
+	// Commit the database writes of a slow hasher in a timely manner
+	store->flushExpired(aTick);
 }
 
 void HashManager::shutdown(ProgressFunction progressF) noexcept {
 	isShutdown = true;
+	TimerManager::getInstance()->removeTask(flushTask);
 
 	{
 		WLock l(Hasher::hcs);
@@ -392,6 +412,12 @@ void HashManager::shutdown(ProgressFunction progressF) noexcept {
 		}
 		Thread::sleep(50);
 	}
+
+	try {
+		store->flush();
+	} catch (const HashException& e) {
+		log(e.getError(), LogMessage::SEV_ERROR);
+	}
 }
 
 void HashManager::stop() noexcept {
@@ -141,10 +141,15 @@ private:
 	void onDirectoryHashed(const string& aPath, const HasherStats&, int aHasherId) noexcept override;
 	void onHasherFinished(int aDirectoriesHashed, const HasherStats&, int aHasherId) noexcept override;
 	void removeHasher(int aHasherId) noexcept override;
+	int getPipelineWorkerCount() const noexcept override;
 	void logHasher(const string& aMessage, int aHasherID, LogMessage::Severity aSeverity, bool aLock) const noexcept override;
 
 	static void log(const string& aMsg, LogMessage::Severity aSeverity) noexcept;
 
+	// Timer tasks (run in the disk thread of the timer)
+	TimerTaskId flushTask = 0;
+	void onTimerFlush(uint64_t aTick) noexcept;
+
 	Hasher* createHasher() noexcept;
 	Hasher* getFileHasher(int64_t aDeviceId, int64_t aSize) const noexcept;
 	bool isPathQueued(const string& aPathLower) const noexcept;
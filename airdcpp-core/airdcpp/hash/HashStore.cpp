@@ -23,6 +23,9 @@
 #include <airdcpp/core/io/File.h>
 #include <airdcpp/hash/HashedFile.h>
 #include <airdcpp/core/io/db/LevelDB.h>
+#ifdef HAVE_LMDB
+#include <airdcpp/core/io/db/LMDB.h>
+#endif
 #include <airdcpp/events/LogManager.h>
 #include <airdcpp/util/PathUtil.h>
 #include <airdcpp/queue/QueueManager.h>
@@ -35,6 +38,29 @@
 #define FILEINDEX_VERSION 1
 #define HASHDATA_VERSION 1
 
+// Version of the file index key layout (stored in the metadata entry)
+// 1 = full lowercase paths as keys (no metadata entry)
+// 2 = directory table + file entries keyed by directory ID and name
+#define FILEINDEX_KEY_VERSION 2
+
+// Key prefixes of the file index
+// Keys of the legacy format are full paths that never start with control characters
+#define FILEINDEX_PREFIX_META '\x01'
+#define FILEINDEX_PREFIX_DIRECTORY '\x02'
+#define FILEINDEX_PREFIX_FILE '\x03'
+
+// Group commit limits for the database writes
+// The file index entries are small while the trees may be up to ~100 KB
+#define FILEINDEX_BATCH_BYTES (256 * 1024)
+#define HASHDATA_BATCH_BYTES (4 * 1024 * 1024)
+#define DB_BATCH_MAX_DELAY 3000
+
+// Entries per write when importing data from another database backend
+#define DB_IMPORT_BATCH_SIZE 10000
+
+// Legacy file index entries per committed chunk when upgrading the key layout
+#define FILEINDEX_MIGRATION_CHUNK_SIZE 10000
+
 namespace dcpp {
 
 HashStore::HashStore() {
@@ -49,40 +75,353 @@ void HashStore::load(StartupLoader& aLoader) {
 	openDb(aLoader);
 }
 
-void HashStore::openDb(StartupLoader& aLoader) {
-	auto hashDataPath = AppUtil::getPath(AppUtil::PATH_USER_CONFIG) + "HashData" + PATH_SEPARATOR;
-	auto fileIndexPath = AppUtil::getPath(AppUtil::PATH_USER_CONFIG) + "FileIndex" + PATH_SEPARATOR;
+string HashStore::getDbPath(DbType aType, int aBackend) noexcept {
+	auto path = AppUtil::getPath(AppUtil::PATH_USER_CONFIG) + (aType == DB_HASH_DATA ? "HashData" : "FileIndex");
+	if (aBackend == SettingsManager::DB_BACKEND_LMDB) {
+		path += "-LMDB";
+	}
 
-	File::ensureDirectory(hashDataPath);
-	File::ensureDirectory(fileIndexPath);
+	return path + PATH_SEPARATOR;
+}
 
-	AppUtil::migrate(fileIndexPath, "*");
-	AppUtil::migrate(hashDataPath, "*");
+unique_ptr<DbHandler> HashStore::createDb(DbType aType, int aBackend) {
+	return createDb(aType, aBackend, getDbPath(aType, aBackend));
+}
 
+unique_ptr<DbHandler> HashStore::createDb(DbType aType, int aBackend, const string& aPath) {
+	auto name = aType == DB_HASH_DATA ? STRING(HASH_DATA) : STRING(FILE_INDEX);
 	auto cacheSize = static_cast<uint32_t>(Util::convertSize(max(SETTING(DB_CACHE_SIZE), 1), Util::MB));
-	auto blockSize = File::getBlockSize(AppUtil::getPath(AppUtil::PATH_USER_CONFIG));
 
-	try {
+	File::ensureDirectory(aPath);
+	AppUtil::migrate(aPath, "*");
+
+#ifdef HAVE_LMDB
+	if (aBackend == SettingsManager::DB_BACKEND_LMDB) {
+		return make_unique<LMDB>(aPath, name, cacheSize);
+	}
+#endif
+
+	if (aType == DB_HASH_DATA) {
 		// Use the file system block size in here. Using a block size smaller than that reduces the performance significantly especially when writing a lot of data (e.g. when migrating the data)
 		// The default cache size of 8 MB is able to hold approximately 256-512 trees with the block size of 16KB which should be enough for most common transfers (should the size be increased with larger block size?)
 		// The number of open files doesn't matter here since the tree lookups are very much random (20 is the minimum allowed by LevelDB). The data won't compress so no need to even try it.
-		hashDb = make_unique<LevelDB>(hashDataPath, STRING(HASH_DATA), cacheSize, 20, false, max(static_cast<int64_t>(16 * 1024), blockSize));
+		auto blockSize = File::getBlockSize(AppUtil::getPath(AppUtil::PATH_USER_CONFIG));
+		return make_unique<LevelDB>(aPath, name, cacheSize, 20, false, max(static_cast<int64_t>(16 * 1024), blockSize));
+	}
+
+	// Use a large block size and allow more open files because the reads are nearly sequential in here (but done with multiple threads). 
+	// Files are keyed by the directory ID so that the files of each directory are stored next to each other
+	return make_unique<LevelDB>(aPath, name, cacheSize, 50, true, 64 * 1024);
+}
+
+void HashStore::importDb(DbType aType, int aBackend, int aSourceBackend, StartupLoader& aLoader) {
+	auto sourcePath = getDbPath(aType, aSourceBackend);
+	auto targetPath = getDbPath(aType, aBackend);
+	if (File::getDirSize(sourcePath, false) == 0 || File::getDirSize(targetPath, false) > 0) {
+		return;
+	}
 
-		// Use a large block size and allow more open files because the reads are nearly sequential in here (but done with multiple threads). 
-		// The default database sorting isn't perfect when having files and folders mixed within the same directory but that shouldn't be a big issue (avoid using custom comparison function for now...)
-		fileDb = make_unique<LevelDB>(fileIndexPath, STRING(FILE_INDEX), cacheSize, 50, true, 64 * 1024);
+	// The backend has been changed, copy the existing data
+	// Leftovers from an interrupted import are discarded
+	auto tempPath = targetPath.substr(0, targetPath.size() - 1) + ".import" + PATH_SEPARATOR;
+	File::removeDirectoryForced(tempPath);
+
+	auto source = createDb(aType, aSourceBackend);
+	auto target = createDb(aType, aBackend, tempPath);
+
+	size_t imported = 0;
+	try {
+		source->open(aLoader.stepF, aLoader.messageF);
+		target->open(aLoader.stepF, aLoader.messageF);
+
+		aLoader.stepF("Importing " + source->getNameLower());
+
+		// Legacy file index keys (full paths) may exceed the key size limit of the target backend, LMDB stores such keys
+		// in a bounded form transparently and they are converted to the current key format by migrateFileIndex afterwards
+		DbWriteBatch batch;
+		source->forEachPrefix(nullptr, 0, [&](void* aKey, size_t aKeyLen, void* aValue, size_t aValueLen) {
+			batch.put(string(static_cast<const char*>(aKey), aKeyLen), string(static_cast<const char*>(aValue), aValueLen));
+			if (batch.size() == DB_IMPORT_BATCH_SIZE) {
+				target->write(batch);
+				imported += batch.size();
+				batch = DbWriteBatch();
+			}
+		});
+
+		if (!batch.empty()) {
+			target->write(batch);
+			imported += batch.size();
+		}
+	} catch (const DbException&) {
+		target.reset();
+		File::removeDirectoryForced(tempPath);
+		throw;
+	}
+
+	auto name = target->getNameLower();
+
+	// Close the databases before moving the files
+	target.reset();
+	source.reset();
+
+	// The target directory may have been created empty by an earlier startup
+	File::removeDirectory(targetPath);
+	File::renameFile(tempPath.substr(0, tempPath.size() - 1), targetPath.substr(0, targetPath.size() - 1));
+
+	log(Util::toString(imported) + " entries imported to " + name + " from " + sourcePath, LogMessage::SEV_INFO);
+
+	// Don't keep the outdated copy around
+	try {
+		File::removeDirectoryForced(sourcePath);
+	} catch (const FileException& e) {
+		log(e.getError(), LogMessage::SEV_WARNING);
+	}
+}
+
+void HashStore::openDb(StartupLoader& aLoader) {
+	auto backend = SETTING(DB_BACKEND);
+	if (backend < 0 || backend >= SettingsManager::DB_BACKEND_LAST) {
+		backend = SettingsManager::DB_BACKEND_LEVELDB;
+	}
+
+#ifndef HAVE_LMDB
+	if (backend == SettingsManager::DB_BACKEND_LMDB) {
+		log("LMDB support isn't available in this build, using LevelDB", LogMessage::SEV_WARNING);
+		backend = SettingsManager::DB_BACKEND_LEVELDB;
+	}
+#endif
+
+	// The previously used backend (if the data needs to be imported)
+	auto otherBackend = backend == SettingsManager::DB_BACKEND_LMDB ? SettingsManager::DB_BACKEND_LEVELDB : SettingsManager::DB_BACKEND_LMDB;
+
+	try {
+#ifdef HAVE_LMDB
+		importDb(DB_HASH_DATA, backend, otherBackend, aLoader);
+		importDb(DB_FILE_INDEX, backend, otherBackend, aLoader);
+#else
+		(void)otherBackend;
+#endif
+
+		hashDb = createDb(DB_HASH_DATA, backend);
+		fileDb = createDb(DB_FILE_INDEX, backend);
 
 		hashDb->open(aLoader.stepF, aLoader.messageF);
 		fileDb->open(aLoader.stepF, aLoader.messageF);
+
+		hashWrites = make_unique<DbWriteBuffer>(*hashDb, HASHDATA_BATCH_BYTES, DB_BATCH_MAX_DELAY);
+		fileWrites = make_unique<DbWriteBuffer>(*fileDb, FILEINDEX_BATCH_BYTES, DB_BATCH_MAX_DELAY, hashWrites.get());
+
+		loadDirectories();
+		migrateFileIndex(aLoader);
 	} catch (const DbException& e) {
 		// Can't continue without hash database, abort startup
 		throw AbortException(e.getError());
+	} catch (const FileException& e) {
+		// Importing the data from another backend failed
+		throw AbortException(e.getError());
 	}
 }
 
 void HashStore::closeDb() noexcept {
+	if (fileWrites) {
+		try {
+			flush();
+		} catch (const HashException& e) {
+			log(e.getError(), LogMessage::SEV_ERROR);
+		}
+	}
+
+	fileWrites.reset(nullptr);
+	hashWrites.reset(nullptr);
+
 	hashDb.reset(nullptr);
 	fileDb.reset(nullptr);
+
+	WLock l(directoryCS);
+	directoryIds.clear();
+	nextDirectoryId = 0;
+}
+
+string HashStore::getDirectoryKey(const string& aDirectoryLower) noexcept {
+	return FILEINDEX_PREFIX_DIRECTORY + aDirectoryLower;
+}
+
+string HashStore::getFileKey(DirectoryId aDirectoryId, const string_view& aNameLower) noexcept {
+	string ret;
+	ret.reserve(1 + sizeof(DirectoryId) + aNameLower.size());
+	ret += FILEINDEX_PREFIX_FILE;
+
+	// Big-endian so that the files are grouped by directory
+	for (int i = sizeof(DirectoryId) - 1; i >= 0; --i) {
+		ret += static_cast<char>((aDirectoryId >> (i * 8)) & 0xFF);
+	}
+
+	ret += aNameLower;
+	return ret;
+}
+
+bool HashStore::isFileKey(const void* aKey, size_t aKeyLen) noexcept {
+	return aKeyLen > 1 + sizeof(DirectoryId) && *static_cast<const char*>(aKey) == FILEINDEX_PREFIX_FILE;
+}
+
+HashStore::DirectoryId HashStore::parseDirectoryId(const void* aKey) noexcept {
+	auto p = static_cast<const uint8_t*>(aKey) + 1;
+
+	DirectoryId ret = 0;
+	for (size_t i = 0; i < sizeof(DirectoryId); ++i) {
+		ret = (ret << 8) | p[i];
+	}
+
+	return ret;
+}
+
+string HashStore::findFileKey(const string& aFileLower) const noexcept {
+	auto fileName = PathUtil::getFileName(aFileLower);
+	auto directory = aFileLower.substr(0, aFileLower.size() - fileName.size());
+
+	RLock l(directoryCS);
+	auto i = directoryIds.find(directory);
+	if (i == directoryIds.end()) {
+		return Util::emptyString;
+	}
+
+	return getFileKey(i->second, fileName);
+}
+
+HashStore::DirectoryId HashStore::getDirectoryId(const string& aDirectoryLower) {
+	{
+		RLock l(directoryCS);
+		auto i = directoryIds.find(aDirectoryLower);
+		if (i != directoryIds.end()) {
+			return i->second;
+		}
+	}
+
+	DirectoryId id;
+	bool flush = false;
+	{
+		WLock l(directoryCS);
+		auto [i, added] = directoryIds.try_emplace(aDirectoryLower, nextDirectoryId);
+		if (!added) {
+			return i->second;
+		}
+
+		id = nextDirectoryId++;
+
+		// Queue the directory key before other threads can see the ID so that it can't be committed after their file keys
+		flush = fileWrites->putDeferred(getDirectoryKey(aDirectoryLower), string(reinterpret_cast<const char*>(&id), sizeof(DirectoryId)));
+	}
+
+	if (flush) {
+		fileWrites->flush();
+	}
+
+	return id;
+}
+
+void HashStore::loadDirectories() {
+	char prefix = FILEINDEX_PREFIX_DIRECTORY;
+
+	WLock l(directoryCS);
+	fileDb->forEachPrefix(&prefix, 1, [this](void* aKey, size_t aKeyLen, void* aValue, size_t aValueLen) {
+		if (aValueLen != sizeof(DirectoryId)) {
+			return;
+		}
+
+		DirectoryId id;
+		memcpy(&id, aValue, sizeof(DirectoryId));
+
+		directoryIds.try_emplace(string(static_cast<const char*>(aKey) + 1, aKeyLen - 1), id);
+		nextDirectoryId = max(nextDirectoryId, id + 1);
+	});
+}
+
+void HashStore::migrateFileIndex(StartupLoader& aLoader) {
+	const auto versionKey = FILEINDEX_PREFIX_META + string("version");
+
+	uint8_t keyVersion = 1;
+	fileDb->get((void*)versionKey.data(), versionKey.size(), sizeof(uint8_t), [&](void* aValue, size_t aValueLen) {
+		if (aValueLen != sizeof(uint8_t)) {
+			return false;
+		}
+
+		memcpy(&keyVersion, aValue, sizeof(uint8_t));
+		return true;
+	});
+
+	if (keyVersion >= FILEINDEX_KEY_VERSION) {
+		return;
+	}
+
+	aLoader.stepF("Upgrading " + fileDb->getNameLower());
+
+	// The legacy entries are converted in chunks, each chunk is removed only after its new entries have been committed
+	// Entries from an interrupted migration are preserved (the directory table has been loaded already)
+	const string legacyStart(1, FILEINDEX_PREFIX_FILE + 1);
+
+	size_t converted = 0;
+	for (;;) {
+		vector<pair<string, string>> entries;
+		fileDb->forEachFrom((void*)legacyStart.data(), legacyStart.size(), [&](void* aKey, size_t aKeyLen, void* aValue, size_t aValueLen) {
+			entries.emplace_back(string(static_cast<const char*>(aKey), aKeyLen), string(static_cast<const char*>(aValue), aValueLen));
+			return entries.size() < FILEINDEX_MIGRATION_CHUNK_SIZE;
+		});
+
+		if (entries.empty()) {
+			break;
+		}
+
+		DbWriteBatch removals;
+		for (auto& [path, value]: entries) {
+			auto fileName = PathUtil::getFileName(path);
+			if (!fileName.empty()) {
+				auto directoryId = getDirectoryId(path.substr(0, path.size() - fileName.size()));
+				fileWrites->put(getFileKey(directoryId, fileName), std::move(value));
+				converted++;
+			}
+
+			// Invalid entries are removed as well
+			removals.remove(std::move(path));
+		}
+
+		fileWrites->flush();
+		fileDb->write(removals);
+	}
+
+	uint8_t newVersion = FILEINDEX_KEY_VERSION;
+	fileDb->put((void*)versionKey.data(), versionKey.size(), &newVersion, sizeof(uint8_t));
+
+	log("File index upgraded (" + Util::toString(converted) + " files, " + Util::toString(directoryIds.size()) + " directories)", LogMessage::SEV_INFO);
+}
+
+void HashStore::flush() {
+	try {
+		hashWrites->flush();
+	} catch (const DbException& e) {
+		throw HashException(STRING_F(WRITE_FAILED_X, hashDb->getNameLower() % e.getError()));
+	}
+
+	try {
+		fileWrites->flush();
+	} catch (const DbException& e) {
+		throw HashException(STRING_F(WRITE_FAILED_X, fileDb->getNameLower() % e.getError()));
+	}
+}
+
+void HashStore::flushExpired(uint64_t aTick) noexcept {
+	// Failed entries are kept pending and committed later
+	try {
+		hashWrites->flushExpired(aTick);
+	} catch (const DbException& e) {
+		log(STRING_F(WRITE_FAILED_X, hashDb->getNameLower() % e.getError()), LogMessage::SEV_ERROR);
+		return;
+	}
+
+	try {
+		fileWrites->flushExpired(aTick);
+	} catch (const DbException& e) {
+		log(STRING_F(WRITE_FAILED_X, fileDb->getNameLower() % e.getError()), LogMessage::SEV_ERROR);
+	}
 }
 
 void HashStore::log(const string& aMsg, LogMessage::Severity aSeverity) noexcept {
@@ -95,22 +434,27 @@ void HashStore::addHashedFile(const string& aFileLower, const TigerTree& tt, con
 }
 
 void HashStore::addFile(const string& aFileLower, const HashedFile& fi_) {
-	auto sz = getFileInfoSize(fi_);
-	void* buf = malloc(sz);
-	saveFileInfo(buf, fi_);
+	string value(getFileInfoSize(fi_), '\0');
+	saveFileInfo(value.data(), fi_);
+
+	auto fileName = PathUtil::getFileName(aFileLower);
 
 	try {
-		fileDb->put((void*)aFileLower.c_str(), aFileLower.length(), (void*)buf, sz);
+		auto directoryId = getDirectoryId(aFileLower.substr(0, aFileLower.size() - fileName.size()));
+		fileWrites->put(getFileKey(directoryId, fileName), std::move(value));
 	} catch (const DbException& e) {
 		throw HashException(STRING_F(WRITE_FAILED_X, fileDb->getNameLower() % e.getError()));
 	}
-
-	free(buf);
 }
 
 void HashStore::removeFile(const string& aFilePathLower) {
+	auto key = findFileKey(aFilePathLower);
+	if (key.empty()) {
+		return;
+	}
+
 	try {
-		fileDb->remove((void*)aFilePathLower.c_str(), aFilePathLower.length());
+		fileWrites->remove(std::move(key));
 	} catch (const DbException& e) {
 		throw HashException(STRING_F(WRITE_FAILED_X, fileDb->getNameLower() % e.getError()));
 	}
@@ -150,12 +494,10 @@ void HashStore::addTree(const TigerTree& tt) {
 	size_t treelen = tt.getLeaves().size() == 1 ? 0 : tt.getLeaves().size() * TTHValue::BYTES;
 	auto sz = sizeof(uint8_t) + sizeof(int64_t) + sizeof(int64_t) + treelen;
 
-	//allocate the memory
-	void* buf = malloc(sz);
-
+	string value(sz, '\0');
 
 	//set the data
-	char* p = (char*)buf;
+	char* p = value.data();
 
 	uint8_t version = HASHDATA_VERSION;
 	memcpy(p, &version, sizeof(uint8_t));
@@ -174,18 +516,15 @@ void HashStore::addTree(const TigerTree& tt) {
 
 	//throw HashException(STRING_F(WRITE_FAILED_X, hashDb->getNameLower() % "TEST"));
 	try {
-		hashDb->put((void*)tt.getRoot().data, sizeof(TTHValue), buf, sz);
+		hashWrites->put(getTreeKey(tt.getRoot()), std::move(value));
 	} catch (const DbException& e) {
-		free(buf);
 		throw HashException(STRING_F(WRITE_FAILED_X, hashDb->getNameLower() % e.getError()));
 	}
-
-	free(buf);
 }
 
 bool HashStore::getTree(const TTHValue& aRoot, TigerTree& tt_) {
 	try {
-		return hashDb->get((void*)aRoot.data, sizeof(TTHValue), 100 * 1024, [&](void* aValue, size_t valueLen) {
+		return hashWrites->get(getTreeKey(aRoot), 100 * 1024, [&](void* aValue, size_t valueLen) {
 			return loadTree(aValue, valueLen, aRoot, tt_, true);
 		});
 	} catch (const DbException& e) {
@@ -198,7 +537,7 @@ bool HashStore::getTree(const TTHValue& aRoot, TigerTree& tt_) {
 bool HashStore::hasTree(const TTHValue& aRoot) {
 	bool ret = false;
 	try {
-		ret = hashDb->hasKey((void*)aRoot.data, sizeof(TTHValue));
+		ret = hashWrites->hasKey(getTreeKey(aRoot));
 	} catch (const DbException& e) {
 		throw HashException(STRING_F(READ_FAILED_X, hashDb->getNameLower() % e.getError()));
 	}
@@ -303,7 +642,7 @@ uint32_t HashStore::getFileInfoSize(const HashedFile& /*aTree*/) {
 int64_t HashStore::getRootInfo(const TTHValue& root, InfoType aType) noexcept {
 	int64_t ret = 0;
 	try {
-		hashDb->get((void*)root.data, sizeof(TTHValue), 100 * 1024, [&](void* aValue, size_t /*valueLen*/) {
+		hashWrites->get(getTreeKey(root), 100 * 1024, [&](void* aValue, size_t /*valueLen*/) {
 			char* p = (char*)aValue;
 
 			uint8_t version;
@@ -339,8 +678,15 @@ bool HashStore::checkTTH(const string& aFileLower, HashedFile& fi_) noexcept {
 }
 
 bool HashStore::getFileInfo(const string& aFileLower, HashedFile& fi_) noexcept {
+	// The directory is resolved from memory
+	auto key = findFileKey(aFileLower);
+	if (key.empty()) {
+		return false;
+	}
+
 	try {
-		return fileDb->get((void*)aFileLower.c_str(), aFileLower.length(), sizeof(HashedFile), [&](void* aValue, size_t valueLen) {
+		// Pending writes are checked first
+		return fileWrites->get(key, sizeof(HashedFile), [&](void* aValue, size_t valueLen) {
 			return loadFileInfo(aValue, valueLen, fi_);
 		});
 	} catch (const DbException& e) {
@@ -351,6 +697,14 @@ bool HashStore::getFileInfo(const string& aFileLower, HashedFile& fi_) noexcept
 }
 
 void HashStore::optimize(bool doVerify) noexcept {
+	optimize(
+		doVerify,
+		[](const string& aPathLower) { return ShareManager::getInstance()->isRealPathShared(aPathLower); },
+		[](const TTHValue& aRoot) { return QueueManager::getInstance()->isFileQueued(aRoot); }
+	);
+}
+
+void HashStore::optimize(bool doVerify, const IsSharedF& aIsSharedF, const IsQueuedF& aIsQueuedF) noexcept {
 
 	int unusedTrees = 0;
 	int failedTrees = 0;
@@ -363,6 +717,15 @@ void HashStore::optimize(bool doVerify) noexcept {
 
 	log(STRING(HASHDB_MAINTENANCE_STARTED), LogMessage::SEV_INFO);
 
+	// The snapshots must contain everything that has been added so far
+	try {
+		flush();
+	} catch (const HashException& e) {
+		log(e.getError(), LogMessage::SEV_ERROR);
+		log(STRING(HASHDB_MAINTENANCE_FAILED), LogMessage::SEV_ERROR);
+		return;
+	}
+
 	{
 		unordered_set<TTHValue> usedRoots;
 
@@ -373,15 +736,40 @@ void HashStore::optimize(bool doVerify) noexcept {
 		HashedFile fi;
 		string path;
 
+		// Directories that were known when the snapshots were taken
+		unordered_map<DirectoryId, string> directoryPaths;
+		unordered_set<DirectoryId> usedDirectories;
+		{
+			RLock l(directoryCS);
+			for (const auto& [directoryPath, id]: directoryIds) {
+				directoryPaths.emplace(id, directoryPath);
+			}
+		}
+
 		// lookup each item in file index from the share
 		try {
 			fileDb->remove_if([&](void* aKey, size_t key_len, void* aValue, size_t valueLen) {
-				path = string((const char*)aKey, key_len);
-				if (ShareManager::getInstance()->isRealPathShared(path)) {
+				if (!isFileKey(aKey, key_len)) {
+					// Directory table is cleaned up separately
+					return false;
+				}
+
+				auto directoryId = parseDirectoryId(aKey);
+				auto d = directoryPaths.find(directoryId);
+				if (d == directoryPaths.end()) {
+					// Orphaned entry
+					unusedFiles++;
+					return true;
+				}
+
+				path = d->second;
+				path.append(static_cast<const char*>(aKey) + 1 + sizeof(DirectoryId), key_len - 1 - sizeof(DirectoryId));
+				if (aIsSharedF(path)) {
 					if (!loadFileInfo(aValue, valueLen, fi))
 						return true;
 
 					usedRoots.emplace(fi.getRoot());
+					usedDirectories.emplace(directoryId);
 					validFiles++;
 					return false;
 				}
@@ -396,6 +784,27 @@ void HashStore::optimize(bool doVerify) noexcept {
 			return;
 		}
 
+		// Remove directories without files
+		// A file added in such directory during the maintenance would just be rehashed later
+		try {
+			for (const auto& [id, directoryPath]: directoryPaths) {
+				if (usedDirectories.contains(id)) {
+					continue;
+				}
+
+				{
+					WLock l(directoryCS);
+					directoryIds.erase(directoryPath);
+				}
+
+				fileWrites->remove(getDirectoryKey(directoryPath));
+			}
+
+			fileWrites->flush();
+		} catch (const DbException& e) {
+			log(STRING_F(WRITE_FAILED_X, fileDb->getNameLower() % e.getError()), LogMessage::SEV_ERROR);
+		}
+
 		//remove trees that aren't shared or queued and optionally check whether each tree can be loaded
 		TigerTree tt;
 		TTHValue curRoot;
@@ -403,7 +812,7 @@ void HashStore::optimize(bool doVerify) noexcept {
 			hashDb->remove_if([&](void* aKey, size_t key_len, void* aValue, size_t valueLen) {
 				memcpy(&curRoot, aKey, key_len);
 				auto i = usedRoots.find(curRoot);
-				if (i == usedRoots.end() && !QueueManager::getInstance()->isFileQueued(curRoot)) {
+				if (i == usedRoots.end() && !aIsQueuedF(curRoot)) {
 					//not needed
 					unusedTrees++;
 					return true;
@@ -431,8 +840,11 @@ void HashStore::optimize(bool doVerify) noexcept {
 		missingTrees = static_cast<int>(usedRoots.size()) - failedTrees;
 		if (!usedRoots.empty()) {
 			try {
-				fileDb->remove_if([&](void* /*aKey*/, size_t /*key_len*/, void* aValue, size_t valueLen) {
-					loadFileInfo(aValue, valueLen, fi);
+				fileDb->remove_if([&](void* aKey, size_t key_len, void* aValue, size_t valueLen) {
+					if (!isFileKey(aKey, key_len) || !loadFileInfo(aValue, valueLen, fi)) {
+						return false;
+					}
+
 					if (usedRoots.contains(fi.getRoot())) {
 						failedSize += fi.getSize();
 						validFiles--;
@@ -486,6 +898,12 @@ void HashStore::optimize(bool doVerify) noexcept {
 }
 
 void HashStore::compact() noexcept {
+	try {
+		flush();
+	} catch (const HashException& e) {
+		log(e.getError(), LogMessage::SEV_ERROR);
+	}
+
 	log(STRING_F(COMPACTING_X, fileDb->getNameLower()), LogMessage::SEV_INFO);
 	fileDb->compact();
 	log(STRING_F(COMPACTING_X, hashDb->getNameLower()), LogMessage::SEV_INFO);
@@ -497,6 +915,11 @@ string HashStore::getDbStats() noexcept {
 	string statMsg;
 
 	statMsg += fileDb->getStats();
+	{
+		RLock l(directoryCS);
+		statMsg += "Directories: " + Util::toString(directoryIds.size()) + "\r\n";
+	}
+
 	statMsg += "Deleted entries since last compaction: " + Util::toString(SETTING(CUR_REMOVED_FILES)) + " (" + Util::toString(((double)SETTING(CUR_REMOVED_FILES) / (double)fileDb->size(false)) * 100) + "%)";
 	statMsg += "\r\n\r\n";
 
@@ -23,6 +23,8 @@
 #include <airdcpp/core/header/typedefs.h>
 
 #include <airdcpp/core/io/db/DbHandler.h>
+#include <airdcpp/core/io/db/DbWriteBuffer.h>
+#include <airdcpp/core/thread/CriticalSection.h>
 #include <airdcpp/hash/value/MerkleTree.h>
 #include <airdcpp/message/Message.h>
 
@@ -47,6 +49,12 @@ public:
 
 	void optimize(bool doVerify) noexcept;
 
+	using IsSharedF = std::function<bool(const string& aPathLower)>;
+	using IsQueuedF = std::function<bool(const TTHValue& aRoot)>;
+
+	// Removes entries for files that aren't shared and trees that aren't used by any shared or queued file
+	void optimize(bool doVerify, const IsSharedF& aIsSharedF, const IsQueuedF& aIsQueuedF) noexcept;
+
 	bool checkTTH(const string& aFileNameLower, HashedFile& fi_) noexcept;
 
 	void addTree(const TigerTree& tt);
@@ -71,11 +79,67 @@ public:
 	void getDbSizes(int64_t& fileDbSize_, int64_t& hashDbSize_) const noexcept;
 	void compact() noexcept;
 
+	// Commits the pending database writes
+	// Throws HashException
+	void flush();
+
+	// Commits the pending database writes that have waited for too long
+	void flushExpired(uint64_t aTick) noexcept;
+
 	static void log(const string& aMsg, LogMessage::Severity aSeverity) noexcept;
 private:
 	std::unique_ptr<DbHandler> fileDb;
 	std::unique_ptr<DbHandler> hashDb;
 
+	// All writes are combined into batches, the file index entries are committed only after the trees that they refer to
+	std::unique_ptr<DbWriteBuffer> fileWrites;
+	std::unique_ptr<DbWriteBuffer> hashWrites;
+
+	enum DbType {
+		DB_HASH_DATA,
+		DB_FILE_INDEX
+	};
+
+	static string getDbPath(DbType aType, int aBackend) noexcept;
+	static unique_ptr<DbHandler> createDb(DbType aType, int aBackend);
+	static unique_ptr<DbHandler> createDb(DbType aType, int aBackend, const string& aPath);
+
+	// Copies the data from another backend if the target database doesn't exist yet
+	// The data is imported in a temporary directory that is renamed only after the import has completed
+	// Throws DbException/FileException
+	void importDb(DbType aType, int aBackend, int aSourceBackend, StartupLoader& aLoader);
+
+	static string getTreeKey(const TTHValue& aRoot) noexcept { return string(reinterpret_cast<const char*>(aRoot.data), TTHValue::BYTES); }
+
+	// File index
+	// Files are keyed by the ID of the parent directory and the file name, the directory table maps the directory paths to IDs.
+	// The whole directory table is kept in memory so that file lookups can be performed with a single database read.
+	using DirectoryId = uint32_t;
+
+	static string getDirectoryKey(const string& aDirectoryLower) noexcept;
+	static string getFileKey(DirectoryId aDirectoryId, const string_view& aNameLower) noexcept;
+
+	static bool isFileKey(const void* aKey, size_t aKeyLen) noexcept;
+	static DirectoryId parseDirectoryId(const void* aKey) noexcept;
+
+	// Returns an empty string if the directory doesn't exist in the index
+	string findFileKey(const string& aFileLower) const noexcept;
+
+	// Adds a new directory entry if needed
+	// Throws DbException
+	DirectoryId getDirectoryId(const string& aDirectoryLower);
+
+	// Throws DbException
+	void loadDirectories();
+
+	// Converts a file index using full paths as keys
+	// Throws DbException
+	void migrateFileIndex(StartupLoader& aLoader);
+
+	unordered_map<string, DirectoryId> directoryIds;
+	DirectoryId nextDirectoryId = 0;
+	mutable SharedMutex directoryCS;
+
 	static bool loadTree(const void* src, size_t len, const TTHValue& aRoot, TigerTree& aTree, bool aReportCorruption);
 
 	static bool loadFileInfo(const void* src, size_t len, HashedFile& aFile);
@@ -21,8 +21,10 @@
 #include <airdcpp/hash/Hasher.h>
 
 #include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/classes/ScopedFunctor.h>
 #include <airdcpp/core/io/File.h>
 #include <airdcpp/core/io/FileReader.h>
+#include <airdcpp/hash/HasherPipeline.h>
 #include <airdcpp/hash/HasherStats.h>
 #include <airdcpp/hash/HashedFile.h>
 #include <airdcpp/hash/value/MerkleTree.h>
@@ -46,6 +48,24 @@ Hasher::Hasher(bool aIsPaused, int aHasherID, HasherManager* aManager) : hasherI
 	start();
 }
 
+// Defined here because HasherPipeline is incomplete in the header
+Hasher::~Hasher() = default;
+
+HasherPipeline* Hasher::getPipeline(int64_t aFileSize) noexcept {
+	auto workers = manager->getPipelineWorkerCount();
+	if (workers <= 1 || aFileSize < static_cast<int64_t>(HasherPipeline::CHUNK_SIZE) * 2) {
+		// Not worth it
+		return nullptr;
+	}
+
+	if (!pipeline || pipeline->getWorkerCount() != workers) {
+		pipeline.reset();
+		pipeline = make_unique<HasherPipeline>(workers);
+	}
+
+	return pipeline.get();
+}
+
 bool Hasher::pause() noexcept {
 	paused = true;
 	return paused;
@@ -251,6 +271,19 @@ optional<HashedFile> Hasher::hashFile(const WorkItem& aItem, HasherStats& stats_
 
 		uint64_t lastRead = GET_TICK();
 
+		// Hash the leaves with multiple threads?
+		auto parallelHasher = getPipeline(size);
+		if (parallelHasher) {
+			parallelHasher->start(tt);
+		}
+
+		// Make sure that the workers are finished before the tree is destructed
+		ScopedFunctor([parallelHasher] {
+			if (parallelHasher) {
+				parallelHasher->finish();
+			}
+		});
+
 		FileReader fr(FileReader::ASYNC);
 		fr.read(aItem.filePath, [&](const void* buf, size_t n) {
 			if (SETTING(MAX_HASH_SPEED) > 0) {
@@ -265,7 +298,11 @@ optional<HashedFile> Hasher::hashFile(const WorkItem& aItem, HasherStats& stats_
 				lastRead = GET_TICK();
 			}
 
-			tt.update(buf, n);
+			if (parallelHasher) {
+				parallelHasher->update(buf, n);
+			} else {
+				tt.update(buf, n);
+			}
 
 			if (fileCRC) {
 				crc32(buf, n);
@@ -282,6 +319,10 @@ optional<HashedFile> Hasher::hashFile(const WorkItem& aItem, HasherStats& stats_
 			return !stopping;
 		});
 
+		if (parallelHasher) {
+			parallelHasher->finish();
+		}
+
 		tt.finalize();
 
 		auto failed = (fileCRC && crc32.getValue() != *fileCRC) || stopping;
@@ -290,6 +331,9 @@ optional<HashedFile> Hasher::hashFile(const WorkItem& aItem, HasherStats& stats_
 		auto duration = end - start;
 		if (!failed) {
 			stats_.addFile(size, duration);
+			if (parallelHasher) {
+				stats_.addPipelineFile(size, duration, parallelHasher->getWaitTime());
+			}
 		}
 
 		if (!stopping) {
@@ -427,6 +471,20 @@ void HasherStats::addFile(int64_t aSize, uint64_t aHashTime) noexcept {
 	}
 }
 
+void HasherStats::addPipelineFile(int64_t aSize, uint64_t aHashTime, uint64_t aWaitTime) noexcept {
+	pipelineSizeHashed += aSize;
+	pipelineHashTime += aHashTime;
+	pipelineWaitTime += aWaitTime;
+
+	if (parent) {
+		parent->addPipelineFile(aSize, aHashTime, aWaitTime);
+	}
+}
+
+int64_t HasherStats::getPipelineSpeed() const noexcept {
+	return pipelineHashTime > 0 ? ((pipelineSizeHashed * 1000) / static_cast<int64_t>(pipelineHashTime)) : 0;
+}
+
 int Hasher::run() {
 	setCurrentThreadPriority(Thread::IDLE);
 
@@ -32,6 +32,7 @@
 namespace dcpp {
 	using devid = int64_t;
 	class DirSFVReader;
+	class HasherPipeline;
 	class HasherStats;
 	class Hasher : public Thread {
 	public:
@@ -39,6 +40,7 @@ namespace dcpp {
 		static const int64_t MIN_BLOCK_SIZE;
 
 		Hasher(bool isPaused, int aHasherID, HasherManager* aManager);
+		~Hasher() override;
 
 		bool hashFile(const string& filePath, const string& filePathLower, int64_t size, devid aDeviceId) noexcept;
 
@@ -98,6 +100,10 @@ namespace dcpp {
 		void processQueue() noexcept;
 		optional<HashedFile> hashFile(const WorkItem& aItem, HasherStats& stats_, const DirSFVReader& aSFV) noexcept;
 
+		// Returns nullptr if the file should be hashed by the current thread
+		HasherPipeline* getPipeline(int64_t aFileSize) noexcept;
+		unique_ptr<HasherPipeline> pipeline;
+
 		SortedVector<WorkItem, std::deque, string, PathUtil::PathSortOrderInt, WorkItem::NameLower> w;
 
 		Semaphore s;
@@ -33,6 +33,9 @@ namespace dcpp {
 		virtual void onHasherFinished(int aDirectoriesHashed, const HasherStats&, int aHasherId) noexcept = 0;
 		virtual void logHasher(const string& aMessage, int aHasherID, LogMessage::Severity aSeverity, bool aLock) const noexcept = 0;
 		virtual void removeHasher(int aHasherId) noexcept = 0;
+
+		// Number of threads to use for hashing a single file (values below 2 disable parallel hashing)
+		virtual int getPipelineWorkerCount() const noexcept = 0;
 	};
 } // namespace dcpp
 
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+#include <airdcpp/hash/HasherPipeline.h>
+
+#include <airdcpp/core/thread/Thread.h>
+#include <airdcpp/core/timer/TimerManager.h>
+
+namespace dcpp {
+
+// Number of buffers per worker (allows the reader to fill the next buffer while the previous ones are being hashed)
+#define CHUNKS_PER_WORKER 2
+
+HasherPipeline::Chunk::Chunk() :
+	data(static_cast<uint8_t*>(::operator new(CHUNK_SIZE, std::align_val_t(BUFFER_ALIGNMENT)))),
+	hashes(CHUNK_SIZE / TigerTree::BASE_BLOCK_SIZE)
+{
+
+}
+
+HasherPipeline::Chunk::~Chunk() {
+	::operator delete(data, std::align_val_t(BUFFER_ALIGNMENT));
+}
+
+HasherPipeline::HasherPipeline(int aWorkerCount) {
+	dcassert(aWorkerCount > 0);
+	for (int i = 0; i < aWorkerCount * CHUNKS_PER_WORKER; ++i) {
+		chunks.push_back(make_unique<Chunk>());
+	}
+
+	for (int i = 0; i < aWorkerCount; ++i) {
+		workers.emplace_back(&HasherPipeline::runWorker, this);
+	}
+}
+
+HasherPipeline::~HasherPipeline() {
+	{
+		std::scoped_lock l(mutex);
+		stopping = true;
+	}
+
+	workAvailable.notify_all();
+	for (auto& w : workers) {
+		w.join();
+	}
+}
+
+void HasherPipeline::runWorker() noexcept {
+	Thread::setCurrentThreadPriority(Thread::IDLE);
+
+	for (;;) {
+		Chunk* chunk = nullptr;
+
+		{
+			std::unique_lock l(mutex);
+			workAvailable.wait(l, [this] { return stopping || !pendingChunks.empty(); });
+			if (stopping) {
+				return;
+			}
+
+			chunk = &getChunkUnsafe(pendingChunks.front());
+			pendingChunks.pop_front();
+		}
+
+		// The chunk isn't accessed by other threads until it has been marked as hashed
+		hashChunk(*chunk);
+
+		{
+			std::scoped_lock l(mutex);
+			chunk->state = Chunk::State::HASHED;
+		}
+
+		chunkHashed.notify_all();
+	}
+}
+
+void HasherPipeline::hashChunk(Chunk& aChunk) noexcept {
+	TigerTree::hashBaseBlocks(aChunk.data, aChunk.len, aChunk.hashes.data());
+}
+
+void HasherPipeline::start(TigerTree& tree_) noexcept {
+	std::scoped_lock l(mutex);
+	dcassert(nextReduce == nextSubmit && !currentChunk);
+	tree = &tree_;
+	waitTime = 0;
+}
+
+void HasherPipeline::submitCurrentUnsafe() noexcept {
+	dcassert(currentChunk && currentChunk->state == Chunk::State::FILLING);
+	currentChunk->state = Chunk::State::PENDING;
+	currentChunk = nullptr;
+
+	pendingChunks.push_back(nextSubmit);
+	nextSubmit++;
+
+	workAvailable.notify_one();
+}
+
+void HasherPipeline::reduceUnsafe(std::unique_lock<std::mutex>& aLock, uint64_t aWaitUntil) noexcept {
+	while (nextReduce < nextSubmit) {
+		auto& chunk = getChunkUnsafe(nextReduce);
+		if (chunk.state != Chunk::State::HASHED) {
+			if (nextReduce >= aWaitUntil) {
+				return;
+			}
+
+			auto waitStart = GET_TICK();
+			chunkHashed.wait(aLock, [&chunk] { return chunk.state == Chunk::State::HASHED; });
+			waitTime += GET_TICK() - waitStart;
+		}
+
+		// Only the reading thread may access hashed chunks
+		aLock.unlock();
+		tree->updateBaseBlocks(chunk.hashes.data(), TigerTree::calcBlocks(chunk.len, TigerTree::BASE_BLOCK_SIZE), chunk.len);
+		aLock.lock();
+
+		chunk.state = Chunk::State::FREE;
+		nextReduce++;
+	}
+}
+
+void HasherPipeline::update(const void* aData, size_t aLen) noexcept {
+	auto data = static_cast<const uint8_t*>(aData);
+
+	std::unique_lock l(mutex);
+	while (aLen > 0) {
+		if (!currentChunk) {
+			// Wait for a free buffer
+			if (nextSubmit >= chunks.size()) {
+				reduceUnsafe(l, nextSubmit - chunks.size() + 1);
+			}
+
+			currentChunk = &getChunkUnsafe(nextSubmit);
+			dcassert(currentChunk->state == Chunk::State::FREE);
+			currentChunk->state = Chunk::State::FILLING;
+			currentChunk->len = 0;
+		}
+
+		// Copy the data
+		auto n = min(aLen, CHUNK_SIZE - currentChunk->len);
+		l.unlock();
+		memcpy(currentChunk->data + currentChunk->len, data, n);
+		l.lock();
+
+		currentChunk->len += n;
+		data += n;
+		aLen -= n;
+
+		if (currentChunk->len == CHUNK_SIZE) {
+			submitCurrentUnsafe();
+		}
+	}
+
+	// Add whatever is ready
+	reduceUnsafe(l, 0);
+}
+
+void HasherPipeline::finish() noexcept {
+	std::unique_lock l(mutex);
+	if (currentChunk) {
+		submitCurrentUnsafe();
+	}
+
+	reduceUnsafe(l, nextSubmit);
+	tree = nullptr;
+}
+
+} // namespace dcpp
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_HASHER_PIPELINE_H
+#define DCPLUSPLUS_DCPP_HASHER_PIPELINE_H
+
+#include <airdcpp/core/header/typedefs.h>
+
+#include <airdcpp/hash/value/MerkleTree.h>
+
+#include <condition_variable>
+#include <thread>
+
+namespace dcpp {
+
+// Calculates the leaf hashes of a Tiger tree with multiple threads
+//
+// The reading thread copies the file data in a bounded ring of aligned buffers. Worker threads
+// hash the 1 KiB base blocks of each buffer and the results are added in the tree in the original
+// order by the reading thread.
+class HasherPipeline {
+public:
+	// Data size that is handed to a worker at once
+	static const size_t CHUNK_SIZE = 1024 * 1024;
+	static const size_t BUFFER_ALIGNMENT = 4096;
+
+	explicit HasherPipeline(int aWorkerCount);
+	~HasherPipeline();
+
+	// Start hashing a new file
+	void start(TigerTree& tree_) noexcept;
+
+	// Sizes must be multiples of the base block size, unless it's the last block of the file
+	void update(const void* aData, size_t aLen) noexcept;
+
+	// Wait until all data has been added in the tree (the tree won't be finalized)
+	void finish() noexcept;
+
+	int getWorkerCount() const noexcept {
+		return static_cast<int>(workers.size());
+	}
+
+	// Total time that the reader had to wait for the workers for the current file
+	uint64_t getWaitTime() const noexcept {
+		return waitTime;
+	}
+
+	HasherPipeline(const HasherPipeline&) = delete;
+	HasherPipeline& operator=(const HasherPipeline&) = delete;
+private:
+	struct Chunk {
+		enum class State : uint8_t {
+			FREE,
+			FILLING,
+			PENDING,
+			HASHED
+		};
+
+		Chunk();
+		~Chunk();
+
+		Chunk(const Chunk&) = delete;
+		Chunk& operator=(const Chunk&) = delete;
+
+		uint8_t* const data;
+		size_t len = 0;
+		vector<TTHValue> hashes;
+		State state = State::FREE;
+	};
+
+	void runWorker() noexcept;
+	static void hashChunk(Chunk& aChunk) noexcept;
+
+	// Lock must be held
+	void submitCurrentUnsafe() noexcept;
+
+	// Add hashed chunks in the tree in order
+	// Waits until all chunks preceding the provided sequence number have been added
+	void reduceUnsafe(std::unique_lock<std::mutex>& aLock, uint64_t aWaitUntil) noexcept;
+
+	Chunk& getChunkUnsafe(uint64_t aSequence) noexcept {
+		return *chunks[aSequence % chunks.size()];
+	}
+
+	vector<unique_ptr<Chunk>> chunks;
+	vector<std::thread> workers;
+
+	std::mutex mutex;
+	std::condition_variable workAvailable;
+	std::condition_variable chunkHashed;
+
+	// Chunk sequence numbers
+	deque<uint64_t> pendingChunks;
+	uint64_t nextSubmit = 0;
+	uint64_t nextReduce = 0;
+
+	Chunk* currentChunk = nullptr;
+	TigerTree* tree = nullptr;
+	uint64_t waitTime = 0;
+
+	bool stopping = false;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_HASHER_PIPELINE_H)
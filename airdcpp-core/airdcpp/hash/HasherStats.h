@@ -31,11 +31,22 @@ namespace dcpp {
 		uint64_t hashTime = 0;
 		int filesHashed = 0;
 
+		// Files hashed with multiple threads (included in the totals above)
+		int64_t pipelineSizeHashed = 0;
+		uint64_t pipelineHashTime = 0;
+
+		// Time spent waiting for the hashing threads (the rest is spent waiting for disk reads)
+		uint64_t pipelineWaitTime = 0;
+
 		string formatDuration() const noexcept;
 		string formatSpeed() const noexcept;
 		string formatSize() const noexcept;
 
 		void addFile(int64_t aSize, uint64_t aHashTime) noexcept;
+		void addPipelineFile(int64_t aSize, uint64_t aHashTime, uint64_t aWaitTime) noexcept;
+
+		// Bytes per second
+		int64_t getPipelineSpeed() const noexcept;
 
 		HasherStats(const HasherStats&) = delete;
 	private:
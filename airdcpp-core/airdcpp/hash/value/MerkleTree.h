@@ -42,6 +42,8 @@ public:
 	static const size_t BITS = Hasher::BITS;
 	static const size_t BYTES = Hasher::BYTES;
 	static const size_t BASE_BLOCK_SIZE = baseBlockSize;
+	/** Number of base blocks that are hashed at once by update */
+	static const size_t BATCH_BLOCKS = 64;
 
 	typedef HashValue<Hasher> MerkleValue;
 	typedef vector<MerkleValue> MerkleList;
@@ -98,29 +100,74 @@ public:
 	 */
 	void update(const void* data, size_t len) {
 		uint8_t* buf = (uint8_t*)data;
-		uint8_t zero = 0;
 		size_t i = 0;
 
 		// Skip empty data sets if we already added at least one of them...
 		if(len == 0 && !(leaves.empty() && blocks.empty()))
 			return;
-		
+
+		MerkleValue hashes[BATCH_BLOCKS];
 		do {
-			size_t n = min(baseBlockSize, len-i);
-			Hasher h;
-			h.update(&zero, 1);
-			h.update(buf + i, n);
-			if((int64_t)baseBlockSize < blockSize) {
-				blocks.emplace_back(MerkleValue(h.finalize()), baseBlockSize);
-				reduceBlocks();
-			} else {
-				leaves.emplace_back(h.finalize());
+			size_t n = min(baseBlockSize * BATCH_BLOCKS, len-i);
+			size_t count = hashBaseBlocks(buf + i, n, hashes);
+			for(size_t j = 0; j < count; ++j) {
+				addBaseBlock(hashes[j]);
 			}
 			i += n;
 		} while(i < len);
 		fileSize += len;
 	}
 
+	/**
+	 * Hash consecutive blocks of data, full blocks are hashed in parallel when possible.
+	 * @param hashes Buffer for calcBlocks(len, baseBlockSize) hashes
+	 * @return Number of hashes
+	 */
+	static size_t hashBaseBlocks(const void* data, size_t len, MerkleValue* hashes) {
+		static_assert(sizeof(MerkleValue) == BYTES, "Hash values must be stored consecutively");
+
+		const uint8_t* buf = (const uint8_t*)data;
+		size_t fullBlocks = len / baseBlockSize;
+		if(fullBlocks > 0) {
+			Hasher::hashMultiple(0, buf, baseBlockSize, fullBlocks, hashes[0].data);
+		}
+
+		size_t rest = len - fullBlocks * baseBlockSize;
+		if(rest > 0 || len == 0) {
+			hashes[fullBlocks] = hashBaseBlock(buf + fullBlocks * baseBlockSize, rest);
+			return fullBlocks + 1;
+		}
+
+		return fullBlocks;
+	}
+
+	/**
+	 * Hash a single block of data (at most baseBlockSize bytes). The hashes can be
+	 * calculated in any order/thread and added in the tree with updateBaseBlocks.
+	 */
+	static MerkleValue hashBaseBlock(const void* data, size_t len) {
+		uint8_t zero = 0;
+		Hasher h;
+		h.update(&zero, 1);
+		h.update(data, len);
+		return MerkleValue(h.finalize());
+	}
+
+	/**
+	 * Update the merkle tree with precalculated block hashes (see hashBaseBlock).
+	 * @param len Length of the hashed data, the same rules apply as with update
+	 */
+	void updateBaseBlocks(const MerkleValue* hashes, size_t count, size_t len) {
+		dcassert(count == max(calcBlocks(len, baseBlockSize), (size_t)1));
+		if(len == 0 && !(leaves.empty() && blocks.empty()))
+			return;
+
+		for(size_t i = 0; i < count; ++i) {
+			addBaseBlock(hashes[i]);
+		}
+		fileSize += len;
+	}
+
 	uint8_t* finalize() {
 		// No updates yet, make sure we have at least one leaf for 0-length files...
 		if(leaves.empty() && blocks.empty()) {
@@ -205,6 +252,15 @@ private:
 		return MerkleValue(h.finalize());
 	}
 
+	void addBaseBlock(const MerkleValue& aHash) {
+		if((int64_t)baseBlockSize < blockSize) {
+			blocks.emplace_back(aHash, baseBlockSize);
+			reduceBlocks();
+		} else {
+			leaves.push_back(aHash);
+		}
+	}
+
 	void reduceBlocks() {
 		while(blocks.size() > 1) {
 			MerkleBlock& a = blocks[blocks.size()-2];
@@ -42,6 +42,13 @@
 #define TIGER_ARCH64
 #endif
 
+// Multi-buffer hashing with AVX2/AVX-512 gather instructions (selected at runtime)
+#if (defined(__amd64__) || defined(__x86_64__)) && defined(__GNUC__) && !defined(TIGER_BIG_ENDIAN)
+#define TIGER_MULTI_BUFFER
+#include <chrono>
+#include <immintrin.h>
+#endif
+
 namespace dcpp {
 
 #define PASSES 3
@@ -249,6 +256,229 @@ uint8_t* TigerHash::finalize() {
 	return getResult();
 }
 
+static void hashSingle(uint8_t aPrefix, const uint8_t* aData, size_t aLen, uint8_t* result_) {
+	TigerHash h;
+	h.update(&aPrefix, 1);
+	h.update(aData, aLen);
+	memcpy(result_, h.finalize(), TigerHash::BYTES);
+}
+
+#ifdef TIGER_MULTI_BUFFER
+
+/*
+ * Each vector lane contains the state of a different message. The S-box lookups
+ * are done with gather instructions, otherwise the compress function is the same
+ * as above (the macros are reused).
+ */
+
+typedef uint64_t tiger_v4 __attribute__((vector_size(32)));
+typedef uint64_t tiger_v8 __attribute__((vector_size(64)));
+
+/* The multipliers are always constants, avoid emulated 64 bit vector multiplications */
+#define tiger_mul_5(b) (((b) << 2) + (b))
+#define tiger_mul_7(b) (((b) << 3) - (b))
+#define tiger_mul_9(b) (((b) << 3) + (b))
+
+#undef round
+#define round(a,b,c,x,mul) \
+	c ^= x; \
+	a -= tiger_gather(t1, ((c)>>(0*8))&0xFF) ^ tiger_gather(t2, ((c)>>(2*8))&0xFF) ^ \
+	     tiger_gather(t3, ((c)>>(4*8))&0xFF) ^ tiger_gather(t4, ((c)>>(6*8))&0xFF) ; \
+	b += tiger_gather(t4, ((c)>>(1*8))&0xFF) ^ tiger_gather(t3, ((c)>>(3*8))&0xFF) ^ \
+	     tiger_gather(t2, ((c)>>(5*8))&0xFF) ^ tiger_gather(t1, ((c)>>(7*8))&0xFF) ; \
+	b = tiger_mul_##mul(b);
+
+/*
+ * Words of the message blocks are interleaved: word w of block k for lane l is located at
+ * blocks[(k * 8 + w) * lanes + l]. The state is interleaved in the same way.
+ */
+#define tiger_compress_parallel(vec_t, lanes) \
+{ \
+	vec_t a, b, c, tmpa; \
+	vec_t aa, bb, cc; \
+	vec_t x0, x1, x2, x3, x4, x5, x6, x7; \
+	int pass_no; \
+	\
+	memcpy(&a, state + 0 * lanes, sizeof(vec_t)); \
+	memcpy(&b, state + 1 * lanes, sizeof(vec_t)); \
+	memcpy(&c, state + 2 * lanes, sizeof(vec_t)); \
+	\
+	for(size_t k = 0; k < blockCount; k++, blocks += 8 * lanes) { \
+		memcpy(&x0, blocks + 0 * lanes, sizeof(vec_t)); memcpy(&x1, blocks + 1 * lanes, sizeof(vec_t)); \
+		memcpy(&x2, blocks + 2 * lanes, sizeof(vec_t)); memcpy(&x3, blocks + 3 * lanes, sizeof(vec_t)); \
+		memcpy(&x4, blocks + 4 * lanes, sizeof(vec_t)); memcpy(&x5, blocks + 5 * lanes, sizeof(vec_t)); \
+		memcpy(&x6, blocks + 6 * lanes, sizeof(vec_t)); memcpy(&x7, blocks + 7 * lanes, sizeof(vec_t)); \
+		\
+		compress; \
+	} \
+	\
+	memcpy(state + 0 * lanes, &a, sizeof(vec_t)); \
+	memcpy(state + 1 * lanes, &b, sizeof(vec_t)); \
+	memcpy(state + 2 * lanes, &c, sizeof(vec_t)); \
+}
+
+#define tiger_gather(t, idx) ((tiger_v4)_mm256_i64gather_epi64((const long long*)(t), (__m256i)(idx), 8))
+
+__attribute__((target("avx2")))
+static void tigerCompress4(const uint64_t* table, const uint64_t* blocks, size_t blockCount, uint64_t* state) {
+	tiger_compress_parallel(tiger_v4, 4);
+}
+
+#undef tiger_gather
+#define tiger_gather(t, idx) ((tiger_v8)_mm512_i64gather_epi64((__m512i)(idx), (const void*)(t), 8))
+
+__attribute__((target("avx512f")))
+static void tigerCompress8(const uint64_t* table, const uint64_t* blocks, size_t blockCount, uint64_t* state) {
+	tiger_compress_parallel(tiger_v8, 8);
+}
+
+#undef tiger_gather
+
+typedef void (*ParallelCompressF)(const uint64_t* table, const uint64_t* blocks, size_t blockCount, uint64_t* state);
+
+static ParallelCompressF getParallelCompress(size_t aLanes) {
+	switch (aLanes) {
+		case 4: return tigerCompress4;
+		case 8: return tigerCompress8;
+		default: return nullptr;
+	}
+}
+
+static void hashParallel(const uint64_t* aTable, size_t aLanes, uint8_t aPrefix, const uint8_t* aData, size_t aLen, size_t aCount, uint8_t* results_) {
+	auto compressF = getParallelCompress(aLanes);
+	dcassert(compressF);
+
+	// Padded messages: prefix, data, 0x01, zeros and the message length in bits
+	const size_t messageLen = aLen + 1;
+	const size_t blockCount = (messageLen + sizeof(uint64_t)) / 64 + 1;
+	const size_t paddedLen = blockCount * 64;
+	const uint64_t bits = static_cast<uint64_t>(messageLen) << 3;
+
+	vector<uint8_t> message(paddedLen);
+	vector<uint64_t> blocks(blockCount * 8 * aLanes);
+	uint64_t state[3 * 8];
+
+	size_t i = 0;
+	for (; i + aLanes <= aCount; i += aLanes) {
+		for (size_t lane = 0; lane < aLanes; ++lane) {
+			message[0] = aPrefix;
+			memcpy(&message[1], aData + (i + lane) * aLen, aLen);
+			message[messageLen] = 0x01;
+			memzero(&message[messageLen + 1], paddedLen - messageLen - 1 - sizeof(uint64_t));
+			memcpy(&message[paddedLen - sizeof(uint64_t)], &bits, sizeof(uint64_t));
+
+			for (size_t w = 0; w < blockCount * 8; ++w) {
+				memcpy(&blocks[w * aLanes + lane], &message[w * sizeof(uint64_t)], sizeof(uint64_t));
+			}
+
+			state[0 * aLanes + lane] = _ULL(0x0123456789ABCDEF);
+			state[1 * aLanes + lane] = _ULL(0xFEDCBA9876543210);
+			state[2 * aLanes + lane] = _ULL(0xF096A5B4C3B2E187);
+		}
+
+		compressF(aTable, blocks.data(), blockCount, state);
+
+		for (size_t lane = 0; lane < aLanes; ++lane) {
+			auto result = results_ + (i + lane) * TigerHash::BYTES;
+			for (size_t w = 0; w < 3; ++w) {
+				memcpy(result + w * sizeof(uint64_t), &state[w * aLanes + lane], sizeof(uint64_t));
+			}
+		}
+	}
+
+	// Leftovers
+	for (; i < aCount; ++i) {
+		hashSingle(aPrefix, aData + i * aLen, aLen, results_ + i * TigerHash::BYTES);
+	}
+}
+
+#endif
+
+size_t TigerHash::getParallelCount() noexcept {
+#ifdef TIGER_MULTI_BUFFER
+	static const size_t count = [] {
+		__builtin_cpu_init();
+
+		vector<size_t> candidates;
+		if (__builtin_cpu_supports("avx512f")) {
+			candidates.push_back(8);
+		}
+
+		if (__builtin_cpu_supports("avx2")) {
+			candidates.push_back(4);
+		}
+
+		if (candidates.empty()) {
+			return static_cast<size_t>(1);
+		}
+
+		// Gather instructions are slow on some CPUs (e.g. due to microcode mitigations), 
+		// pick the implementation that is actually the fastest and verify that the results are correct
+		const size_t leafSize = 1024, leafCount = 64;
+		vector<uint8_t> data(leafSize * leafCount);
+		for (size_t i = 0; i < data.size(); ++i) {
+			data[i] = static_cast<uint8_t>(i * 31 + (i >> 10));
+		}
+
+		vector<uint8_t> expected(leafCount * BYTES), results(leafCount * BYTES);
+		auto measure = [&](const std::function<void ()>& aF) {
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < 4; ++i) {
+				aF();
+			}
+
+			return std::chrono::steady_clock::now() - start;
+		};
+
+		size_t ret = 1;
+		auto bestTime = measure([&] {
+			for (size_t i = 0; i < leafCount; ++i) {
+				hashSingle(0, data.data() + i * leafSize, leafSize, expected.data() + i * BYTES);
+			}
+		});
+
+		for (auto lanes : candidates) {
+			auto time = measure([&] {
+				hashParallel(table, lanes, 0, data.data(), leafSize, leafCount, results.data());
+			});
+
+			if (results != expected) {
+				dcassert(0);
+				continue;
+			}
+
+			if (time < bestTime) {
+				bestTime = time;
+				ret = lanes;
+			}
+		}
+
+		dcdebug("TigerHash: using %d parallel lanes\n", static_cast<int>(ret));
+		return ret;
+	}();
+
+	return count;
+#else
+	return 1;
+#endif
+}
+
+void TigerHash::hashMultiple(uint8_t prefix, const void* data, size_t len, size_t count, uint8_t* results) {
+	auto buf = static_cast<const uint8_t*>(data);
+
+#ifdef TIGER_MULTI_BUFFER
+	auto lanes = getParallelCount();
+	if (lanes > 1 && count >= lanes) {
+		hashParallel(table, lanes, prefix, buf, len, count, results);
+		return;
+	}
+#endif
+
+	for (size_t i = 0; i < count; ++i) {
+		hashSingle(prefix, buf + i * len, len, results + i * BYTES);
+	}
+}
+
 uint64_t TigerHash::table[4*256] = {
 	_ULL(0x02AAB17CF7E90C5E)   /*    0 */,    _ULL(0xAC424B03E243A8EC)   /*    1 */,
 		_ULL(0x72CD5BE30DD5FCD3)   /*    2 */,    _ULL(0x6D019B93F6F97F3A)   /*    3 */,
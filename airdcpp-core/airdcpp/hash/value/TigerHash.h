@@ -57,6 +57,17 @@ public:
 	uint8_t* finalize();
 
 	uint8_t* getResult() const noexcept { return (uint8_t*) res; }
+
+	/**
+	 * Calculates the hashes of equally sized messages that are stored consecutively
+	 * in memory and preceded by a single prefix byte each (such as Merkle tree leaves).
+	 * Multiple messages are processed at once with SIMD instructions when supported by the CPU.
+	 * @param results Buffer for count * BYTES bytes
+	 */
+	static void hashMultiple(uint8_t prefix, const void* data, size_t len, size_t count, uint8_t* results);
+
+	/** Number of messages that hashMultiple can process in parallel with the current CPU */
+	static size_t getParallelCount() noexcept;
 private:
 	enum { BLOCK_SIZE = 512/8 };
 	/** 512 bit blocks for the compress function */
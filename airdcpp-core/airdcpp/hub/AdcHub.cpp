@@ -66,7 +66,6 @@ const vector<StringList> AdcHub::searchExtensions = {
 AdcHub::AdcHub(const string& aHubURL, const ClientPtr& aOldClient) :
 	Client(aHubURL, '\n', aOldClient) {
 
-	TimerManager::getInstance()->addListener(this);
 }
 
 AdcHub::~AdcHub() {
@@ -77,7 +76,6 @@ void AdcHub::shutdown(ClientPtr& aClient, bool aRedirect) {
 	resetHBRI();
 
 	Client::shutdown(aClient, aRedirect);
-	TimerManager::getInstance()->removeListener(this);
 }
 
 size_t AdcHub::getUserCount() const noexcept {
@@ -1555,8 +1553,8 @@ void AdcHub::on(Line l, const string& aLine) noexcept {
 	});
 }
 
-void AdcHub::on(TimerManagerListener::Second s, uint64_t aTick) noexcept {
-	Client::on(s, aTick);
+void AdcHub::onTimerTick(uint64_t aTick) noexcept {
+	Client::onTimerTick(aTick);
 	if(stateNormal() && (aTick > (getLastActivity() + 120*1000)) ) {
 		send("\n", 1);
 	}
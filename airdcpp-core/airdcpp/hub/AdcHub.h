@@ -160,7 +160,7 @@ private:
 
 	void onErrorMessage(const AdcCommand& c, const OnlineUserPtr& aSender) noexcept;
 
-	void on(TimerManagerListener::Second, uint64_t aTick) noexcept override;
+	void onTimerTick(uint64_t aTick) noexcept override;
 
 	unique_ptr<HBRIValidator> hbriValidator;
 
@@ -51,7 +51,8 @@ Client::Client(const string& aHubUrl, char aSeparator, const ClientPtr& aOldClie
 	hubUrl(aHubUrl),
 	separator(aSeparator)
 {
-	TimerManager::getInstance()->addListener(this);
+	tickTask = TimerManager::getInstance()->addTask("Hub tick", 1000, [this](uint64_t aTick) { onTimerTick(aTick); });
+	maintenanceTask = TimerManager::getInstance()->addTask("Hub maintenance", 60 * 1000, [this](uint64_t aTick) { onTimerMaintenance(aTick); });
 	ShareManager::getInstance()->getProfileMgr().addListener(this);
 
 	string file, proto, query, fragment;
@@ -76,7 +77,8 @@ void Client::setActive() noexcept {
 }
 
 void Client::shutdown(ClientPtr& aClient, bool aRedirect) {
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(tickTask);
+	TimerManager::getInstance()->removeTask(maintenanceTask);
 	ShareManager::getInstance()->getProfileMgr().removeListener(this);
 
 	if (!aRedirect) {
@@ -601,7 +603,7 @@ void Client::on(BufferedSocketListener::Line, const string& aLine) noexcept {
 	COMMAND_DEBUG(aLine, ProtocolCommandManager::TYPE_HUB, ProtocolCommandManager::INCOMING, getIpPort());
 }
 
-void Client::on(TimerManagerListener::Second, uint64_t aTick) noexcept{
+void Client::onTimerTick(uint64_t aTick) noexcept {
 	if (state == STATE_DISCONNECTED && getAutoReconnect() && (aTick > (getLastActivity() + getReconnDelay() * 1000))) {
 		// Try to reconnect...
 		connect();
@@ -25,7 +25,6 @@
 #include <airdcpp/connection/socket/BufferedSocketListener.h>
 #include <airdcpp/hub/ClientListener.h>
 #include <airdcpp/share/profiles/ShareProfileManagerListener.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 #include <airdcpp/protocol/AdcSupports.h>
 #include <airdcpp/core/classes/FloodCounter.h>
@@ -58,7 +57,7 @@ public:
 
 /** Yes, this should probably be called a Hub */
 class Client : 
-	public ClientBase, public ChatHandlerBase, public Speaker<ClientListener>, public BufferedSocketListener, protected TimerManagerListener, 
+	public ClientBase, public ChatHandlerBase, public Speaker<ClientListener>, public BufferedSocketListener,
 	private ShareProfileManagerListener, public HubSettings, private boost::noncopyable {
 public:
 	using UrlMap = unordered_map<string *, ClientPtr, noCaseStringHash, noCaseStringEq>;
@@ -234,8 +233,9 @@ protected:
 	virtual void search(const SearchPtr& aSearch) noexcept = 0;
 	virtual void infoImpl() noexcept = 0;
 
-	// TimerManagerListener
-	virtual void on(Second, uint64_t aTick) noexcept override;
+	// Timer tasks (run in the timer thread)
+	virtual void onTimerTick(uint64_t aTick) noexcept;
+	virtual void onTimerMaintenance(uint64_t /*aTick*/) noexcept { }
 
 	// BufferedSocketListener
 	virtual void on(BufferedSocketListener::Connecting) noexcept override;
@@ -289,6 +289,9 @@ private:
 	CountType countType = COUNT_UNCOUNTED;
 	bool countIsSharing = false;
 
+	TimerTaskId tickTask = 0;
+	TimerTaskId maintenanceTask = 0;
+
 	void destroySocket(const AsyncF& aShutdownAction = nullptr) noexcept;
 	void handleFlood(const FloodCounter::FloodResult& aResult, const string& aMessage) noexcept;
 };
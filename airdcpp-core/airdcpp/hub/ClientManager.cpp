@@ -38,11 +38,12 @@ namespace dcpp {
 using ranges::find_if;
 
 ClientManager::ClientManager() : udp(make_unique<Socket>(Socket::TYPE_UDP)), lastOfflineUserCleanup(GET_TICK()) {
-	TimerManager::getInstance()->addListener(this);
+	auto tm = TimerManager::getInstance();
+	maintenanceTask = tm->addTask("Client maintenance", 60 * 1000, [this](uint64_t aTick) { onTimerMaintenance(aTick); }, tm->getBackgroundExecutor());
 }
 
 ClientManager::~ClientManager() {
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(maintenanceTask);
 }
 
 ClientPtr ClientManager::makeClient(const string& aHubURL, const ClientPtr& aOldClient) noexcept {
@@ -1183,9 +1184,7 @@ bool ClientManager::sendNmdcUDP(const string& aData, const string& aIP, const st
 //store offline users information for approx 10minutes, no need to be accurate.
 #define USERMAP_CLEANUP_INTERVAL_MINUTES 10
 
-// LISTENERS
-void ClientManager::on(TimerManagerListener::Minute, uint64_t aTick) noexcept {
-	
+void ClientManager::onTimerMaintenance(uint64_t aTick) noexcept {
 	if (aTick > (lastOfflineUserCleanup + USERMAP_CLEANUP_INTERVAL_MINUTES * 60 * 1000)) {
 		cleanUserMap();
 		lastOfflineUserCleanup = aTick;
@@ -25,7 +25,6 @@
 #include "Client.h"
 #include "UserConnectResult.h"
 
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 #include <airdcpp/core/ActionHook.h>
 #include <airdcpp/protocol/AdcCommand.h>
@@ -40,8 +39,7 @@
 namespace dcpp {
 
 class ClientManager : public Speaker<ClientManagerListener>, 
-	private ClientListener, public Singleton<ClientManager>, 
-	private TimerManagerListener
+	private ClientListener, public Singleton<ClientManager>
 {
 	using UserMap = unordered_map<CID *, UserPtr>;
 	using UserIter = UserMap::iterator;
@@ -330,8 +328,9 @@ private:
 	void on(ClientListener::OutgoingSearch, const Client*, const SearchPtr&) noexcept override;
 	void on(ClientListener::PrivateMessage, const Client*, const ChatMessagePtr&) noexcept override;
 
-	// TimerManagerListener
-	void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
+	// Timer tasks (run in the background thread of the timer)
+	TimerTaskId maintenanceTask = 0;
+	void onTimerMaintenance(uint64_t aTick) noexcept;
 
 	void cleanUserMap() noexcept;
 };
@@ -1157,15 +1157,15 @@ void NmdcHub::on(Line, const string& aLine) noexcept {
 	onLine(aLine);
 }
 
-void NmdcHub::on(Second, uint64_t aTick) noexcept {
-	Client::on(Second(), aTick);
+void NmdcHub::onTimerTick(uint64_t aTick) noexcept {
+	Client::onTimerTick(aTick);
 
 	if(stateNormal() && (aTick > (getLastActivity() + 120*1000)) ) {
 		send("|", 1);
 	}
 }
 
-void NmdcHub::on(Minute, uint64_t /*aTick*/) noexcept {
+void NmdcHub::onTimerMaintenance(uint64_t /*aTick*/) noexcept {
 	callAsync([this] { refreshLocalIp(); });
 }
 
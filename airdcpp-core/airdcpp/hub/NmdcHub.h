@@ -114,9 +114,9 @@ private:
 	string checkNick(const string& aNick) noexcept override;
 	bool v4only() const noexcept override { return true; }
 
-	// TimerManagerListener
-	void on(TimerManagerListener::Second, uint64_t aTick) noexcept override;
-	void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
+	// Timer tasks
+	void onTimerTick(uint64_t aTick) noexcept override;
+	void onTimerMaintenance(uint64_t aTick) noexcept override;
 
 	void on(BufferedSocketListener::Connected) noexcept override;
 	void on(BufferedSocketListener::Line, const string& l) noexcept override;
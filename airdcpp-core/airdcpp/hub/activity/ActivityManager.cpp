@@ -26,12 +26,12 @@
 namespace dcpp {
 
 ActivityManager::ActivityManager() {
-	TimerManager::getInstance()->addListener(this);
+	tickTask = TimerManager::getInstance()->addTask("Away idle check", 1000, [this](uint64_t aTick) { onTimerTick(aTick); });
 	SettingsManager::getInstance()->addListener(this);
 }
 
 ActivityManager::~ActivityManager() {
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(tickTask);
 	SettingsManager::getInstance()->removeListener(this);
 }
 
@@ -52,7 +52,7 @@ void ActivityManager::updateActivity(time_t aLastActivity) noexcept {
 	}
 }
 
-void ActivityManager::on(TimerManagerListener::Second, uint64_t aTick) noexcept {
+void ActivityManager::onTimerTick(uint64_t aTick) noexcept {
 	if (!SETTING(AWAY_IDLE_TIME) || awayMode != AWAY_OFF) {
 		return;
 	}
@@ -22,7 +22,6 @@
 #include <airdcpp/core/header/typedefs.h>
 
 #include <airdcpp/settings/SettingsManagerListener.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 #include <airdcpp/core/Speaker.h>
 #include <airdcpp/core/timer/TimerManager.h>
@@ -46,7 +45,7 @@ namespace dcpp {
 		virtual void on(AwayModeChanged, AwayMode) noexcept { }
 	};
 
-	class ActivityManager : public Speaker<ActivityManagerListener>, public Singleton<ActivityManager>, public TimerManagerListener, private SettingsManagerListener
+	class ActivityManager : public Speaker<ActivityManagerListener>, public Singleton<ActivityManager>, private SettingsManagerListener
 	{
 	public:
 		ActivityManager();
@@ -61,7 +60,10 @@ namespace dcpp {
 		string getAwayMessage(const string& aAwayMsg, ParamMap& params) const noexcept;
 	private:
 		void on(SettingsManagerListener::LoadCompleted, bool aFileLoaded) noexcept override;
-		void on(TimerManagerListener::Second, uint64_t aTick) noexcept override;
+
+		// Timer tasks (run in the timer thread)
+		TimerTaskId tickTask = 0;
+		void onTimerTick(uint64_t aTick) noexcept;
 
 		AwayMode awayMode = AWAY_OFF;
 		time_t lastActivity = GET_TICK();
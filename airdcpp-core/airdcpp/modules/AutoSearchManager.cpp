@@ -46,14 +46,17 @@ using ranges::copy_if;
 
 AutoSearchManager::AutoSearchManager() noexcept
 {
-	TimerManager::getInstance()->addListener(this);
+	auto tm = TimerManager::getInstance();
+	tickTask = tm->addTask("Auto search tick", 1000, [this](uint64_t aTick) { onTimerTick(aTick); }, tm->getBackgroundExecutor());
+	maintenanceTask = tm->addTask("Auto search maintenance", 60 * 1000, [this](uint64_t aTick) { onTimerMaintenance(aTick); }, tm->getBackgroundExecutor());
 	SearchManager::getInstance()->addListener(this);
 	DirectoryListingManager::getInstance()->addListener(this);
 }
 
 AutoSearchManager::~AutoSearchManager() noexcept {
+	TimerManager::getInstance()->removeTask(tickTask);
+	TimerManager::getInstance()->removeTask(maintenanceTask);
 	SearchManager::getInstance()->removeListener(this);
-	TimerManager::getInstance()->removeListener(this);
 	QueueManager::getInstance()->removeListener(this);
 	DirectoryListingManager::getInstance()->removeListener(this);
 }
@@ -92,6 +95,7 @@ void AutoSearchManager::addAutoSearch(AutoSearchPtr aAutoSearch, bool search, bo
 	{
 		WLock l(cs);
 		searchItems.addItem(aAutoSearch);
+		matcher.updateItem(aAutoSearch);
 	}
 
 	dirty = true;
@@ -156,6 +160,7 @@ bool AutoSearchManager::updateAutoSearch(AutoSearchPtr& ipw) noexcept {
 		ipw->updateSearchTime();
 		ipw->updateStatus();
 		ipw->updateExcluded();
+		matcher.updateItem(ipw);
 	}
 
 	delayEvents.addEvent(RECALCULATE_SEARCH, [this] { resetSearchTimes(GET_TICK()); }, 1000);
@@ -174,6 +179,7 @@ void AutoSearchManager::updateStatus(AutoSearchPtr& as, bool setTabDirty) noexce
 void AutoSearchManager::changeNumber(AutoSearchPtr as, bool increase) noexcept {
 	WLock l(cs);
 	as->changeNumber(increase);
+	matcher.updateItem(as);
 	as->setLastError(Util::emptyString);
 
 	updateStatus(as, true);
@@ -187,6 +193,7 @@ void AutoSearchManager::removeAutoSearch(AutoSearchPtr& aItem) noexcept {
 		if(hasItem) {
 			fire(AutoSearchManagerListener::ItemRemoved(), aItem);
 			searchItems.removeItem(aItem);
+			matcher.removeItem(aItem);
 			dirty = true;
 		}
 	}
@@ -351,8 +358,10 @@ void AutoSearchManager::onRemoveBundle(const BundlePtr& aBundle, bool finished)
 			if (finished && as->removeOnCompleted()) {
 				removed.push_back(as);
 			} else if (as->onBundleRemoved(aBundle, finished)) {
+				matcher.updateItem(as);
 				expired.push_back(as);
 			} else {
+				matcher.updateItem(as);
 				itemsEnabled = true;
 				as->setLastError(Util::emptyString);
 				dirty = true;
@@ -437,6 +446,7 @@ void AutoSearchManager::performSearch(AutoSearchPtr& as, StringList& aHubs, Sear
 	{
 		WLock l(cs);
 		as->updatePattern();
+		matcher.updateItem(as);
 		if (as->getStatus() == AutoSearch::STATUS_FAILED_MISSING) {
 			auto p = find_if(as->getBundles(), Bundle::HasStatus(Bundle::STATUS_VALIDATION_ERROR));
 			if (p != as->getBundles().end()) {
@@ -451,6 +461,7 @@ void AutoSearchManager::performSearch(AutoSearchPtr& as, StringList& aHubs, Sear
 
 	if ((aType == TYPE_MANUAL_BG || aType == TYPE_MANUAL_FG) && !as->getEnabled()) {
 		as->setManualSearch(true);
+		pendingManualSearches = true;
 		as->setStatus(AutoSearch::STATUS_MANUAL);
 	}
 	
@@ -559,8 +570,8 @@ bool AutoSearchManager::searchItem(AutoSearchPtr& as, SearchType aType) noexcept
 }
 
 
-/* Timermanager */
-void AutoSearchManager::on(TimerManagerListener::Second, uint64_t aTick) noexcept {
+/* Timer tasks */
+void AutoSearchManager::onTimerTick(uint64_t aTick) noexcept {
 	
 	maybePopSearchItem(aTick, false);
 
@@ -571,7 +582,7 @@ void AutoSearchManager::on(TimerManagerListener::Second, uint64_t aTick) noexcep
 	}
 }
 
-void AutoSearchManager::on(TimerManagerListener::Minute, uint64_t /*aTick*/) noexcept {
+void AutoSearchManager::onTimerMaintenance(uint64_t /*aTick*/) noexcept {
 	checkItems();
 }
 
@@ -608,6 +619,7 @@ void AutoSearchManager::checkItems() noexcept {
 				}
 				dirty = true;
 				as->changeNumber(true);
+				matcher.updateItem(as);
 				as->updateStatus();
 				fireUpdate = true;
 			}
@@ -652,14 +664,23 @@ AutoSearchList AutoSearchManager::matchResult(const SearchResultPtr& sr) noexcep
 	AutoSearchList matches;
 
 	RLock l (cs);
-	for(auto& as: searchItems.getItems() | views::values) {
-		if (!as->allowNewItems() && !as->getManualSearch())
-			continue;
-			
-		if (as->getManualSearch()) {
-			as->setManualSearch(false);
-			as->updateStatus();
+
+	// Items that were searched for manually may match this result even if they wouldn't accept new items otherwise
+	AutoSearchList manualSearches;
+	if (pendingManualSearches.exchange(false)) {
+		for (auto& as: searchItems.getItems() | views::values) {
+			if (as->getManualSearch()) {
+				as->setManualSearch(false);
+				as->updateStatus();
+				manualSearches.push_back(as);
+			}
 		}
+	}
+
+	// Only the items with patterns that may match need to be checked
+	for (auto& as: matcher.getCandidates(sr)) {
+		if (!as->allowNewItems() && ranges::find(manualSearches, as) == manualSearches.end())
+			continue;
 
 		//match
 		if (as->getFileType() == SEARCH_TYPE_TTH) {
@@ -22,6 +22,7 @@
 #include <airdcpp/forward.h>
 
 #include "AutoSearchManagerListener.h"
+#include "AutoSearchMatcher.h"
 #include "AutoSearchQueue.h"
 
 #include <airdcpp/filelist/DirectoryListingManagerListener.h>
@@ -33,13 +34,12 @@
 #include <airdcpp/message/Message.h>
 #include <airdcpp/core/Singleton.h>
 #include <airdcpp/core/Speaker.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 
 namespace dcpp {
 
 class AutoSearchManager final : public Singleton<AutoSearchManager>, public Speaker<AutoSearchManagerListener>, 
-	private TimerManagerListener, private SearchManagerListener, private QueueManagerListener, private DirectoryListingManagerListener {
+	private SearchManagerListener, private QueueManagerListener, private DirectoryListingManagerListener {
 public:
 	enum SearchType {
 		TYPE_MANUAL_FG,
@@ -114,6 +114,12 @@ private:
 	void checkItems() noexcept;
 	Searches searchItems;
 
+	// Compiled patterns of searchItems (modify only while holding the write lock)
+	AutoSearchMatcher matcher;
+
+	// Set when there are items that are allowed to match the next results even if they are disabled
+	atomic<bool> pendingManualSearches { false };
+
 	void loadAutoSearch(SimpleXML& aXml);
 
 	AutoSearchPtr loadItemFromXml(SimpleXML& aXml);
@@ -135,8 +141,12 @@ private:
 	/* Listeners */
 	void on(SearchManagerListener::SR, const SearchResultPtr&) noexcept override;
 
-	void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
-	void on(TimerManagerListener::Second, uint64_t aTick) noexcept override;
+	// Timer tasks (run in the background thread of the timer)
+	TimerTaskId tickTask = 0;
+	TimerTaskId maintenanceTask = 0;
+
+	void onTimerTick(uint64_t aTick) noexcept;
+	void onTimerMaintenance(uint64_t aTick) noexcept;
 
 	void on(QueueManagerListener::BundleRemoved, const BundlePtr& aBundle) noexcept override { onRemoveBundle(aBundle, false); }
 	void on(QueueManagerListener::BundleStatusChanged, const BundlePtr& aBundle) noexcept override;
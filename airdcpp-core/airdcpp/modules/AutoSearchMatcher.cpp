@@ -0,0 +1,182 @@
+/*
+* Copyright (C) 2011-2024 AirDC++ Project
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include "stdinc.h"
+
+#include "AutoSearchMatcher.h"
+
+#include <airdcpp/search/SearchResult.h>
+#include <airdcpp/search/SearchTypes.h>
+#include <airdcpp/util/text/StringTokenizer.h>
+#include <airdcpp/util/text/Text.h>
+
+namespace dcpp {
+
+AutoSearchMatcher::Entry AutoSearchMatcher::parseEntry(const AutoSearchPtr& aItem) noexcept {
+	Entry e;
+	e.item = aItem;
+	e.target = aItem->getFileType() == SEARCH_TYPE_TTH ? TARGET_TTH : aItem->getMatchFullPath() ? TARGET_PATH : TARGET_NAME;
+
+	const auto& pattern = aItem->pattern;
+	switch (aItem->getMethod()) {
+		case StringMatch::PARTIAL: {
+			StringTokenizer<string> st(pattern, ' ');
+			for (const auto& token: st.getTokens()) {
+				if (!token.empty()) {
+					e.literals.push_back(token);
+				}
+			}
+
+			// Only spaces, matches everything
+			e.always = e.literals.empty();
+			break;
+		}
+		case StringMatch::EXACT: {
+			e.exact = Text::toLower(pattern);
+			break;
+		}
+		case StringMatch::WILDCARD: {
+			// Alternatives are passed to the regex as they are
+			if (pattern.find('|') != string::npos) {
+				e.always = true;
+				break;
+			}
+
+			string::size_type i = 0, j;
+			while ((j = pattern.find_first_of("*?", i)) != string::npos) {
+				if (j > i) {
+					e.literals.push_back(pattern.substr(i, j - i));
+				}
+
+				i = j + 1;
+			}
+
+			if (i < pattern.size()) {
+				e.literals.push_back(pattern.substr(i));
+			}
+
+			e.always = e.literals.empty();
+			break;
+		}
+		default: {
+			e.always = true;
+			break;
+		}
+	}
+
+	return e;
+}
+
+void AutoSearchMatcher::updateItem(const AutoSearchPtr& aItem) noexcept {
+	auto e = parseEntry(aItem);
+
+	WLock l(cs);
+	entries.insert_or_assign(aItem->getToken(), std::move(e));
+	dirty = true;
+}
+
+void AutoSearchMatcher::removeItem(const AutoSearchPtr& aItem) noexcept {
+	WLock l(cs);
+	entries.erase(aItem->getToken());
+	dirty = true;
+}
+
+void AutoSearchMatcher::Index::clear() noexcept {
+	search.clear();
+	literalEntries.clear();
+	entries.clear();
+	exact.clear();
+	always.clear();
+}
+
+void AutoSearchMatcher::rebuild() noexcept {
+	for (auto& index: indexes) {
+		index.clear();
+	}
+
+	for (const auto& e: entries | views::values) {
+		auto& index = indexes[e.target];
+		if (e.always) {
+			index.always.push_back(e.item);
+		} else if (!e.literals.empty()) {
+			auto entryPos = index.entries.size();
+			index.entries.push_back(&e);
+			for (const auto& literal: e.literals) {
+				index.search.addString(literal, static_cast<MultiStringSearch::PatternId>(index.literalEntries.size()));
+				index.literalEntries.push_back(entryPos);
+			}
+		} else if (!e.exact.empty()) {
+			index.exact.emplace(e.exact, e.item);
+		}
+	}
+
+	for (auto& index: indexes) {
+		index.search.build();
+	}
+}
+
+void AutoSearchMatcher::Index::match(const string& aStrLower, AutoSearchList& candidates_) const noexcept {
+	if (aStrLower.empty()) {
+		return;
+	}
+
+	if (!search.empty()) {
+		// The same literal may occur multiple times in the string
+		unordered_set<MultiStringSearch::PatternId> foundLiterals;
+		unordered_map<size_t, size_t> foundCounts;
+
+		search.matchLower(aStrLower, [&](MultiStringSearch::PatternId aId) {
+			if (!foundLiterals.insert(aId).second) {
+				return;
+			}
+
+			auto entryPos = literalEntries[aId];
+			auto entry = entries[entryPos];
+			if (++foundCounts[entryPos] == entry->literals.size()) {
+				candidates_.push_back(entry->item);
+			}
+		});
+	}
+
+	auto exactMatches = exact.equal_range(aStrLower);
+	for (auto i = exactMatches.first; i != exactMatches.second; ++i) {
+		candidates_.push_back(i->second);
+	}
+
+	candidates_.insert(candidates_.end(), always.begin(), always.end());
+}
+
+AutoSearchList AutoSearchMatcher::getCandidates(const SearchResultPtr& aResult) noexcept {
+	if (dirty) {
+		WLock l(cs);
+		if (dirty) {
+			rebuild();
+			dirty = false;
+		}
+	}
+
+	AutoSearchList ret;
+
+	RLock l(cs);
+	indexes[TARGET_NAME].match(Text::toLower(aResult->getFileName()), ret);
+	indexes[TARGET_PATH].match(Text::toLower(aResult->getAdcPath()), ret);
+	indexes[TARGET_TTH].match(Text::toLower(aResult->getTTH().toBase32()), ret);
+	return ret;
+}
+
+}
@@ -0,0 +1,92 @@
+/*
+* Copyright (C) 2011-2024 AirDC++ Project
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef DCPP_AUTOSEARCHMATCHER_H
+#define DCPP_AUTOSEARCHMATCHER_H
+
+#include <airdcpp/core/header/typedefs.h>
+
+#include "AutoSearch.h"
+
+#include <airdcpp/core/thread/CriticalSection.h>
+#include <airdcpp/util/text/MultiStringSearch.h>
+
+namespace dcpp {
+
+// Index of the auto search patterns that is used for picking the items that may match a search result
+// without running the matcher of each item separately
+//
+// Partial patterns and the literal parts of wildcard patterns are compiled into a single automaton for each match target
+// and exact patterns are looked up by value. Regular expressions can't be combined so those will always be returned.
+// The returned candidates must still be checked with the item matcher.
+class AutoSearchMatcher {
+public:
+	// Must be called whenever the pattern, match method, file type or path matching option of the item changes
+	void updateItem(const AutoSearchPtr& aItem) noexcept;
+	void removeItem(const AutoSearchPtr& aItem) noexcept;
+
+	AutoSearchList getCandidates(const SearchResultPtr& aResult) noexcept;
+private:
+	enum Target {
+		TARGET_NAME,
+		TARGET_PATH,
+		TARGET_TTH,
+		TARGET_LAST
+	};
+
+	struct Entry {
+		AutoSearchPtr item;
+		Target target = TARGET_NAME;
+
+		// All of these must be found from the string (unless the item should always be checked)
+		StringList literals;
+
+		// Lower case pattern for exact matching
+		string exact;
+
+		bool always = false;
+	};
+
+	struct Index {
+		MultiStringSearch search;
+
+		// Pattern ID -> position in entries
+		vector<size_t> literalEntries;
+		vector<const Entry*> entries;
+
+		unordered_multimap<string, AutoSearchPtr> exact;
+		AutoSearchList always;
+
+		void clear() noexcept;
+		void match(const string& aStrLower, AutoSearchList& candidates_) const noexcept;
+	};
+
+	static Entry parseEntry(const AutoSearchPtr& aItem) noexcept;
+	void rebuild() noexcept;
+
+	unordered_map<ProfileToken, Entry> entries;
+	Index indexes[TARGET_LAST];
+
+	// Entries are updated immediately while the indexes are rebuilt only when needed
+	atomic<bool> dirty { false };
+	SharedMutex cs;
+};
+
+}
+
+#endif
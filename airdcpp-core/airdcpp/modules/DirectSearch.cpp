@@ -28,9 +28,8 @@
 namespace dcpp {
 	DirectSearch::DirectSearch(const HintedUser& aUser, const SearchPtr& aSearch, uint64_t aNoResultTimeout) : noResultTimeout(aNoResultTimeout) {
 		ClientManager::getInstance()->addListener(this);
-		SearchManager::getInstance()->addListener(this);
-
 		searchToken = aSearch->token;
+		SearchManager::getInstance()->addResultRoute(searchToken, this);
 
 		maxResultCount = aSearch->maxResults;
 
@@ -100,6 +99,6 @@ namespace dcpp {
 
 	void DirectSearch::removeListeners() noexcept {
 		ClientManager::getInstance()->removeListener(this);
-		SearchManager::getInstance()->removeListener(this);
+		SearchManager::getInstance()->removeResultRoute(this);
 	}
 } // namespace dcpp
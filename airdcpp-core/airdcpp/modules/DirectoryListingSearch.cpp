@@ -24,6 +24,7 @@
 
 #include <airdcpp/share/ShareManager.h>
 #include <airdcpp/search/SearchQuery.h>
+#include <airdcpp/core/timer/TimerManager.h>
 
 
 namespace dcpp {
@@ -39,7 +40,7 @@ DirectoryListingSearch::DirectoryListingSearch(const DirectoryListingPtr& aList,
 DirectoryListingSearch::~DirectoryListingSearch() {
 	dcdebug("Filelist deleted\n");
 
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(searchTask);
 }
 
 bool DirectoryListingSearch::supportsASCH() const noexcept {
@@ -68,7 +69,12 @@ void DirectoryListingSearch::searchImpl(const SearchPtr& aSearch) noexcept {
 
 		endSearch(false);
 	} else if (list->getPartialList() && !list->getUser()->isNMDC()) {
-		TimerManager::getInstance()->addListener(this);
+		if (!searchTask) {
+			// Checked in the list thread
+			searchTask = TimerManager::getInstance()->addTask("Filelist search", 1000, [this](uint64_t aTick) { onTimerSearch(aTick); }, [this](Callback&& aTask) {
+				list->addAsyncTask(std::move(aTask));
+			});
+		}
 
 		directSearch.reset(new DirectSearch(list->getHintedUser(), aSearch));
 	} else {
@@ -81,13 +87,18 @@ void DirectoryListingSearch::searchImpl(const SearchPtr& aSearch) noexcept {
 	}
 }
 
-void DirectoryListingSearch::on(TimerManagerListener::Second, uint64_t /*aTick*/) noexcept {
+void DirectoryListingSearch::onTimerSearch(uint64_t /*aTick*/) noexcept {
 	if (directSearch && directSearch->finished()) {
 		endSearch(directSearch->hasTimedOut());
 	}
 }
 
 void DirectoryListingSearch::endSearch(bool aTimedOut /*false*/) noexcept {
+	if (searchTask) {
+		TimerManager::getInstance()->removeTask(searchTask);
+		searchTask = 0;
+	}
+
 	if (directSearch) {
 		directSearch->getAdcPaths(searchResults, true);
 		directSearch.reset(nullptr);
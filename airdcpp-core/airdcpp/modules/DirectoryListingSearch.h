@@ -23,20 +23,19 @@
 #include <airdcpp/core/header/typedefs.h>
 
 #include <airdcpp/filelist/DirectoryListingDirectory.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 namespace dcpp {
 
 class DirectSearch;
 class SearchQuery;
 
-class DirectoryListingSearch : private TimerManagerListener
+class DirectoryListingSearch
 {
 public:
 	using FailedCallback = std::function<void(bool)>;
 
 	DirectoryListingSearch(const DirectoryListingPtr& aList, FailedCallback&& aFailedHandler);
-	~DirectoryListingSearch() override;
+	~DirectoryListingSearch();
 
 	void addSearchTask(const SearchPtr& aSearch) noexcept;
 
@@ -50,7 +49,9 @@ public:
 	bool supportsASCH() const noexcept;
 	string getCurrentSearchPath() const noexcept;
 private:
-	void on(TimerManagerListener::Second, uint64_t aTick) noexcept override;
+	// Polls the direct search (run in the list thread)
+	TimerTaskId searchTask = 0;
+	void onTimerSearch(uint64_t aTick) noexcept;
 
 	void endSearch(bool timedOut = false) noexcept;
 
@@ -50,7 +50,7 @@ RSSManager::RSSManager() : tasks(true) {
 
 RSSManager::~RSSManager()
 {
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(tickTask);
 }
 
 void RSSManager::clearRSSData(const RSSPtr& aFeed) noexcept {
@@ -354,7 +354,7 @@ RSSPtr RSSManager::getUpdateItem() const noexcept {
 }
 
 
-void RSSManager::on(TimerManagerListener::Second, uint64_t aTick) noexcept {
+void RSSManager::onTimerTick(uint64_t aTick) noexcept {
 	if (rssList.empty())
 		return;
 
@@ -448,7 +448,7 @@ void RSSManager::load() {
 	} catch (...) { }
 
 	nextUpdate = GET_TICK() + 120 * 1000; //start after 120 seconds
-	TimerManager::getInstance()->addListener(this);
+	tickTask = TimerManager::getInstance()->addTask("RSS tick", 1000, [this](uint64_t aTick) { onTimerTick(aTick); });
 
 }
 
@@ -169,7 +169,7 @@ public:
 };
 
 
-class RSSManager : public Speaker<RSSManagerListener>, public Singleton<RSSManager>, private TimerManagerListener
+class RSSManager : public Speaker<RSSManagerListener>, public Singleton<RSSManager>
 {
 public:
 	friend class Singleton<RSSManager>;	
@@ -234,8 +234,9 @@ private:
 	DispatcherQueue tasks;
 
 	void downloadComplete(const string& aUrl);
-	// TimerManagerListener
-	void on(TimerManagerListener::Second, uint64_t tick) noexcept;
+	// Timer tasks (run in the timer thread)
+	TimerTaskId tickTask = 0;
+	void onTimerTick(uint64_t aTick) noexcept;
 
 };
 
@@ -89,8 +89,9 @@ QueueManager::~QueueManager() {
 }
 
 void QueueManager::shutdown() noexcept {
+	TimerManager::getInstance()->removeTask(tickTask);
+	TimerManager::getInstance()->removeTask(maintenanceTask);
 	SearchManager::getInstance()->removeListener(this);
-	TimerManager::getInstance()->removeListener(this);
 	ClientManager::getInstance()->removeListener(this);
 	ShareManager::getInstance()->removeListener(this);
 
@@ -2429,8 +2430,12 @@ void QueueManager::loadQueue(StartupLoader& aLoader) noexcept {
 	// Old Queue.xml (useful only for users migrating from other clients)
 	migrateLegacyQueue();
 
+	// Timer tasks are run in the task thread so that they won't block the timer
+	auto executor = [this](Callback&& aTask) { tasks.addTask(std::move(aTask)); };
+	tickTask = TimerManager::getInstance()->addTask("Queue tick", 1000, [this](uint64_t aTick) { onTimerTick(aTick); }, executor);
+	maintenanceTask = TimerManager::getInstance()->addTask("Queue maintenance", 60 * 1000, [this](uint64_t aTick) { onTimerMaintenance(aTick); }, executor);
+
 	// Listeners
-	TimerManager::getInstance()->addListener(this); 
 	SearchManager::getInstance()->addListener(this);
 	ClientManager::getInstance()->addListener(this);
 	ShareManager::getInstance()->addListener(this);
@@ -3037,38 +3042,34 @@ void QueueManager::checkResumeBundles() noexcept {
 	}
 }
 
-void QueueManager::on(TimerManagerListener::Second, uint64_t aTick) noexcept {
-	tasks.addTask([aTick, this] {
-		if ((lastXmlSave + 10000) < aTick) {
-			saveQueue(false);
-			lastXmlSave = aTick;
-		}
+void QueueManager::onTimerTick(uint64_t aTick) noexcept {
+	if ((lastXmlSave + 10000) < aTick) {
+		saveQueue(false);
+		lastXmlSave = aTick;
+	}
 
-		QueueItemList runningItems;
+	QueueItemList runningItems;
 
-		{
-			RLock l(cs);
-			for (const auto& q : fileQueue.getPathQueue() | views::values) {
-				if (!q->isRunning())
-					continue;
+	{
+		RLock l(cs);
+		for (const auto& q : fileQueue.getPathQueue() | views::values) {
+			if (!q->isRunning())
+				continue;
 
-				runningItems.push_back(q);
-			}
+			runningItems.push_back(q);
 		}
+	}
 
-		for (const auto& q : runningItems) {
-			fire(QueueManagerListener::ItemTick(), q);
-		}
+	for (const auto& q : runningItems) {
+		fire(QueueManagerListener::ItemTick(), q);
+	}
 
-		calculatePriorities(aTick);
-	});
+	calculatePriorities(aTick);
 }
 
-void QueueManager::on(TimerManagerListener::Minute, uint64_t aTick) noexcept {
-	tasks.addTask([aTick, this] {
-		searchAlternates(aTick);
-		checkResumeBundles();
-	});
+void QueueManager::onTimerMaintenance(uint64_t aTick) noexcept {
+	searchAlternates(aTick);
+	checkResumeBundles();
 }
 
 template<class T>
@@ -3375,6 +3376,18 @@ void QueueManager::setFileStatus(const QueueItemPtr& aFile, QueueItem::Status aN
 	}
 }
 
+vector<DupeType> QueueManager::isFileQueued(std::span<const TTHValue> aTTHs) const noexcept {
+	vector<DupeType> ret;
+	ret.reserve(aTTHs.size());
+
+	RLock l(cs);
+	for (const auto& tth: aTTHs) {
+		ret.push_back(fileQueue.isFileQueued(tth));
+	}
+
+	return ret;
+}
+
 bool QueueManager::isChunkDownloaded(const TTHValue& tth, const Segment* aSegment, int64_t& fileSize_, string& target_) noexcept {
 	QueueItemList ql;
 
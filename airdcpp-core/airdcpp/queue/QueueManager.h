@@ -24,7 +24,6 @@
 #include <airdcpp/queue/QueueManagerListener.h>
 #include <airdcpp/search/SearchManagerListener.h>
 #include <airdcpp/share/ShareManagerListener.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 #include <airdcpp/core/ActionHook.h>
 #include <airdcpp/queue/BundleQueue.h>
@@ -72,7 +71,7 @@ struct BundleFileAddHookResult {
 	Priority priority = Priority::DEFAULT;
 };
 
-class QueueManager : public Singleton<QueueManager>, public Speaker<QueueManagerListener>, private TimerManagerListener, 
+class QueueManager : public Singleton<QueueManager>, public Speaker<QueueManagerListener>,
 	private SearchManagerListener, private ClientManagerListener, private ShareManagerListener
 {
 public:
@@ -360,6 +359,9 @@ public:
 
 	DupeType isFileQueued(const TTHValue& aTTH) const noexcept { RLock l(cs); return fileQueue.isFileQueued(aTTH); }
 
+	// Checks the queue status of multiple files with a single lock
+	vector<DupeType> isFileQueued(std::span<const TTHValue> aTTHs) const noexcept;
+
 	// Get real path of the bundle
 	string getBundlePath(QueueToken aBundleToken) const noexcept;
 
@@ -549,9 +551,12 @@ private:
 	StringMatch highPrioFiles;
 	StringMatch skipList;
 
-	// TimerManagerListener
-	void on(TimerManagerListener::Second, uint64_t aTick) noexcept override;
-	void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
+	// Timer tasks (run in the task thread)
+	TimerTaskId tickTask = 0;
+	TimerTaskId maintenanceTask = 0;
+
+	void onTimerTick(uint64_t aTick) noexcept;
+	void onTimerMaintenance(uint64_t aTick) noexcept;
 
 	// Perform automatic search for alternate sources
 	void searchAlternates(uint64_t aTick) noexcept;
@@ -21,7 +21,6 @@
 
 #include <airdcpp/queue/QueueManagerListener.h>
 #include <airdcpp/search/SearchManagerListener.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 #include <airdcpp/protocol/AdcCommand.h>
 #include <airdcpp/core/thread/CriticalSection.h>
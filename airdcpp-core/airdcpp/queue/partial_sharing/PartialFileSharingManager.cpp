@@ -31,13 +31,14 @@ const auto ENABLE_DEBUG = false;
 namespace dcpp {
 
 PartialFileSharingManager::PartialFileSharingManager() {
-	TimerManager::getInstance()->addListener(this);
+	auto tm = TimerManager::getInstance();
+	maintenanceTask = tm->addTask("Partial file sharing maintenance", 60 * 1000, [this](uint64_t aTick) { onTimerMaintenance(aTick); }, tm->getBackgroundExecutor());
 	SearchManager::getInstance()->addListener(this);
 	ProtocolCommandManager::getInstance()->addListener(this);
 }
 
 PartialFileSharingManager::~PartialFileSharingManager() {
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(maintenanceTask);
 	SearchManager::getInstance()->removeListener(this);
 	ProtocolCommandManager::getInstance()->removeListener(this);
 }
@@ -407,7 +408,7 @@ void PartialFileSharingManager::requestPartialSourceInfo(uint64_t aTick, uint64_
 	}
 }
 
-void PartialFileSharingManager::on(TimerManagerListener::Minute, uint64_t aTick) noexcept {
+void PartialFileSharingManager::onTimerMaintenance(uint64_t aTick) noexcept {
 	requestPartialSourceInfo(aTick, 300000); // 5 minutes
 }
 
@@ -21,7 +21,6 @@
 
 #include <airdcpp/queue/QueueManagerListener.h>
 #include <airdcpp/search/SearchManagerListener.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 #include <airdcpp/protocol/AdcCommand.h>
 #include <airdcpp/core/thread/CriticalSection.h>
@@ -32,7 +31,7 @@
 
 namespace dcpp {
 
-class PartialFileSharingManager : private TimerManagerListener, private SearchManagerListener, private ProtocolCommandManagerListener
+class PartialFileSharingManager : private SearchManagerListener, private ProtocolCommandManagerListener
 {
 public:
 	void onPSR(const AdcCommand& cmd, UserPtr from, const string& remoteIp);
@@ -75,7 +74,9 @@ private:
 
 	string getPartsString(const PartsInfo& partsInfo) const;
 
-	void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
+	// Timer tasks (run in the background thread of the timer)
+	TimerTaskId maintenanceTask = 0;
+	void onTimerMaintenance(uint64_t aTick) noexcept;
 
 	void on(SearchManagerListener::IncomingSearch, Client* aClient, const OnlineUserPtr& aUser, const SearchQuery& aQuery, const SearchResultList&, bool aIsUdpActive) noexcept override;
 
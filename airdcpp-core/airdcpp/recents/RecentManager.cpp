@@ -59,7 +59,8 @@ RecentManager::RecentManager() {
 	DirectoryListingManager::getInstance()->addListener(this);
 	PrivateChatManager::getInstance()->addListener(this);
 
-	TimerManager::getInstance()->addListener(this);
+	auto tm = TimerManager::getInstance();
+	saveTask = tm->addTask("Recent entries save", 60 * 1000, [this](uint64_t aTick) { onTimerSave(aTick); }, tm->getDiskExecutor());
 }
 
 RecentManager::~RecentManager() {
@@ -67,7 +68,7 @@ RecentManager::~RecentManager() {
 	DirectoryListingManager::getInstance()->removeListener(this);
 	PrivateChatManager::getInstance()->removeListener(this);
 
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(saveTask);
 }
 
 RecentEntryList RecentManager::getRecents(RecentEntry::Type aType) const noexcept {
@@ -75,7 +76,7 @@ RecentEntryList RecentManager::getRecents(RecentEntry::Type aType) const noexcep
 	return recents[aType]; 
 }
 
-void RecentManager::on(TimerManagerListener::Minute, uint64_t) noexcept {
+void RecentManager::onTimerSave(uint64_t /*aTick*/) noexcept {
 	save();
 }
 
@@ -28,11 +28,10 @@
 #include <airdcpp/private_chat/PrivateChatManagerListener.h>
 #include <airdcpp/recents/RecentManagerListener.h>
 #include <airdcpp/settings/SettingsManager.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 
 namespace dcpp {
-	class RecentManager : public Speaker<RecentManagerListener>, public Singleton<RecentManager>, private TimerManagerListener,
+	class RecentManager : public Speaker<RecentManagerListener>, public Singleton<RecentManager>,
 		private ClientManagerListener, private PrivateChatManagerListener, private DirectoryListingManagerListener
 	{
 	public:
@@ -66,7 +65,9 @@ namespace dcpp {
 
 		mutable SharedMutex cs;
 
-		void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
+		// Timer tasks (run in the disk thread of the timer)
+		TimerTaskId saveTask = 0;
+		void onTimerSave(uint64_t aTick) noexcept;
 
 		void on(ClientManagerListener::ClientCreated, const ClientPtr& c) noexcept override;
 		void on(ClientManagerListener::ClientRedirected, const ClientPtr& aOldClient, const ClientPtr& aNewClient) noexcept override;
@@ -29,13 +29,8 @@
 namespace dcpp {
 	FastCriticalSection GroupedSearchResult::cs;
 
-	GroupedSearchResult::GroupedSearchResult(const SearchResultPtr& aSR, SearchResult::RelevanceInfo&& aRelevance) :
-		baseResult(aSR), relevanceInfo(std::move(aRelevance)) {
-
-		// check the dupe
-		if (SETTING(DUPE_SEARCH)) {
-			dupe = baseResult->getDupe();
-		}
+	GroupedSearchResult::GroupedSearchResult(const SearchResultPtr& aSR, SearchResult::RelevanceInfo&& aRelevance, DupeType aDupe) :
+		dupe(aDupe), baseResult(aSR), relevanceInfo(std::move(aRelevance)) {
 
 		children.push_back(aSR);
 	}
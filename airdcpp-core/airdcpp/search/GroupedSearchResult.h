@@ -41,7 +41,7 @@ namespace dcpp {
 		using Map = unordered_map<TTHValue, Ptr>;
 		using Set = multiset<Ptr, RelevanceSort>;
 
-		GroupedSearchResult(const SearchResultPtr& aSR, SearchResult::RelevanceInfo&& aRelevance);
+		GroupedSearchResult(const SearchResultPtr& aSR, SearchResult::RelevanceInfo&& aRelevance, DupeType aDupe);
 		~GroupedSearchResult() { }
 
 		bool hasUser(const UserPtr& aUser) const noexcept;
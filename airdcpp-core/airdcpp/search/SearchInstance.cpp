@@ -22,13 +22,13 @@
 #include <airdcpp/hub/ClientManager.h>
 #include <airdcpp/search/SearchManager.h>
 #include <airdcpp/search/SearchQuery.h>
+#include <airdcpp/settings/SettingsManager.h>
 #include <airdcpp/core/timer/TimerManager.h>
 
 
 namespace dcpp {
 	atomic<SearchInstanceToken> searchInstanceIdCounter { 1 };
 	SearchInstance::SearchInstance(const string& aOwnerId, uint64_t aExpirationTick) : token(searchInstanceIdCounter++), expirationTick(aExpirationTick), ownerId(aOwnerId) {
-		SearchManager::getInstance()->addListener(this);
 		ClientManager::getInstance()->addListener(this);
 	}
 
@@ -36,7 +36,7 @@ namespace dcpp {
 		ClientManager::getInstance()->cancelSearch(this);
 
 		ClientManager::getInstance()->removeListener(this);
-		SearchManager::getInstance()->removeListener(this);
+		SearchManager::getInstance()->removeResultRoute(this);
 	}
 
 	optional<int64_t> SearchInstance::getTimeToExpiration() const noexcept {
@@ -79,10 +79,15 @@ namespace dcpp {
 	void SearchInstance::reset(const SearchPtr& aSearch) noexcept {
 		ClientManager::getInstance()->cancelSearch(this);
 
+		auto matcher = shared_ptr<SearchQuery>(SearchQuery::fromSearch(aSearch));
+
+		// NMDC results don't have a token so those will be matched against all text searches
+		SearchManager::getInstance()->addResultRoute(aSearch->token, this, true, matcher->root);
+
 		{
 			WLock l(cs);
 			currentSearchToken = aSearch->token;
-			curMatcher = shared_ptr<SearchQuery>(SearchQuery::fromSearch(aSearch));
+			curMatcher = matcher;
 			curParams = aSearch;
 
 			results.clear();
@@ -213,12 +218,28 @@ namespace dcpp {
 		return relevanceInfo;
 	}
 
-	void SearchInstance::on(SearchManagerListener::SR, const SearchResultPtr& aResult) noexcept {
-		auto relevanceInfo = matchResult(aResult);
-		if (!relevanceInfo) {
+	void SearchInstance::on(SearchManagerListener::SRList, const SearchResultList& aResults) noexcept {
+		SearchResultList matchingResults;
+		vector<SearchResult::RelevanceInfo> relevanceInfos;
+		for (const auto& result: aResults) {
+			if (auto relevanceInfo = matchResult(result); relevanceInfo) {
+				matchingResults.push_back(result);
+				relevanceInfos.push_back(std::move(*relevanceInfo));
+			}
+		}
+
+		if (matchingResults.empty()) {
 			return;
 		}
 
+		// Check the dupes of the whole batch at once
+		auto dupes = SETTING(DUPE_SEARCH) ? SearchResult::getDupes(matchingResults) : vector<DupeType>(matchingResults.size(), DUPE_NONE);
+		for (size_t i = 0; i < matchingResults.size(); ++i) {
+			addResult(matchingResults[i], std::move(relevanceInfos[i]), dupes[i]);
+		}
+	}
+
+	void SearchInstance::addResult(const SearchResultPtr& aResult, SearchResult::RelevanceInfo&& aRelevanceInfo, DupeType aDupe) noexcept {
 		GroupedSearchResultPtr parent = nullptr;
 		bool created = false;
 
@@ -226,7 +247,7 @@ namespace dcpp {
 			WLock l(cs);
 			auto i = results.find(aResult->getTTH());
 			if (i == results.end()) {
-				parent = std::make_shared<GroupedSearchResult>(aResult, std::move(*relevanceInfo));
+				parent = std::make_shared<GroupedSearchResult>(aResult, std::move(aRelevanceInfo), aDupe);
 				results.try_emplace(aResult->getTTH(), parent);
 				created = true;
 			} else {
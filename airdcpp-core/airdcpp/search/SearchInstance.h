@@ -76,8 +76,9 @@ namespace dcpp {
 
 		IGETSET(bool, freeSlotsOnly, FreeSlotsOnly, false);
 	private:
-		void on(SearchManagerListener::SR, const SearchResultPtr& aResult) noexcept override;
+		void on(SearchManagerListener::SRList, const SearchResultList& aResults) noexcept override;
 		optional<SearchResult::RelevanceInfo> matchResult(const SearchResultPtr& aResult) noexcept;
+		void addResult(const SearchResultPtr& aResult, SearchResult::RelevanceInfo&& aRelevanceInfo, DupeType aDupe) noexcept;
 
 		GroupedSearchResult::Map results;
 		shared_ptr<SearchQuery> curMatcher;
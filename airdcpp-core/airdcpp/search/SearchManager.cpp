@@ -39,7 +39,7 @@ SearchManager::SearchManager() :
 	searchTypes(make_unique<SearchTypes>([this]{ fire(SearchManagerListener::SearchTypesChanged()); })), 
 	udpServer(make_unique<UDPServer>()) 
 {
-	TimerManager::getInstance()->addListener(this);
+	maintenanceTask = TimerManager::getInstance()->addTask("Search maintenance", 60 * 1000, [this](uint64_t aTick) { onTimerMaintenance(aTick); });
 
 #ifdef _DEBUG
 	CryptoUtil::testSUDP();
@@ -47,7 +47,7 @@ SearchManager::SearchManager() :
 }
 
 SearchManager::~SearchManager() {
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(maintenanceTask);
 }
 
 string SearchManager::normalizeWhitespace(const string& aString){
@@ -153,7 +153,121 @@ SearchInstanceList SearchManager::getSearchInstances() const noexcept {
 	return ret;
 }
 
-bool SearchManager::decryptPacket(string& x, size_t aLen, const ByteVector& aBuf) {
+void SearchManager::addResultRoute(const string& aToken, SearchManagerListener* aListener, bool aReceiveTokenless, const optional<TTHValue>& aTokenlessRoot) noexcept {
+	Lock l(routeCS);
+	removeResultRoute(aListener);
+
+	resultRoutes.try_emplace(aListener, ResultRoute({ aToken, aReceiveTokenless, aTokenlessRoot }));
+	if (!aToken.empty()) {
+		tokenRoutes.emplace(aToken, aListener);
+	}
+
+	if (aReceiveTokenless) {
+		if (aTokenlessRoot) {
+			tokenlessRootRoutes.emplace(*aTokenlessRoot, aListener);
+		} else {
+			tokenlessRoutes.push_back(aListener);
+		}
+	}
+}
+
+void SearchManager::removeResultRoute(SearchManagerListener* aListener) noexcept {
+	Lock l(routeCS);
+	auto i = resultRoutes.find(aListener);
+	if (i == resultRoutes.end()) {
+		return;
+	}
+
+	const auto& route = i->second;
+	auto eraseRoute = [aListener](auto& aRoutes, const auto& aKey) {
+		auto range = aRoutes.equal_range(aKey);
+		auto r = find_if(range.first, range.second, [aListener](const auto& p) { return p.second == aListener; });
+		if (r != range.second) {
+			aRoutes.erase(r);
+		}
+	};
+
+	if (!route.token.empty()) {
+		eraseRoute(tokenRoutes, route.token);
+	}
+
+	if (route.receiveTokenless) {
+		if (route.tokenlessRoot) {
+			eraseRoute(tokenlessRootRoutes, *route.tokenlessRoot);
+		} else {
+			std::erase(tokenlessRoutes, aListener);
+		}
+	}
+
+	resultRoutes.erase(i);
+}
+
+// Results of the current batch (if any)
+static thread_local SearchResultList* batchedResults = nullptr;
+
+void SearchManager::batchResults(const Callback& aCallback) noexcept {
+	dcassert(!batchedResults);
+
+	SearchResultList results;
+	batchedResults = &results;
+	aCallback();
+	batchedResults = nullptr;
+
+	if (!results.empty()) {
+		routeResults(results);
+	}
+}
+
+void SearchManager::fireResult(const SearchResultPtr& aResult) noexcept {
+	if (batchedResults) {
+		batchedResults->push_back(aResult);
+	} else {
+		routeResults({ aResult });
+	}
+
+	fire(SearchManagerListener::SR(), aResult);
+}
+
+void SearchManager::routeResults(const SearchResultList& aResults) noexcept {
+	Lock l(routeCS);
+
+	// The listeners may modify the routes
+	vector<pair<SearchManagerListener*, SearchResultList>> receivers;
+	auto addReceiver = [&receivers](SearchManagerListener* aListener, const SearchResultPtr& aResult) {
+		auto i = ranges::find_if(receivers, [aListener](const auto& r) { return r.first == aListener; });
+		if (i == receivers.end()) {
+			receivers.emplace_back(aListener, SearchResultList({ aResult }));
+		} else {
+			i->second.push_back(aResult);
+		}
+	};
+
+	for (const auto& result: aResults) {
+		if (!result->getSearchToken().empty()) {
+			auto range = tokenRoutes.equal_range(result->getSearchToken());
+			for (auto i = range.first; i != range.second; ++i) {
+				addReceiver(i->second, result);
+			}
+		} else if (result->isNMDC()) {
+			auto range = tokenlessRootRoutes.equal_range(result->getTTH());
+			for (auto i = range.first; i != range.second; ++i) {
+				addReceiver(i->second, result);
+			}
+
+			for (auto listener: tokenlessRoutes) {
+				addReceiver(listener, result);
+			}
+		}
+	}
+
+	for (const auto& [receiver, results]: receivers) {
+		if (resultRoutes.contains(receiver)) {
+			receiver->on(SearchManagerListener::SRList(), results);
+		}
+	}
+}
+
+bool SearchManager::decryptPacket(string& x, size_t aLen, const uint8_t* aBuf) {
 	RLock l (cs);
 	for (const auto& [key, _] : searchKeys | views::reverse) {
 		if (CryptoUtil::decryptSUDP(key.get(), aBuf, aLen, x)) {
@@ -264,7 +378,7 @@ void SearchManager::onSR(const string& x, const string& aRemoteIP /*Util::emptyS
 		adcPath, aRemoteIP, TTHValue(tth), Util::emptyString, 0, connection, DirectoryContentInfo::uninitialized()
 	);
 
-	fire(SearchManagerListener::SR(), sr);
+	fireResult(sr);
 }
 
 void SearchManager::onRES(const AdcCommand& cmd, const UserPtr& aFrom, const string& aRemoteIp) {
@@ -331,10 +445,10 @@ void SearchManager::onRES(const AdcCommand& cmd, const UserPtr& aFrom, const str
 		return;
 	}
 
-	fire(SearchManagerListener::SR(), sr);
+	fireResult(sr);
 }
 
-void SearchManager::on(TimerManagerListener::Minute, uint64_t aTick) noexcept {
+void SearchManager::onTimerMaintenance(uint64_t aTick) noexcept {
 	vector<SearchInstanceToken> expiredIds;
 
 	{
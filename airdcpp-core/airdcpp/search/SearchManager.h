@@ -20,9 +20,9 @@
 #define DCPLUSPLUS_DCPP_SEARCH_MANAGER_H
 
 #include <airdcpp/search/SearchManagerListener.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 #include <airdcpp/core/ActionHook.h>
+#include <airdcpp/hash/value/MerkleTree.h>
 #include <airdcpp/protocol/AdcCommand.h>
 #include <airdcpp/core/thread/CriticalSection.h>
 #include <airdcpp/core/types/GetSet.h>
@@ -45,7 +45,7 @@ struct SearchQueueInfo {
 	string error;
 };
 
-class SearchManager : public Speaker<SearchManagerListener>, public Singleton<SearchManager>, private TimerManagerListener
+class SearchManager : public Speaker<SearchManagerListener>, public Singleton<SearchManager>
 {
 public:
 	ActionHook<nullptr_t, const SearchResultPtr&> incomingSearchResultHook;
@@ -64,7 +64,16 @@ public:
 
 	void onRES(const AdcCommand& cmd, const UserPtr& aFrom, const string& aRemoteIp);
 
-	bool decryptPacket(string& x, size_t aLen, const ByteVector& aBuf);
+	bool decryptPacket(string& x, size_t aLen, const uint8_t* aBuf);
+
+	// Results with a matching search token are passed directly to the route listener
+	// (listeners of SearchManagerListener::SR will still receive all results)
+	// Results without a token (NMDC) are passed to the listener if tokenless results are accepted and the TTH filter matches
+	void addResultRoute(const string& aToken, SearchManagerListener* aListener, bool aReceiveTokenless = false, const optional<TTHValue>& aTokenlessRoot = nullopt) noexcept;
+	void removeResultRoute(SearchManagerListener* aListener) noexcept;
+
+	// Results received while running the callback are delivered to the route listeners as a single list
+	void batchResults(const Callback& aCallback) noexcept;
 
 	SearchInstancePtr createSearchInstance(const string& aOwnerId, uint64_t aExpirationTick = 0) noexcept;
 	SearchInstancePtr removeSearchInstance(SearchInstanceToken aToken) noexcept;
@@ -92,14 +101,33 @@ private:
 	static std::string normalizeWhitespace(const std::string& aString);
 
 	~SearchManager() override;
-	
-	void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
+
+	// Timer tasks (run in the timer thread)
+	TimerTaskId maintenanceTask = 0;
+	void onTimerMaintenance(uint64_t aTick) noexcept;
 
 	const unique_ptr<SearchTypes> searchTypes;
 	const unique_ptr<UDPServer> udpServer;
 
 	using SearchInstanceMap = map<SearchInstanceToken, SearchInstancePtr>;
 	SearchInstanceMap searchInstances;
+
+	void fireResult(const SearchResultPtr& aResult) noexcept;
+	void routeResults(const SearchResultList& aResults) noexcept;
+
+	struct ResultRoute {
+		string token;
+		bool receiveTokenless;
+		optional<TTHValue> tokenlessRoot;
+	};
+
+	unordered_map<SearchManagerListener*, ResultRoute> resultRoutes;
+	unordered_multimap<string, SearchManagerListener*> tokenRoutes;
+	unordered_multimap<TTHValue, SearchManagerListener*> tokenlessRootRoutes;
+	vector<SearchManagerListener*> tokenlessRoutes;
+
+	// Held while the results are being delivered (similar to the listener lock of Speaker)
+	mutable CriticalSection routeCS;
 };
 
 } // namespace dcpp
@@ -32,12 +32,20 @@ public:
 
 	typedef X<0> SR;
 	typedef X<1> IncomingSearch;
+	typedef X<2> SRList;
 
 	typedef X<5> SearchTypesChanged;
     typedef X<6> SearchInstanceCreated;
     typedef X<7> SearchInstanceRemoved;
 
 	virtual void on(SR, const SearchResultPtr&) noexcept { }
+
+	// Results that are received at once (used for the result routes only)
+	virtual void on(SRList, const SearchResultList& aResults) noexcept {
+		for (const auto& r: aResults) {
+			on(SR(), r);
+		}
+	}
 	virtual void on(IncomingSearch, Client*, const OnlineUserPtr& /*aAdcUser*/, const SearchQuery&, const SearchResultList&, bool /*isActive*/) noexcept {}
 
 	virtual void on(SearchTypesChanged) noexcept { }
@@ -239,4 +239,27 @@ DupeType SearchResult::getDupe() const noexcept {
 	}
 }
 
+vector<DupeType> SearchResult::getDupes(const SearchResultList& aResults) noexcept {
+	vector<DupeType> ret(aResults.size(), DUPE_NONE);
+
+	vector<TTHValue> fileTTHs;
+	vector<size_t> filePositions;
+	for (size_t i = 0; i < aResults.size(); ++i) {
+		const auto& result = aResults[i];
+		if (result->getType() == Type::DIRECTORY) {
+			ret[i] = result->getDupe();
+		} else {
+			fileTTHs.push_back(result->getTTH());
+			filePositions.push_back(i);
+		}
+	}
+
+	auto fileDupes = DupeUtil::checkFileDupes(fileTTHs);
+	for (size_t i = 0; i < fileDupes.size(); ++i) {
+		ret[filePositions[i]] = fileDupes[i];
+	}
+
+	return ret;
+}
+
 }
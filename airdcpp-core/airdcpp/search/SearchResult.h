@@ -99,6 +99,9 @@ public:
 
 	const DirectoryContentInfo& getContentInfo() const noexcept { return contentInfo; }
 	DupeType getDupe() const noexcept;
+
+	// Checks the file dupes with a single lookup
+	static vector<DupeType> getDupes(const SearchResultList& aResults) noexcept;
 private:
 	bool matches(SearchQuery& aQuery, const string_view& aSearchToken) const noexcept;
 
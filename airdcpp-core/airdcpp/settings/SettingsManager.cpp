@@ -56,6 +56,9 @@ const ResourceManager::Strings SettingsManager::incomingStrings[INCOMING_LAST] {
 const ResourceManager::Strings SettingsManager::outgoingStrings[OUTGOING_LAST] { ResourceManager::SETTINGS_DIRECT, ResourceManager::SETTINGS_SOCKS5 };
 const ResourceManager::Strings SettingsManager::dropStrings[QUEUE_LAST] { ResourceManager::FILE, ResourceManager::BUNDLE, ResourceManager::ALL };
 const ResourceManager::Strings SettingsManager::updateStrings[VERSION_LAST] { ResourceManager::CHANNEL_STABLE, ResourceManager::CHANNEL_BETA, ResourceManager::CHANNEL_NIGHTLY };
+const ResourceManager::Strings SettingsManager::monitoringStrings[MONITORING_LAST] { ResourceManager::DISABLED, ResourceManager::MONITORING_INCOMING_ONLY, ResourceManager::MONITORING_ALL_DIRECTORIES };
+const ResourceManager::Strings SettingsManager::skipUnchangedStrings[SKIP_UNCHANGED_LAST] { ResourceManager::DISABLED, ResourceManager::REFRESH_MODIFICATION_DATE, ResourceManager::REFRESH_MODIFICATION_DATE_STRICT };
+const ResourceManager::Strings SettingsManager::dbBackendStrings[DB_BACKEND_LAST] { ResourceManager::LEVELDB, ResourceManager::LMDB };
 
 
 void SettingsManager::registerChangeHandler(const SettingKeyList& aKeys, SettingChangeHandler::OnSettingChangedF&& changeF) noexcept {
@@ -121,6 +124,18 @@ SettingsManager::EnumStringMap SettingsManager::getEnumStrings(int aKey, bool aV
 		insertStrings(profileStrings, PROFILE_LAST);
 	}
 
+	if (aKey == MONITORING_MODE) {
+		insertStrings(monitoringStrings, MONITORING_LAST);
+	}
+
+	if (aKey == REFRESH_SKIP_UNCHANGED) {
+		insertStrings(skipUnchangedStrings, SKIP_UNCHANGED_LAST);
+	}
+
+	if (aKey == DB_BACKEND) {
+		insertStrings(dbBackendStrings, DB_BACKEND_LAST);
+	}
+
 	return ret;
 }
 
@@ -264,6 +279,8 @@ const string SettingsManager::settingTags[] =
 
 	"AutoSearchEvery", "ASDelayHours",
 
+	"HasherPipelineThreads", "SocketReactorThreads", "DbBackend", "MonitoringMode", "MonitoringDelay", "RefreshSkipUnchanged",
+
 #ifdef HAVE_GUI
 	// Windows GUI
 	"BackgroundColor", "TextColor", "MainWindowState",
@@ -342,7 +359,7 @@ const string SettingsManager::settingTags[] =
 	"SkipEmptyDirsShare", "RemoveExpiredAs", "AdcLogGroupCID", "ShareFollowSymlinks", "UseDefaultCertPaths", "StartupRefresh",
 	"FLReportDupeFiles", "UseUploadBundles", "LogIgnored", "RemoveFinishedBundles", "AlwaysCCPM",
 
-	"PopupBotPms", "PopupHubPms", "SortFavUsersFirst",
+	"PopupBotPms", "PopupHubPms", "SortFavUsersFirst", "ZeroCopyUploads",
 #ifdef HAVE_GUI
 	// Windows GUI
 	"BoldFinishedDownloads", "BoldFinishedUploads", "BoldHub", "BoldPm",
@@ -616,16 +633,22 @@ SettingsManager::SettingsManager() : connectionRegex("(\\d+(\\.\\d+)?)")
 	setDefault(MAX_HASHING_THREADS, std::thread::hardware_concurrency());
 
 	setDefault(HASHERS_PER_VOLUME, 1);
+	setDefault(HASHER_PIPELINE_THREADS, 1);
+	setDefault(SOCKET_REACTOR_THREADS, 0);
 
 	setDefault(MIN_DUPE_CHECK_SIZE, 512);
 	setDefault(SKIP_EMPTY_DIRS_SHARE, true);
 
 	setDefault(DB_CACHE_SIZE, 8);
+	setDefault(DB_BACKEND, DB_BACKEND_LEVELDB);
 	setDefault(CUR_REMOVED_TREES, 0);
 	setDefault(CUR_REMOVED_FILES, 0);
 
 	setDefault(DL_AUTO_DISCONNECT_MODE, QUEUE_FILE);
 	setDefault(REFRESH_THREADING, MULTITHREAD_MANUAL);
+	setDefault(MONITORING_MODE, MONITORING_DISABLED);
+	setDefault(MONITORING_DELAY, 30);
+	setDefault(REFRESH_SKIP_UNCHANGED, SKIP_UNCHANGED_DISABLED);
 
 	setDefault(REMOVE_EXPIRED_AS, false);
 
@@ -661,6 +684,7 @@ SettingsManager::SettingsManager() : connectionRegex("(\\d+(\\.\\d+)?)")
 	setDefault(POPUP_HUB_PMS, true);
 	setDefault(POPUP_BOT_PMS, true);
 	setDefault(SORT_FAVUSERS_FIRST, false);
+	setDefault(ZERO_COPY_UPLOADS, true);
 
 #ifdef _WIN32
 	setDefault(NMDC_ENCODING, Text::systemCharset);
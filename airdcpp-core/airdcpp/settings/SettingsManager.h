@@ -140,6 +140,8 @@ public:
 
 		AUTOSEARCH_EVERY, AS_DELAY_HOURS,
 
+		HASHER_PIPELINE_THREADS, SOCKET_REACTOR_THREADS, DB_BACKEND, MONITORING_MODE, MONITORING_DELAY, REFRESH_SKIP_UNCHANGED,
+
 #ifdef HAVE_GUI
 		// Windows GUI
 		BACKGROUND_COLOR, TEXT_COLOR, MAIN_WINDOW_STATE,
@@ -218,7 +220,7 @@ public:
 		SKIP_EMPTY_DIRS_SHARE, REMOVE_EXPIRED_AS, PM_LOG_GROUP_CID, SHARE_FOLLOW_SYMLINKS, USE_DEFAULT_CERT_PATHS, STARTUP_REFRESH,
 		FL_REPORT_FILE_DUPES, USE_UPLOAD_BUNDLES, LOG_IGNORED, REMOVE_FINISHED_BUNDLES, ALWAYS_CCPM,
 
-		POPUP_BOT_PMS, POPUP_HUB_PMS, SORT_FAVUSERS_FIRST,
+		POPUP_BOT_PMS, POPUP_HUB_PMS, SORT_FAVUSERS_FIRST, ZERO_COPY_UPLOADS,
 #ifdef HAVE_GUI
 		// Windows GUI
 		BOLD_FINISHED_DOWNLOADS, BOLD_FINISHED_UPLOADS, BOLD_HUB, BOLD_PM,
@@ -306,6 +308,12 @@ public:
 
 	enum { BLOOM_DISABLED, BLOOM_ENABLED, BLOOM_AUTO, BLOOM_LAST };
 
+	enum { DB_BACKEND_LEVELDB, DB_BACKEND_LMDB, DB_BACKEND_LAST };
+
+	enum { MONITORING_DISABLED, MONITORING_INCOMING, MONITORING_ALL, MONITORING_LAST };
+
+	enum { SKIP_UNCHANGED_DISABLED, SKIP_UNCHANGED_MODIFICATION_DATE, SKIP_UNCHANGED_STRICT, SKIP_UNCHANGED_LAST };
+
 	static const ResourceManager::Strings encryptionStrings[TLS_LAST];
 	static const ResourceManager::Strings bloomStrings[BLOOM_LAST];
 	static const ResourceManager::Strings profileStrings[PROFILE_LAST];
@@ -315,6 +323,9 @@ public:
 	static const ResourceManager::Strings outgoingStrings[OUTGOING_LAST];
 	static const ResourceManager::Strings dropStrings[QUEUE_LAST];
 	static const ResourceManager::Strings updateStrings[VERSION_LAST];
+	static const ResourceManager::Strings monitoringStrings[MONITORING_LAST];
+	static const ResourceManager::Strings skipUnchangedStrings[SKIP_UNCHANGED_LAST];
+	static const ResourceManager::Strings dbBackendStrings[DB_BACKEND_LAST];
 
 	using SettingValue = boost::variant<bool, int, string>;
 	using SettingValueList = vector<SettingValue>;
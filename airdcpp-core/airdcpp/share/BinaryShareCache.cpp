@@ -0,0 +1,393 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+
+#include <airdcpp/share/BinaryShareCache.h>
+
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/io/File.h>
+#include <airdcpp/core/io/MappedFile.h>
+#include <airdcpp/core/io/stream/Streams.h>
+#include <airdcpp/core/thread/concurrency.h>
+#include <airdcpp/hash/HashManager.h>
+#include <airdcpp/hash/HashedFile.h>
+#include <airdcpp/share/ShareRefreshInfo.h>
+#include <airdcpp/util/text/Text.h>
+
+#include <thread>
+
+namespace dcpp {
+
+static_assert(sizeof(BinaryShareCache::Header) == 32);
+static_assert(sizeof(BinaryShareCache::DirectoryEntry) == 48);
+static_assert(sizeof(BinaryShareCache::FileEntry) == 48);
+
+static const char CACHE_MAGIC[8] = { 'A', 'D', 'C', 'S', 'H', 'A', 'R', 'E' };
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// Subtrees with fewer files than this aren't worth splitting
+static const size_t MIN_TASK_FILES = 10000;
+
+static string getCacheName(const DualString& aName) noexcept {
+	return aName.lowerCaseOnly() ? aName.getLower() : aName.getNormal();
+}
+
+void BinaryShareCache::write(OutputStream& os_, const ShareDirectory& aRoot) {
+	// Build the directory table and calculate the string offsets
+	// (strings are stored in the same order as the items: directory name followed by the names of its files)
+	vector<const ShareDirectory*> directories;
+	vector<DirectoryEntry> directoryEntries;
+	uint64_t stringTableSize = 0;
+	uint32_t fileCount = 0;
+
+	auto addDirectory = [&](auto& aSelf, const ShareDirectory& aDirectory) -> void {
+		auto pos = directoryEntries.size();
+		directories.push_back(&aDirectory);
+
+		auto& e = directoryEntries.emplace_back();
+		e.name = static_cast<uint32_t>(stringTableSize);
+		e.firstFile = fileCount;
+		e.fileCount = static_cast<uint32_t>(aDirectory.files.size());
+		e.lastWrite = aDirectory.lastWrite;
+		e.changeTime = aDirectory.getChangeTime();
+		e.fileId = aDirectory.getFileId();
+		e.flags = aDirectory.getStableLastWrite() ? FLAG_STABLE_LAST_WRITE : 0;
+		e.reserved = 0;
+
+		stringTableSize += getCacheName(aDirectory.realName).size() + 1;
+		for (const auto& f: aDirectory.files) {
+			stringTableSize += getCacheName(f->getName()).size() + 1;
+		}
+
+		fileCount += static_cast<uint32_t>(aDirectory.files.size());
+		for (const auto& d: aDirectory.directories) {
+			aSelf(aSelf, *d);
+		}
+
+		directoryEntries[pos].subtreeEnd = static_cast<uint32_t>(directoryEntries.size());
+	};
+
+	addDirectory(addDirectory, aRoot);
+
+	if (stringTableSize > std::numeric_limits<uint32_t>::max()) {
+		throw FileException("The directory is too large for the cache");
+	}
+
+	// Header
+	Header header;
+	memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+	header.version = VERSION;
+	header.byteOrder = BYTE_ORDER_MARK;
+	header.directoryCount = static_cast<uint32_t>(directoryEntries.size());
+	header.fileCount = fileCount;
+	header.stringTableSize = stringTableSize;
+
+	os_.write(&header, sizeof(Header));
+	os_.write(directoryEntries.data(), directoryEntries.size() * sizeof(DirectoryEntry));
+
+	// Files
+	{
+		uint32_t stringPos = 0;
+		for (const auto& d: directories) {
+			stringPos += static_cast<uint32_t>(getCacheName(d->realName).size() + 1);
+			for (const auto& f: d->files) {
+				FileEntry e;
+				e.name = stringPos;
+				e.reserved = 0;
+				e.size = f->getSize();
+				e.timeStamp = static_cast<uint64_t>(f->getLastWrite());
+				memcpy(e.tth, f->getTTH().data, TTHValue::BYTES);
+				os_.write(&e, sizeof(FileEntry));
+
+				stringPos += static_cast<uint32_t>(getCacheName(f->getName()).size() + 1);
+			}
+		}
+	}
+
+	// Strings
+	for (const auto& d: directories) {
+		auto name = getCacheName(d->realName);
+		os_.write(name.c_str(), name.size() + 1);
+		for (const auto& f: d->files) {
+			name = getCacheName(f->getName());
+			os_.write(name.c_str(), name.size() + 1);
+		}
+	}
+}
+
+namespace {
+
+struct DirectoryEntryV1 {
+	uint32_t name;
+	uint32_t subtreeEnd;
+	uint32_t firstFile;
+	uint32_t fileCount;
+	int64_t lastWrite;
+};
+
+static_assert(sizeof(DirectoryEntryV1) == 24);
+
+void setDirectoryAttributes(const BinaryShareCache::DirectoryEntry& aEntry, ShareDirectory& directory_) noexcept {
+	directory_.setLastWrite(aEntry.lastWrite);
+	directory_.setChangeTime(aEntry.changeTime);
+	directory_.setFileId(aEntry.fileId);
+	directory_.setStableLastWrite((aEntry.flags & BinaryShareCache::FLAG_STABLE_LAST_WRITE) != 0);
+}
+
+class CacheReader {
+public:
+	explicit CacheReader(const MappedFile& aFile) {
+		if (aFile.size() < sizeof(BinaryShareCache::Header)) {
+			throw Exception("Invalid cache header");
+		}
+
+		memcpy(&header, aFile.data(), sizeof(BinaryShareCache::Header));
+		if (memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0 || header.byteOrder != BYTE_ORDER_MARK) {
+			throw Exception("Invalid cache header");
+		}
+
+		if (header.version > BinaryShareCache::VERSION) {
+			throw Exception("Newer cache version");
+		} else if (header.version != BinaryShareCache::VERSION && header.version != 1) {
+			throw Exception("Unsupported cache version");
+		}
+
+		// Validate the size before accessing the tables
+		auto directoryEntrySize = header.version == 1 ? sizeof(DirectoryEntryV1) : sizeof(BinaryShareCache::DirectoryEntry);
+		auto directoriesPos = static_cast<uint64_t>(sizeof(BinaryShareCache::Header));
+		auto filesPos = directoriesPos + static_cast<uint64_t>(header.directoryCount) * directoryEntrySize;
+		auto stringsPos = filesPos + static_cast<uint64_t>(header.fileCount) * sizeof(BinaryShareCache::FileEntry);
+		if (header.directoryCount == 0 || stringsPos + header.stringTableSize != aFile.size()) {
+			throw Exception("Invalid cache size");
+		}
+
+		// The tables are properly aligned as all entry sizes are multiples of 8 bytes
+		if (header.version == 1) {
+			convertDirectories(reinterpret_cast<const DirectoryEntryV1*>(aFile.data() + directoriesPos));
+		} else {
+			directories = reinterpret_cast<const BinaryShareCache::DirectoryEntry*>(aFile.data() + directoriesPos);
+		}
+
+		files = reinterpret_cast<const BinaryShareCache::FileEntry*>(aFile.data() + filesPos);
+		strings = reinterpret_cast<const char*>(aFile.data() + stringsPos);
+
+		// All names must be terminated
+		if (header.stringTableSize == 0 || strings[header.stringTableSize - 1] != '\0') {
+			throw Exception("Invalid string table");
+		}
+
+		validate();
+	}
+
+	uint32_t getDirectoryCount() const noexcept { return header.directoryCount; }
+	uint32_t getFileCount() const noexcept { return header.fileCount; }
+	const BinaryShareCache::DirectoryEntry& getDirectory(uint32_t aIndex) const noexcept { return directories[aIndex]; }
+
+	const char* getName(uint32_t aOffset) const noexcept { return strings + aOffset; }
+
+	// Number of files in the subtree
+	size_t getSubtreeFileCount(uint32_t aIndex) const noexcept {
+		const auto& d = directories[aIndex];
+		auto filesEnd = d.subtreeEnd < header.directoryCount ? directories[d.subtreeEnd].firstFile : header.fileCount;
+		return filesEnd - d.firstFile;
+	}
+
+	template<typename HandlerT>
+	void forEachChild(uint32_t aIndex, const HandlerT& aHandler) const {
+		auto end = directories[aIndex].subtreeEnd;
+		for (auto i = aIndex + 1; i < end; i = directories[i].subtreeEnd) {
+			aHandler(i);
+		}
+	}
+
+	// The file information is read from the hash database as the cache may be outdated
+	// Files missing from the database are queued for hashing
+	void loadFiles(uint32_t aIndex, ShareDirectory& directory_, ShareTreeMaps& maps_, ShareRefreshStats& stats_) const noexcept {
+		const auto& d = directories[aIndex];
+		if (d.fileCount == 0) {
+			return;
+		}
+
+		auto path = directory_.getRealPathUnsafe();
+		auto pathLower = Text::toLower(path);
+		for (auto i = d.firstFile; i < d.firstFile + d.fileCount; i++) {
+			DualString name(getName(files[i].name));
+			try {
+				HashedFile fi;
+				HashManager::getInstance()->getFileInfo(pathLower + name.getLower(), path + name.getNormal(), fi);
+				directory_.addFile(std::move(name), fi, maps_, stats_.addedSize);
+			} catch (const Exception& e) {
+				stats_.hashSize += File::getSize(path + name.getNormal());
+				dcdebug("Error loading shared file %s \n", e.getError().c_str());
+			}
+		}
+	}
+
+	ShareDirectory::Ptr createDirectory(uint32_t aIndex, ShareDirectory& aParent, ShareTreeMaps& maps_) const {
+		const auto& d = directories[aIndex];
+		auto directory = ShareDirectory::createNormal(DualString(getName(d.name)), &aParent, d.lastWrite, maps_);
+		if (!directory) {
+			throw Exception("Duplicate directory name");
+		}
+
+		setDirectoryAttributes(d, *directory);
+		return directory;
+	}
+
+	void loadTree(uint32_t aIndex, ShareDirectory& directory_, ShareTreeMaps& maps_, ShareRefreshStats& stats_) const {
+		loadFiles(aIndex, directory_, maps_, stats_);
+		forEachChild(aIndex, [&](uint32_t aChild) {
+			auto child = createDirectory(aChild, directory_, maps_);
+			loadTree(aChild, *child, maps_, stats_);
+		});
+	}
+private:
+	// Change detection attributes are left empty so that the directories will be scanned normally
+	void convertDirectories(const DirectoryEntryV1* aEntries) {
+		convertedDirectories.resize(header.directoryCount);
+		for (uint32_t i = 0; i < header.directoryCount; i++) {
+			auto& d = convertedDirectories[i];
+			d.name = aEntries[i].name;
+			d.subtreeEnd = aEntries[i].subtreeEnd;
+			d.firstFile = aEntries[i].firstFile;
+			d.fileCount = aEntries[i].fileCount;
+			d.lastWrite = aEntries[i].lastWrite;
+		}
+
+		directories = convertedDirectories.data();
+	}
+
+	// Checks that the tables reference valid items so that the loading can't crash with corrupted caches
+	void validate() const {
+		uint64_t expectedFile = 0;
+		for (uint32_t i = 0; i < header.directoryCount; i++) {
+			const auto& d = directories[i];
+			if (d.name >= header.stringTableSize || d.subtreeEnd <= i || d.subtreeEnd > header.directoryCount) {
+				throw Exception("Invalid directory entry");
+			}
+
+			if (d.firstFile != expectedFile || static_cast<uint64_t>(d.firstFile) + d.fileCount > header.fileCount) {
+				throw Exception("Invalid directory entry");
+			}
+
+			expectedFile += d.fileCount;
+		}
+
+		if (expectedFile != header.fileCount || directories[0].subtreeEnd != header.directoryCount) {
+			throw Exception("Invalid directory table");
+		}
+
+		// Subtrees must be nested
+		validateSubtree(0);
+
+		for (uint32_t i = 0; i < header.fileCount; i++) {
+			if (files[i].name >= header.stringTableSize) {
+				throw Exception("Invalid file entry");
+			}
+		}
+	}
+
+	void validateSubtree(uint32_t aIndex) const {
+		auto end = directories[aIndex].subtreeEnd;
+		for (auto i = aIndex + 1; i < end; i = directories[i].subtreeEnd) {
+			if (directories[i].subtreeEnd > end) {
+				throw Exception("Invalid directory tree");
+			}
+
+			validateSubtree(i);
+		}
+	}
+
+	BinaryShareCache::Header header;
+
+	const BinaryShareCache::DirectoryEntry* directories = nullptr;
+	vector<BinaryShareCache::DirectoryEntry> convertedDirectories;
+	const BinaryShareCache::FileEntry* files = nullptr;
+	const char* strings = nullptr;
+};
+
+// Subtrees that are loaded in a separate thread with their own indexes
+// The indexes are merged in the refresh info afterwards
+class SubtreeTask : public ShareRefreshSubtreeInfo {
+public:
+	SubtreeTask(size_t aBloomSize) : ShareRefreshSubtreeInfo(aBloomSize) { }
+
+	size_t fileCount = 0;
+
+	// Cache index, directory created for the entry
+	vector<pair<uint32_t, ShareDirectory*>> directories;
+
+	void load(const CacheReader& aReader) {
+		for (const auto& [index, directory] : directories) {
+			aReader.loadTree(index, *directory, *this, stats);
+		}
+	}
+};
+
+}
+
+void BinaryShareCache::load(const string& aPath, ShareRefreshInfo& ri_) {
+	MappedFile file(aPath);
+	CacheReader reader(file);
+
+	auto& root = *ri_.newDirectory;
+	setDirectoryAttributes(reader.getDirectory(0), root);
+
+	// Directories with large subtrees are created in this thread and the remaining subtrees are split into tasks of roughly equal size
+	const auto taskFiles = max(reader.getFileCount() / (max(std::thread::hardware_concurrency(), 1U) * 4), static_cast<uint32_t>(MIN_TASK_FILES));
+	const auto bloomSize = ri_.getBloom().getTableSize();
+
+	vector<unique_ptr<SubtreeTask>> tasks;
+	auto addTask = [&](uint32_t aIndex, ShareDirectory* aDirectory) {
+		if (tasks.empty() || tasks.back()->fileCount >= taskFiles) {
+			tasks.push_back(make_unique<SubtreeTask>(bloomSize));
+		}
+
+		tasks.back()->directories.emplace_back(aIndex, aDirectory);
+		tasks.back()->fileCount += reader.getSubtreeFileCount(aIndex);
+	};
+
+	auto expand = [&](auto& aSelf, uint32_t aIndex, ShareDirectory& aDirectory) -> void {
+		reader.loadFiles(aIndex, aDirectory, ri_, ri_.stats);
+		reader.forEachChild(aIndex, [&](uint32_t aChild) {
+			auto child = reader.createDirectory(aChild, aDirectory, ri_);
+			if (reader.getSubtreeFileCount(aChild) > taskFiles) {
+				aSelf(aSelf, aChild, *child);
+			} else {
+				addTask(aChild, child.get());
+			}
+		});
+	};
+
+	expand(expand, 0, root);
+
+	if (tasks.size() == 1) {
+		tasks.front()->load(reader);
+	} else {
+		parallel_for_each(tasks.begin(), tasks.end(), [&reader](const unique_ptr<SubtreeTask>& aTask) {
+			aTask->load(reader);
+		});
+	}
+
+	for (const auto& t: tasks) {
+		t->merge(ri_);
+	}
+}
+
+}
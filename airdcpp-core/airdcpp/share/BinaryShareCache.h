@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_BINARY_SHARE_CACHE_H
+#define DCPLUSPLUS_DCPP_BINARY_SHARE_CACHE_H
+
+#include <airdcpp/forward.h>
+#include <airdcpp/core/header/typedefs.h>
+
+#include <airdcpp/hash/value/MerkleTree.h>
+#include <airdcpp/share/ShareDirectory.h>
+
+namespace dcpp {
+
+class OutputStream;
+class ShareRefreshInfo;
+
+// Share cache of a single root that can be loaded directly from a memory mapped file
+//
+// Layout: header, directory table, file table, string table
+//
+// Directories are stored in pre-order so that each subtree forms a continuous range in the directory table
+// and the files of a subtree form a continuous range in the file table. This allows the subtrees to be
+// loaded in parallel. Names are stored as null-terminated UTF-8 strings in the string table.
+//
+// Integers are stored in native byte order (the cache is never moved between systems).
+class BinaryShareCache {
+public:
+	// Version 1 caches (without the change detection attributes) can still be loaded
+	static const uint32_t VERSION = 2;
+
+	struct Header {
+		char magic[8];
+		uint32_t version;
+
+		// Detects caches written with a different byte order
+		uint32_t byteOrder;
+
+		uint32_t directoryCount;
+		uint32_t fileCount;
+		uint64_t stringTableSize;
+	};
+
+	struct DirectoryEntry {
+		uint32_t name;
+
+		// Index after the last directory of the subtree
+		uint32_t subtreeEnd;
+
+		uint32_t firstFile;
+		uint32_t fileCount;
+
+		int64_t lastWrite;
+		int64_t changeTime;
+		uint64_t fileId;
+
+		uint32_t flags;
+		uint32_t reserved;
+	};
+
+	enum DirectoryFlags : uint32_t {
+		FLAG_STABLE_LAST_WRITE = 0x01
+	};
+
+	// The hash database is authoritative for the file information when loading
+	struct FileEntry {
+		uint32_t name;
+		uint32_t reserved;
+
+		int64_t size;
+		uint64_t timeStamp;
+		uint8_t tth[TTHValue::BYTES];
+	};
+
+	// Writes the whole tree of a root directory
+	// The tree must be locked by the caller
+	// Throws FileException
+	static void write(OutputStream& os_, const ShareDirectory& aRoot);
+
+	// Loads the cache in the new directory of the refresh info (the root must have been created already)
+	// Subtrees of large roots are loaded in parallel
+	// Throws Exception in case of invalid content and FileException in case of read errors
+	static void load(const string& aPath, ShareRefreshInfo& ri_);
+};
+
+}
+
+#endif
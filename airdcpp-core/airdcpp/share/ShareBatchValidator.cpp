@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+#include <airdcpp/share/ShareBatchValidator.h>
+
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/hash/HashManager.h>
+
+namespace dcpp {
+
+// Upper limit for a single hook call
+#define MAX_BATCH_SIZE 1000
+
+ShareBatchValidator::ShareBatchValidator(const SharePathValidator& aValidator, CallerPtr aCaller, const bool& aStopping) :
+	validator(aValidator), caller(aCaller), refreshStopping(aStopping) {
+
+	start();
+}
+
+ShareBatchValidator::~ShareBatchValidator() {
+	finish();
+}
+
+void ShareBatchValidator::add(File::List&& aFiles) noexcept {
+	{
+		Lock l(cs);
+		ranges::move(aFiles, back_inserter(queuedFiles));
+	}
+
+	s.signal();
+}
+
+ShareBatchValidator::File::List ShareBatchValidator::finish() noexcept {
+	if (!finished) {
+		finished = true;
+		finishing = true;
+		s.signal();
+		join();
+	}
+
+	Lock l(cs);
+	return std::move(validatedFiles);
+}
+
+int ShareBatchValidator::run() {
+	for (;;) {
+		s.wait();
+
+		for (;;) {
+			File::List batch;
+
+			{
+				Lock l(cs);
+				if (queuedFiles.empty()) {
+					break;
+				}
+
+				auto count = min(queuedFiles.size(), static_cast<size_t>(MAX_BATCH_SIZE));
+				batch.assign(make_move_iterator(queuedFiles.begin()), make_move_iterator(queuedFiles.begin() + count));
+				queuedFiles.erase(queuedFiles.begin(), queuedFiles.begin() + count);
+			}
+
+			if (!refreshStopping) {
+				validateBatch(batch);
+			}
+
+			Lock l(cs);
+			ranges::move(batch, back_inserter(validatedFiles));
+		}
+
+		if (finishing) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+void ShareBatchValidator::validateBatch(File::List& files_) noexcept {
+	ShareValidationFile::List hookFiles;
+	for (const auto& f: files_) {
+		hookFiles.push_back(f.info);
+	}
+
+	auto rejectedFiles = validator.validateFileBatchHooked(hookFiles, caller);
+	for (auto& f: files_) {
+		if (auto i = rejectedFiles.find(f.info.path); i != rejectedFiles.end()) {
+			f.result = Result::REJECTED;
+			f.error = i->second;
+			continue;
+		}
+
+		// Files are hashed only after they have been accepted
+		try {
+			f.result = HashManager::getInstance()->checkTTH(f.pathLower, f.info.path, f.fileInfo) ? Result::HASHED : Result::HASHING;
+		} catch (const HashException&) {
+			f.result = Result::FAILED;
+		}
+	}
+}
+
+} // namespace dcpp
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_SHARE_BATCH_VALIDATOR_H
+#define DCPLUSPLUS_DCPP_SHARE_BATCH_VALIDATOR_H
+
+#include <airdcpp/core/thread/CriticalSection.h>
+#include <airdcpp/core/thread/Semaphore.h>
+#include <airdcpp/core/thread/Thread.h>
+#include <airdcpp/hash/HashedFile.h>
+#include <airdcpp/share/ShareDirectory.h>
+#include <airdcpp/share/SharePathValidator.h>
+
+namespace dcpp {
+
+// Runs the batched file validation hooks for a refresh in a separate thread
+//
+// The refresh keeps scanning while the hook subscribers are processing the earlier files. Files that are
+// queued during a hook call are combined in the next batch, so the batches grow when the subscribers are slow.
+// Accepted files are also checked from the hash database, the caller will add them in the tree afterwards.
+class ShareBatchValidator : private Thread {
+public:
+	enum class Result {
+		PENDING,
+		REJECTED,
+		HASHED,
+		HASHING,
+		FAILED
+	};
+
+	struct File {
+		File(ShareValidationFile&& aInfo, const ShareDirectory::Ptr& aDirectory, const string& aPathLower, time_t aLastWrite) noexcept :
+			info(std::move(aInfo)), directory(aDirectory), pathLower(aPathLower), fileInfo(aLastWrite, info.size) {}
+
+		ShareValidationFile info;
+		ShareDirectory::Ptr directory;
+		string pathLower;
+
+		HashedFile fileInfo;
+
+		Result result = Result::PENDING;
+		string error;
+
+		using List = vector<File>;
+	};
+
+	ShareBatchValidator(const SharePathValidator& aValidator, CallerPtr aCaller, const bool& aStopping);
+	~ShareBatchValidator() override;
+
+	// Queue files for validation
+	void add(File::List&& aFiles) noexcept;
+
+	// Waits until all queued files have been handled and returns them
+	// Files are left pending if the refresh was aborted
+	File::List finish() noexcept;
+
+	ShareBatchValidator(const ShareBatchValidator&) = delete;
+	ShareBatchValidator& operator=(const ShareBatchValidator&) = delete;
+private:
+	int run() override;
+
+	void validateBatch(File::List& files_) noexcept;
+
+	const SharePathValidator& validator;
+	const CallerPtr caller;
+	const bool& refreshStopping;
+
+	CriticalSection cs;
+	Semaphore s;
+
+	File::List queuedFiles;
+	File::List validatedFiles;
+
+	atomic<bool> finishing = false;
+	bool finished = false;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_SHARE_BATCH_VALIDATOR_H)
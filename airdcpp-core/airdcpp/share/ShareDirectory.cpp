@@ -27,6 +27,7 @@
 #include <airdcpp/search/SearchQuery.h>
 #include <airdcpp/search/SearchResult.h>
 #include <airdcpp/settings/SettingsManager.h>
+#include <airdcpp/share/ShareSearchIndex.h>
 #include <airdcpp/core/io/xml/SimpleXML.h>
 
 namespace dcpp {
@@ -69,6 +70,10 @@ ShareDirectory::Ptr ShareDirectory::createNormal(DualString&& aRealName, ShareDi
 	}
 
 	addDirName(dir, maps_.lowerDirNameMap, maps_.getBloom());
+	if (auto searchIndex = maps_.getSearchIndex(); searchIndex) {
+		searchIndex->addDirectory(*dir);
+	}
+
 	return dir;
 }
 
@@ -81,6 +86,10 @@ ShareDirectory::Ptr ShareDirectory::createRoot(const string& aRootPath, const st
 	maps_.rootPaths[dir->getRealPathUnsafe()] = dir;
 
 	addDirName(dir, maps_.lowerDirNameMap, maps_.getBloom());
+	if (auto searchIndex = maps_.getSearchIndex(); searchIndex) {
+		searchIndex->addDirectory(*dir);
+	}
+
 	return dir;
 }
 
@@ -109,6 +118,16 @@ bool ShareDirectory::setParent(const ShareDirectory::Ptr& aDirectory, ShareDirec
 
 void ShareDirectory::updateModifyDate() {
 	lastWrite = dcpp::File::getLastModified(getRealPathUnsafe());
+
+	// Other changes may have been made at the same time
+	stableLastWrite = false;
+}
+
+void ShareDirectory::clearStableLastWriteRecursive() noexcept {
+	stableLastWrite = false;
+	for (const auto& d : directories) {
+		d->clearStableLastWriteRecursive();
+	}
 }
 
 int64_t ShareDirectory::getLevelSize() const noexcept {
@@ -154,24 +173,41 @@ const string& ShareDirectory::getVirtualNameLower() const noexcept {
 }
 
 void ShareDirectory::addFile(DualString&& aName, const HashedFile& aFileInfo, ShareTreeMaps& maps_, int64_t& sharedSize_, ProfileTokenSet* dirtyProfiles_) noexcept {
-	{
-		auto i = files.find(aName.getLower());
-		if (i != files.end()) {
-			// Get rid of false constness...
-			(*i)->cleanIndices(sharedSize_, maps_.tthIndex);
-			delete* i;
-			files.erase(i);
-		}
-	}
+	removeFile(aName.getLower(), maps_, sharedSize_);
 
 	auto it = files.insert_sorted(new ShareDirectory::File(std::move(aName), this, aFileInfo)).first;
 	(*it)->updateIndices(maps_.getBloom(), sharedSize_, maps_.tthIndex);
+	if (auto searchIndex = maps_.getSearchIndex(); searchIndex) {
+		searchIndex->addFile(**it);
+	}
 
 	if (dirtyProfiles_) {
 		copyRootProfiles(*dirtyProfiles_, true);
 	}
 }
 
+bool ShareDirectory::removeFile(const string& aNameLower, ShareTreeMaps& maps_, int64_t& sharedSize_, ProfileTokenSet* dirtyProfiles_) noexcept {
+	auto i = files.find(aNameLower);
+	if (i == files.end()) {
+		return false;
+	}
+
+	// Get rid of false constness...
+	(*i)->cleanIndices(sharedSize_, maps_.tthIndex);
+	if (auto searchIndex = maps_.getSearchIndex(); searchIndex) {
+		searchIndex->removeFile(**i);
+	}
+
+	delete* i;
+	files.erase(i);
+
+	if (dirtyProfiles_) {
+		copyRootProfiles(*dirtyProfiles_, true);
+	}
+
+	return true;
+}
+
 const ShareRoot::Ptr& ShareDirectory::getRoot() const noexcept {
 	dcassert(isRoot());
 	return root; 
@@ -291,8 +327,10 @@ bool ShareDirectory::hasProfile(const ProfileTokenSet& aProfiles) const noexcept
 void ShareDirectory::copyRootProfiles(ProfileTokenSet& profiles_, bool aSetCacheDirty) const noexcept {
 	if (root) {
 		ranges::copy(root->getRootProfiles(), inserter(profiles_, profiles_.begin()));
-		if (aSetCacheDirty)
+		if (aSetCacheDirty) {
 			root->setCacheDirty(true);
+			root->updateRevision();
+		}
 	}
 
 	if (parent)
@@ -433,7 +471,7 @@ ShareDirectory::SearchResultInfo::SearchResultInfo(const ShareDirectory* d, cons
 * but not the parents...
 */
 
-void ShareDirectory::search(SearchResultInfo::Set& results_, SearchQuery& aStrings, int aLevel) const noexcept {
+void ShareDirectory::search(SearchResultInfo::Set& results_, SearchQuery& aStrings, int aLevel, const ShareSearchCandidates* aCandidates) const noexcept {
 	const auto& dirName = getVirtualNameLower();
 	if (aStrings.isExcludedLower(dirName)) {
 		return;
@@ -481,6 +519,10 @@ void ShareDirectory::search(SearchResultInfo::Set& results_, SearchQuery& aStrin
 	// Match files
 	if (aStrings.itemType != SearchQuery::ItemType::DIRECTORY) {
 		for (const auto& f : files) {
+			if (aCandidates && !aCandidates->hasFile(f)) {
+				continue;
+			}
+
 			if (!aStrings.matchesFileLower(f->getName().getLower(), f->getSize(), f->getLastWrite())) {
 				continue;
 			}
@@ -493,7 +535,15 @@ void ShareDirectory::search(SearchResultInfo::Set& results_, SearchQuery& aStrin
 
 	// Match directories
 	for (const auto& d : directories) {
-		d->search(results_, aStrings, aLevel);
+		if (!aCandidates) {
+			d->search(results_, aStrings, aLevel);
+			continue;
+		}
+
+		auto match = aCandidates->matchDirectory(d.get());
+		if (match != ShareSearchCandidates::DirectoryMatch::NONE) {
+			d->search(results_, aStrings, aLevel, match == ShareSearchCandidates::DirectoryMatch::FULL ? nullptr : aCandidates);
+		}
 	}
 
 	// Moving to a lower level
@@ -523,38 +573,7 @@ void ShareDirectory::File::addSR(SearchResultList& aResults, bool aAddParent) co
 }
 
 
-// CACHE
 #define LITERAL(n) n, sizeof(n)-1
-void ShareDirectory::toCacheXmlList(OutputStream& xmlFile, string& indent, string& tmp) const {
-	xmlFile.write(indent);
-	xmlFile.write(LITERAL("<Directory Name=\""));
-	xmlFile.write(SimpleXML::escape(realName.lowerCaseOnly() ? realName.getLower() : realName.getNormal(), tmp, true));
-
-	xmlFile.write(LITERAL("\" Date=\""));
-	xmlFile.write(SimpleXML::escape(Util::toString(lastWrite), tmp, true));
-	xmlFile.write(LITERAL("\">\r\n"));
-
-	indent += '\t';
-	filesToCacheXmlList(xmlFile, indent, tmp);
-
-	for (const auto& d : directories) {
-		d->toCacheXmlList(xmlFile, indent, tmp);
-	}
-
-	indent.erase(indent.length() - 1);
-	xmlFile.write(indent);
-	xmlFile.write(LITERAL("</Directory>\r\n"));
-}
-
-void ShareDirectory::filesToCacheXmlList(OutputStream& xmlFile, string& indent, string& tmp2) const {
-	for (const auto& f : files) {
-		xmlFile.write(indent);
-		xmlFile.write(LITERAL("<File Name=\""));
-		xmlFile.write(SimpleXML::escape(f->getName().lowerCaseOnly() ? f->getName().getLower() : f->getName().getNormal(), tmp2, true));
-		xmlFile.write(LITERAL("\"/>\r\n"));
-	}
-}
-
 
 // FILELISTS
 
@@ -715,9 +734,11 @@ bool ShareRoot::hasRootProfile(ProfileToken aProfile) const noexcept {
 	return rootProfiles.contains(aProfile);
 }
 
+atomic<uint64_t> ShareRoot::nextRevision { 1 };
+
 ShareRoot::ShareRoot(const string& aRootPath, const string& aVname, const ProfileTokenSet& aProfiles, bool aIncoming, time_t aLastRefreshTime) noexcept :
 	rootProfiles(aProfiles), incoming(aIncoming), lastRefreshTime(aLastRefreshTime),
-	virtualName(make_unique<DualString>(aVname)), path(aRootPath), pathLower(Text::toLower(aRootPath)) {
+	virtualName(make_unique<DualString>(aVname)), path(aRootPath), pathLower(Text::toLower(aRootPath)), revision(nextRevision++) {
 
 }
 
@@ -738,8 +759,17 @@ string ShareRoot::getCacheXmlPath() const noexcept {
 	return AppUtil::getPath(AppUtil::PATH_SHARECACHE) + "ShareCache_" + PathUtil::validateFileName(path) + ".xml";
 }
 
+string ShareRoot::getCacheBinaryPath() const noexcept {
+	return AppUtil::getPath(AppUtil::PATH_SHARECACHE) + "ShareCache_" + PathUtil::validateFileName(path) + ".bin";
+}
+
 void ShareRoot::setName(const string& aName) noexcept {
 	virtualName = make_unique<DualString>(aName);
+	updateRevision();
+}
+
+void ShareRoot::updateRevision() noexcept {
+	revision = nextRevision++;
 }
 
 }
\ No newline at end of file
@@ -76,6 +76,14 @@ public:
 
 	void setName(const string& aName) noexcept;
 	string getCacheXmlPath() const noexcept;
+	string getCacheBinaryPath() const noexcept;
+
+	// Changes whenever the listed content of the root may have changed (unique between all roots)
+	uint64_t getRevision() const noexcept {
+		return revision;
+	}
+
+	void updateRevision() noexcept;
 
 	ShareRoot(ShareRoot&) = delete;
 	ShareRoot& operator=(ShareRoot&) = delete;
@@ -85,9 +93,14 @@ private:
 	unique_ptr<DualString> virtualName;
 	const string path;
 	const string pathLower;
+
+	atomic<uint64_t> revision;
+	static atomic<uint64_t> nextRevision;
 };
 
 class ShareTreeMaps;
+class ShareSearchCandidates;
+class ShareSearchIndex;
 class FilelistDirectory;
 class ShareDirectory {
 public:
@@ -125,6 +138,7 @@ public:
 		GETSET(ShareDirectory*, parent, Parent);
 		GETSET(time_t, lastWrite, LastWrite);
 		GETSET(TTHValue, tth, TTH);
+		IGETSET(uint32_t, searchIndexId, SearchIndexId, 0);
 
 		void updateIndices(ShareBloom& aBloom_, int64_t& sharedSize_, File::TTHMap& tthIndex_) noexcept;
 		void cleanIndices(int64_t& sharedSize_, TTHMap& tthIndex_) noexcept;
@@ -216,15 +230,20 @@ public:
 
 	void getProfileInfo(ProfileToken aProfile, int64_t& totalSize_, size_t& filesCount_) const noexcept;
 
-	void search(SearchResultInfo::Set& aResults, SearchQuery& aStrings, int aLevel) const noexcept;
+	// Candidates are used to skip items that can't match the search (nullptr if everything should be matched)
+	void search(SearchResultInfo::Set& aResults, SearchQuery& aStrings, int aLevel, const ShareSearchCandidates* aCandidates = nullptr) const noexcept;
 
 	void toTTHList(OutputStream& tthList, string& tmp2, bool aRecursive) const;
 
-	//for file list caching
-	void toCacheXmlList(OutputStream& xmlFile, string& indent, string& tmp) const;
-	void filesToCacheXmlList(OutputStream& xmlFile, string& indent, string& tmp2) const;
-
 	GETSET(time_t, lastWrite, LastWrite);
+	IGETSET(uint32_t, searchIndexId, SearchIndexId, 0);
+
+	// The modification date was older than the content scan so it can be used for detecting later changes
+	IGETSET(bool, stableLastWrite, StableLastWrite, false);
+
+	// Additional attributes for detecting changed directories (zero if not available)
+	IGETSET(time_t, changeTime, ChangeTime, 0);
+	IGETSET(uint64_t, fileId, FileId, 0);
 
 	~ShareDirectory();
 
@@ -237,6 +256,9 @@ public:
 	// check for an updated modify date from filesystem
 	void updateModifyDate();
 
+	// Force the directory and its children to be rescanned on the next refresh
+	void clearStableLastWriteRecursive() noexcept;
+
 	ShareDirectory(ShareDirectory&) = delete;
 	ShareDirectory& operator=(ShareDirectory&) = delete;
 
@@ -283,6 +305,9 @@ public:
 
 	void addFile(DualString&& aName, const HashedFile& fi, ShareTreeMaps& maps_, int64_t& sharedSize_, ProfileTokenSet* dirtyProfiles_ = nullptr) noexcept;
 
+	// Returns false if the file wasn't found
+	bool removeFile(const string& aNameLower, ShareTreeMaps& maps_, int64_t& sharedSize_, ProfileTokenSet* dirtyProfiles_ = nullptr) noexcept;
+
 	File::Set getFiles() const noexcept {
 		return files;
 	}
@@ -294,6 +319,8 @@ public:
 	// Shoild not be used directly, use createNormal or createRoot instead
 	ShareDirectory(DualString&& aRealName, ShareDirectory* aParent, time_t aLastWrite, const ShareRoot::Ptr& aRoot = nullptr);
 private:
+	friend class BinaryShareCache;
+
 	File::Set files;
 	void cleanIndices(int64_t& sharedSize_, File::TTHMap& tthIndex_, ShareDirectory::MultiMap& dirNames_) const noexcept;
 
@@ -311,7 +338,7 @@ private:
 class ShareTreeMaps {
 public:
 	typedef std::function<ShareBloom*()> GetBloomF;
-	ShareTreeMaps(GetBloomF&& aGetBloomF) : getBloomF(aGetBloomF) {}
+	ShareTreeMaps(GetBloomF&& aGetBloomF, ShareSearchIndex* aSearchIndex = nullptr) : getBloomF(aGetBloomF), searchIndex(aSearchIndex) {}
 
 	// Map real name to virtual name - multiple real names may be mapped to a single virtual one
 	ShareDirectory::Map rootPaths;
@@ -323,8 +350,14 @@ public:
 	ShareBloom& getBloom() noexcept {
 		return *getBloomF();
 	}
+
+	// Not available for trees that are being built
+	ShareSearchIndex* getSearchIndex() noexcept {
+		return searchIndex;
+	}
 private:
 	GetBloomF getBloomF;
+	ShareSearchIndex* const searchIndex;
 };
 
 class FilelistDirectory {
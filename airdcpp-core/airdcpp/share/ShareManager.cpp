@@ -20,9 +20,11 @@
 #include <airdcpp/share/ShareManager.h>
 
 #include <airdcpp/queue/Bundle.h>
-#include <airdcpp/core/io/compress/BZUtils.h>
+#include <airdcpp/core/io/compress/ParallelFilter.h>
 #include <airdcpp/DCPlusPlus.h>
 #include <airdcpp/core/classes/ErrorCollector.h>
+#include <airdcpp/core/classes/ScopedFunctor.h>
+#include <airdcpp/core/io/DirectoryReader.h>
 #include <airdcpp/core/io/File.h>
 #include <airdcpp/core/io/stream/FilteredFile.h>
 #include <airdcpp/events/LogManager.h>
@@ -31,6 +33,8 @@
 #include <airdcpp/core/localization/ResourceManager.h>
 #include <airdcpp/search/SearchQuery.h>
 #include <airdcpp/search/SearchResult.h>
+#include <airdcpp/share/BinaryShareCache.h>
+#include <airdcpp/share/ShareBatchValidator.h>
 #include <airdcpp/share/SharePathValidator.h>
 #include <airdcpp/share/profiles/ShareProfileManager.h>
 #include <airdcpp/share/ShareTasks.h>
@@ -43,6 +47,7 @@
 #include <airdcpp/core/version.h>
 
 #include <airdcpp/core/thread/concurrency.h>
+#include <airdcpp/core/thread/WorkStealingPool.h>
 
 namespace dcpp {
 
@@ -53,7 +58,8 @@ ShareManager::ShareManager() :
 	profiles(make_unique<ShareProfileManager>([this](const ShareProfilePtr& p) { removeRootProfile(p); })), 
 	tree(make_unique<ShareTree>()),
 	validator(make_unique<SharePathValidator>([this](const string& aRealPath) { return tree->parseRoot(aRealPath); })),
-	tasks(make_unique<ShareTasks>(this))
+	tasks(make_unique<ShareTasks>(this)),
+	monitor(make_unique<ShareMonitor>(this))
 { 
 	SettingsManager::getInstance()->addListener(this);
 	HashManager::getInstance()->addListener(this);
@@ -103,7 +109,9 @@ void ShareManager::startup(StartupLoader& aLoader) noexcept {
 	}
 
 	aLoader.addPostLoadTask([refreshScheduled, this] {
-		TimerManager::getInstance()->addListener(this);
+		auto tm = TimerManager::getInstance();
+		maintenanceTask = tm->addTask("Share maintenance", 60 * 1000, [this](uint64_t aTick) { onTimerMaintenance(aTick); }, tm->getDiskExecutor());
+		monitor->start();
 
 		if (!refreshScheduled && SETTING(STARTUP_REFRESH)) {
 			refresh(ShareRefreshType::STARTUP, ShareRefreshPriority::NORMAL);
@@ -112,10 +120,13 @@ void ShareManager::startup(StartupLoader& aLoader) noexcept {
 }
 
 void ShareManager::shutdown(const ProgressFunction& progressF) noexcept {
+	// Wait for a possible scheduled save to finish
+	TimerManager::getInstance()->removeTask(maintenanceTask);
+
 	saveShareCache(progressF);
 	profiles->removeCachedFilelists();
 
-	TimerManager::getInstance()->removeListener(this);
+	monitor->stop();
 	tasks->shutdown();
 }
 
@@ -223,8 +234,16 @@ private:
 	string curDirPath;
 };
 
-using ShareLoaderPtr = shared_ptr<ShareManager::ShareLoader>;
-using LoaderList = vector<ShareLoaderPtr>;
+// Cache of a single root
+struct CacheLoader {
+	shared_ptr<ShareRefreshInfo> info;
+	string cachePath;
+
+	// Throws on errors
+	std::function<void()> load;
+};
+
+using LoaderList = vector<CacheLoader>;
 
 bool ShareManager::loadCache(const ProgressFunction& progressF) noexcept {
 	HashManager::HashPauser pauser;
@@ -234,10 +253,22 @@ bool ShareManager::loadCache(const ProgressFunction& progressF) noexcept {
 	LoaderList cacheLoaders;
 
 	// Create loaders
+	// The binary cache is preferred, XML caches are still loaded if the binary one is missing (e.g. after upgrading from an older version)
 	for (const auto& [rootPath, rootDir] : tree->getRootPathsUnsafe()) {
+		auto binaryPath = rootDir->getRoot()->getCacheBinaryPath();
+		if (File::getSize(binaryPath) > 0) {
+			auto loader = std::make_shared<ShareRefreshInfo>(rootPath, rootDir, 0, *tree->getBloom());
+			cacheLoaders.push_back({ loader, binaryPath, [loader, binaryPath] {
+				BinaryShareCache::load(binaryPath, *loader);
+			} });
+			continue;
+		}
+
 		try {
 			auto loader = std::make_shared<ShareLoader>(rootPath, rootDir, *tree->getBloom());
-			cacheLoaders.emplace_back(loader);
+			cacheLoaders.push_back({ loader, loader->xmlPath, [loader] {
+				SimpleXMLReader(loader.get()).parse(*loader->file);
+			} });
 		} catch (const FileException&) {
 			log(STRING_F(SHARE_CACHE_FILE_MISSING, rootPath), LogMessage::SEV_ERROR);
 			return false;
@@ -248,8 +279,8 @@ bool ShareManager::loadCache(const ProgressFunction& progressF) noexcept {
 		// Remove obsolete cache files
 		auto fileList = File::findFiles(AppUtil::getPath(AppUtil::PATH_SHARECACHE), "ShareCache_*", File::TYPE_FILE);
 		for (const auto& p: fileList) {
-			auto rp = find_if(cacheLoaders, [&p](const ShareLoaderPtr& aLoader) {
-				return p == aLoader->xmlPath;
+			auto rp = find_if(cacheLoaders, [&p](const CacheLoader& aLoader) {
+				return p == aLoader.cachePath;
 			});
 
 			if (rp == cacheLoaders.end()) {
@@ -265,25 +296,21 @@ bool ShareManager::loadCache(const ProgressFunction& progressF) noexcept {
 	{
 		const auto dirCount = cacheLoaders.size();
 
-		//ll.sort(SimpleXMLReader::ThreadedCallBack::SizeSort());
-
 		// Parse the actual cache files
 		atomic<long> loaded(0);
 		bool hasFailedCaches = false;
 
 		try {
-			parallel_for_each(cacheLoaders.begin(), cacheLoaders.end(), [&](const ShareLoaderPtr& i) {
-				//log("Thread: " + Util::toString(::GetCurrentThreadId()) + "Size " + Util::toString(loader.size), LogMessage::SEV_INFO);
-				auto& loader = *i;
+			parallel_for_each(cacheLoaders.begin(), cacheLoaders.end(), [&](const CacheLoader& aLoader) {
 				try {
-					SimpleXMLReader(&loader).parse(*loader.file);
-				} catch (SimpleXMLException& e) {
-					log(STRING_F(LOAD_FAILED_X, loader.xmlPath % e.getError()), LogMessage::SEV_ERROR);
+					aLoader.load();
+				} catch (const Exception& e) {
+					log(STRING_F(LOAD_FAILED_X, aLoader.cachePath % e.getError()), LogMessage::SEV_ERROR);
 					hasFailedCaches = true;
-					File::deleteFile(loader.xmlPath);
+					File::deleteFile(aLoader.cachePath);
 				} catch (...) {
 					hasFailedCaches = true;
-					File::deleteFile(loader.xmlPath);
+					File::deleteFile(aLoader.cachePath);
 				}
 
 				if (progressF) {
@@ -304,8 +331,8 @@ bool ShareManager::loadCache(const ProgressFunction& progressF) noexcept {
 	// Apply the changes
 	ShareRefreshStats stats;
 	for (const auto& l : cacheLoaders) {
-		tree->applyRefreshChanges(*l, nullptr);
-		stats.merge(l->stats);
+		tree->applyRefreshChanges(*l.info, nullptr);
+		stats.merge(l.info->stats);
 	}
 
 #ifdef _DEBUG
@@ -561,6 +588,10 @@ bool ShareManager::isFileShared(const TTHValue& aTTH, ProfileToken aProfile) con
 	return tree->isFileShared(aTTH, aProfile);
 }
 
+vector<bool> ShareManager::isFileShared(std::span<const TTHValue> aTTHs) const noexcept {
+	return tree->isFileShared(aTTHs);
+}
+
 bool ShareManager::findDirectoryByRealPath(const string& aPath, const ShareDirectoryCallback& aCallback) const noexcept {
 	return tree->findDirectoryByRealPath(aPath, aCallback);
 }
@@ -624,14 +655,53 @@ ShareSearchStats ShareManager::getSearchMatchingStats() const noexcept {
 
 
 // REFRESH
-ShareManager::RefreshTaskHandler::ShareBuilder::ShareBuilder(const string& aPath, const ShareDirectory::Ptr& aOldRoot, time_t aLastWrite, ShareBloom& bloom_, ShareManager* aSm) :
-	sm(*aSm), ShareRefreshInfo(aPath, aOldRoot, aLastWrite, bloom_) {
+ShareManager::RefreshTaskHandler::ShareBuilder::ShareBuilder(const string& aPath, const ShareDirectory::Ptr& aOldRoot, time_t aLastWrite, ShareBloom& bloom_, ShareManager* aSm, int aSkipUnchanged) :
+	sm(*aSm), ShareRefreshInfo(aPath, aOldRoot, aLastWrite, bloom_), skipUnchanged(aSkipUnchanged) {
 
+	// Subdirectories get the attributes from the parent listing
+	DirectoryReader::Entry entry;
+	if (DirectoryReader::readItem(aPath, entry)) {
+		newDirectory->setChangeTime(entry.changeTime);
+		newDirectory->setFileId(entry.fileId);
+	}
 }
 
-bool ShareManager::RefreshTaskHandler::ShareBuilder::buildTree(const bool& aStopping) noexcept {
+bool ShareManager::RefreshTaskHandler::ShareBuilder::isUnchanged(const ShareDirectory& aDirectory, const ShareDirectory& aOldDirectory) const noexcept {
+	if (skipUnchanged == SettingsManager::SKIP_UNCHANGED_DISABLED || !aOldDirectory.getStableLastWrite()) {
+		return false;
+	}
+
+	if (aDirectory.getLastWrite() != aOldDirectory.getLastWrite()) {
+		return false;
+	}
+
+	if (skipUnchanged == SettingsManager::SKIP_UNCHANGED_STRICT) {
+		// Another directory may have been moved in place with the same modification date
+		return aDirectory.getChangeTime() == aOldDirectory.getChangeTime() && aDirectory.getFileId() == aOldDirectory.getFileId();
+	}
+
+	return true;
+}
+
+bool ShareManager::RefreshTaskHandler::ShareBuilder::buildTree(size_t aThreads, const bool& aStopping) noexcept {
 	try {
-		buildTree(path, Text::toLower(path), newDirectory, optionalOldDirectory, aStopping);
+		if (sm.validator->fileBatchValidationHook.hasSubscribers()) {
+			batchValidator = make_unique<ShareBatchValidator>(*sm.validator, &sm, aStopping);
+		}
+
+		if (aThreads > 1) {
+			buildTreeMultiThread(aThreads, aStopping);
+		} else {
+			buildTreeSingleThread(aStopping);
+		}
+
+		if (batchValidator) {
+			addBatchValidatedFiles();
+		}
+
+		if (!aStopping) {
+			finalizeTree(newDirectory, optionalOldDirectory);
+		}
 	} catch (const std::bad_alloc&) {
 		log(STRING_F(DIR_REFRESH_FAILED, path % STRING(OUT_OF_MEMORY)), LogMessage::SEV_ERROR);
 		return false;
@@ -664,16 +734,78 @@ bool ShareManager::RefreshTaskHandler::ShareBuilder::validateFileItem(const File
 	return true;
 }
 
-void ShareManager::RefreshTaskHandler::ShareBuilder::buildTree(const string& aPath, const string& aPathLower, const ShareDirectory::Ptr& aParent, const ShareDirectory::Ptr& aOldParent, const bool& aStopping) {
-	ErrorCollector errors;
-	FileFindIter end;
-	for(FileFindIter i(aPath, "*"); i != end && !aStopping; ++i) {
-		const auto name = i->getFileName();
-		if(name.empty()) {
+void ShareManager::RefreshTaskHandler::ShareBuilder::buildTreeSingleThread(const bool& aStopping) {
+	// Subdirectories are built recursively
+	SpawnF spawnF = [&](DirectoryTask&& aTask) {
+		buildDirectory(aTask, *this, stats, spawnF, aStopping);
+	};
+
+	spawnF({ path, Text::toLower(path), newDirectory, optionalOldDirectory });
+}
+
+void ShareManager::RefreshTaskHandler::ShareBuilder::buildTreeMultiThread(size_t aThreads, const bool& aStopping) {
+	WorkStealingPool<DirectoryTask> pool(aThreads);
+
+	// Each worker adds the items in its own indexes
+	vector<unique_ptr<ShareRefreshSubtreeInfo>> workerInfos;
+	for (size_t i = 0; i < pool.getWorkerCount(); ++i) {
+		workerInfos.push_back(make_unique<ShareRefreshSubtreeInfo>(getBloom().getTableSize()));
+	}
+
+	pool.push(0, { path, Text::toLower(path), newDirectory, optionalOldDirectory });
+	pool.run([&](const DirectoryTask& aTask, size_t aWorker) {
+		if (aStopping) {
 			return;
 		}
 
-		const auto isDirectory = i->isDirectory();
+		auto& info = *workerInfos[aWorker];
+		buildDirectory(aTask, info, info.stats, [&](DirectoryTask&& aSubdirectoryTask) {
+			pool.push(aWorker, std::move(aSubdirectoryTask));
+		}, aStopping);
+	});
+
+	for (const auto& info: workerInfos) {
+		info->merge(*this);
+	}
+}
+
+void ShareManager::RefreshTaskHandler::ShareBuilder::buildDirectory(const DirectoryTask& aTask, ShareTreeMaps& maps_, ShareRefreshStats& stats_, const SpawnF& aSpawnF, const bool& aStopping) {
+	const auto& aPath = aTask.path;
+	const auto& aPathLower = aTask.pathLower;
+	const auto& aParent = aTask.directory;
+	const auto& aOldParent = aTask.oldDirectory;
+
+	if (aOldParent) {
+		auto unchanged = false;
+
+		{
+			RLock l(sm.tree->getCS());
+			unchanged = isUnchanged(*aParent, *aOldParent);
+		}
+
+		if (unchanged) {
+			copyDirectory(aTask, maps_, stats_, aSpawnF);
+			return;
+		}
+	}
+
+	// Changes made during the same second as the listing wouldn't update the modification date
+	// The directory can be skipped in later refreshes only if all of its items were shared during this scan
+	auto stable = aParent->getLastWrite() < scanStart - 1;
+
+	DirectoryReader::List entries;
+	DirectoryReader::read(aPath, entries);
+
+	ErrorCollector errors;
+	ShareBatchValidator::File::List batchFiles;
+	for (auto& entry: entries) {
+		if (aStopping) {
+			stable = false;
+			break;
+		}
+
+		const auto& name = entry.name;
+		const auto isDirectory = entry.isDirectory();
 		if (!isDirectory) {
 			errors.increaseTotal();
 		}
@@ -695,24 +827,20 @@ void ShareManager::RefreshTaskHandler::ShareBuilder::buildTree(const string& aPa
 			// Validations
 			{
 				auto newParent = !aOldParent;
-				if (!validateFileItem(*i, curPath, isNew, newParent, errors)) {
-					stats.skippedDirectoryCount++;
+				if (!validateFileItem(entry, curPath, isNew, newParent, errors)) {
+					stats_.skippedDirectoryCount++;
+					stable = false;
 					continue;
 				}
 
 			}
 
-			// Add it
-			auto curDir = ShareDirectory::createNormal(std::move(dualName), aParent.get(), i->getLastWriteTime(), *this);
+			// Add it (the directory counts are updated after the whole tree has been built)
+			auto curDir = ShareDirectory::createNormal(std::move(dualName), aParent.get(), entry.getLastWriteTime(), maps_);
 			if (curDir) {
-				buildTree(curPath, curPathLower, curDir, oldDir, aStopping);
-				if (checkContent(curDir)) {
-					if (isNew) {
-						stats.newDirectoryCount++;
-					} else {
-						stats.existingDirectoryCount++;
-					}
-				}
+				curDir->setChangeTime(entry.changeTime);
+				curDir->setFileId(entry.fileId);
+				aSpawnF({ std::move(curPath), std::move(curPathLower), curDir, oldDir });
 			}
 		} else {
 			// Not a directory, assume it's a file...
@@ -728,38 +856,169 @@ void ShareManager::RefreshTaskHandler::ShareBuilder::buildTree(const string& aPa
 
 				// Validations
 				auto newParent = !aOldParent;
-				if (!validateFileItem(*i, curPath, isNew, newParent, errors)) {
-					stats.skippedFileCount++;
+				if (!validateFileItem(entry, curPath, isNew, newParent, errors)) {
+					stats_.skippedFileCount++;
+					stable = false;
+					continue;
+				}
+
+				if (batchValidator) {
+					// Counted and added after the batch hooks have been run (the stable flag is cleared if the file isn't added)
+					batchFiles.emplace_back(ShareValidationFile{ curPath, entry.getSize(), isNew, newParent }, aParent, curPathLower, entry.getLastWriteTime());
 					continue;
 				}
 
 				if (isNew) {
-					stats.newFileCount++;
+					stats_.newFileCount++;
 				} else {
-					stats.existingFileCount++;
+					stats_.existingFileCount++;
 				}
 			}
 
 			// Add it
-			auto size = i->getSize();
+			auto size = entry.getSize();
 			try {
-				HashedFile fi(i->getLastWriteTime(), size);
-				if(HashManager::getInstance()->checkTTH(aPathLower + dualName.getLower(), aPath + name, fi)) {
-					aParent->addFile(std::move(dualName), fi, *this, stats.addedSize);
+				HashedFile fi(entry.getLastWriteTime(), size);
+				if(HashManager::getInstance()->checkTTH(curPathLower, curPath, fi)) {
+					aParent->addFile(std::move(dualName), fi, maps_, stats_.addedSize);
 				} else {
-					stats.hashSize += size;
+					// The hash queue isn't persisted
+					stats_.hashSize += size;
+					stable = false;
 				}
 			} catch(const HashException&) {
+				stable = false;
 			}
 		}
 	}
 
+	aParent->setStableLastWrite(stable);
+
+	if (!batchFiles.empty()) {
+		batchValidator->add(std::move(batchFiles));
+	}
+
 	auto msg = errors.getMessage();
 	if (!msg.empty()) {
 		log(STRING_F(SHARE_FILES_BLOCKED, aPath % msg), LogMessage::SEV_INFO);
 	}
 }
 
+void ShareManager::RefreshTaskHandler::ShareBuilder::addBatchValidatedFiles() noexcept {
+	auto files = batchValidator->finish();
+
+	// Directory path -> errors
+	map<string, ErrorCollector> directoryErrors;
+	const auto reportBlocked = SETTING(REPORT_BLOCKED_SHARE);
+	for (const auto& f: files) {
+		if (f.result != ShareBatchValidator::Result::HASHED) {
+			// The file must be scanned again in the next refresh
+			f.directory->setStableLastWrite(false);
+		}
+
+		if (f.result == ShareBatchValidator::Result::PENDING) {
+			// Aborted
+			continue;
+		}
+
+		const auto& path = f.info.path;
+
+		ErrorCollector* errors = nullptr;
+		if (reportBlocked) {
+			errors = &directoryErrors[PathUtil::getFilePath(path)];
+			errors->increaseTotal();
+		}
+
+		if (f.result == ShareBatchValidator::Result::REJECTED) {
+			dcdebug("Item %s won't be shared: %s\n", path.c_str(), f.error.c_str());
+			if (errors) {
+				errors->add(f.error, PathUtil::getFileName(path), false);
+			}
+
+			stats.skippedFileCount++;
+			continue;
+		}
+
+		if (f.info.isNew) {
+			stats.newFileCount++;
+		} else {
+			stats.existingFileCount++;
+		}
+
+		if (f.result == ShareBatchValidator::Result::HASHED) {
+			f.directory->addFile(DualString(PathUtil::getFileName(path)), f.fileInfo, *this, stats.addedSize);
+		} else if (f.result == ShareBatchValidator::Result::HASHING) {
+			stats.hashSize += f.info.size;
+		}
+	}
+
+	for (const auto& [directoryPath, errors]: directoryErrors) {
+		auto msg = errors.getMessage();
+		if (!msg.empty()) {
+			log(STRING_F(SHARE_FILES_BLOCKED, directoryPath % msg), LogMessage::SEV_INFO);
+		}
+	}
+}
+
+void ShareManager::RefreshTaskHandler::ShareBuilder::copyDirectory(const DirectoryTask& aTask, ShareTreeMaps& maps_, ShareRefreshStats& stats_, const SpawnF& aSpawnF) {
+	const auto& aParent = aTask.directory;
+	const auto& aOldParent = aTask.oldDirectory;
+
+	aParent->setStableLastWrite(true);
+
+	ShareDirectory::List oldDirectories;
+
+	{
+		// The files were validated and hashed during the previous scan
+		RLock l(sm.tree->getCS());
+		for (const auto& f: aOldParent->getFiles()) {
+			aParent->addFile(DualString(f->getName().getNormal()), HashedFile(f->getTTH(), f->getLastWrite(), f->getSize()), maps_, stats_.addedSize);
+			stats_.existingFileCount++;
+		}
+
+		ranges::copy(aOldParent->getDirectories(), back_inserter(oldDirectories));
+	}
+
+	// Subdirectories have their own modification dates
+	for (const auto& oldDir: oldDirectories) {
+		const auto& name = oldDir->getRealName();
+		auto curPath = aTask.path + name.getNormal() + PATH_SEPARATOR;
+
+		DirectoryReader::Entry entry;
+		if (!DirectoryReader::readItem(curPath, entry) || !entry.isDirectory()) {
+			continue;
+		}
+
+		auto curDir = ShareDirectory::createNormal(DualString(name.getNormal()), aParent.get(), entry.getLastWriteTime(), maps_);
+		if (curDir) {
+			curDir->setChangeTime(entry.changeTime);
+			curDir->setFileId(entry.fileId);
+			aSpawnF({ std::move(curPath), aTask.pathLower + name.getLower() + PATH_SEPARATOR, curDir, oldDir });
+		}
+	}
+}
+
+void ShareManager::RefreshTaskHandler::ShareBuilder::finalizeTree(const ShareDirectory::Ptr& aDirectory, const ShareDirectory::Ptr& aOldDirectory) noexcept {
+	// Empty directories are removed from the parent
+	auto directories = aDirectory->getDirectories();
+	for (const auto& d: directories) {
+		ShareDirectory::Ptr oldDir = nullptr;
+		if (aOldDirectory) {
+			RLock l(sm.tree->getCS());
+			oldDir = aOldDirectory->findDirectoryLower(d->getRealName().getLower());
+		}
+
+		finalizeTree(d, oldDir);
+		if (checkContent(d)) {
+			if (!oldDir) {
+				stats.newDirectoryCount++;
+			} else {
+				stats.existingDirectoryCount++;
+			}
+		}
+	}
+}
+
 optional<RefreshTaskQueueInfo> ShareManager::refreshVirtualName(const string& aVirtualName, ShareRefreshPriority aPriority) noexcept {
 	StringList refreshDirs;
 
@@ -822,11 +1081,13 @@ bool ShareManager::handleRefreshPath(const string& aRefreshPath, const ShareRefr
 		optionalOldDirectory = tree->findDirectoryUnsafe(aRefreshPath);
 	}
 
-	auto ri = RefreshTaskHandler::ShareBuilder(aRefreshPath, optionalOldDirectory, File::getLastModified(aRefreshPath), *bloom_, this);
+	auto ri = RefreshTaskHandler::ShareBuilder(aRefreshPath, optionalOldDirectory, File::getLastModified(aRefreshPath), *bloom_, this,
+		aTask.priority == ShareRefreshPriority::MANUAL ? static_cast<int>(SettingsManager::SKIP_UNCHANGED_DISABLED) : SETTING(REFRESH_SKIP_UNCHANGED)
+	);
 	setRefreshState(ri.path, ShareRootRefreshState::STATE_RUNNING, false, aTask.token);
 	 
 	// Build the tree
-	auto completed = ri.buildTree(aTask.canceled);
+	auto completed = ri.buildTree(ShareTasks::getPathThreadCount(aTask), aTask.canceled);
 
 	// Apply the changes
 	if (completed) {
@@ -890,6 +1151,8 @@ shared_ptr<ShareTasksManager::RefreshTaskHandler> ShareManager::startRefresh(con
 		lastIncomingUpdate = GET_TICK();
 	}
 
+	checkBatchValidationSubscribers();
+
 	fire(ShareManagerListener::RefreshStarted(), aTask);
 	return make_shared<ShareManager::RefreshTaskHandler>(
 		refreshBloom,
@@ -898,6 +1161,24 @@ shared_ptr<ShareTasksManager::RefreshTaskHandler> ShareManager::startRefresh(con
 	);
 }
 
+void ShareManager::checkBatchValidationSubscribers() noexcept {
+	StringSet subscribers;
+	for (const auto& s : validator->fileBatchValidationHook.getSubscribers()) {
+		subscribers.insert(s.getId());
+	}
+
+	auto hasNew = ranges::any_of(subscribers, [this](const string& aId) {
+		return !batchValidatedSubscribers.contains(aId);
+	});
+
+	if (hasNew) {
+		dcdebug("ShareManager::checkBatchValidationSubscribers: new batch validation subscribers, all directories will be rescanned\n");
+		tree->clearStableLastWrite();
+	}
+
+	batchValidatedSubscribers = std::move(subscribers);
+}
+
 void ShareManager::onRefreshQueued(const ShareRefreshTask& aTask) noexcept {
 	for (auto& path : aTask.dirs) {
 		setRefreshState(path, ShareRootRefreshState::STATE_PENDING, false, aTask.token);
@@ -918,6 +1199,67 @@ ShareRefreshTaskList ShareManager::getRefreshTasks() const noexcept {
 	return tasks->getRefreshTasks();
 }
 
+// MONITORING
+void ShareManager::handleMonitoredFile(const string& aPath) noexcept {
+	try {
+		validatePathHooked(aPath, false, this);
+	} catch (const Exception& e) {
+		dcdebug("ShareManager::handleMonitoredFile: file %s won't be shared (%s)\n", aPath.c_str(), e.getError().c_str());
+		return;
+	}
+
+	// New files will be added after hashing
+	try {
+		HashedFile fi(File::getLastModified(aPath), File::getSize(aPath));
+		if (HashManager::getInstance()->checkTTH(Text::toLower(aPath), aPath, fi)) {
+			onFileHashed(aPath, fi);
+		}
+	} catch (const HashException&) {
+	}
+}
+
+void ShareManager::removeMonitoredPath(const string& aPath) noexcept {
+	ProfileTokenSet dirtyProfiles;
+	if (PathUtil::isDirectoryPath(aPath)) {
+		HashManager::getInstance()->stopHashing(aPath);
+		if (!tree->removeDirectory(aPath, &dirtyProfiles)) {
+			return;
+		}
+	} else if (!tree->removeFile(aPath, &dirtyProfiles)) {
+		return;
+	}
+
+	profiles->setProfilesDirty(dirtyProfiles, false);
+}
+
+void ShareManager::refreshMonitoredPaths(const StringList& aPaths) noexcept {
+	StringList paths;
+	ranges::copy_if(aPaths, back_inserter(paths), [this](const string& aPath) {
+		return allowShareDirectoryHooked(aPath, this);
+	});
+
+	if (!paths.empty()) {
+		tasks->addRefreshTask(ShareRefreshPriority::SCHEDULED, paths, ShareRefreshType::REFRESH_DIRS);
+	}
+}
+
+StringList ShareManager::getMonitoredRoots() const noexcept {
+	StringList ret;
+
+	auto mode = SETTING(MONITORING_MODE);
+	if (mode == SettingsManager::MONITORING_DISABLED) {
+		return ret;
+	}
+
+	for (const auto& rootDirectory: tree->getShareRoots()) {
+		if (mode == SettingsManager::MONITORING_ALL || rootDirectory->getIncoming()) {
+			ret.push_back(rootDirectory->getPath());
+		}
+	}
+
+	return ret;
+}
+
 bool ShareManager::isRefreshing() const noexcept {
 	return tasks->isRefreshing();
 }
@@ -933,7 +1275,7 @@ bool ShareManager::abortRefresh(optional<ShareRefreshTaskToken> aToken) noexcept
 
 
 // TIMER
-void ShareManager::on(TimerManagerListener::Minute, uint64_t aTick) noexcept {
+void ShareManager::onTimerMaintenance(uint64_t aTick) noexcept {
 	if (lastSave == 0 || lastSave + 15 * 60 * 1000 <= aTick) {
 		saveShareCache();
 	}
@@ -1054,29 +1396,14 @@ FileList* ShareManager::generateXmlList(ProfileToken aProfile, bool forced /*fal
 	{
 		Lock lFl(fl->cs);
 		if (fl->allowGenerateNew(forced)) {
-			auto tmpName = fl->getFileName().substr(0, fl->getFileName().length() - 4);
 			try {
-				{
-					File f(tmpName, File::RW, File::TRUNCATE | File::CREATE, File::BUFFER_SEQUENTIAL, false);
-
-					tree->toFilelist(f, ADC_ROOT_STR, aProfile, true, duplicateFilelistFileLogger);
-
-					fl->setXmlListLen(f.getSize());
-
-					File bz(fl->getFileName(), File::WRITE, File::TRUNCATE | File::CREATE, File::BUFFER_SEQUENTIAL, false);
-					// We don't care about the leaves...
-					CalcOutputStream<TTFilter<1024 * 1024 * 1024>, false> bzTree(&bz);
-					FilteredOutputStream<BZFilter, false> bzipper(&bzTree);
-					CalcOutputStream<TTFilter<1024 * 1024 * 1024>, false> newXmlFile(&bzipper);
-
-					newXmlFile.write(f.read());
-					newXmlFile.flushBuffers(false);
-
-					newXmlFile.getFilter().getTree().finalize();
-					bzTree.getFilter().getTree().finalize();
-
-					fl->setXmlRoot(newXmlFile.getFilter().getTree().getRoot());
-					fl->setBzXmlRoot(bzTree.getFilter().getTree().getRoot());
+				try {
+					generateXmlListIncremental(*fl);
+				} catch (const Exception& e) {
+					// Shouldn't happen unless the disk is full
+					dcdebug("Incremental filelist generation failed for profile %d (%s), generating a full list\n", aProfile, e.getError().c_str());
+					fl->fragments.clear();
+					generateXmlListFull(*fl);
 				}
 
 				fl->saveList();
@@ -1091,13 +1418,53 @@ FileList* ShareManager::generateXmlList(ProfileToken aProfile, bool forced /*fal
 					throw ShareException(UserConnection::FILE_NOT_AVAILABLE);
 				}
 			}
-
-			File::deleteFile(tmpName);
 		}
 	}
 	return fl;
 }
 
+void ShareManager::generateXmlListIncremental(FileList& fileList_) {
+	File bz(fileList_.getFileName(), File::WRITE, File::TRUNCATE | File::CREATE, File::BUFFER_SEQUENTIAL, false);
+
+	// We don't care about the leaves...
+	CalcOutputStream<TTFilter<1024 * 1024 * 1024>, false> bzTree(&bz);
+	auto xmlListLen = tree->toCompressedFilelist(bzTree, fileList_, duplicateFilelistFileLogger);
+	bzTree.flushBuffers(false);
+	bzTree.getFilter().getTree().finalize();
+
+	fileList_.setXmlListLen(xmlListLen);
+	fileList_.setBzXmlRoot(bzTree.getFilter().getTree().getRoot());
+
+	// Calculated on demand
+	fileList_.setXmlRoot(nullopt);
+}
+
+void ShareManager::generateXmlListFull(FileList& fileList_) {
+	auto tmpName = fileList_.getFileName().substr(0, fileList_.getFileName().length() - 4);
+	ScopedFunctor([&tmpName] { File::deleteFile(tmpName); });
+
+	File f(tmpName, File::RW, File::TRUNCATE | File::CREATE, File::BUFFER_SEQUENTIAL, false);
+
+	tree->toFilelist(f, ADC_ROOT_STR, fileList_.getProfile(), true, duplicateFilelistFileLogger);
+
+	fileList_.setXmlListLen(f.getSize());
+
+	File bz(fileList_.getFileName(), File::WRITE, File::TRUNCATE | File::CREATE, File::BUFFER_SEQUENTIAL, false);
+	// We don't care about the leaves...
+	CalcOutputStream<TTFilter<1024 * 1024 * 1024>, false> bzTree(&bz);
+	FilteredOutputStream<ParallelBZFilter, false> bzipper(&bzTree);
+	CalcOutputStream<TTFilter<1024 * 1024 * 1024>, false> newXmlFile(&bzipper);
+
+	newXmlFile.write(f.read());
+	newXmlFile.flushBuffers(false);
+
+	newXmlFile.getFilter().getTree().finalize();
+	bzTree.getFilter().getTree().finalize();
+
+	fileList_.setXmlRoot(newXmlFile.getFilter().getTree().getRoot());
+	fileList_.setBzXmlRoot(bzTree.getFilter().getTree().getRoot());
+}
+
 MemoryInputStream* ShareManager::generatePartialList(const string& aVirtualPath, bool aRecursive, const OptionalProfileToken& aProfile) const noexcept {
 	string xml = Util::emptyString;
 
@@ -1152,19 +1519,20 @@ void ShareManager::saveShareCache(const ProgressFunction& progressF /*nullptr*/)
 
 		try {
 			parallel_for_each(dirtyDirs.begin(), dirtyDirs.end(), [&](const ShareDirectory::Ptr& d) {
-				string path = d->getRoot()->getCacheXmlPath();
+				string path = d->getRoot()->getCacheBinaryPath();
 				try {
 					{
-						string indent, tmp;
-
 						//create a backup first in case we get interrupted on creation.
 						File ff(path + ".tmp", File::WRITE, File::TRUNCATE | File::CREATE);
-						BufferedOutputStream<false> xmlFile(&ff);
-						tree->toCache(xmlFile, d);
+						BufferedOutputStream<false> cacheFile(&ff);
+						tree->toBinaryCache(cacheFile, d);
 					}
 
 					File::deleteFile(path);
 					File::renameFile(path + ".tmp", path);
+
+					// Legacy cache would be outdated if the binary cache gets removed
+					File::deleteFile(d->getRoot()->getCacheXmlPath());
 				} catch (Exception& e) {
 					log(STRING_F(SAVE_FAILED_X, path % e.getError()), LogMessage::SEV_WARNING);
 				}
@@ -23,7 +23,6 @@
 #include <airdcpp/hash/HashManagerListener.h>
 #include <airdcpp/settings/SettingsManagerListener.h>
 #include <airdcpp/share/ShareManagerListener.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 #include <airdcpp/core/types/DupeType.h>
 #include <airdcpp/core/classes/Exception.h>
@@ -32,6 +31,7 @@
 #include <airdcpp/hash/value/MerkleTree.h>
 #include <airdcpp/share/ShareDirectory.h>
 #include <airdcpp/share/ShareDirectoryInfo.h>
+#include <airdcpp/share/ShareMonitor.h>
 #include <airdcpp/share/ShareRefreshInfo.h>
 #include <airdcpp/share/ShareRefreshTask.h>
 #include <airdcpp/share/ShareSearchInfo.h>
@@ -48,6 +48,7 @@ class HashedFile;
 class OutputStream;
 class MemoryInputStream;
 class SearchQuery;
+class ShareBatchValidator;
 class SharePathValidator;
 class ShareProfileManager;
 class ShareTasks;
@@ -56,7 +57,7 @@ class ShareTree;
 class FileList;
 
 class ShareManager : public Singleton<ShareManager>, public Speaker<ShareManagerListener>, private SettingsManagerListener, 
-	private TimerManagerListener, private HashManagerListener, public ShareTasksManager
+	private HashManagerListener, public ShareTasksManager, public ShareMonitorManager
 {
 public:
 	static void log(const string& aMsg, LogMessage::Severity aSeverity) noexcept;
@@ -121,6 +122,12 @@ public:
 
 	ShareRefreshTaskList getRefreshTasks() const noexcept;
 
+	// ShareMonitorManager
+	void handleMonitoredFile(const string& aPath) noexcept override;
+	void removeMonitoredPath(const string& aPath) noexcept override;
+	void refreshMonitoredPaths(const StringList& aPaths) noexcept override;
+	StringList getMonitoredRoots() const noexcept override;
+
 	// Throws ShareException in case an invalid path is provided
 	void search(SearchResultList& l, ShareSearch& aSearch);
 
@@ -134,6 +141,7 @@ public:
 
 	bool isFileShared(const TTHValue& aTTH) const noexcept;
 	bool isFileShared(const TTHValue& aTTH, ProfileToken aProfile) const noexcept;
+	vector<bool> isFileShared(std::span<const TTHValue> aTTHs) const noexcept;
 	bool isRealPathShared(const string& aPath) const noexcept;
 
 	// Returns true if the real path can be added in share
@@ -227,6 +235,15 @@ private:
 	const unique_ptr<SharePathValidator> validator;
 	const unique_ptr<ShareTasks> tasks;
 	const unique_ptr<ShareTree> tree;
+	const unique_ptr<ShareMonitor> monitor;
+
+	// Batch validation hook subscribers that have validated the unchanged (stable) directories in the tree
+	// Accessed only from the refresh thread
+	StringSet batchValidatedSubscribers;
+
+	// Unchanged directories are copied from the old tree during refreshes without running the validation hooks again
+	// Clear the stable flags so that new batch validation subscribers will get to see all shared files
+	void checkBatchValidationSubscribers() noexcept;
 
 	friend class Singleton<ShareManager>;
 	
@@ -236,6 +253,12 @@ private:
 	// Throws ShareException
 	FileList* generateXmlList(ProfileToken aProfile, bool aForced = false);
 
+	// Reuses the compressed content of unchanged top-level directories (throws Exception)
+	void generateXmlListIncremental(FileList& fileList_);
+
+	// Throws Exception
+	void generateXmlListFull(FileList& fileList_);
+
 	bool loadCache(const ProgressFunction& progressF) noexcept;
 
 	uint64_t lastFullUpdate = GET_TICK();
@@ -262,16 +285,51 @@ private:
 
 		class ShareBuilder : public ShareRefreshInfo {
 		public:
-			ShareBuilder(const string& aPath, const ShareDirectory::Ptr& aOldRoot, time_t aLastWrite, ShareBloom& bloom_, ShareManager* sm);
+			// Content of directories that haven't changed since the previous scan is copied from the old tree when aSkipUnchanged is enabled
+			ShareBuilder(const string& aPath, const ShareDirectory::Ptr& aOldRoot, time_t aLastWrite, ShareBloom& bloom_, ShareManager* sm, int aSkipUnchanged);
 
-			// Recursive function for building a new share tree from a path
-			bool buildTree(const bool& aStopping) noexcept;
+			// Build a new share tree from the path
+			// Directories are scanned in parallel when using more than one thread
+			bool buildTree(size_t aThreads, const bool& aStopping) noexcept;
 		private:
-			void buildTree(const string& aPath, const string& aPathLower, const ShareDirectory::Ptr& aCurrentDirectory, const ShareDirectory::Ptr& aOldDirectory, const bool& aStopping);
+			struct DirectoryTask {
+				string path;
+				string pathLower;
+				ShareDirectory::Ptr directory;
+				ShareDirectory::Ptr oldDirectory;
+			};
+
+			using SpawnF = function<void (DirectoryTask&&)>;
+
+			void buildTreeSingleThread(const bool& aStopping);
+			void buildTreeMultiThread(size_t aThreads, const bool& aStopping);
+
+			// Add the content of a single directory, subdirectories are passed to the spawn function
+			void buildDirectory(const DirectoryTask& aTask, ShareTreeMaps& maps_, ShareRefreshStats& stats_, const SpawnF& aSpawnF, const bool& aStopping);
+
+			// Copy the content of an unchanged directory from the old tree without accessing the files on disk
+			void copyDirectory(const DirectoryTask& aTask, ShareTreeMaps& maps_, ShareRefreshStats& stats_, const SpawnF& aSpawnF);
+
+			// Compares the attributes of the scanned directory with the old one
+			bool isUnchanged(const ShareDirectory& aDirectory, const ShareDirectory& aOldDirectory) const noexcept;
+
+			// Remove empty directories (if enabled) and count the directories that were added
+			void finalizeTree(const ShareDirectory::Ptr& aDirectory, const ShareDirectory::Ptr& aOldDirectory) noexcept;
 
 			bool validateFileItem(const FileItemInfoBase& aFileItem, const string& aPath, bool aIsNew, bool aNewParent, ErrorCollector& aErrorCollector) noexcept;
 
+			// Add the files that have been handled by the batch validator
+			void addBatchValidatedFiles() noexcept;
+
 			const ShareManager& sm;
+
+			// Set when there are batch validation hooks, the files are added after the tree has been built
+			unique_ptr<ShareBatchValidator> batchValidator;
+
+			const int skipUnchanged;
+
+			// Directories modified after this can't be trusted to be unchanged during the next refresh
+			const time_t scanStart = GET_TIME();
 		};
 
 		using ShareBuilderPtr = shared_ptr<ShareBuilder>;
@@ -295,8 +353,9 @@ private:
 
 	void on(SettingsManagerListener::LoadCompleted, bool aFileLoaded) noexcept override;
 	
-	// TimerManagerListener
-	void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
+	// Timer tasks (run in the disk thread of the timer)
+	TimerTaskId maintenanceTask = 0;
+	void onTimerMaintenance(uint64_t aTick) noexcept;
 
 	void loadProfiles(SimpleXML& aXml);
 	void loadProfile(SimpleXML& aXml, bool aIsDefault);
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+#include <airdcpp/share/ShareMonitor.h>
+
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/io/File.h>
+#include <airdcpp/core/localization/ResourceManager.h>
+#include <airdcpp/events/LogManager.h>
+#include <airdcpp/settings/SettingsManager.h>
+#include <airdcpp/util/PathUtil.h>
+
+namespace dcpp {
+
+// Roots are added again after an error (e.g. the directory was removed temporarily)
+#define FAILED_ROOT_RETRY_INTERVAL (10 * 60 * 1000)
+
+ShareMonitor::ShareMonitor(ShareMonitorManager* aManager) noexcept : manager(aManager) {
+	monitor.addListener(this);
+}
+
+ShareMonitor::~ShareMonitor() {
+	stop();
+	monitor.removeListener(this);
+}
+
+void ShareMonitor::log(const string& aMsg, LogMessage::Severity aSeverity) noexcept {
+	LogManager::getInstance()->message(aMsg, aSeverity, STRING(SHARE));
+}
+
+void ShareMonitor::start() noexcept {
+	if (!DirectoryMonitor::isSupported() || timerTask != 0) {
+		return;
+	}
+
+	// The roots are added from the first tick
+	auto tm = TimerManager::getInstance();
+	timerTask = tm->addTask("Share monitor", 1000, [this](uint64_t aTick) { onTimer(aTick); }, tm->getDiskExecutor());
+}
+
+void ShareMonitor::stop() noexcept {
+	if (timerTask != 0) {
+		TimerManager::getInstance()->removeTask(timerTask);
+		timerTask = 0;
+	}
+
+	monitor.stop();
+}
+
+void ShareMonitor::onTimer(uint64_t aTick) noexcept {
+	updateRoots(aTick);
+	processChanges(aTick);
+}
+
+void ShareMonitor::updateRoots(uint64_t aTick) noexcept {
+	auto roots = manager->getMonitoredRoots();
+
+	StringList retriedRoots;
+
+	{
+		Lock l(cs);
+		std::erase_if(failedRoots, [&roots](const auto& aFailed) { return ranges::find(roots, aFailed.first) == roots.end(); });
+		for (const auto& path: failedRoots | views::keys) {
+			monitoredRoots.erase(path);
+		}
+	}
+
+	// Removed roots (or monitoring disabled)
+	for (auto i = monitoredRoots.begin(); i != monitoredRoots.end();) {
+		if (ranges::find(roots, *i) == roots.end()) {
+			monitor.removeDirectory(*i);
+
+			Lock l(cs);
+			std::erase_if(changedPaths, [&i](const auto& aChange) { return aChange.first.starts_with(*i); });
+			i = monitoredRoots.erase(i);
+		} else {
+			++i;
+		}
+	}
+
+	// New roots
+	for (const auto& path: roots) {
+		if (monitoredRoots.contains(path)) {
+			continue;
+		}
+
+		bool retry = false;
+
+		{
+			Lock l(cs);
+			if (auto f = failedRoots.find(path); f != failedRoots.end()) {
+				if (f->second > aTick) {
+					continue;
+				}
+
+				failedRoots.erase(f);
+				retry = true;
+			}
+		}
+
+		try {
+			auto backend = monitor.addDirectory(path);
+			dcdebug("ShareMonitor: monitoring %s (%s)\n", path.c_str(), backend == DirectoryMonitor::Backend::FANOTIFY ? "fanotify" : "inotify");
+		} catch (const MonitorException& e) {
+			log(STRING_F(SHARE_MONITORING_FAILED, path % e.getError()), LogMessage::SEV_WARNING);
+
+			Lock l(cs);
+			failedRoots[path] = aTick + FAILED_ROOT_RETRY_INTERVAL;
+			continue;
+		}
+
+		monitoredRoots.insert(path);
+		if (retry) {
+			// Changes made while the root wasn't monitored are unknown
+			retriedRoots.push_back(path);
+		}
+	}
+
+	if (!retriedRoots.empty()) {
+		manager->refreshMonitoredPaths(retriedRoots);
+	}
+}
+
+void ShareMonitor::processChanges(uint64_t aTick) noexcept {
+	StringList paths;
+
+	{
+		auto delay = static_cast<uint64_t>(SETTING(MONITORING_DELAY)) * 1000;
+
+		Lock l(cs);
+		for (auto i = changedPaths.begin(); i != changedPaths.end();) {
+			if (i->second + delay <= aTick) {
+				paths.push_back(i->first);
+				i = changedPaths.erase(i);
+			} else {
+				++i;
+			}
+		}
+	}
+
+	if (paths.empty()) {
+		return;
+	}
+
+	// Parent directories are sorted before their content, which is handled by the directory
+	ranges::sort(paths);
+
+	StringList refreshPaths;
+	string handledDirectory;
+	for (const auto& path: paths) {
+		if (!handledDirectory.empty() && path.starts_with(handledDirectory)) {
+			continue;
+		}
+
+		if (PathUtil::isDirectoryPath(path)) {
+			handledDirectory = path;
+			if (File::isDirectory(path)) {
+				refreshPaths.push_back(path);
+			} else {
+				manager->removeMonitoredPath(path);
+			}
+		} else if (File::getSize(path) >= 0) {
+			manager->handleMonitoredFile(path);
+		} else {
+			manager->removeMonitoredPath(path);
+		}
+	}
+
+	if (!refreshPaths.empty()) {
+		manager->refreshMonitoredPaths(refreshPaths);
+	}
+}
+
+void ShareMonitor::addChange(const string& aPath) noexcept {
+	Lock l(cs);
+	changedPaths[aPath] = GET_TICK();
+}
+
+void ShareMonitor::on(DirectoryMonitorListener::FileModified, const string& aPath) noexcept {
+	addChange(aPath);
+}
+
+void ShareMonitor::on(DirectoryMonitorListener::FileRemoved, const string& aPath) noexcept {
+	addChange(aPath);
+}
+
+void ShareMonitor::on(DirectoryMonitorListener::DirectoryCreated, const string& aPath) noexcept {
+	addChange(aPath);
+}
+
+void ShareMonitor::on(DirectoryMonitorListener::DirectoryRemoved, const string& aPath) noexcept {
+	addChange(aPath);
+}
+
+void ShareMonitor::on(DirectoryMonitorListener::Overflow, const string& aRootPath) noexcept {
+	// Some changes are unknown, refresh everything
+	addChange(aRootPath);
+}
+
+void ShareMonitor::on(DirectoryMonitorListener::Failed, const string& aRootPath, const string& aError) noexcept {
+	log(STRING_F(SHARE_MONITORING_FAILED, aRootPath % aError), LogMessage::SEV_WARNING);
+
+	Lock l(cs);
+	failedRoots[aRootPath] = GET_TICK() + FAILED_ROOT_RETRY_INTERVAL;
+}
+
+} // namespace dcpp
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_SHARE_MONITOR_H
+#define DCPLUSPLUS_DCPP_SHARE_MONITOR_H
+
+#include <airdcpp/core/io/DirectoryMonitor.h>
+#include <airdcpp/core/timer/TimerManager.h>
+#include <airdcpp/message/Message.h>
+
+namespace dcpp {
+
+struct ShareMonitorManager {
+	// Add or update a file that has been modified on disk
+	virtual void handleMonitoredFile(const string& aPath) noexcept = 0;
+
+	// Remove a file or directory that no longer exists on disk
+	virtual void removeMonitoredPath(const string& aPath) noexcept = 0;
+
+	// Queue a refresh for new or changed directories
+	virtual void refreshMonitoredPaths(const StringList& aPaths) noexcept = 0;
+
+	// Root directories that should be monitored (based on the user settings)
+	virtual StringList getMonitoredRoots() const noexcept = 0;
+};
+
+// Applies file system changes for the monitored share roots without full refreshes
+//
+// Changes are collected per path and applied after no new events have been received for the path
+// during the configured delay (so that files that are still being written won't get hashed).
+// Events only tell which paths have changed, the current state is always read from the disk.
+class ShareMonitor : private DirectoryMonitorListener {
+public:
+	explicit ShareMonitor(ShareMonitorManager* aManager) noexcept;
+	~ShareMonitor() override;
+
+	static void log(const string& aMsg, LogMessage::Severity aSeverity) noexcept;
+
+	void start() noexcept;
+	void stop() noexcept;
+
+	ShareMonitor(const ShareMonitor&) = delete;
+	ShareMonitor& operator=(const ShareMonitor&) = delete;
+private:
+	ShareMonitorManager* const manager;
+
+	DirectoryMonitor monitor;
+	TimerTaskId timerTask = 0;
+
+	// Sync the monitored directories with the shared roots
+	void updateRoots(uint64_t aTick) noexcept;
+
+	// Apply the changes that have exceeded the delay
+	void processChanges(uint64_t aTick) noexcept;
+
+	void onTimer(uint64_t aTick) noexcept;
+
+	void addChange(const string& aPath) noexcept;
+
+	CriticalSection cs;
+
+	// Path -> time of the latest event
+	unordered_map<string, uint64_t> changedPaths;
+
+	// Root path -> time when monitoring can be retried
+	unordered_map<string, uint64_t> failedRoots;
+
+	// Accessed only from the timer task
+	StringSet monitoredRoots;
+
+	// DirectoryMonitorListener
+	void on(DirectoryMonitorListener::FileModified, const string& aPath) noexcept override;
+	void on(DirectoryMonitorListener::FileRemoved, const string& aPath) noexcept override;
+	void on(DirectoryMonitorListener::DirectoryCreated, const string& aPath) noexcept override;
+	void on(DirectoryMonitorListener::DirectoryRemoved, const string& aPath) noexcept override;
+	void on(DirectoryMonitorListener::Overflow, const string& aRootPath) noexcept override;
+	void on(DirectoryMonitorListener::Failed, const string& aRootPath, const string& aError) noexcept override;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_SHARE_MONITOR_H)
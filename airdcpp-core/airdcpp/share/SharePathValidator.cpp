@@ -248,6 +248,21 @@ void SharePathValidator::validateHooked(const FileItemInfoBase& aFileItem, const
 	}
 }
 
+StringMap SharePathValidator::validateFileBatchHooked(const ShareValidationFile::List& aFiles, CallerPtr aCaller) const noexcept {
+	try {
+		auto results = fileBatchValidationHook.runHooksDataThrow(aCaller, aFiles);
+		return ActionHook<StringMap, const ShareValidationFile::List&>::normalizeMap(results);
+	} catch (const HookRejectException& e) {
+		// The whole batch was rejected
+		StringMap ret;
+		for (const auto& f: aFiles) {
+			ret.emplace(f.path, e.getError());
+		}
+
+		return ret;
+	}
+}
+
 void SharePathValidator::validateRootPath(const string& aRealPath) const {
 	if (aRealPath.empty()) {
 		throw ShareException(STRING(NO_DIRECTORY_SPECIFIED));
@@ -293,6 +308,23 @@ void SharePathValidator::validateNewDirectoryPathTokensHooked(const string& aBas
 void SharePathValidator::validateNewPathHooked(const string& aPath, bool aSkipQueueCheck, bool aNewParent, CallerPtr aCaller) const {
 	FileItem f(aPath);
 	validateHooked(f, aPath, aSkipQueueCheck, aCaller, true, aNewParent);
+
+	if (!f.isDirectory()) {
+		// Files added outside refreshes must pass the batch hook as well
+		validateFileBatchSingleHooked(ShareValidationFile{ aPath, f.getSize(), true, aNewParent }, aCaller);
+	}
+}
+
+void SharePathValidator::validateFileBatchSingleHooked(const ShareValidationFile& aFile, CallerPtr aCaller) const {
+	if (!fileBatchValidationHook.hasSubscribers()) {
+		return;
+	}
+
+	auto rejected = validateFileBatchHooked({ aFile }, aCaller);
+	auto i = rejected.find(aFile.path);
+	if (i != rejected.end()) {
+		throw ShareValidatorException(i->second, ShareValidatorErrorType::TYPE_HOOK);
+	}
 }
 
 }
\ No newline at end of file
@@ -55,6 +55,15 @@ private:
 	const ShareValidatorErrorType type;
 };
 
+struct ShareValidationFile {
+	string path;
+	int64_t size;
+	bool isNew;
+	bool newParent;
+
+	using List = vector<ShareValidationFile>;
+};
+
 class SharePathValidator {
 public:
 	ActionHook<nullptr_t, const string&, int64_t> fileValidationHook;
@@ -62,6 +71,12 @@ public:
 	ActionHook<nullptr_t, const string&, bool /* aNewParent */> newDirectoryValidationHook;
 	ActionHook<nullptr_t, const string&, int64_t, bool /* aNewParent */> newFileValidationHook;
 
+	// Authoritative filter for shared files: files that have passed all other validations are passed
+	// in batches during refreshes, and as single-item lists when files are added outside refreshes
+	// (monitoring and other single-path additions)
+	// The data should contain the rejected paths with the reason (path -> message)
+	ActionHook<StringMap, const ShareValidationFile::List&> fileBatchValidationHook;
+
 	using RootPointParser = std::function<string(const string&)>;
 	SharePathValidator(RootPointParser&& aRootPointParser);
 
@@ -100,6 +115,14 @@ public:
 	// Throws ShareValidatorException/QueueException in case of errors
 	// FileException is thrown if the file doesn't exist
 	void validateNewPathHooked(const string& aPath, bool aSkipQueueCheck, bool aNewParent, CallerPtr aCaller) const;
+
+	// Run the batched file validation hooks
+	// Returns the rejected paths with the errors
+	StringMap validateFileBatchHooked(const ShareValidationFile::List& aFiles, CallerPtr aCaller) const noexcept;
+
+	// Run the batched file validation hooks for a single file
+	// Throws ShareValidatorException if the file is rejected
+	void validateFileBatchSingleHooked(const ShareValidationFile& aFile, CallerPtr aCaller) const;
 private:
 	// Comprehensive check for a directory/file whether it is valid to be added in share
 	// Use validateRootPath for new root directories instead
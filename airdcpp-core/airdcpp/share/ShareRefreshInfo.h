@@ -25,6 +25,7 @@
 #include <airdcpp/core/header/typedefs.h>
 
 #include <airdcpp/share/ShareDirectory.h>
+#include <airdcpp/share/ShareSearchIndex.h>
 
 namespace dcpp {
 
@@ -56,12 +57,27 @@ public:
 	string path;
 
 	bool checkContent(const ShareDirectory::Ptr& aDirectory) noexcept;
-	void applyRefreshChanges(ShareDirectory::MultiMap& lowerDirNameMap_, ShareDirectory::Map& rootPaths_, ShareDirectory::File::TTHMap& tthIndex_, int64_t& sharedBytes_, ProfileTokenSet* dirtyProfiles) noexcept;
+	void applyRefreshChanges(ShareDirectory::MultiMap& lowerDirNameMap_, ShareDirectory::Map& rootPaths_, ShareDirectory::File::TTHMap& tthIndex_, int64_t& sharedBytes_, ShareSearchIndex& searchIndex_, ProfileTokenSet* dirtyProfiles) noexcept;
 
 	ShareRefreshInfo(ShareRefreshInfo&) = delete;
 	ShareRefreshInfo& operator=(ShareRefreshInfo&) = delete;
 };
 
+// Indexes for the part of a refreshed tree that is built in a separate thread
+// The content is merged in the refresh info after the thread has finished
+class ShareRefreshSubtreeInfo : public ShareTreeMaps {
+public:
+	explicit ShareRefreshSubtreeInfo(size_t aBloomSize);
+
+	ShareBloom bloom;
+	ShareRefreshStats stats;
+
+	void merge(ShareRefreshInfo& ri_) noexcept;
+
+	ShareRefreshSubtreeInfo(ShareRefreshSubtreeInfo&) = delete;
+	ShareRefreshSubtreeInfo& operator=(ShareRefreshSubtreeInfo&) = delete;
+};
+
 }
 
 #endif
\ No newline at end of file
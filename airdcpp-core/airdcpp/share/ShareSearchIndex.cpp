@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+#include <airdcpp/share/ShareSearchIndex.h>
+
+#include <airdcpp/search/SearchQuery.h>
+
+namespace dcpp {
+
+// Don't use the index if the candidates would cover a large part of the share
+// (walking through the tree is cheaper than collecting the candidates in that case)
+#define MAX_CANDIDATE_RATIO 4
+
+// Compact the posting lists when there are more removed IDs than this (and more than there are live items)
+#define MIN_COMPACT_COUNT 10000
+
+
+// CANDIDATES
+void ShareSearchCandidates::addDirectory(const ShareDirectory* aDirectory) noexcept {
+	matchingDirectories.insert(aDirectory);
+	addParents(aDirectory);
+}
+
+void ShareSearchCandidates::addFile(const ShareDirectory::File* aFile) noexcept {
+	files.insert(aFile);
+	if (parentDirectories.insert(aFile->getParent()).second) {
+		addParents(aFile->getParent());
+	}
+}
+
+void ShareSearchCandidates::addParents(const ShareDirectory* aDirectory) noexcept {
+	for (auto cur = aDirectory->getParent(); cur; cur = cur->getParent()) {
+		if (!parentDirectories.insert(cur).second) {
+			// Handled already
+			break;
+		}
+	}
+}
+
+bool ShareSearchCandidates::hasFile(const ShareDirectory::File* aFile) const noexcept {
+	return files.contains(aFile);
+}
+
+ShareSearchCandidates::DirectoryMatch ShareSearchCandidates::matchDirectory(const ShareDirectory* aDirectory) const noexcept {
+	if (matchingDirectories.contains(aDirectory)) {
+		return DirectoryMatch::FULL;
+	}
+
+	if (parentDirectories.contains(aDirectory)) {
+		return DirectoryMatch::PARTIAL;
+	}
+
+	return DirectoryMatch::NONE;
+}
+
+ShareSearchCandidates::DirectoryMatch ShareSearchCandidates::matchRoot(const ShareDirectory* aDirectory) const noexcept {
+	for (auto cur = aDirectory->getParent(); cur; cur = cur->getParent()) {
+		if (matchingDirectories.contains(cur)) {
+			return DirectoryMatch::FULL;
+		}
+	}
+
+	return matchDirectory(aDirectory);
+}
+
+
+// INDEX
+void ShareSearchIndex::getTrigrams(const string& aNameLower, vector<Trigram>& trigrams_) noexcept {
+	trigrams_.clear();
+	if (aNameLower.size() < MIN_PATTERN_LENGTH) {
+		return;
+	}
+
+	trigrams_.reserve(aNameLower.size() - 2);
+	for (size_t i = 0; i + 2 < aNameLower.size(); ++i) {
+		auto trigram = static_cast<Trigram>(static_cast<uint8_t>(aNameLower[i])) << 16 |
+			static_cast<Trigram>(static_cast<uint8_t>(aNameLower[i + 1])) << 8 |
+			static_cast<Trigram>(static_cast<uint8_t>(aNameLower[i + 2]));
+		trigrams_.push_back(trigram);
+	}
+
+	ranges::sort(trigrams_);
+	trigrams_.erase(ranges::unique(trigrams_).begin(), trigrams_.end());
+}
+
+template<class ItemT>
+ShareSearchIndex::ItemId ShareSearchIndex::NameIndex<ItemT>::add(ItemT* aItem, const string& aNameLower) noexcept {
+	auto id = static_cast<ItemId>(items.size());
+	items.push_back(aItem);
+
+	// IDs are always increasing, the lists will stay sorted
+	vector<Trigram> trigrams;
+	getTrigrams(aNameLower, trigrams);
+	for (auto trigram : trigrams) {
+		postings[trigram].push_back(id);
+	}
+
+	return id;
+}
+
+template<class ItemT>
+void ShareSearchIndex::NameIndex<ItemT>::remove(ItemId aId) noexcept {
+	dcassert(aId > 0 && aId < items.size() && items[aId]);
+
+	// The ID will be removed from the posting lists when compacting
+	items[aId] = nullptr;
+	removedCount++;
+
+	if (removedCount > MIN_COMPACT_COUNT && removedCount > getItemCount()) {
+		compact();
+	}
+}
+
+template<class ItemT>
+void ShareSearchIndex::NameIndex<ItemT>::compact() noexcept {
+	// Allocate new IDs for the remaining items (the order won't change)
+	vector<ItemId> newIds(items.size(), 0);
+	vector<ItemT*> newItems(1, nullptr);
+	newItems.reserve(getItemCount() + 1);
+
+	for (ItemId oldId = 1; oldId < items.size(); ++oldId) {
+		auto item = items[oldId];
+		if (!item) {
+			continue;
+		}
+
+		auto newId = static_cast<ItemId>(newItems.size());
+		newIds[oldId] = newId;
+		newItems.push_back(item);
+		item->setSearchIndexId(newId);
+	}
+
+	for (auto i = postings.begin(); i != postings.end();) {
+		auto& ids = i->second;
+		std::erase_if(ids, [&newIds](ItemId aId) { return newIds[aId] == 0; });
+		if (ids.empty()) {
+			i = postings.erase(i);
+			continue;
+		}
+
+		for (auto& id : ids) {
+			id = newIds[id];
+		}
+
+		ids.shrink_to_fit();
+		++i;
+	}
+
+	dcdebug("ShareSearchIndex: compacted, %d items removed\n", static_cast<int>(removedCount));
+
+	items = std::move(newItems);
+	removedCount = 0;
+}
+
+template<class ItemT>
+ShareSearchIndex::IdList ShareSearchIndex::NameIndex<ItemT>::find(const vector<Trigram>& aTrigrams) const noexcept {
+	vector<const IdList*> lists;
+	for (auto trigram : aTrigrams) {
+		auto i = postings.find(trigram);
+		if (i == postings.end()) {
+			// Nothing contains this trigram
+			return IdList();
+		}
+
+		lists.push_back(&i->second);
+	}
+
+	if (lists.empty()) {
+		return IdList();
+	}
+
+	// Start from the shortest list
+	ranges::sort(lists, [](const IdList* a, const IdList* b) { return a->size() < b->size(); });
+
+	IdList ret(*lists.front()), tmp;
+	for (auto i = lists.begin() + 1; i != lists.end() && !ret.empty(); ++i) {
+		tmp.clear();
+		ranges::set_intersection(ret, **i, back_inserter(tmp));
+		ret.swap(tmp);
+	}
+
+	// Skip removed items
+	std::erase_if(ret, [this](ItemId aId) { return !items[aId]; });
+	return ret;
+}
+
+void ShareSearchIndex::addDirectory(ShareDirectory& aDirectory) noexcept {
+	dcassert(aDirectory.getSearchIndexId() == 0);
+	aDirectory.setSearchIndexId(directories.add(&aDirectory, aDirectory.getVirtualNameLower()));
+}
+
+void ShareSearchIndex::removeDirectory(ShareDirectory& aDirectory) noexcept {
+	if (aDirectory.getSearchIndexId() == 0) {
+		dcassert(0);
+		return;
+	}
+
+	directories.remove(aDirectory.getSearchIndexId());
+	aDirectory.setSearchIndexId(0);
+}
+
+void ShareSearchIndex::removeTree(ShareDirectory& aDirectory) noexcept {
+	for (const auto& d : aDirectory.getDirectories()) {
+		removeTree(*d);
+	}
+
+	for (const auto& f : aDirectory.getFiles()) {
+		removeFile(*f);
+	}
+
+	removeDirectory(aDirectory);
+}
+
+void ShareSearchIndex::addFile(ShareDirectory::File& aFile) noexcept {
+	dcassert(aFile.getSearchIndexId() == 0);
+	aFile.setSearchIndexId(files.add(&aFile, aFile.getName().getLower()));
+}
+
+void ShareSearchIndex::removeFile(ShareDirectory::File& aFile) noexcept {
+	if (aFile.getSearchIndexId() == 0) {
+		dcassert(0);
+		return;
+	}
+
+	files.remove(aFile.getSearchIndexId());
+	aFile.setSearchIndexId(0);
+}
+
+unique_ptr<ShareSearchCandidates> ShareSearchIndex::findCandidates(const SearchQuery& aSearch) const noexcept {
+	// All include patterns must be matched by the item name or by any of its parents
+	// Use the pattern with the least matches for picking the candidates
+	optional<pair<IdList, IdList>> best; // directories, files
+
+	vector<Trigram> trigrams;
+	for (const auto& pattern : aSearch.include.getPatterns()) {
+		if (pattern.size() < MIN_PATTERN_LENGTH) {
+			continue;
+		}
+
+		getTrigrams(pattern.str(), trigrams);
+
+		// Remove false positives
+		auto directoryIds = directories.find(trigrams);
+		std::erase_if(directoryIds, [&](ItemId aId) {
+			return pattern.matchLower(directories.getItem(aId)->getVirtualNameLower()) == string::npos;
+		});
+
+		auto fileIds = files.find(trigrams);
+		std::erase_if(fileIds, [&](ItemId aId) {
+			return pattern.matchLower(files.getItem(aId)->getName().getLower()) == string::npos;
+		});
+
+		if (!best || directoryIds.size() + fileIds.size() < best->first.size() + best->second.size()) {
+			best.emplace(std::move(directoryIds), std::move(fileIds));
+		}
+	}
+
+	if (!best) {
+		// Only short patterns
+		return nullptr;
+	}
+
+	auto& [directoryIds, fileIds] = *best;
+	if ((directoryIds.size() + fileIds.size()) * MAX_CANDIDATE_RATIO > getDirectoryCount() + getFileCount()) {
+		return nullptr;
+	}
+
+	auto ret = make_unique<ShareSearchCandidates>();
+	for (auto id : directoryIds) {
+		ret->addDirectory(directories.getItem(id));
+	}
+
+	for (auto id : fileIds) {
+		ret->addFile(files.getItem(id));
+	}
+
+	return ret;
+}
+
+} // namespace dcpp
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_SHARE_SEARCH_INDEX_H
+#define DCPLUSPLUS_DCPP_SHARE_SEARCH_INDEX_H
+
+#include <airdcpp/core/header/typedefs.h>
+
+#include <airdcpp/share/ShareDirectory.h>
+
+namespace dcpp {
+
+class SearchQuery;
+
+// Share items that may match a text search
+// Items that aren't listed here (or aren't located under a matching directory) can't match the search
+class ShareSearchCandidates {
+public:
+	enum class DirectoryMatch : uint8_t {
+		NONE, // Nothing to search
+		PARTIAL, // Contains candidates, use the filter for the subtree
+		FULL // The directory name matches, search the whole subtree
+	};
+
+	DirectoryMatch matchDirectory(const ShareDirectory* aDirectory) const noexcept;
+	bool hasFile(const ShareDirectory::File* aFile) const noexcept;
+
+	// Root directories may be subdirectories when searching inside a virtual path
+	DirectoryMatch matchRoot(const ShareDirectory* aDirectory) const noexcept;
+
+	void addDirectory(const ShareDirectory* aDirectory) noexcept;
+	void addFile(const ShareDirectory::File* aFile) noexcept;
+
+	size_t getFileCount() const noexcept {
+		return files.size();
+	}
+
+	size_t getDirectoryCount() const noexcept {
+		return matchingDirectories.size();
+	}
+private:
+	void addParents(const ShareDirectory* aDirectory) noexcept;
+
+	// Directories with matching names
+	unordered_set<const ShareDirectory*> matchingDirectories;
+
+	// Parents of all candidate items
+	unordered_set<const ShareDirectory*> parentDirectories;
+
+	unordered_set<const ShareDirectory::File*> files;
+};
+
+// Inverted trigram index of lowercase share item names
+// Posting lists contain compact item IDs that are allocated in increasing order so that
+// the lists stay sorted without extra work; removed items leave stale IDs behind until the index is compacted
+//
+// Not thread-safe, the caller must lock the share tree
+class ShareSearchIndex {
+public:
+	using ItemId = uint32_t;
+	using Trigram = uint32_t;
+	using IdList = vector<ItemId>;
+
+	// Patterns shorter than this can't be looked up from the index
+	static const size_t MIN_PATTERN_LENGTH = 3;
+
+	ShareSearchIndex() = default;
+
+	void addDirectory(ShareDirectory& aDirectory) noexcept;
+	void removeDirectory(ShareDirectory& aDirectory) noexcept;
+
+	// Removes the directory and all of its content
+	void removeTree(ShareDirectory& aDirectory) noexcept;
+
+	void addFile(ShareDirectory::File& aFile) noexcept;
+	void removeFile(ShareDirectory::File& aFile) noexcept;
+
+	// Returns nullptr if the index can't narrow down the search (the whole tree should be searched instead)
+	unique_ptr<ShareSearchCandidates> findCandidates(const SearchQuery& aSearch) const noexcept;
+
+	size_t getFileCount() const noexcept {
+		return files.getItemCount();
+	}
+
+	size_t getDirectoryCount() const noexcept {
+		return directories.getItemCount();
+	}
+
+	ShareSearchIndex(ShareSearchIndex&) = delete;
+	ShareSearchIndex& operator=(ShareSearchIndex&) = delete;
+private:
+	static void getTrigrams(const string& aNameLower, vector<Trigram>& trigrams_) noexcept;
+
+	template<class ItemT>
+	class NameIndex {
+	public:
+		NameIndex() : items(1, nullptr) {}
+
+		// Returns the ID of the added item
+		ItemId add(ItemT* aItem, const string& aNameLower) noexcept;
+		void remove(ItemId aId) noexcept;
+
+		// Returns IDs of items that contain all the provided trigrams (false positives are possible)
+		IdList find(const vector<Trigram>& aTrigrams) const noexcept;
+
+		ItemT* getItem(ItemId aId) const noexcept {
+			return items[aId];
+		}
+
+		size_t getItemCount() const noexcept {
+			return items.size() - 1 - removedCount;
+		}
+	private:
+		void compact() noexcept;
+
+		// Item ID 0 is reserved for non-indexed items
+		vector<ItemT*> items;
+		unordered_map<Trigram, IdList> postings;
+		size_t removedCount = 0;
+	};
+
+	NameIndex<ShareDirectory> directories;
+	NameIndex<ShareDirectory::File> files;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_SHARE_SEARCH_INDEX_H)
@@ -43,6 +43,7 @@ struct ShareSearchCounters {
 	uint64_t recursiveSearches = 0;
 	uint64_t recursiveSearchTime = 0;
 	uint64_t filteredSearches = 0;
+	uint64_t indexedSearches = 0;
 	uint64_t recursiveSearchesResponded = 0;
 	uint64_t searchTokenCount = 0;
 	uint64_t searchTokenLength = 0;
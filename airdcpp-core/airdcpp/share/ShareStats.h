@@ -26,7 +26,7 @@ namespace dcpp {
 struct ShareSearchStats {
 	uint64_t totalSearches = 0;
 	double totalSearchesPerSecond = 0;
-	uint64_t recursiveSearches = 0, filteredSearches = 0;
+	uint64_t recursiveSearches = 0, filteredSearches = 0, indexedSearches = 0;
 	uint64_t averageSearchMatchMs = 0;
 	uint64_t recursiveSearchesResponded = 0;
 
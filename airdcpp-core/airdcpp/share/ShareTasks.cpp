@@ -28,6 +28,8 @@
 
 #include <airdcpp/core/thread/concurrency.h>
 
+#include <thread>
+
 namespace dcpp {
 
 #ifdef ATOMIC_FLAG_INIT
@@ -76,7 +78,7 @@ bool ShareRefreshInfo::checkContent(const ShareDirectory::Ptr& aDirectory) noexc
 }
 
 
-void ShareRefreshInfo::applyRefreshChanges(ShareDirectory::MultiMap& lowerDirNameMap_, ShareDirectory::Map& rootPaths_, ShareDirectory::File::TTHMap& tthIndex_, int64_t& sharedBytes_, ProfileTokenSet* dirtyProfiles_) noexcept {
+void ShareRefreshInfo::applyRefreshChanges(ShareDirectory::MultiMap& lowerDirNameMap_, ShareDirectory::Map& rootPaths_, ShareDirectory::File::TTHMap& tthIndex_, int64_t& sharedBytes_, ShareSearchIndex& searchIndex_, ProfileTokenSet* dirtyProfiles_) noexcept {
 #ifdef _DEBUG
 	for (const auto& d : lowerDirNameMap | views::values) {
 		ShareDirectory::checkAddedDirNameDebug(d, lowerDirNameMap_);
@@ -90,6 +92,16 @@ void ShareRefreshInfo::applyRefreshChanges(ShareDirectory::MultiMap& lowerDirNam
 	lowerDirNameMap_.insert(lowerDirNameMap.begin(), lowerDirNameMap.end());
 	tthIndex_.insert(tthIndex.begin(), tthIndex.end());
 
+	// Index the new items for searching
+	for (const auto& d : lowerDirNameMap | views::values) {
+		searchIndex_.addDirectory(*d);
+	}
+
+	for (const auto& f : tthIndex | views::values) {
+		// Get rid of false constness...
+		searchIndex_.addFile(*const_cast<ShareDirectory::File*>(f));
+	}
+
 	// Add new roots
 	for (const auto& [p, rootDir] : rootPaths) {
 		//dcassert(rootPaths_.find(rp.first) == rootPaths_.end());
@@ -109,6 +121,20 @@ void ShareRefreshInfo::applyRefreshChanges(ShareDirectory::MultiMap& lowerDirNam
 	newDirectory = nullptr;
 }
 
+ShareRefreshSubtreeInfo::ShareRefreshSubtreeInfo(size_t aBloomSize) : ShareTreeMaps([this] { return &bloom; }), bloom(aBloomSize) {
+
+}
+
+void ShareRefreshSubtreeInfo::merge(ShareRefreshInfo& ri_) noexcept {
+	ri_.lowerDirNameMap.insert(lowerDirNameMap.begin(), lowerDirNameMap.end());
+	ri_.tthIndex.insert(tthIndex.begin(), tthIndex.end());
+	ri_.getBloom().merge(bloom);
+	ri_.stats.merge(stats);
+
+	lowerDirNameMap.clear();
+	tthIndex.clear();
+}
+
 bool ShareRefreshStats::isEmpty() const noexcept {
 	return newDirectoryCount == 0 && newFileCount == 0 && existingDirectoryCount == 0 && existingFileCount == 0;
 }
@@ -318,6 +344,25 @@ void ShareTasks::runTasks(const ProgressFunction& progressF /*nullptr*/) noexcep
 	}
 }
 
+bool ShareTasks::isMultithreaded(const ShareRefreshTask& aTask) noexcept {
+	return SETTING(REFRESH_THREADING) == SettingsManager::MULTITHREAD_ALWAYS || (SETTING(REFRESH_THREADING) == SettingsManager::MULTITHREAD_MANUAL && aTask.priority == ShareRefreshPriority::MANUAL);
+}
+
+size_t ShareTasks::getPathThreadCount(const ShareRefreshTask& aTask) noexcept {
+	if (!isMultithreaded(aTask)) {
+		return 1;
+	}
+
+	const size_t hardwareThreads = max(std::thread::hardware_concurrency(), 1U);
+	if (!PARALLEL_FOR_EACH_CONCURRENT) {
+		// The paths are refreshed one by one
+		return hardwareThreads;
+	}
+
+	const auto concurrentPaths = min(max(aTask.dirs.size(), static_cast<size_t>(1)), hardwareThreads);
+	return max(hardwareThreads / concurrentPaths, static_cast<size_t>(1));
+}
+
 Callback ShareTasks::runRefreshTask(const ShareRefreshTask& aTask, const ProgressFunction& progressF) noexcept {
 
 	refreshRunning = true;
@@ -349,7 +394,7 @@ Callback ShareTasks::runRefreshTask(const ShareRefreshTask& aTask, const Progres
 	};
 
 	try {
-		if (SETTING(REFRESH_THREADING) == SettingsManager::MULTITHREAD_ALWAYS || (SETTING(REFRESH_THREADING) == SettingsManager::MULTITHREAD_MANUAL && aTask.priority == ShareRefreshPriority::MANUAL)) {
+		if (isMultithreaded(aTask)) {
 			TaskScheduler s;
 			parallel_for_each(refreshPaths.begin(), refreshPaths.end(), doRefresh);
 		} else {
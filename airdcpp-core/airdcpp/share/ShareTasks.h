@@ -20,7 +20,6 @@
 #define DCPLUSPLUS_DCPP_SHARE_TASKS_H
 
 
-#include <airdcpp/core/timer/TimerManagerListener.h>
 
 #include <airdcpp/message/Message.h>
 #include <airdcpp/share/ShareDirectoryInfo.h>
@@ -42,6 +41,13 @@ public:
 
 	bool isRefreshing() const noexcept { return refreshRunning; }
 
+	// Whether the refresh task should be run with multiple threads (based on the user settings)
+	static bool isMultithreaded(const ShareRefreshTask& aTask) noexcept;
+
+	// Number of threads for building a single path of the task
+	// The hardware threads are split between the paths if they are refreshed concurrently
+	static size_t getPathThreadCount(const ShareRefreshTask& aTask) noexcept;
+
 	// Abort filelist refresh (or an individual refresh task)
 	RefreshPathList abortRefresh(optional<ShareRefreshTaskToken> aToken = nullopt) noexcept;
 
@@ -22,11 +22,14 @@
 #include <airdcpp/hub/ClientManager.h>
 #include <airdcpp/util/DupeUtil.h>
 #include <airdcpp/core/io/File.h>
+#include <airdcpp/core/io/compress/ParallelFilter.h>
 #include <airdcpp/core/io/stream/FilteredFile.h>
+#include <airdcpp/core/io/stream/Streams.h>
 #include <airdcpp/util/PathUtil.h>
 #include <airdcpp/core/localization/ResourceManager.h>
 #include <airdcpp/search/SearchResult.h>
 #include <airdcpp/search/SearchQuery.h>
+#include <airdcpp/share/BinaryShareCache.h>
 #include <airdcpp/share/SharePathValidator.h>
 #include <airdcpp/share/profiles/ShareProfile.h>
 #include <airdcpp/share/ShareRefreshInfo.h>
@@ -42,7 +45,7 @@ using ranges::find_if;
 using ranges::copy;
 
 
-ShareTree::ShareTree() : bloom(make_unique<ShareBloom>(1 << 20)), ShareTreeMaps([this] { return bloom.get(); })
+ShareTree::ShareTree() : ShareTreeMaps([this] { return bloom.get(); }, &searchIndex), bloom(make_unique<ShareBloom>(1 << 20))
 {
 #if defined(_DEBUG) && defined(_WIN32)
 	testDualString();
@@ -62,6 +65,18 @@ bool ShareTree::isFileShared(const TTHValue& aTTH) const noexcept {
 	return tthIndex.contains(const_cast<TTHValue*>(&aTTH));
 }
 
+vector<bool> ShareTree::isFileShared(std::span<const TTHValue> aTTHs) const noexcept {
+	vector<bool> ret;
+	ret.reserve(aTTHs.size());
+
+	RLock l(cs);
+	for (const auto& tth: aTTHs) {
+		ret.push_back(tthIndex.contains(const_cast<TTHValue*>(&tth)));
+	}
+
+	return ret;
+}
+
 bool ShareTree::toRealWithSize(const UploadFileQuery& aQuery, string& path_, int64_t& size_, bool& noAccess_) const noexcept {
 	if (aQuery.profiles && ranges::all_of(*aQuery.profiles, [](ProfileToken s) { return s == SP_HIDDEN; })) {
 		return false;
@@ -175,6 +190,13 @@ void ShareTree::countStats(time_t& totalAge_, size_t& totalDirs_, int64_t& total
 	}
 }
 
+void ShareTree::clearStableLastWrite() noexcept {
+	WLock l(cs);
+	for (const auto& d : rootPaths | views::values) {
+		d->clearStableLastWriteRecursive();
+	}
+}
+
 void ShareTree::getRootsUnsafe(const OptionalProfileToken& aProfile, ShareDirectory::List& dirs_) const noexcept {
 	ranges::copy(rootPaths | views::values | views::filter(ShareDirectory::HasRootProfile(aProfile)), back_inserter(dirs_));
 }
@@ -414,10 +436,12 @@ ShareRoot::Ptr ShareTree::removeShareRoot(const string& aPath) noexcept {
 		rootPaths.erase(k);
 
 		// Remove the root
+		searchIndex.removeTree(*directory);
 		ShareDirectory::cleanIndices(*directory, sharedSize, tthIndex, lowerDirNameMap);
 	}
 
 	File::deleteFile(directory->getRoot()->getCacheXmlPath());
+	File::deleteFile(directory->getRoot()->getCacheBinaryPath());
 
 #ifdef _DEBUG
 	validateDirectoryTreeDebug();
@@ -449,8 +473,12 @@ ShareRoot::Ptr ShareTree::updateShareRoot(const ShareDirectoryInfoPtr& aDirector
 		rootDirectory = directory->getRoot();
 
 		ShareDirectory::removeDirName(*directory, lowerDirNameMap);
+		searchIndex.removeDirectory(*directory);
+
 		rootDirectory->setName(vName);
+
 		ShareDirectory::addDirName(directory, lowerDirNameMap, *bloom.get());
+		searchIndex.addDirectory(*directory);
 	}
 
 	rootDirectory->setIncoming(aDirectoryInfo->incoming);
@@ -477,7 +505,13 @@ bool ShareTree::applyRefreshChanges(ShareRefreshInfo& ri, ProfileTokenSet* aDirt
 
 		parent = ri.optionalOldDirectory->getParent();
 
+		// The content is modified even if nothing gets added in place of the old directory
+		if (aDirtyProfiles) {
+			ri.optionalOldDirectory->copyRootProfiles(*aDirtyProfiles, true);
+		}
+
 		// Remove the old directory
+		searchIndex.removeTree(*ri.optionalOldDirectory);
 		ShareDirectory::cleanIndices(*ri.optionalOldDirectory, sharedSize, tthIndex, lowerDirNameMap);
 	}
 
@@ -505,7 +539,7 @@ bool ShareTree::applyRefreshChanges(ShareRefreshInfo& ri, ProfileTokenSet* aDirt
 		}
 	}
 
-	ri.applyRefreshChanges(lowerDirNameMap, rootPaths, tthIndex, sharedSize, aDirtyProfiles);
+	ri.applyRefreshChanges(lowerDirNameMap, rootPaths, tthIndex, sharedSize, searchIndex, aDirtyProfiles);
 	dcdebug("Share changes applied for the directory %s\n", ri.path.c_str());
 	return true;
 }
@@ -568,29 +602,9 @@ void ShareTree::setBloom(ShareBloom* aBloom) noexcept {
 	bloom.reset(aBloom);
 }
 
-#define LITERAL(n) n, sizeof(n)-1
-void ShareTree::toCache(OutputStream& os_, const ShareDirectory::Ptr& aDirectory) const {
-	string indent, tmp;
-
-	os_.write(SimpleXML::utf8Header);
-	os_.write(LITERAL("<Share Version=\"" SHARE_CACHE_VERSION));
-	os_.write(LITERAL("\" Path=\""));
-	os_.write(SimpleXML::escape(aDirectory->getRoot()->getPath(), tmp, true));
-
-	os_.write(LITERAL("\" Date=\""));
-	os_.write(SimpleXML::escape(Util::toString(aDirectory->getLastWrite()), tmp, true));
-	os_.write(LITERAL("\">\r\n"));
-	indent += '\t';
-
-	{
-		RLock l(cs);
-		for (const auto& child : aDirectory->getDirectories()) {
-			child->toCacheXmlList(os_, indent, tmp);
-		}
-		aDirectory->filesToCacheXmlList(os_, indent, tmp);
-	}
-
-	os_.write(LITERAL("</Share>"));
+void ShareTree::toBinaryCache(OutputStream& os_, const ShareDirectory::Ptr& aDirectory) const {
+	RLock l(cs);
+	BinaryShareCache::write(os_, *aDirectory);
 }
 
 void ShareTree::toFilelist(OutputStream& os_, const string& aVirtualPath, const OptionalProfileToken& aProfile, bool aRecursive, const FilelistDirectory::DuplicateFileHandler& aDuplicateFileHandler) const {
@@ -637,6 +651,107 @@ void ShareTree::toFilelist(OutputStream& os_, const string& aVirtualPath, const
 	os_.write("</FileListing>");
 }
 
+static BZStreamJoiner::Stream compressFilelistFragment(const string& aXml) {
+	string bz;
+	{
+		StringOutputStream sos(bz);
+		FilteredOutputStream<ParallelBZFilter, false> bzipper(&sos);
+		bzipper.write(aXml);
+		bzipper.flushBuffers(false);
+	}
+
+	return BZStreamJoiner::Stream(std::move(bz));
+}
+
+int64_t ShareTree::toCompressedFilelist(OutputStream& os_, FileList& fileList_, const FilelistDirectory::DuplicateFileHandler& aDuplicateFileHandler) const {
+	struct ListDirectory {
+		string name;
+		vector<uint64_t> rootRevisions;
+		shared_ptr<const FileList::Fragment> fragment;
+		string xml;
+	};
+
+	vector<ListDirectory> listDirectories;
+	time_t baseDate = 0;
+
+	{
+		ShareDirectory::List roots;
+
+		RLock l(cs);
+		getRootsUnsafe(fileList_.getProfile(), roots);
+
+		// Roots with the same virtual name are merged in the list
+		map<string, ShareDirectory::List> rootsByName;
+		for (const auto& root : roots) {
+			rootsByName[root->getVirtualNameLower()].push_back(root);
+			baseDate = max(baseDate, root->getLastWrite());
+		}
+
+		for (const auto& [name, directories] : rootsByName) {
+			ListDirectory listDirectory { name };
+			for (const auto& d : directories) {
+				listDirectory.rootRevisions.push_back(d->getRoot()->getRevision());
+			}
+
+			ranges::sort(listDirectory.rootRevisions);
+
+			if (auto i = fileList_.fragments.find(name); i != fileList_.fragments.end() && i->second->rootRevisions == listDirectory.rootRevisions) {
+				listDirectory.fragment = i->second;
+			} else {
+				// Compression is done after releasing the lock
+				StringOutputStream xml(listDirectory.xml);
+				string tmp, indent = "\t";
+
+				auto listRoot = FilelistDirectory::generateRoot(ShareDirectory::List(), directories, true);
+				for (const auto& ld : listRoot->getListDirectories() | views::values) {
+					ld->toXml(xml, indent, tmp, true, aDuplicateFileHandler);
+				}
+			}
+
+			listDirectories.push_back(std::move(listDirectory));
+		}
+	}
+
+	BZStreamJoiner joiner(os_);
+	int64_t xmlLength = 0;
+
+	{
+		auto header = SimpleXML::utf8Header;
+		header += R"(<FileListing Version="1" CID=")" + ClientManager::getInstance()->getMyCID().toBase32() +
+			"\" Base=\"" + ADC_ROOT_STR +
+			"\" BaseDate=\"" + Util::toString(baseDate) +
+			"\" Generator=\"" + shortVersionString + "\">\r\n";
+
+		joiner.append(compressFilelistFragment(header));
+		xmlLength += header.size();
+	}
+
+	FileList::FragmentMap fragments;
+	for (auto& ld : listDirectories) {
+		if (!ld.fragment) {
+			auto stream = compressFilelistFragment(ld.xml);
+			ld.fragment = make_shared<FileList::Fragment>(std::move(ld.rootRevisions), std::move(stream), static_cast<int64_t>(ld.xml.size()));
+			string().swap(ld.xml);
+		}
+
+		joiner.append(ld.fragment->stream);
+		xmlLength += ld.fragment->xmlLength;
+		fragments.emplace(ld.name, ld.fragment);
+	}
+
+	{
+		string footer = "</FileListing>";
+		joiner.append(compressFilelistFragment(footer));
+		xmlLength += footer.size();
+	}
+
+	joiner.finish();
+
+	// Directories that are no longer listed get dropped
+	fileList_.fragments.swap(fragments);
+	return xmlLength;
+}
+
 void ShareTree::toTTHList(OutputStream& os_, const string& aVirtualPath, bool aRecursive, ProfileToken aProfile) const noexcept {
 	ShareDirectory::List directories;
 	string tmp;
@@ -744,9 +859,23 @@ void ShareTree::searchText(SearchResultList& results_, ShareSearch& aSearchInfo,
 			getDirectoriesByVirtualUnsafe<OptionalProfileToken>(aSearchInfo.virtualPath, aSearchInfo.profile, roots);
 		}
 
+		// Narrow down the directories and files to match
+		auto candidates = searchIndex.findCandidates(srch);
+		if (candidates) {
+			counters_.indexedSearches++;
+		}
+
 		// go them through recursively
 		for (const auto& d: roots) {
-			d->search(resultInfos, srch, 0);
+			if (!candidates) {
+				d->search(resultInfos, srch, 0);
+				continue;
+			}
+
+			auto match = candidates->matchRoot(d.get());
+			if (match != ShareSearchCandidates::DirectoryMatch::NONE) {
+				d->search(resultInfos, srch, 0, match == ShareSearchCandidates::DirectoryMatch::FULL ? nullptr : candidates.get());
+			}
 		}
 
 		endF();
@@ -795,6 +924,7 @@ ShareSearchStats ShareSearchCounters::toStats() const noexcept {
 	stats.recursiveSearches = recursiveSearches;
 	stats.recursiveSearchesResponded = recursiveSearchesResponded;
 	stats.filteredSearches = filteredSearches;
+	stats.indexedSearches = indexedSearches;
 	stats.unfilteredRecursiveSearchesPerSecond = static_cast<double>(recursiveSearches - filteredSearches) / upseconds;
 
 	stats.averageSearchMatchMs = static_cast<uint64_t>(Util::countAverage(recursiveSearchTime, recursiveSearches - filteredSearches));
@@ -915,6 +1045,41 @@ void ShareTree::addHashedFile(const string& aRealPath, const HashedFile& aFileIn
 	d->addFile(PathUtil::getFileName(aRealPath), aFileInfo, *this, sharedSize, dirtyProfiles);
 }
 
+bool ShareTree::removeFile(const string& aRealPath, ProfileTokenSet* dirtyProfiles) noexcept {
+	WLock l(cs);
+	auto d = findDirectoryUnsafe(PathUtil::getFilePath(aRealPath));
+	if (!d) {
+		return false;
+	}
+
+	return d->removeFile(Text::toLower(PathUtil::getFileName(aRealPath)), *this, sharedSize, dirtyProfiles);
+}
+
+bool ShareTree::removeDirectory(const string& aRealPath, ProfileTokenSet* dirtyProfiles) noexcept {
+	ShareDirectory::Ptr directory = nullptr;
+
+	{
+		WLock l(cs);
+		directory = findDirectoryUnsafe(aRealPath);
+		if (!directory || directory->isRoot()) {
+			return false;
+		}
+
+		if (dirtyProfiles) {
+			directory->copyRootProfiles(*dirtyProfiles, true);
+		}
+
+		searchIndex.removeTree(*directory);
+		ShareDirectory::cleanIndices(*directory, sharedSize, tthIndex, lowerDirNameMap);
+	}
+
+#ifdef _DEBUG
+	validateDirectoryTreeDebug();
+#endif
+
+	return true;
+}
+
 
 // DEBUG CODE
 #ifdef _DEBUG
@@ -27,6 +27,7 @@
 #include <airdcpp/hash/value/MerkleTree.h>
 #include <airdcpp/share/ShareDirectory.h>
 #include <airdcpp/share/ShareDirectoryInfo.h>
+#include <airdcpp/share/ShareSearchIndex.h>
 #include <airdcpp/share/ShareStats.h>
 #include <airdcpp/core/classes/SortedVector.h>
 #include <airdcpp/share/UploadFileProvider.h>
@@ -34,6 +35,7 @@
 
 namespace dcpp {
 
+class FileList;
 class OutputStream;
 class MemoryInputStream;
 class SearchQuery;
@@ -55,10 +57,21 @@ public:
 	bool isFileShared(const TTHValue& aTTH) const noexcept;
 	bool isFileShared(const TTHValue& aTTH, ProfileToken aProfile) const noexcept;
 
+	// Checks multiple files with a single lock
+	vector<bool> isFileShared(std::span<const TTHValue> aTTHs) const noexcept;
+
 	void toTTHList(OutputStream& os_, const string& aVirtualPath, bool aRecursive, ProfileToken aProfile) const noexcept;
 
 	void toFilelist(OutputStream& os_, const string& aVirtualPath, const OptionalProfileToken& aProfile, bool aRecursive, const FilelistDirectory::DuplicateFileHandler& aDuplicateFileHandler) const;
-	void toCache(OutputStream& os_, const ShareDirectory::Ptr& aDirectory) const;
+
+	// Writes a bzip2-compressed full filelist of the profile
+	// Top-level directories are compressed separately and cached in the list so that only directories with changed roots need to be regenerated
+	// Returns the size of the uncompressed XML
+	// Throws Exception
+	int64_t toCompressedFilelist(OutputStream& os_, FileList& fileList_, const FilelistDirectory::DuplicateFileHandler& aDuplicateFileHandler) const;
+
+	// Throws FileException
+	void toBinaryCache(OutputStream& os_, const ShareDirectory::Ptr& aDirectory) const;
 
 	// Throws ShareException
 	AdcCommand getFileInfo(const TTHValue& aTTH) const;
@@ -144,6 +157,11 @@ public:
 
 	void addHashedFile(const string& aRealPath, const HashedFile& aFileInfo, ProfileTokenSet* dirtyProfiles) noexcept;
 
+	// Remove a single item from the tree (roots can't be removed)
+	// Returns false if the item isn't shared
+	bool removeFile(const string& aRealPath, ProfileTokenSet* dirtyProfiles) noexcept;
+	bool removeDirectory(const string& aRealPath, ProfileTokenSet* dirtyProfiles) noexcept;
+
 	ShareBloom* getBloom() const noexcept {
 		return bloom.get();
 	}
@@ -162,6 +180,9 @@ public:
 
 	ShareDirectory::Map getRootPaths() const noexcept;
 
+	// Make all directories to be rescanned on the next refresh even if they haven't been modified
+	void clearStableLastWrite() noexcept;
+
 	const ShareDirectory::Map& getRootPathsUnsafe() const noexcept {
 		return rootPaths;
 	}
@@ -181,6 +202,9 @@ private:
 
 	unique_ptr<ShareBloom> bloom;
 
+	// Name index for text searches
+	ShareSearchIndex searchIndex;
+
 	ShareDirectoryInfoPtr getRootInfoUnsafe(const ShareDirectory::Ptr& aDir) const noexcept;
 
 	bool addDirectoryResultUnsafe(const ShareDirectory* aDir, SearchResultList& aResults, const OptionalProfileToken& aProfile, const SearchQuery& srch) const noexcept;
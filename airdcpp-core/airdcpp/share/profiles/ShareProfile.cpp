@@ -22,6 +22,7 @@
 #include <airdcpp/core/io/compress/BZUtils.h>
 #include <airdcpp/core/io/stream/FilteredFile.h>
 #include <airdcpp/core/localization/ResourceManager.h>
+#include <airdcpp/hash/value/MerkleTree.h>
 #include <airdcpp/settings/SettingsManager.h>
 #include <airdcpp/share/profiles/ShareProfile.h>
 #include <airdcpp/core/timer/TimerManager.h>
@@ -52,6 +53,41 @@ void FileList::generationFinished(bool aFailed) noexcept {
 		listN--;
 }
 
+TTHValue FileList::getXmlRoot() noexcept {
+	Lock l(cs);
+	if (!xmlRoot) {
+		try {
+			File f(getFileName(), File::READ, File::OPEN, File::BUFFER_SEQUENTIAL, false);
+			FilteredInputStream<UnBZFilter, false> xml(&f);
+			TTFilter<1024 * 1024 * 1024> tree;
+
+			ByteVector buf(1024 * 1024);
+			for (;;) {
+				size_t len = buf.size();
+				auto n = xml.read(&buf[0], len);
+				if (n == 0) {
+					break;
+				}
+
+				tree(&buf[0], n);
+			}
+
+			tree.getTree().finalize();
+			xmlRoot = tree.getTree().getRoot();
+		} catch (const Exception& e) {
+			dcdebug("FileList: failed to calculate the XML root for %s (%s)\n", getFileName().c_str(), e.getError().c_str());
+			return TTHValue();
+		}
+	}
+
+	return *xmlRoot;
+}
+
+void FileList::setXmlRoot(const optional<TTHValue>& aRoot) noexcept {
+	Lock l(cs);
+	xmlRoot = aRoot;
+}
+
 void FileList::saveList() {
 	bzXmlRef.reset(new File(getFileName(), File::READ, File::OPEN, File::BUFFER_SEQUENTIAL, false));
 	bzXmlListLen = File::getSize(getFileName());
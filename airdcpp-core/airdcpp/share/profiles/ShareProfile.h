@@ -23,6 +23,7 @@
 #include <airdcpp/forward.h>
 
 #include <airdcpp/core/io/File.h>
+#include <airdcpp/core/io/compress/BZStreamJoiner.h>
 #include <airdcpp/core/types/GetSet.h>
 #include <airdcpp/hash/value/HashValue.h>
 #include <airdcpp/hash/value/TigerHash.h>
@@ -41,7 +42,6 @@ class FileList {
 	public:
 		FileList(ProfileToken aProfile);
 
-		GETSET(TTHValue, xmlRoot, XmlRoot);
 		GETSET(TTHValue, bzXmlRoot, BzXmlRoot);
 		GETSET(ProfileToken, profile, Profile);
 
@@ -54,6 +54,25 @@ class FileList {
 		unique_ptr<File> bzXmlRef;
 		string getFileName() const noexcept;
 
+		// Calculated from the compressed list when needed for the first time (the uncompressed list is rarely requested)
+		TTHValue getXmlRoot() noexcept;
+		void setXmlRoot(const optional<TTHValue>& aRoot) noexcept;
+
+		// Compressed content of a top-level directory that can be reused when generating a new list
+		struct Fragment {
+			Fragment(vector<uint64_t>&& aRootRevisions, BZStreamJoiner::Stream&& aStream, int64_t aXmlLength) :
+				rootRevisions(std::move(aRootRevisions)), stream(std::move(aStream)), xmlLength(aXmlLength) { }
+
+			// Revisions of the share roots that the directory was generated from
+			const vector<uint64_t> rootRevisions;
+			const BZStreamJoiner::Stream stream;
+			const int64_t xmlLength;
+		};
+
+		// Fragments by lowercase virtual directory name
+		using FragmentMap = unordered_map<string, shared_ptr<const Fragment>>;
+		FragmentMap fragments;
+
 		bool allowGenerateNew(bool aForce = false) noexcept;
 		void generationFinished(bool aFailed) noexcept;
 		void saveList();
@@ -61,6 +80,7 @@ class FileList {
 		int getCurrentNumber() const noexcept { return listN; }
 	private:
 		int listN = 0;
+		optional<TTHValue> xmlRoot;
 };
 
 class ShareProfileInfo;
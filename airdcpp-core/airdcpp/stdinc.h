@@ -70,6 +70,7 @@
 #include <memory>
 #include <ranges>
 #include <set>
+#include <span>
 #include <string>
 #include <numeric>
 #include <limits>
@@ -35,11 +35,12 @@ namespace dcpp {
 static const string DOWNLOAD_AREA = "Downloads";
 
 DownloadManager::DownloadManager() {
-	TimerManager::getInstance()->addListener(this);
+	auto tm = TimerManager::getInstance();
+	tickTask = tm->addTask("Download tick", 1000, [this](uint64_t aTick) { onTimerTick(aTick); }, tm->getBackgroundExecutor());
 }
 
 DownloadManager::~DownloadManager() {
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(tickTask);
 	while(true) {
 		{
 			WLock l(cs);
@@ -83,7 +84,7 @@ bool DownloadManager::disconnectSlowSpeed(Download* d, uint64_t aTick) const noe
 }
 
 using UserSpeedMap = unordered_map<UserPtr, int64_t, User::Hash>;
-void DownloadManager::on(TimerManagerListener::Second, uint64_t aTick) noexcept {
+void DownloadManager::onTimerTick(uint64_t aTick) noexcept {
 	vector<DropInfo> dropTargets;
 	BundleList bundleTicks;
 	UserSpeedMap userSpeedMap;
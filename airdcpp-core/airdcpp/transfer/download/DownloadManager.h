@@ -23,7 +23,6 @@
 
 #include <airdcpp/transfer/download/DownloadManagerListener.h>
 #include <airdcpp/connection/UserConnectionListener.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 #include <airdcpp/core/Singleton.h>
 #include <airdcpp/core/Speaker.h>
 
@@ -40,7 +39,7 @@ namespace dcpp {
  * in the user interface.
  */
 class DownloadManager : public Speaker<DownloadManagerListener>, 
-	private UserConnectionListener, private TimerManagerListener, 
+	private UserConnectionListener, 
 	public Singleton<DownloadManager>
 {
 public:
@@ -115,8 +114,9 @@ private:
 	void on(AdcCommand::SND, UserConnection*, const AdcCommand&) noexcept override;
 	void on(AdcCommand::STA, UserConnection*, const AdcCommand&) noexcept override;
 
-	// TimerManagerListener
-	void on(TimerManagerListener::Second, uint64_t aTick) noexcept override;
+	// Timer tasks (run in the background thread of the timer)
+	TimerTaskId tickTask = 0;
+	void onTimerTick(uint64_t aTick) noexcept;
 
 	// Statistics
 	uint64_t lastUpdate = 0;
@@ -23,6 +23,7 @@
 #include <airdcpp/core/localization/ResourceManager.h>
 #include <airdcpp/core/io/stream/StreamBase.h>
 #include <airdcpp/connection/UserConnection.h>
+#include <airdcpp/core/io/compress/ParallelFilter.h>
 #include <airdcpp/core/io/compress/ZUtils.h>
 
 namespace dcpp {
@@ -39,7 +40,13 @@ InputStream* Upload::getStream() {
 }
 
 void Upload::setFiltered() {
-	stream.reset(new FilteredInputStream<ZFilter, true>(stream.release()));
+	if (getType() == TYPE_PARTIAL_LIST) {
+		// Partial lists of large directories are generated in memory, compress them with all cores
+		stream.reset(new FilteredInputStream<ParallelZFilter, true>(stream.release()));
+	} else {
+		stream.reset(new FilteredInputStream<ZFilter, true>(stream.release()));
+	}
+
 	setFlag(Upload::FLAG_ZUPLOAD);
 }
 
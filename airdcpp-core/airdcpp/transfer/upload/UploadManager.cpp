@@ -39,7 +39,8 @@ namespace dcpp {
 using ranges::find_if;
 
 UploadManager::UploadManager() noexcept : queue(make_unique<UploadQueueManager>([this] { return getFreeSlots(); })) {
-	TimerManager::getInstance()->addListener(this);
+	tickTask = TimerManager::getInstance()->addTask("Upload tick", 1000, [this](uint64_t aTick) { onTimerTick(aTick); });
+	maintenanceTask = TimerManager::getInstance()->addTask("Upload maintenance", 60 * 1000, [this](uint64_t aTick) { onTimerMaintenance(aTick); });
 
 
 	SettingsManager::getInstance()->registerChangeHandler({
@@ -50,7 +51,8 @@ UploadManager::UploadManager() noexcept : queue(make_unique<UploadQueueManager>(
 }
 
 UploadManager::~UploadManager() {
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(tickTask);
+	TimerManager::getInstance()->removeTask(maintenanceTask);
 
 	while (true) {
 		{
@@ -852,8 +854,8 @@ void UploadManager::checkExpiredDelayUploads() {
 	}
 }
 
-// TimerManagerListener
-void UploadManager::on(TimerManagerListener::Second, uint64_t /*aTick*/) noexcept {
+// Timer tasks
+void UploadManager::onTimerTick(uint64_t /*aTick*/) noexcept {
 	checkExpiredDelayUploads();
 
 	UploadList ticks;
@@ -872,7 +874,7 @@ void UploadManager::on(TimerManagerListener::Second, uint64_t /*aTick*/) noexcep
 	}
 }
 
-void UploadManager::on(TimerManagerListener::Minute, uint64_t) noexcept {
+void UploadManager::onTimerMaintenance(uint64_t /*aTick*/) noexcept {
 	disconnectOfflineUsers();
 }
 
@@ -28,7 +28,6 @@
 #include <airdcpp/core/Singleton.h>
 #include <airdcpp/core/Speaker.h>
 #include <airdcpp/util/text/StringMatch.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 #include <airdcpp/transfer/upload/UploadManagerListener.h>
 #include <airdcpp/transfer/TransferSlot.h>
 #include <airdcpp/connection/UserConnectionListener.h>
@@ -40,7 +39,7 @@ class UploadParser;
 struct UploadRequest;
 struct ParsedUpload;
 
-class UploadManager : private UserConnectionListener, public Speaker<UploadManagerListener>, private TimerManagerListener, public Singleton<UploadManager>
+class UploadManager : private UserConnectionListener, public Speaker<UploadManagerListener>, public Singleton<UploadManager>
 {
 public:
 	ActionHook<OptionalTransferSlot, const UserConnection&, const ParsedUpload&> slotTypeHook;
@@ -133,9 +132,12 @@ private:
 	
 	void startTransfer(Upload* aUpload) noexcept;
 	
-	// TimerManagerListener
-	void on(TimerManagerListener::Second, uint64_t aTick) noexcept override;
-	void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
+	// Timer tasks (run in the timer thread)
+	TimerTaskId tickTask = 0;
+	TimerTaskId maintenanceTask = 0;
+
+	void onTimerTick(uint64_t aTick) noexcept;
+	void onTimerMaintenance(uint64_t aTick) noexcept;
 
 	// UserConnectionListener
 	void on(BytesSent, UserConnection*, size_t, size_t) noexcept override;
@@ -39,11 +39,13 @@ using ranges::find_if;
 
 UploadQueueManager::UploadQueueManager(FreeSlotF&& aFreeSlotF) noexcept : freeSlotF(std::move(aFreeSlotF)) {
 	ClientManager::getInstance()->addListener(this);
-	TimerManager::getInstance()->addListener(this);
+	tickTask = TimerManager::getInstance()->addTask("Upload queue tick", 1000, [this](uint64_t aTick) { onTimerTick(aTick); });
+	maintenanceTask = TimerManager::getInstance()->addTask("Upload queue maintenance", 60 * 1000, [this](uint64_t aTick) { onTimerMaintenance(aTick); });
 }
 
 UploadQueueManager::~UploadQueueManager() {
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(tickTask);
+	TimerManager::getInstance()->removeTask(maintenanceTask);
 	ClientManager::getInstance()->removeListener(this);
 	{
 		WLock l(cs);
@@ -166,7 +168,7 @@ void UploadQueueManager::notifyQueuedUsers(uint8_t aFreeSlots) noexcept {
 		connectUser(wu.user, wu.token);
 }
 
-void UploadQueueManager::on(TimerManagerListener::Minute, uint64_t aTick) noexcept {
+void UploadQueueManager::onTimerMaintenance(uint64_t aTick) noexcept {
 	WLock l(cs);
 	for (auto i = notifiedUsers.begin(); i != notifiedUsers.end();) {
 		if ((i->second + (90 * 1000)) < aTick) {
@@ -186,7 +188,7 @@ UploadQueueManager::SlotQueue UploadQueueManager::getUploadQueue() const noexcep
 	return uploadQueue; 
 }
 
-void UploadQueueManager::on(TimerManagerListener::Second, uint64_t /*aTick*/) noexcept {
+void UploadQueueManager::onTimerTick(uint64_t /*aTick*/) noexcept {
 	notifyQueuedUsers(freeSlotF());
 	fire(UploadQueueManagerListener::QueueUpdate());
 }
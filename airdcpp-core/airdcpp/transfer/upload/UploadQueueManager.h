@@ -25,7 +25,6 @@
 #include <airdcpp/hub/UserConnectResult.h>
 #include <airdcpp/core/thread/CriticalSection.h>
 #include <airdcpp/core/Speaker.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 #include <airdcpp/transfer/upload/UploadQueueManagerListener.h>
 #include <airdcpp/user/UserInfoBase.h>
 
@@ -40,7 +39,7 @@ struct WaitingUser {
 	string					token;
 };
 
-class UploadQueueManager : private ClientManagerListener, public Speaker<UploadQueueManagerListener>, private TimerManagerListener
+class UploadQueueManager : private ClientManagerListener, public Speaker<UploadQueueManagerListener>
 {
 public:
 	void clearUserFiles(const UserPtr& aUser) noexcept {
@@ -80,9 +79,12 @@ private:
 	// ClientManagerListener
 	void on(ClientManagerListener::UserDisconnected, const UserPtr& aUser, bool aWentOffline) noexcept override;
 	
-	// TimerManagerListener
-	void on(TimerManagerListener::Second, uint64_t aTick) noexcept override;
-	void on(TimerManagerListener::Minute, uint64_t aTick) noexcept override;
+	// Timer tasks (run in the timer thread)
+	TimerTaskId tickTask = 0;
+	TimerTaskId maintenanceTask = 0;
+
+	void onTimerTick(uint64_t aTick) noexcept;
+	void onTimerMaintenance(uint64_t aTick) noexcept;
 
 	FreeSlotF freeSlotF;
 };
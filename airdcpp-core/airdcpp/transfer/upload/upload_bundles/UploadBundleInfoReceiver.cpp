@@ -53,13 +53,13 @@ string UploadBundleInfoReceiver::formatDebugBundle(const UploadBundlePtr& u) noe
 }
 
 UploadBundleInfoReceiver::UploadBundleInfoReceiver() noexcept {
-	TimerManager::getInstance()->addListener(this);
+	tickTask = TimerManager::getInstance()->addTask("Upload bundle tick", 1000, [this](uint64_t aTick) { onTimerTick(aTick); });
 	UploadManager::getInstance()->addListener(this);
 	ProtocolCommandManager::getInstance()->addListener(this);
 }
 
 UploadBundleInfoReceiver::~UploadBundleInfoReceiver() {
-	TimerManager::getInstance()->removeListener(this);
+	TimerManager::getInstance()->removeTask(tickTask);
 	UploadManager::getInstance()->removeListener(this);
 	ProtocolCommandManager::getInstance()->removeListener(this);
 }
@@ -406,8 +406,8 @@ UploadBundlePtr UploadBundleInfoReceiver::findByBundleToken(const string& aBundl
 	return nullptr;
 }
 
-// TimerManagerListener
-void UploadBundleInfoReceiver::on(TimerManagerListener::Second, uint64_t /*aTick*/) noexcept {
+// Timer tasks
+void UploadBundleInfoReceiver::onTimerTick(uint64_t /*aTick*/) noexcept {
 	vector<pair<UploadBundlePtr, UploadBundle::BundleUploadList>> bundleUploads;
 
 	{
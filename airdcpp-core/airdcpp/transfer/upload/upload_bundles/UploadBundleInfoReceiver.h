@@ -27,14 +27,13 @@
 #include <airdcpp/user/HintedUser.h>
 #include <airdcpp/message/Message.h>
 #include <airdcpp/core/Speaker.h>
-#include <airdcpp/core/timer/TimerManagerListener.h>
 #include <airdcpp/transfer/upload/upload_bundles/UploadBundle.h>
 #include <airdcpp/transfer/upload/upload_bundles/UploadBundleInfoReceiverListener.h>
 #include <airdcpp/transfer/upload/UploadManagerListener.h>
 
 namespace dcpp {
 
-class UploadBundleInfoReceiver : public Speaker<UploadBundleInfoReceiverListener>, private TimerManagerListener, private UploadManagerListener, private ProtocolCommandManagerListener
+class UploadBundleInfoReceiver : public Speaker<UploadBundleInfoReceiverListener>, private UploadManagerListener, private ProtocolCommandManagerListener
 {
 public:
 	void onUBD(const AdcCommand& cmd);
@@ -73,9 +72,11 @@ private:
 	using UploadCallback = std::function<void (Upload *)> &&;
 	bool callAsync(const string& aToken, UploadCallback&& aCallback) const noexcept;
 
-	// Listeners
-	void on(TimerManagerListener::Second, uint64_t aTick) noexcept override;
+	// Timer tasks (run in the timer thread)
+	TimerTaskId tickTask = 0;
+	void onTimerTick(uint64_t aTick) noexcept;
 
+	// Listeners
 	void on(UploadManagerListener::Created, Upload*, const TransferSlot&) noexcept override;
 	void on(UploadManagerListener::Removed, const Upload*) noexcept override;
 
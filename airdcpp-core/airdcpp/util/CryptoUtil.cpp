@@ -139,7 +139,7 @@ void CryptoUtil::testSUDP() {
 	auto encrypted = encryptSUDP(keyChar, data);
 
 	string result;
-	auto success = decryptSUDP(keyChar, ByteVector(begin(encrypted), end(encrypted)), encrypted.length(), result);
+	auto success = decryptSUDP(keyChar, reinterpret_cast<const uint8_t*>(encrypted.data()), encrypted.length(), result);
 	dcassert(success);
 	dcassert(compare(data, result) == 0);
 }
@@ -180,8 +180,8 @@ string CryptoUtil::encryptSUDP(const uint8_t* aKey, const string& aCmd) {
 	return inData;
 }
 
-bool CryptoUtil::decryptSUDP(const uint8_t* aKey, const ByteVector& aData, size_t aDataLen, string& result_) {
-	boost::scoped_array<uint8_t> out(new uint8_t[aData.size()]);
+bool CryptoUtil::decryptSUDP(const uint8_t* aKey, const uint8_t* aData, size_t aDataLen, string& result_) {
+	boost::scoped_array<uint8_t> out(new uint8_t[aDataLen]);
 
 	uint8_t ivd[16] = { };
 
@@ -191,7 +191,7 @@ bool CryptoUtil::decryptSUDP(const uint8_t* aKey, const ByteVector& aData, size_
 	int len;
 	CHECK(EVP_CipherInit_ex(ctx, EVP_aes_128_cbc(), NULL, aKey, ivd, 0));
 	CHECK(EVP_CIPHER_CTX_set_padding(ctx, 0));
-	CHECK(EVP_DecryptUpdate(ctx, out.get(), &len, aData.data(), aDataLen));
+	CHECK(EVP_DecryptUpdate(ctx, out.get(), &len, aData, aDataLen));
 	CHECK(EVP_DecryptFinal_ex(ctx, out.get() + len, &len));
 	EVP_CIPHER_CTX_free(ctx);
 #undef CHECK
@@ -34,7 +34,7 @@ public:
 
 	// SUDP
 	static string encryptSUDP(const uint8_t* aKey, const string& aCmd);
-	static bool decryptSUDP(const uint8_t* aKey, const ByteVector& aData, size_t aDataLen, string& result_);
+	static bool decryptSUDP(const uint8_t* aKey, const uint8_t* aData, size_t aDataLen, string& result_);
 
 	using SUDPKey = std::unique_ptr<uint8_t[]>;
 	static SUDPKey generateSUDPKey();
@@ -122,6 +122,22 @@ DupeType DupeUtil::checkFileDupe(const TTHValue& aTTH) {
 	return QueueManager::getInstance()->isFileQueued(aTTH);
 }
 
+vector<DupeType> DupeUtil::checkFileDupes(std::span<const TTHValue> aTTHs) {
+	if (aTTHs.empty()) {
+		return vector<DupeType>();
+	}
+
+	auto shared = ShareManager::getInstance()->isFileShared(aTTHs);
+	auto ret = QueueManager::getInstance()->isFileQueued(aTTHs);
+	for (size_t i = 0; i < ret.size(); ++i) {
+		if (shared[i]) {
+			ret[i] = DUPE_SHARE_FULL;
+		}
+	}
+
+	return ret;
+}
+
 bool DupeUtil::allowOpenDirectoryDupe(DupeType aType) noexcept {
 	return aType != DUPE_NONE;
 }
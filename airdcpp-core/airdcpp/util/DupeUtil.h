@@ -39,6 +39,9 @@ public:
 	static DupeType checkAdcDirectoryDupe(const string& aAdcPath, int64_t aSize);
 	static DupeType checkFileDupe(const TTHValue& aTTH);
 
+	// Checks multiple files with a single lookup for each manager
+	static vector<DupeType> checkFileDupes(std::span<const TTHValue> aTTHs);
+
 	static StringList getAdcDirectoryDupePaths(DupeType aType, const string& aAdcPath);
 	static StringList getFileDupePaths(DupeType aType, const TTHValue& aTTH);
 
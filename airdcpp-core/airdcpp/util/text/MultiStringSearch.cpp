@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "stdinc.h"
+#include <airdcpp/util/text/MultiStringSearch.h>
+
+#include <airdcpp/util/text/Text.h>
+
+#include <deque>
+
+namespace dcpp {
+
+// Node 0 is the root (it's never a valid failure target for output links)
+#define ROOT_NODE 0
+
+MultiStringSearch::MultiStringSearch() {
+	clear();
+}
+
+void MultiStringSearch::clear() {
+	nodes.clear();
+	nodes.emplace_back();
+	patternCount = 0;
+	built = false;
+}
+
+MultiStringSearch::NodeIndex MultiStringSearch::findChild(const Node& aNode, uint8_t aChar) const noexcept {
+	auto i = ranges::lower_bound(aNode.children, aChar, {}, [](const auto& c) { return c.first; });
+	return i != aNode.children.end() && i->first == aChar ? i->second : ROOT_NODE;
+}
+
+void MultiStringSearch::addString(const string& aPattern, PatternId aId) {
+	dcassert(!built);
+	if (aPattern.empty()) {
+		return;
+	}
+
+	NodeIndex cur = ROOT_NODE;
+	for (auto c: Text::toLower(aPattern)) {
+		auto ch = static_cast<uint8_t>(c);
+		auto child = findChild(nodes[cur], ch);
+		if (child == ROOT_NODE) {
+			child = static_cast<NodeIndex>(nodes.size());
+			auto& children = nodes[cur].children;
+			children.insert(ranges::lower_bound(children, ch, {}, [](const auto& p) { return p.first; }), { ch, child });
+			nodes.emplace_back();
+		}
+
+		cur = child;
+	}
+
+	nodes[cur].patterns.push_back(aId);
+	patternCount++;
+}
+
+void MultiStringSearch::build() {
+	// Breadth-first so that the failure links of shorter suffixes are available
+	std::deque<NodeIndex> queue;
+	for (const auto& [ch, child] : nodes[ROOT_NODE].children) {
+		nodes[child].fail = ROOT_NODE;
+		queue.push_back(child);
+	}
+
+	while (!queue.empty()) {
+		auto cur = queue.front();
+		queue.pop_front();
+
+		for (const auto& [ch, child] : nodes[cur].children) {
+			auto fail = next(nodes[cur].fail, ch);
+			nodes[child].fail = fail;
+			nodes[child].output = !nodes[fail].patterns.empty() ? fail : nodes[fail].output;
+			queue.push_back(child);
+		}
+	}
+
+	built = true;
+}
+
+MultiStringSearch::NodeIndex MultiStringSearch::next(NodeIndex aState, uint8_t aChar) const noexcept {
+	for (;;) {
+		auto child = findChild(nodes[aState], aChar);
+		if (child != ROOT_NODE || aState == ROOT_NODE) {
+			return child;
+		}
+
+		aState = nodes[aState].fail;
+	}
+}
+
+void MultiStringSearch::match(const string& aText, const MatchF& aHandler) const {
+	matchLower(Text::toLower(aText), aHandler);
+}
+
+void MultiStringSearch::matchLower(const string& aText, const MatchF& aHandler) const {
+	dcassert(built);
+	dcassert(Text::isLower(aText));
+
+	NodeIndex state = ROOT_NODE;
+	for (auto c: aText) {
+		state = next(state, static_cast<uint8_t>(c));
+
+		for (auto o = state; o != ROOT_NODE; o = nodes[o].output) {
+			for (auto id: nodes[o].patterns) {
+				aHandler(id);
+			}
+		}
+	}
+}
+
+} // namespace dcpp
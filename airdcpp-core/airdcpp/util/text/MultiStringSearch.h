@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DCPLUSPLUS_DCPP_MULTI_STRING_SEARCH_H
+#define DCPLUSPLUS_DCPP_MULTI_STRING_SEARCH_H
+
+#include <airdcpp/core/header/typedefs.h>
+
+namespace dcpp {
+
+/**
+ * Finds occurrences of any number of patterns with a single pass over the text (Aho-Corasick).
+ * Patterns are matched case-insensitively in the same way as with StringSearch.
+ */
+class MultiStringSearch {
+public:
+	typedef uint32_t PatternId;
+	typedef std::function<void(PatternId)> MatchF;
+
+	MultiStringSearch();
+
+	/** Patterns can't be added after the search has been built */
+	void addString(const string& aPattern, PatternId aId);
+
+	/** Calculates the failure links, must be called before matching */
+	void build();
+
+	/** Calls the handler for each match (the same pattern is reported once for each occurrence) */
+	void matchLower(const string& aText, const MatchF& aHandler) const;
+	void match(const string& aText, const MatchF& aHandler) const;
+
+	void clear();
+	bool empty() const noexcept { return patternCount == 0; }
+	size_t count() const noexcept { return patternCount; }
+private:
+	typedef uint32_t NodeIndex;
+
+	struct Node {
+		// Sorted by character
+		vector<pair<uint8_t, NodeIndex>> children;
+
+		NodeIndex fail = 0;
+
+		// Closest node reachable via failure links that ends a pattern
+		NodeIndex output = 0;
+
+		vector<PatternId> patterns;
+	};
+
+	NodeIndex findChild(const Node& aNode, uint8_t aChar) const noexcept;
+	NodeIndex next(NodeIndex aState, uint8_t aChar) const noexcept;
+
+	vector<Node> nodes;
+	size_t patternCount = 0;
+	bool built = false;
+};
+
+} // namespace dcpp
+
+#endif // !defined(DCPLUSPLUS_DCPP_MULTI_STRING_SEARCH_H)
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+// Replays typical hash database workloads with the selected database backend
+//
+// Usage: airdcpp-hashstore-bench <leveldb|lmdb> <work directory> [file count] [lookup count]
+//
+// The work directory is used as the settings directory and it should be empty (or contain
+// the databases of a previous run for measuring the startup with an existing database).
+
+#include <airdcpp/stdinc.h>
+
+#include <airdcpp/DCPlusPlus.h>
+#include <airdcpp/core/classes/Exception.h>
+#include <airdcpp/core/localization/ResourceManager.h>
+#include <airdcpp/core/timer/TimerManager.h>
+#include <airdcpp/events/LogManager.h>
+#include <airdcpp/hash/HashedFile.h>
+#include <airdcpp/hash/HashStore.h>
+#include <airdcpp/settings/SettingsManager.h>
+#include <airdcpp/util/AppUtil.h>
+#include <airdcpp/util/Util.h>
+
+#include <chrono>
+#include <random>
+
+using namespace dcpp;
+
+// Files per directory
+#define BENCH_DIRECTORY_SIZE 100
+
+// Share of the files that are removed from share before running the maintenance (percents)
+#define BENCH_UNSHARED_PERCENT 10
+
+class BenchTimer {
+public:
+	BenchTimer(const string& aName, size_t aOperations) : name(aName), operations(aOperations), start(std::chrono::steady_clock::now()) { }
+
+	~BenchTimer() {
+		auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		printf("%-24s %10.3f s", name.c_str(), elapsed);
+		if (operations > 0 && elapsed > 0) {
+			printf(" %14.0f ops/s", static_cast<double>(operations) / elapsed);
+		}
+
+		printf("\n");
+	}
+private:
+	const string name;
+	const size_t operations;
+	const std::chrono::steady_clock::time_point start;
+};
+
+struct BenchFile {
+	string path;
+	TTHValue root;
+	int64_t size;
+};
+
+static TigerTree createTree(std::mt19937_64& rng) {
+	// Mostly small files with single-leaf trees, some larger ones
+	auto leaves = rng() % 4 == 0 ? static_cast<size_t>(rng() % 512 + 2) : 1;
+	int64_t blockSize = 64 * 1024;
+
+	vector<uint8_t> data(leaves * TTHValue::BYTES);
+	for (auto& b: data) {
+		b = static_cast<uint8_t>(rng());
+	}
+
+	return TigerTree(static_cast<int64_t>(leaves) * blockSize, blockSize, data.data());
+}
+
+static vector<BenchFile> insertFiles(HashStore& aStore, size_t aCount, std::mt19937_64& rng) {
+	vector<BenchFile> files;
+	files.reserve(aCount);
+
+	BenchTimer t("bulk insert", aCount);
+	for (size_t i = 0; i < aCount; ++i) {
+		auto tree = createTree(rng);
+		auto path = "/share/bench/directory " + Util::toString(i / BENCH_DIRECTORY_SIZE) + "/file " + Util::toString(i) + ".bin";
+
+		aStore.addHashedFile(path, tree, HashedFile(tree.getRoot(), i, tree.getFileSize()));
+		files.push_back({ std::move(path), tree.getRoot(), tree.getFileSize() });
+	}
+
+	aStore.flush();
+	return files;
+}
+
+static void runLookups(HashStore& aStore, const vector<BenchFile>& aFiles, size_t aCount, std::mt19937_64& rng) {
+	size_t found = 0;
+
+	{
+		BenchTimer t("random getTree", aCount);
+		TigerTree tree;
+		for (size_t i = 0; i < aCount; ++i) {
+			if (aStore.getTree(aFiles[rng() % aFiles.size()].root, tree)) {
+				found++;
+			}
+		}
+	}
+
+	{
+		// Every other lookup misses
+		BenchTimer t("random hasTree", aCount);
+		TTHValue missing;
+		for (size_t i = 0; i < aCount; ++i) {
+			if (aStore.hasTree(i % 2 == 0 ? aFiles[rng() % aFiles.size()].root : missing)) {
+				found++;
+			}
+		}
+	}
+
+	{
+		BenchTimer t("random checkTTH", aCount);
+		for (size_t i = 0; i < aCount; ++i) {
+			auto fileIndex = rng() % aFiles.size();
+
+			// Timestamp is the index of the file
+			HashedFile fi(fileIndex, aFiles[fileIndex].size);
+			if (aStore.checkTTH(aFiles[fileIndex].path, fi)) {
+				found++;
+			}
+		}
+	}
+
+	printf("%-24s %10zu\n", "lookup hits", found);
+}
+
+static void runOptimize(HashStore& aStore, const vector<BenchFile>& aFiles) {
+	unordered_set<string> unshared;
+	for (size_t i = 0; i < aFiles.size(); i += 100 / BENCH_UNSHARED_PERCENT) {
+		unshared.insert(aFiles[i].path);
+	}
+
+	BenchTimer t("optimize (verify)", aFiles.size());
+	aStore.optimize(
+		true,
+		[&](const string& aPath) { return !unshared.contains(aPath); },
+		[](const TTHValue&) { return false; }
+	);
+}
+
+static void printSizes(HashStore& aStore) {
+	int64_t fileDbSize = 0, hashDbSize = 0;
+	aStore.getDbSizes(fileDbSize, hashDbSize);
+	printf("%-24s %10s\n", "file index size", Util::formatBytes(fileDbSize).c_str());
+	printf("%-24s %10s\n", "hash data size", Util::formatBytes(hashDbSize).c_str());
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 3) {
+		printf("Usage: %s <leveldb|lmdb> <work directory> [file count] [lookup count]\n", argv[0]);
+		return 1;
+	}
+
+	auto backend = string(argv[1]) == "lmdb" ? SettingsManager::DB_BACKEND_LMDB : SettingsManager::DB_BACKEND_LEVELDB;
+	auto fileCount = argc > 3 ? static_cast<size_t>(Util::toInt64(argv[3])) : 100000;
+	auto lookupCount = argc > 4 ? static_cast<size_t>(Util::toInt64(argv[4])) : 100000;
+
+	initializeUtil(AppUtil::formatCustomConfigPath(argv[2]));
+
+	ResourceManager::newInstance();
+	SettingsManager::newInstance();
+	LogManager::newInstance();
+	TimerManager::newInstance();
+
+	SettingsManager::getInstance()->set(SettingsManager::DB_BACKEND, backend);
+
+	// The loader stores references to these
+	StepFunction stepF = [](const string& aMessage) { printf("%s\n", aMessage.c_str()); };
+	MessageFunction messageF = [](const string& aMessage, bool, bool) { printf("%s\n", aMessage.c_str()); return true; };
+	ProgressFunction progressF = [](float) { };
+
+	std::mt19937_64 rng(1);
+	try {
+		vector<BenchFile> files;
+
+		{
+			auto store = make_unique<HashStore>();
+			{
+				StartupLoader loader(stepF, progressF, messageF);
+				BenchTimer t("load (initial)", 0);
+				store->load(loader);
+			}
+
+			files = insertFiles(*store, fileCount, rng);
+			runLookups(*store, files, lookupCount, rng);
+			printSizes(*store);
+		}
+
+		{
+			auto store = make_unique<HashStore>();
+			{
+				StartupLoader loader(stepF, progressF, messageF);
+				BenchTimer t("load (existing)", 0);
+				store->load(loader);
+			}
+
+			runOptimize(*store, files);
+			runLookups(*store, files, lookupCount, rng);
+			printSizes(*store);
+		}
+	} catch (const Exception& e) {
+		printf("Benchmark failed: %s\n", e.getError().c_str());
+		return 1;
+	}
+
+	TimerManager::deleteInstance();
+	LogManager::deleteInstance();
+	SettingsManager::deleteInstance();
+	ResourceManager::deleteInstance();
+	return 0;
+}
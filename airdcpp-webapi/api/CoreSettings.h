@@ -143,12 +143,17 @@ namespace webserver {
 		{ "max_hash_speed", SettingsManager::MAX_HASH_SPEED, ResourceManager::SETTINGS_MAX_HASHER_SPEED, ApiSettingItem::TYPE_LAST, ResourceManager::Strings::MBPS },
 		{ "max_total_hashers", SettingsManager::MAX_HASHING_THREADS, ResourceManager::MAX_HASHING_THREADS },
 		{ "max_volume_hashers", SettingsManager::HASHERS_PER_VOLUME, ResourceManager::MAX_VOL_HASHERS },
+		{ "file_hashing_threads", SettingsManager::HASHER_PIPELINE_THREADS, ResourceManager::MAX_FILE_HASHING_THREADS },
+		{ "hash_database_backend", SettingsManager::DB_BACKEND, ResourceManager::SETTINGS_DB_BACKEND },
 
 		//{ ResourceManager::REFRESH_OPTIONS },
 		{ "refresh_time", SettingsManager::AUTO_REFRESH_TIME, ResourceManager::SETTINGS_AUTO_REFRESH_TIME, ApiSettingItem::TYPE_LAST, ResourceManager::Strings::MINUTES_LOWER },
 		{ "refresh_time_incoming", SettingsManager::INCOMING_REFRESH_TIME, ResourceManager::SETTINGS_INCOMING_REFRESH_TIME, ApiSettingItem::TYPE_LAST, ResourceManager::Strings::MINUTES_LOWER },
 		{ "refresh_startup", SettingsManager::STARTUP_REFRESH, ResourceManager::SETTINGS_STARTUP_REFRESH },
 		{ "refresh_threading", SettingsManager::REFRESH_THREADING, ResourceManager::MULTITHREADED_REFRESH },
+		{ "refresh_skip_unchanged", SettingsManager::REFRESH_SKIP_UNCHANGED, ResourceManager::SETTINGS_REFRESH_SKIP_UNCHANGED },
+		{ "monitoring_mode", SettingsManager::MONITORING_MODE, ResourceManager::SETTINGS_MONITORING_MODE },
+		{ "monitoring_delay", SettingsManager::MONITORING_DELAY, ResourceManager::SETTINGS_MONITORING_DELAY, ApiSettingItem::TYPE_LAST, ResourceManager::Strings::SECONDS_LOWER },
 
 		//{ ResourceManager::SETTINGS_SHARING_OPTIONS },
 		{ "share_skiplist", SettingsManager::SKIPLIST_SHARE, ResourceManager::ST_SKIPLIST_SHARE },
@@ -211,8 +216,10 @@ namespace webserver {
 		//{ ResourceManager::SETTINGS_ADVANCED },
 		{ "socket_read_buffer", SettingsManager::SOCKET_IN_BUFFER, ResourceManager::SETTINGS_SOCKET_IN_BUFFER, ApiSettingItem::TYPE_LAST, ResourceManager::Strings::B },
 		{ "socket_write_buffer", SettingsManager::SOCKET_OUT_BUFFER, ResourceManager::SETTINGS_SOCKET_OUT_BUFFER, ApiSettingItem::TYPE_LAST, ResourceManager::Strings::B },
+		{ "socket_reactor_threads", SettingsManager::SOCKET_REACTOR_THREADS, ResourceManager::SETTINGS_SOCKET_REACTOR_THREADS },
 		{ "buffer_size", SettingsManager::BUFFER_SIZE, ResourceManager::SETTINGS_WRITE_BUFFER, ApiSettingItem::TYPE_LAST, ResourceManager::Strings::KiB },
 		{ "compress_transfers", SettingsManager::COMPRESS_TRANSFERS, ResourceManager::SETTINGS_COMPRESS_TRANSFERS },
+		{ "zero_copy_uploads", SettingsManager::ZERO_COPY_UPLOADS, ResourceManager::SETTINGS_ZERO_COPY_UPLOADS },
 		{ "max_compression", SettingsManager::MAX_COMPRESSION, ResourceManager::SETTINGS_MAX_COMPRESS },
 		{ "bloom_mode", SettingsManager::BLOOM_MODE, ResourceManager::BLOOM_MODE },
 
@@ -142,6 +142,14 @@ namespace webserver {
 		});
 	}
 
+	json HashApi::serializePipelineStats(const HasherStats& aStats) noexcept {
+		return {
+			{ "size", aStats.pipelineSizeHashed },
+			{ "duration", aStats.pipelineHashTime },
+			{ "wait_time", aStats.pipelineWaitTime },
+		};
+	}
+
 	void HashApi::on(HashManagerListener::DirectoryHashed, const string& aPath, const HasherStats& aStats, int aHasherId) noexcept {
 		maybeSend("hasher_directory_finished", [&] { 
 			return json({
@@ -149,6 +157,7 @@ namespace webserver {
 				{ "size", aStats.sizeHashed },
 				{ "files", aStats.filesHashed },
 				{ "duration", aStats.hashTime },
+				{ "pipeline", serializePipelineStats(aStats) },
 				{ "hasher_id", aHasherId },
 			});
 		});
@@ -161,6 +170,7 @@ namespace webserver {
 				{ "files", aStats.filesHashed },
 				{ "directories", aDirsHashed },
 				{ "duration", aStats.hashTime },
+				{ "pipeline", serializePipelineStats(aStats) },
 				{ "hasher_id", aHasherId },
 			});
 		});
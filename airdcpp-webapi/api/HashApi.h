@@ -36,6 +36,7 @@ namespace webserver {
 		json serializeHashStatistics(const HashManager::HashStats& aStats) noexcept;
 
 		static json formatDbStatus(bool aMaintenanceRunning) noexcept;
+		static json serializePipelineStats(const HasherStats& aStats) noexcept;
 		void updateDbStatus(bool aMaintenanceRunning) noexcept;
 
 		api_return handlePause(ApiRequest& aRequest);
@@ -68,6 +68,8 @@ namespace webserver {
 		METHOD_HANDLER(Access::SETTINGS_EDIT,	METHOD_PATCH,	(EXACT_PARAM("types"), STR_PARAM(SEARCH_TYPE_ID)),	SearchApi::handleUpdateType);
 		METHOD_HANDLER(Access::SETTINGS_EDIT,	METHOD_DELETE,	(EXACT_PARAM("types"), STR_PARAM(SEARCH_TYPE_ID)),	SearchApi::handleRemoveType);
 
+		METHOD_HANDLER(Access::SEARCH,			METHOD_GET,		(EXACT_PARAM("udp_stats")),							SearchApi::handleGetUdpStats);
+
 		// Listeners
 		SearchManager::getInstance()->addListener(this);
 
@@ -217,6 +219,21 @@ namespace webserver {
 		return http_status::ok;
 	}
 
+	api_return SearchApi::handleGetUdpStats(ApiRequest& aRequest) const {
+		auto stats = SearchManager::getInstance()->getUdpServer().getStats();
+		aRequest.setResponseBody(serializeUdpStats(stats));
+		return http_status::ok;
+	}
+
+	json SearchApi::serializeUdpStats(const UDPServer::Stats& aStats) noexcept {
+		return {
+			{ "packets_received", aStats.packetsReceived },
+			{ "packets_per_second", aStats.packetsPerSecond },
+			{ "packets_dropped", aStats.packetsDropped },
+			{ "receive_queue_drops", aStats.receiveQueueDrops },
+		};
+	}
+
 	api_return SearchApi::handleGetType(ApiRequest& aRequest) const {
 		auto id = parseSearchTypeId(aRequest);
 
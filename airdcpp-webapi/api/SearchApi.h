@@ -25,6 +25,7 @@
 #include <api/base/HierarchicalApiModule.h>
 
 #include <airdcpp/core/header/typedefs.h>
+#include <airdcpp/connection/UDPServer.h>
 #include <airdcpp/search/SearchManagerListener.h>
 
 namespace webserver {
@@ -46,6 +47,9 @@ namespace webserver {
 		api_return handleUpdateType(ApiRequest& aRequest) const;
 		api_return handleRemoveType(ApiRequest& aRequest) const;
 
+		api_return handleGetUdpStats(ApiRequest& aRequest) const;
+		static json serializeUdpStats(const UDPServer::Stats& aStats) noexcept;
+
 		void on(SearchManagerListener::SearchTypesChanged) noexcept override;
 		void on(SearchManagerListener::SearchInstanceCreated, const SearchInstancePtr& aInstance) noexcept override;
 		void on(SearchManagerListener::SearchInstanceRemoved, const SearchInstancePtr& aInstance) noexcept override;
@@ -24,6 +24,7 @@
 #include <api/common/Serializer.h>
 
 #include <web-server/JsonUtil.h>
+#include <web-server/SocketManager.h>
 #include <web-server/WebSocket.h>
 #include <web-server/WebServerManager.h>
 #include <web-server/WebServerSettings.h>
@@ -134,7 +135,7 @@ namespace webserver {
 		dcassert(session);
 
 		if (aRequest.authenticationCallback) {
-			aRequest.authenticationCallback(session);
+			onSocketAuthenticated(aRequest, session);
 		}
 
 
@@ -142,6 +143,20 @@ namespace webserver {
 		return http_status::ok;
 	}
 
+	void SessionApi::onSocketAuthenticated(RouterRequest& aRequest, const SessionPtr& aSession) {
+		auto eventBatching = JsonUtil::getOptionalFieldDefault<bool>("event_batching", aRequest.apiRequest.getRequestBody(), false);
+
+		aRequest.authenticationCallback(aSession);
+
+		if (eventBatching) {
+			auto& socketManager = aSession->getServer()->getSocketManager();
+			auto socket = socketManager.getSocket(aSession->getId());
+			if (socket) {
+				socketManager.enableEventBatching(socket);
+			}
+		}
+	}
+
 	json SessionApi::serializeLoginInfo(const SessionPtr& aSession, const string& aRefreshToken) {
 		json ret = {
 			{ "session_id", aSession->getId() },
@@ -179,7 +194,7 @@ namespace webserver {
 			return http_status::bad_request;
 		}
 
-		aRequest.authenticationCallback(session);
+		onSocketAuthenticated(aRequest, session);
 
 		apiRequest.setResponseBody(serializeLoginInfo(session, Util::emptyString));
 		return http_status::ok;
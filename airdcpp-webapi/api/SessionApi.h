@@ -49,6 +49,9 @@ namespace webserver {
 		api_return logout(ApiRequest& aRequest, const SessionPtr& aSession);
 
 		static json serializeLoginInfo(const SessionPtr& aSession, const string& aRefreshToken);
+
+		// Associates the session with the requesting socket and applies the socket options
+		static void onSocketAuthenticated(RouterRequest& aRequest, const SessionPtr& aSession);
 		static json serializeSession(const SessionPtr& aSession) noexcept;
 		static string getSessionType(const SessionPtr& aSession) noexcept;
 
@@ -51,6 +51,8 @@
 #define HOOK_NEW_FILE_VALIDATION "new_share_file_validation_hook"
 #define HOOK_NEW_DIRECTORY_VALIDATION "new_share_directory_validation_hook"
 
+#define HOOK_FILE_BATCH_VALIDATION "share_file_batch_validation_hook"
+
 namespace webserver {
 	ShareApi::ShareApi(Session* aSession) : HookApiModule(aSession, Access::SHARE_VIEW, Access::SHARE_EDIT) {
 		createSubscriptions({
@@ -100,6 +102,7 @@ namespace webserver {
 		HOOK_HANDLER(HOOK_DIRECTORY_VALIDATION,		ShareManager::getInstance()->getValidator().directoryValidationHook,	ShareApi::directoryValidationHook);
 		HOOK_HANDLER(HOOK_NEW_FILE_VALIDATION,		ShareManager::getInstance()->getValidator().newFileValidationHook,		ShareApi::newFileValidationHook);
 		HOOK_HANDLER(HOOK_NEW_DIRECTORY_VALIDATION, ShareManager::getInstance()->getValidator().newDirectoryValidationHook, ShareApi::newDirectoryValidationHook);
+		HOOK_HANDLER(HOOK_FILE_BATCH_VALIDATION,	ShareManager::getInstance()->getValidator().fileBatchValidationHook,	ShareApi::fileBatchValidationHook);
 
 		// Listeners
 		ShareManager::getInstance()->addListener(this);
@@ -163,6 +166,42 @@ namespace webserver {
 		);
 	}
 
+	ActionHookResult<StringMap> ShareApi::fileBatchValidationHook(const ShareValidationFile::List& aFiles, const ActionHookResultGetter<StringMap>& aResultGetter) noexcept {
+		return HookCompletionData::toResult<StringMap>(
+			maybeFireHook(HOOK_FILE_BATCH_VALIDATION, WEBCFG(SHARE_FILE_BATCH_VALIDATION_HOOK_TIMEOUT).num(), [&]() {
+				auto files = json::array();
+				for (const auto& f: aFiles) {
+					files.push_back({
+						{ "path", f.path },
+						{ "size", f.size },
+						{ "new", f.isNew },
+						{ "new_parent", f.newParent },
+					});
+				}
+
+				return json({
+					{ "files", files },
+				});
+			}),
+			aResultGetter,
+			this,
+			[](const json& aData, const ActionHookResultGetter<StringMap>& aResultGetter) {
+				StringMap rejectedFiles;
+				if (aData.is_null()) {
+					return rejectedFiles;
+				}
+
+				for (const auto& rejection: JsonUtil::getOptionalArrayField("rejected_files", aData)) {
+					auto path = JsonUtil::getField<string>("path", rejection, false);
+					auto message = JsonUtil::getField<string>("message", rejection, false);
+					rejectedFiles.emplace(path, aResultGetter.getSubscriber().getName() + ": " + message);
+				}
+
+				return rejectedFiles;
+			}
+		);
+	}
+
 	json ShareApi::serializeShareItem(const ShareItem& aItem) noexcept {
 		if (aItem.directory) {
 			return serializeDirectory(aItem.directory);
@@ -577,6 +616,7 @@ namespace webserver {
 
 			{ "unfiltered_recursive_searches_per_second", searchStats.unfilteredRecursiveSearchesPerSecond },
 			{ "filtered_searches", searchStats.filteredSearches },
+			{ "indexed_searches", searchStats.indexedSearches },
 
 			{ "recursive_searches", searchStats.recursiveSearches },
 			{ "recursive_searches_responded", searchStats.recursiveSearchesResponded },
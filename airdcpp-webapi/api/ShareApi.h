@@ -26,6 +26,7 @@
 #include <airdcpp/share/ShareManagerListener.h>
 #include <airdcpp/share/temp_share/TempShareManagerListener.h>
 #include <airdcpp/share/ShareRefreshTask.h>
+#include <airdcpp/share/SharePathValidator.h>
 
 namespace webserver {
 	class ShareApi : public HookApiModule, private ShareManagerListener, private TempShareManagerListener {
@@ -47,6 +48,7 @@ namespace webserver {
 		ActionHookResult<> directoryValidationHook(const string& aPath, const ActionHookResultGetter<>& aResultGetter) noexcept;
 		ActionHookResult<> newDirectoryValidationHook(const string& aPath, bool aNewParent, const ActionHookResultGetter<>& aResultGetter) noexcept;
 		ActionHookResult<> newFileValidationHook(const string& aPath, int64_t aSize, bool aNewParent, const ActionHookResultGetter<>& aResultGetter) noexcept;
+		ActionHookResult<StringMap> fileBatchValidationHook(const ShareValidationFile::List& aFiles, const ActionHookResultGetter<StringMap>& aResultGetter) noexcept;
 
 		api_return handleRefreshShare(ApiRequest& aRequest);
 		api_return handleRefreshPaths(ApiRequest& aRequest);
@@ -132,9 +132,24 @@ namespace webserver {
 	api_return SystemApi::handleGetStats(ApiRequest& aRequest) {
 		auto server = session->getServer();
 
+		auto timerTasks = json::array();
+		for (const auto& t: TimerManager::getInstance()->getTaskStats()) {
+			timerTasks.push_back({
+				{ "name", t.name },
+				{ "interval", t.interval },
+				{ "runs", t.runs },
+				{ "overruns", t.overruns },
+				{ "average_jitter", t.runs > 0 ? t.totalJitter / t.runs : 0 },
+				{ "max_jitter", t.maxJitter },
+				{ "average_duration", t.runs > 0 ? t.totalDuration / t.runs : 0 },
+				{ "max_duration", t.maxDuration },
+			});
+		}
+
 		aRequest.setResponseBody({
 			{ "server_threads", WEBCFG(SERVER_THREADS).num() },
 			{ "active_sessions", server->getUserManager().getUserSessionCount() },
+			{ "timer_tasks", timerTasks },
 		});
 		return http_status::ok;
 	}
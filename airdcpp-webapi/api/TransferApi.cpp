@@ -27,6 +27,7 @@
 
 #include <airdcpp/transfer/download/DownloadManager.h>
 #include <airdcpp/connection/ConnectionManager.h>
+#include <airdcpp/core/io/stream/SharedFileStream.h>
 #include <airdcpp/queue/QueueManager.h>
 #include <airdcpp/connection/ThrottleManager.h>
 #include <airdcpp/transfer/TransferInfoManager.h>
@@ -128,10 +129,26 @@ namespace webserver {
 	}
 
 	api_return TransferApi::handleGetTransferStats(ApiRequest& aRequest) {
-		aRequest.setResponseBody(serializeTransferStats());
+		auto j = serializeTransferStats();
+		j["shared_files"] = serializeSharedFileStats();
+
+		aRequest.setResponseBody(j);
 		return http_status::ok;
 	}
 
+	json TransferApi::serializeSharedFileStats() noexcept {
+		const auto& stats = SharedFileStream::getStats();
+		return {
+			{ "open_handles", stats.openHandles.load() },
+			{ "reads", stats.reads.load() },
+			{ "writes", stats.writes.load() },
+			{ "bytes_read", stats.bytesRead.load() },
+			{ "bytes_written", stats.bytesWritten.load() },
+			{ "pool_locks", stats.poolLocks.load() },
+			{ "pool_contentions", stats.poolContentions.load() },
+		};
+	}
+
 	json TransferApi::serializeTransferStats() const noexcept {
 		auto resetSpeed = [](int transfers, int64_t speed) {
 			return (transfers == 0 && speed < 10 * 1024) || speed < 1024;
@@ -36,6 +36,7 @@ namespace webserver {
 		~TransferApi();
 	private:
 		json serializeTransferStats() const noexcept;
+		static json serializeSharedFileStats() noexcept;
 
 		api_return handleGetTransfers(ApiRequest& aRequest);
 		api_return handleGetTransfer(ApiRequest& aRequest);
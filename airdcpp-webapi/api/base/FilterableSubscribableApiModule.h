@@ -66,7 +66,7 @@ namespace webserver {
 
 		bool maybeSend(const string& aSubscription, const IdType& aId, const BaseType::JsonCallback& aCallback) {
 			if (hasEntitySubscribers(aSubscription, aId)) {
-				return BaseType::send(toSubscription(aSubscription, aId), aCallback());
+				return BaseType::sendEvent(toSubscription(aSubscription, aId), aCallback);
 			}
 
 			return BaseType::maybeSend(aSubscription, aCallback);
@@ -192,20 +192,16 @@ namespace webserver {
 		SubApiModule(ParentType* aParentModule, const IdJsonType& aJsonId) :
 			SubscribableApiModule(aParentModule->getSession(), aParentModule->getSubscriptionAccess()), parentModule(aParentModule), jsonId(aJsonId) { }
 
-		bool send(const string& aSubscription, const json& aJson) override {
-			return SubscribableApiModule::send({
+		json serializeEvent(const string& aSubscription, json&& aJson) const override {
+			return {
 				{ "event", aSubscription },
-				{ "data", aJson },
+				{ "data", std::move(aJson) },
 				{ "id", jsonId }
-			});
+			};
 		}
 
-		bool maybeSend(const string& aSubscription, const SubscribableApiModule::JsonCallback& aCallback) override {
-			if (!subscriptionActive(aSubscription)) {
-				return false;
-			}
-
-			return send(aSubscription, aCallback());
+		string getEventCacheKey(const string& aSubscription) const noexcept override {
+			return aSubscription + '/' + json(jsonId).dump();
 		}
 
 		bool subscriptionActive(const string& aSubscription) const noexcept override {
@@ -25,7 +25,29 @@
 
 #include <api/base/SubscribableApiModule.h>
 
+#include <airdcpp/core/Speaker.h>
+
 namespace webserver {
+	// Serialized messages of the event that is currently being fired by the thread
+	// Other sessions listening to the same event will send the cached message
+	struct EventMessageCache {
+		struct Message {
+			string message;
+
+			// Modules that have sent the message
+			vector<const SubscribableApiModule*> senders;
+
+			// The same module sent the subscription more than once during the event (e.g. for different entities),
+			// the messages can't be identified by the key
+			bool disabled = false;
+		};
+
+		uint64_t eventId = 0;
+		unordered_map<string, Message> messages;
+	};
+
+	static thread_local EventMessageCache eventMessageCache;
+
 	SubscribableApiModule::SubscribableApiModule(Session* aSession, Access aSubscriptionAccess) : ApiModule(aSession), subscriptionAccess(aSubscriptionAccess) {
 		socket = aSession->getServer()->getSocketManager().getSocket(aSession->getId());
 
@@ -96,21 +118,21 @@ namespace webserver {
 			return false;
 		}
 
+		string message;
 		try {
-			s->sendPlain(aJson);
-		} catch (const json::exception&) {
+			message = aJson.dump();
+		} catch (const json::exception& e) {
 			// Ignore JSON errors...
+			dcdebug("Failed to convert event to JSON: %s\n", e.what());
 			return false;
 		}
 
+		s->sendEvent(message);
 		return true;
 	}
 
 	bool SubscribableApiModule::send(const string& aSubscription, const json& aData) {
-		return send({
-			{ "event", aSubscription },
-			{ "data", aData },
-		});
+		return send(serializeEvent(aSubscription, json(aData)));
 	}
 
 	bool SubscribableApiModule::maybeSend(const string& aSubscription, const JsonCallback& aCallback) {
@@ -118,6 +140,68 @@ namespace webserver {
 			return false;
 		}
 
-		return send(aSubscription, aCallback());
+		return sendEvent(aSubscription, aCallback);
+	}
+
+	json SubscribableApiModule::serializeEvent(const string& aSubscription, json&& aData) const {
+		return {
+			{ "event", aSubscription },
+			{ "data", std::move(aData) },
+		};
+	}
+
+	string SubscribableApiModule::getEventCacheKey(const string& aSubscription) const noexcept {
+		return aSubscription;
+	}
+
+	bool SubscribableApiModule::sendEvent(const string& aSubscription, const JsonCallback& aCallback) {
+		auto s = socket;
+		if (!s) {
+			return false;
+		}
+
+		auto eventId = SpeakerEvent::getCurrentId();
+		if (eventId == 0) {
+			// Not called from a listener
+			return send(serializeEvent(aSubscription, aCallback()));
+		}
+
+		auto& cache = eventMessageCache;
+		if (cache.eventId != eventId) {
+			cache.eventId = eventId;
+			cache.messages.clear();
+		}
+
+		// Different modules may use the same subscription names
+		auto key = string(typeid(*this).name()) + '/' + getEventCacheKey(aSubscription);
+		if (auto i = cache.messages.find(key); i != cache.messages.end() && !i->second.disabled) {
+			auto& cached = i->second;
+			if (ranges::find(cached.senders, this) == cached.senders.end()) {
+				cached.senders.push_back(this);
+				s->sendEvent(cached.message);
+				return true;
+			}
+
+			// Sent again by the same module
+			cached.disabled = true;
+			cached.message.clear();
+		}
+
+		string message;
+		try {
+			message = serializeEvent(aSubscription, aCallback()).dump();
+		} catch (const json::exception& e) {
+			dcdebug("Failed to convert event to JSON: %s\n", e.what());
+			return false;
+		}
+
+		s->sendEvent(message);
+
+		// The listener may have fired other events
+		if (cache.eventId == eventId && !cache.messages.contains(key)) {
+			cache.messages.emplace(std::move(key), EventMessageCache::Message{ std::move(message), { this } });
+		}
+
+		return true;
 	}
-}
\ No newline at end of file
+}
@@ -38,10 +38,12 @@ namespace webserver {
 		virtual void createSubscriptions(const StringList& aSubscriptions) noexcept;
 
 		virtual bool send(const json& aJson);
-		virtual bool send(const string& aSubscription, const json& aJson);
+		bool send(const string& aSubscription, const json& aJson);
 
+		// The callback must return the same data for all sessions as the serialized event
+		// is shared with other sessions receiving the same event
 		using JsonCallback = std::function<json ()>;
-		virtual bool maybeSend(const string& aSubscription, const JsonCallback& aCallback);
+		bool maybeSend(const string& aSubscription, const JsonCallback& aCallback);
 
 		virtual void setSubscriptionState(const string& aSubscription, bool aActive) noexcept {
 			subscriptions[aSubscription] = aActive;
@@ -68,6 +70,15 @@ namespace webserver {
 	protected:
 		void createSubscription(const string& aSubscription) noexcept;
 
+		// Serializes the event (or uses the serialized event of another session if the listeners are being called for the same event)
+		bool sendEvent(const string& aSubscription, const JsonCallback& aCallback);
+
+		// Event message
+		virtual json serializeEvent(const string& aSubscription, json&& aData) const;
+
+		// Key for the cached serialized events (must be unique for different event messages)
+		virtual string getEventCacheKey(const string& aSubscription) const noexcept;
+
 		void on(SessionListener::SocketConnected, const WebSocketPtr&) noexcept override;
 		void on(SessionListener::SocketDisconnected) noexcept override;
 
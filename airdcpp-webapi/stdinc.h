@@ -27,6 +27,7 @@
 
 #include <websocketpp/http/constants.hpp>
 #include <websocketpp/config/asio.hpp>
+#include <websocketpp/extensions/permessage_deflate/enabled.hpp>
 #include <websocketpp/server.hpp>
 
 #include "json.h"
@@ -36,10 +37,19 @@ namespace webserver {
 	using json = nlohmann::json;
 	using http_status = websocketpp::http::status_code::value;
 
+	// Enables the permessage-deflate extension (compression is used if the client supports it)
+	template<typename BaseConfig>
+	struct deflate_config : public BaseConfig {
+		using type = deflate_config<BaseConfig>;
+
+		struct permessage_deflate_config {};
+		using permessage_deflate_type = websocketpp::extensions::permessage_deflate::enabled<permessage_deflate_config>;
+	};
+
 	// define types for two different server endpoints, one for each config we are
 	// using
-	using server_plain = websocketpp::server<websocketpp::config::asio>;
-	using server_tls = websocketpp::server<websocketpp::config::asio_tls>;
+	using server_plain = websocketpp::server<deflate_config<websocketpp::config::asio>>;
+	using server_tls = websocketpp::server<deflate_config<websocketpp::config::asio_tls>>;
 	using api_return = http_status;
 
 	using HTTPFileCompletionF = std::function<void(api_return aStatus, const std::string& aOutput, const std::vector<std::pair<std::string, std::string>>& aHeaders)>;
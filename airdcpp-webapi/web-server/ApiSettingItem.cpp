@@ -203,6 +203,10 @@ namespace webserver {
 
 		{ SettingsManager::MAX_HASHING_THREADS, { 1, 100 } },
 		{ SettingsManager::HASHERS_PER_VOLUME, { 1, 100 } },
+		{ SettingsManager::HASHER_PIPELINE_THREADS, { 1, 64 } },
+		{ SettingsManager::SOCKET_REACTOR_THREADS, { 0, 64 } },
+		{ SettingsManager::MONITORING_DELAY, { 1, 3600 } },
+		{ SettingsManager::DB_BACKEND, { SettingsManager::DB_BACKEND_LEVELDB, SettingsManager::DB_BACKEND_LAST - 1 } },
 
 		{ SettingsManager::MAX_COMPRESSION, { 0, 9 } },
 		{ SettingsManager::MINIMUM_SEARCH_INTERVAL, { 5, 1000 } },
@@ -255,15 +255,43 @@ namespace webserver {
 		}
 
 		auto fileSize = File::getSize(filePath);
+		if (!isViewFile && fileSize >= 0) {
+			// Conditional requests for UI resources
+			auto lastModified = File::getLastModified(filePath);
+			auto etag = HttpUtil::formatETag(fileSize, lastModified);
+			auto lastModifiedStr = HttpUtil::formatHttpDate(lastModified);
+
+			headers_.emplace_back("ETag", etag);
+			if (!lastModifiedStr.empty()) {
+				headers_.emplace_back("Last-Modified", lastModifiedStr);
+			}
+
+			if (HttpUtil::isNotModified(aRequest, etag, lastModifiedStr)) {
+				return http_status::not_modified;
+			}
+		}
+
 		int64_t startPos = 0, endPos = fileSize - 1;
 
 		auto partialContent = HttpUtil::parsePartialRange(aRequest.get_header("Range"), startPos, endPos);
+		if (!partialContent && fileSize > MAX_RANGE_SIZE) {
+			// Response bodies are sent as a single buffer, don't read large files in memory
+			// The client will get the first part and must fetch the rest with range requests
+			partialContent = true;
+		}
 
-		// Read file
+		if (partialContent) {
+			// Return only the beginning of large ranges (the response header tells the actual range)
+			endPos = min(endPos, startPos + MAX_RANGE_SIZE - 1);
+		}
+
+		// Read the requested part of the file
 		try {
-			File f(filePath, File::READ, File::OPEN);
-			f.setPos(startPos);
-			output_ = f.read(static_cast<size_t>(endPos) + 1);
+			File f(filePath, File::READ, File::OPEN, File::BUFFER_SEQUENTIAL);
+
+			auto len = static_cast<size_t>(max(endPos - startPos + 1, static_cast<int64_t>(0)));
+			output_.resize(len);
+			output_.resize(f.readAt(output_.data(), len, startPos));
 		} catch (const FileException& e) {
 			dcdebug("Failed to serve the file %s: %s\n", filePath.c_str(), e.getError().c_str());
 
@@ -306,6 +334,10 @@ namespace webserver {
 			return http_status::partial_content;
 		}
 
+		if (isViewFile) {
+			headers_.emplace_back("Accept-Ranges", "bytes");
+		}
+
 		return http_status::ok;
 	}
 
@@ -43,6 +43,10 @@ namespace webserver {
 		string getTempFilePath(const string& fileId) const noexcept;
 		void stop() noexcept;
 
+		// Maximum number of bytes returned for a single request (larger files are always returned as partial content)
+		// Media players will fetch the rest of the file with subsequent requests, which keeps the memory usage bounded
+		static const int64_t MAX_RANGE_SIZE = 8 * 1024 * 1024;
+
 		FileServer(FileServer&) = delete;
 		FileServer& operator=(FileServer&) = delete;
 	private:
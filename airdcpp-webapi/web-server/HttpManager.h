@@ -168,7 +168,7 @@ namespace webserver {
 				);
 
 				auto responseOk = setHttpResponse(con, aStatus, aOutput);
-				if (responseOk && HttpUtil::isStatusOk(aStatus)) {
+				if (responseOk && (HttpUtil::isStatusOk(aStatus) || aStatus == http_status::not_modified)) {
 					// Don't set any incomplete/invalid headers in case of errors...
 					for (const auto& [name, value] : aHeaders) {
 						con->append_header(name, value);
@@ -130,6 +130,43 @@ namespace webserver {
 		headers_.emplace_back("Cache-Control", aDaysValid == 0 ? "no-store" : "max-age=" + Util::toString(aDaysValid * 24 * 60 * 60));
 	}
 
+	string HttpUtil::formatHttpDate(time_t aTime) noexcept {
+		static const char* days[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+		static const char* months[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+		tm _tm;
+#ifdef _WIN32
+		if (gmtime_s(&_tm, &aTime) != 0) {
+#else
+		if (!gmtime_r(&aTime, &_tm)) {
+#endif
+			return Util::emptyString;
+		}
+
+		char buf[64];
+		snprintf(buf, sizeof(buf), "%s, %02d %s %04d %02d:%02d:%02d GMT",
+			days[_tm.tm_wday], _tm.tm_mday, months[_tm.tm_mon], _tm.tm_year + 1900, _tm.tm_hour, _tm.tm_min, _tm.tm_sec);
+		return buf;
+	}
+
+	string HttpUtil::formatETag(int64_t aSize, time_t aLastModified) noexcept {
+		char buf[64];
+		snprintf(buf, sizeof(buf), "\"%llx-%llx\"", static_cast<unsigned long long>(aLastModified), static_cast<unsigned long long>(aSize));
+		return buf;
+	}
+
+	bool HttpUtil::isNotModified(const websocketpp::http::parser::request& aRequest, const string& aETag, const string& aLastModified) noexcept {
+		// If-None-Match takes precedence when both are present
+		const auto& noneMatch = aRequest.get_header("If-None-Match");
+		if (!noneMatch.empty()) {
+			return noneMatch == "*" || noneMatch.find(aETag) != string::npos;
+		}
+
+		// Browsers send the last received value as such
+		const auto& modifiedSince = aRequest.get_header("If-Modified-Since");
+		return !modifiedSince.empty() && !aLastModified.empty() && modifiedSince == aLastModified;
+	}
+
 	string HttpUtil::formatPartialRange(int64_t aStartPos, int64_t aEndPos, int64_t aFileSize) noexcept {
 		dcassert(aEndPos < aFileSize);
 		return "bytes " + Util::toString(aStartPos) + "-" + Util::toString(aEndPos) + "/" + Util::toString(aFileSize);
@@ -40,6 +40,15 @@ namespace webserver {
 
 		static void addCacheControlHeader(StringPairList& headers_, int aDaysValid) noexcept;
 
+		// Format a timestamp in the HTTP date format (RFC 7231, e.g. "Sun, 06 Nov 1994 08:49:37 GMT")
+		static string formatHttpDate(time_t aTime) noexcept;
+
+		// Strong validator based on the file size and modification time
+		static string formatETag(int64_t aSize, time_t aLastModified) noexcept;
+
+		// Returns true if the validators sent with a conditional GET request still match the file
+		static bool isNotModified(const websocketpp::http::parser::request& aRequest, const string& aETag, const string& aLastModified) noexcept;
+
 		static bool isStatusOk(int aCode) noexcept;
 		static bool parseStatus(const string& aResponse, int& code_, string& text_) noexcept;
 		static string parseAuthToken(const websocketpp::http::parser::request& aRequest) noexcept;
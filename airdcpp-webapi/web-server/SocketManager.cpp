@@ -33,6 +33,9 @@
 namespace webserver {
 	constexpr auto AUTHENTICATION_TIMEOUT = 60; // seconds;
 
+	// Check interval for a changed batch window when batching has been disabled
+	constexpr auto EVENT_BATCH_DISABLED_INTERVAL = 1000; // milliseconds
+
 	using namespace dcpp;
 
 	void SocketManager::start() {
@@ -57,6 +60,12 @@ namespace webserver {
 		if (socketPingTimer)
 			socketPingTimer->stop(true);
 
+		{
+			Lock l(eventBatchCS);
+			if (eventBatchTimer)
+				eventBatchTimer->stop(true);
+		}
+
 		disconnectSockets(STRING(WEB_SERVER_SHUTTING_DOWN));
 
 		for (;;) {
@@ -127,6 +136,51 @@ namespace webserver {
 		}
 	}
 
+	void SocketManager::enableEventBatching(const WebSocketPtr& aSocket) noexcept {
+		// Batching is disabled if the window is 0
+		auto batchWindow = WEBCFG(EVENT_BATCH_WINDOW).num();
+		if (batchWindow <= 0) {
+			return;
+		}
+
+		aSocket->setEventBatching(true);
+
+		// Batched events are sent when the window expires
+		Lock l(eventBatchCS);
+		if (!eventBatchTimer) {
+			eventBatchTimer = wsm->addTimer(
+				[this] {
+					flushEvents();
+				},
+				batchWindow
+			);
+
+			eventBatchTimer->start(false);
+		}
+	}
+
+	void SocketManager::flushEvents() noexcept {
+		// The setting may have been changed after the timer was created
+		auto batchWindow = WEBCFG(EVENT_BATCH_WINDOW).num();
+
+		{
+			RLock l(cs);
+			for (const auto& socket : sockets | views::values) {
+				if (!socket->isEventBatching()) {
+					continue;
+				}
+
+				if (batchWindow > 0) {
+					socket->flushEvents();
+				} else {
+					socket->setEventBatching(false);
+				}
+			}
+		}
+
+		eventBatchTimer->setInterval(batchWindow > 0 ? batchWindow : EVENT_BATCH_DISABLED_INTERVAL);
+	}
+
 	void SocketManager::disconnectSockets(const string& aMessage) noexcept {
 		RLock l(cs);
 		for (const auto& socket : sockets | views::values) {
@@ -44,6 +44,9 @@ namespace webserver {
 		// Reset sessions for associated sockets
 		WebSocketPtr getSocket(LocalSessionId aSessionToken) noexcept;
 
+		// Collect the events of the socket in batches (if batching is enabled in the settings)
+		void enableEventBatching(const WebSocketPtr& aSocket) noexcept;
+
 		SocketManager(SocketManager&) = delete;
 		SocketManager& operator=(SocketManager&) = delete;
 
@@ -96,12 +99,19 @@ namespace webserver {
 
 		void pingTimer() noexcept;
 
+		// Send batched events of all sockets, also applies changes of the batch window
+		void flushEvents() noexcept;
+
 		mutable SharedMutex cs;
 
 		using WebSocketList = vector<WebSocketPtr>;
 		std::map<websocketpp::connection_hdl, WebSocketPtr, std::owner_less<websocketpp::connection_hdl>> sockets;
 
 		TimerPtr socketPingTimer;
+
+		// Created when the first socket enables batching
+		TimerPtr eventBatchTimer;
+		CriticalSection eventBatchCS;
 		WebServerManager* wsm;
 
 		void resetSocketSession(const WebSocketPtr& aSocket) noexcept;
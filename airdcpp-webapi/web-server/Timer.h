@@ -67,6 +67,11 @@ namespace webserver {
 			return running;
 		}
 
+		// Used for scheduling the next tick (call only from the timer callback)
+		void setInterval(time_t aIntervalMillis) noexcept {
+			interval = std::chrono::milliseconds(aIntervalMillis);
+		}
+
 		void flush() {
 			timer.cancel();
 			scheduleNext(std::chrono::milliseconds(0));
@@ -52,6 +52,7 @@ namespace webserver {
 			DEFAULT_SESSION_IDLE_TIMEOUT,
 			PING_INTERVAL,
 			PING_TIMEOUT,
+			EVENT_BATCH_WINDOW,
 
 			EXTENSIONS_DEBUG_MODE,
 			EXTENSIONS_INIT_TIMEOUT,
@@ -61,6 +62,7 @@ namespace webserver {
 			SHARE_DIRECTORY_VALIDATION_HOOK_TIMEOUT,
 			NEW_SHARE_FILE_VALIDATION_HOOK_TIMEOUT,
 			NEW_SHARE_DIRECTORY_VALIDATION_HOOK_TIMEOUT,
+			SHARE_FILE_BATCH_VALIDATION_HOOK_TIMEOUT,
 
 			OUTGOING_CHAT_MESSAGE_HOOK_TIMEOUT,
 			INCOMING_CHAT_MESSAGE_HOOK_TIMEOUT,
@@ -32,6 +32,9 @@
 
 
 namespace webserver {
+	// Send the pending events immediately if the batch grows larger than this
+	constexpr size_t MAX_EVENT_BATCH_BYTES = 256 * 1024;
+
 	WebSocket::WebSocket(bool aIsSecure, websocketpp::connection_hdl aHdl, const websocketpp::http::parser::request& aRequest, server_plain* aServer, WebServerManager* aWsm) : WebSocket(aIsSecure, aHdl, aRequest, aWsm) {
 		plainServer = aServer;
 	}
@@ -126,13 +129,65 @@ namespace webserver {
 			throw;
 		}
 
-		wsm->onData(str, TransportType::TYPE_SOCKET, Direction::OUTGOING, getIp());
+		// Keep the order of events and responses
+		Lock l(eventCS);
+		flushEventsUnsafe();
+		sendText(str);
+	}
+
+	void WebSocket::sendEvent(const string& aPayload) noexcept {
+		// Batching may be disabled concurrently, the pending events would be left unsent otherwise
+		Lock l(eventCS);
+		if (!eventBatching) {
+			sendText(aPayload);
+			return;
+		}
+
+		if (!pendingEvents.empty()) {
+			pendingEvents += ',';
+		}
+
+		pendingEvents += aPayload;
+		pendingEventCount++;
+
+		if (pendingEvents.size() >= MAX_EVENT_BATCH_BYTES) {
+			flushEventsUnsafe();
+		}
+	}
+
+	void WebSocket::flushEvents() noexcept {
+		Lock l(eventCS);
+		flushEventsUnsafe();
+	}
+
+	void WebSocket::flushEventsUnsafe() noexcept {
+		if (pendingEventCount == 0) {
+			return;
+		}
+
+		sendText("[" + pendingEvents + "]");
+
+		pendingEvents.clear();
+		pendingEventCount = 0;
+	}
+
+	void WebSocket::setEventBatching(bool aEnabled) noexcept {
+		Lock l(eventCS);
+		if (!aEnabled) {
+			flushEventsUnsafe();
+		}
+
+		eventBatching = aEnabled;
+	}
+
+	void WebSocket::sendText(const string& aPayload) noexcept {
+		wsm->onData(aPayload, TransportType::TYPE_SOCKET, Direction::OUTGOING, getIp());
 
 		try {
 			if (secure) {
-				tlsServer->send(hdl, str, websocketpp::frame::opcode::text);
+				tlsServer->send(hdl, aPayload, websocketpp::frame::opcode::text);
 			} else {
-				plainServer->send(hdl, str, websocketpp::frame::opcode::text);
+				plainServer->send(hdl, aPayload, websocketpp::frame::opcode::text);
 			}
 		} catch (const websocketpp::exception& e) {
 			logError("Failed to send data: " + string(e.what()), websocketpp::log::elevel::fatal);
@@ -23,6 +23,7 @@
 
 #include "forward.h"
 
+#include <airdcpp/core/thread/CriticalSection.h>
 #include <airdcpp/core/types/GetSet.h>
 
 namespace webserver {
@@ -49,6 +50,19 @@ namespace webserver {
 		void sendPlain(const json& aJson);
 		void sendApiResponse(const json& aJsonResponse, const json& aErrorJson, http_status aCode, int aCallbackId) noexcept;
 
+		// Send an event message that has been serialized already
+		// With event batching, the events are combined into a single frame (JSON array) that is sent 
+		// when the batching window expires or before the next API response
+		void sendEvent(const string& aPayload) noexcept;
+
+		// Send the pending batched events
+		void flushEvents() noexcept;
+
+		void setEventBatching(bool aEnabled) noexcept;
+		bool isEventBatching() const noexcept {
+			return eventBatching;
+		}
+
 		void onData(const string& aPayload, const SessionCallback& aAuthCallback);
 
 		WebSocket(WebSocket&) = delete;
@@ -78,6 +92,9 @@ namespace webserver {
 	protected:
 		WebSocket(bool aIsSecure, websocketpp::connection_hdl aHdl, const websocketpp::http::parser::request& aRequest, WebServerManager* aWsm);
 	private:
+		void sendText(const string& aPayload) noexcept;
+		void flushEventsUnsafe() noexcept;
+
 		const union {
 			server_plain* plainServer;
 			server_tls* tlsServer;
@@ -89,6 +106,14 @@ namespace webserver {
 		const time_t timeCreated;
 		string url;
 		string ip;
+
+		// Changed only while holding eventCS (atomic for isEventBatching)
+		atomic<bool> eventBatching = false;
+
+		// Comma-separated list of pending events
+		string pendingEvents;
+		size_t pendingEventCount = 0;
+		mutable CriticalSection eventCS;
 	};
 }
 
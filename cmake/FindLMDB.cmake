@@ -0,0 +1,35 @@
+if(UNIX)
+    find_package(PkgConfig QUIET)
+    pkg_check_modules(_LMDB QUIET lmdb)
+endif()
+
+find_path(LMDB_INCLUDE_DIR
+    NAMES lmdb.h
+    HINTS ${_LMDB_INCLUDEDIR})
+find_library(LMDB_LIBRARY
+    NAMES lmdb
+    HINTS ${_LMDB_LIBDIR})
+
+set(LMDB_INCLUDE_DIRS ${LMDB_INCLUDE_DIR})
+set(LMDB_LIBRARIES ${LMDB_LIBRARY})
+
+include(FindPackageHandleStandardArgs)
+
+find_package_handle_standard_args(LMDB
+    REQUIRED_VARS
+        LMDB_LIBRARY
+        LMDB_INCLUDE_DIR)
+
+mark_as_advanced(LMDB_INCLUDE_DIR LMDB_LIBRARY)
+
+if(LMDB_FOUND)
+    # message(STATUS "Found lmdb  (include: ${LMDB_INCLUDE_DIR}, library: ${LMDB_LIBRARY})")
+    if(NOT TARGET lmdb)
+      add_library(lmdb UNKNOWN IMPORTED)
+      set_target_properties(lmdb PROPERTIES
+        INTERFACE_INCLUDE_DIRECTORIES "${LMDB_INCLUDE_DIR}")
+
+        set_property(TARGET lmdb APPEND PROPERTY
+          IMPORTED_LOCATION "${LMDB_LIBRARY}")
+    endif()
+endif()
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2011-2024 AirDC++ Project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <airdcpp/core/io/FileReader.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace dcpp;
+
+#define CHECK(cond) if (!(cond)) { printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); return false; }
+
+#define TEST_FILE "file_reader_test.bin"
+
+// Default block size of the reader
+#define BLOCK_SIZE (1024 * 1024)
+
+// Reported as skipped by CTest
+#define EXIT_SKIPPED 77
+
+using ByteList = std::vector<uint8_t>;
+
+static ByteList writeFile(size_t aSize) {
+	std::mt19937 rng(static_cast<unsigned>(aSize));
+	ByteList data(aSize);
+	for (auto& b: data) {
+		b = static_cast<uint8_t>(rng());
+	}
+
+	std::ofstream f(TEST_FILE, std::ios::binary | std::ios::trunc);
+	f.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	return data;
+}
+
+// Read the file with the given strategy, stop after aMaxCallbacks
+// Fails if the reader fell back to another strategy
+static bool readFile(FileReader::Strategy aStrategy, ByteList& data_, size_t& read_, size_t aMaxCallbacks = static_cast<size_t>(-1)) {
+	size_t callbacks = 0;
+	FileReader reader(aStrategy);
+	read_ = reader.read(TEST_FILE, [&](const void* aData, size_t aLen) {
+		auto bytes = static_cast<const uint8_t*>(aData);
+		data_.insert(data_.end(), bytes, bytes + aLen);
+
+		callbacks++;
+		return callbacks < aMaxCallbacks;
+	});
+
+	CHECK(reader.getLastStrategy() == aStrategy);
+	return true;
+}
+
+// Asynchronous reads require io_uring and a file system supporting unbuffered reads
+static bool isAsyncSupported() {
+	writeFile(1);
+
+	FileReader reader(FileReader::ASYNC);
+	reader.read(TEST_FILE, [](const void*, size_t) { return true; });
+	return reader.getLastStrategy() == FileReader::ASYNC;
+}
+
+static bool testFileSize(size_t aSize) {
+	auto expected = writeFile(aSize);
+
+	ByteList syncData, asyncData;
+	size_t syncRead, asyncRead;
+	CHECK(readFile(FileReader::SYNC, syncData, syncRead));
+	CHECK(readFile(FileReader::ASYNC, asyncData, asyncRead));
+
+	CHECK(syncData == expected);
+	CHECK(asyncData == syncData);
+	CHECK(syncRead == aSize);
+	CHECK(asyncRead == syncRead);
+	return true;
+}
+
+static bool testFileSizes() {
+	// Unbuffered reads are aligned, and up to four blocks are read at the same time
+	const size_t sizes[] = {
+		0, 1, 4095, 4096, 4097,
+		BLOCK_SIZE - 1, BLOCK_SIZE, BLOCK_SIZE + 1,
+		4 * BLOCK_SIZE, 4 * BLOCK_SIZE + 1,
+		9 * BLOCK_SIZE + BLOCK_SIZE / 2 + 3
+	};
+
+	for (auto size: sizes) {
+		if (!testFileSize(size)) {
+			printf("Failed with file size %d\n", static_cast<int>(size));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool testAbort() {
+	// Reads that are in flight must not be delivered after the callback has returned false
+	auto expected = writeFile(6 * BLOCK_SIZE + 5);
+
+	ByteList data;
+	size_t read;
+	CHECK(readFile(FileReader::ASYNC, data, read, 2));
+
+	CHECK(!data.empty());
+	CHECK(read == data.size());
+	CHECK(data.size() < expected.size());
+	CHECK(std::equal(data.begin(), data.end(), expected.begin()));
+	return true;
+}
+
+int main() {
+	auto success = false;
+	try {
+		if (!isAsyncSupported()) {
+			std::remove(TEST_FILE);
+			printf("Asynchronous reads aren't available (io_uring or unbuffered reads not supported), skipping\n");
+			return EXIT_SKIPPED;
+		}
+
+		success = testFileSizes() && testAbort();
+	} catch (const std::exception& e) {
+		printf("Read failed: %s\n", e.what());
+	}
+
+	std::remove(TEST_FILE);
+
+	printf(success ? "All tests passed\n" : "Tests failed\n");
+	return success ? 0 : 1;
+}